@@ -0,0 +1,268 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/animations/SkeletonInstance.h>
+
+#include <y/concurrent/concurrent.h>
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+using namespace yave;
+using namespace y::test;
+
+static constexpr usize bench_bones = 64;
+static constexpr usize bench_keys = 60;
+static constexpr float bench_duration = 2.0f;
+
+static Skeleton bench_skeleton() {
+	core::Vector<Bone> bones;
+	for(usize i = 0; i != bench_bones; ++i) {
+		bones << Bone{core::String("bone_") + i, i ? u32((i - 1) / 2) : u32(-1), BoneTransform{math::Vec3(0.0f, 0.0f, 1.0f)}};
+	}
+	return Skeleton(bones);
+}
+
+// every other bone is animated with smooth curves, channels are in reverse bone order
+static core::Vector<AnimationChannel> bench_channels() {
+	math::FastRandom rng;
+	auto random = [&] { return float(rng() % 1024) / 1024.0f; };
+
+	core::Vector<AnimationChannel> channels;
+	for(usize i = bench_bones; i != 0; --i) {
+		if(i % 2) {
+			continue;
+		}
+		math::Vec3 freq(random(), random(), random());
+		math::Vec3 phase(random(), random(), random());
+
+		core::Vector<AnimationChannel::BoneKey> keys;
+		for(usize k = 0; k != bench_keys; ++k) {
+			float t = bench_duration * k / bench_keys;
+			math::Vec3 a = phase + freq * t * 2.0f * math::pi<float>;
+			BoneTransform tr{math::Vec3(std::sin(a.x()), std::sin(a.y()), 1.0f + t * 0.1f)};
+			tr.rotation = math::Quaternion<>::from_euler(std::sin(a.x()), std::sin(a.y()), std::sin(a.z()) * 0.5f);
+			keys << AnimationChannel::BoneKey{t, tr};
+		}
+		channels << AnimationChannel(core::String("bone_") + (i - 1), std::move(keys));
+	}
+	return channels;
+}
+
+static Animation bench_animation() {
+	return Animation(bench_duration, bench_channels());
+}
+
+// every iteration is a 60 fps frame
+static float next_frame_time() {
+	static usize frame = 0;
+	return std::fmod(frame++ / 60.0f, bench_duration);
+}
+
+// fixtures hold pointers to each other and are never moved
+template<usize Instances>
+struct Sampling : NonMovable {
+	Skeleton skeleton = bench_skeleton();
+	Animation animation = bench_animation();
+	core::Vector<AnimationChannel> raw = bench_channels();
+	core::Vector<u32> raw_cursors = core::Vector<u32>(Instances * raw.size(), 0);
+	core::Vector<AnimationSampler> samplers;
+	std::unique_ptr<AnimationSampler::Pose> pose = std::make_unique<AnimationSampler::Pose>();
+	std::unique_ptr<AnimationSampler::LocalPose> local = std::make_unique<AnimationSampler::LocalPose>();
+
+	static Sampling& get() {
+		static Sampling sampling;
+		return sampling;
+	}
+
+	private:
+		Sampling() {
+			for(usize i = 0; i != Instances; ++i) {
+				samplers << AnimationSampler(&animation, &skeleton);
+			}
+		}
+};
+
+template<usize Instances>
+struct Skeletons : NonMovable {
+	Skeleton skeleton = bench_skeleton();
+	core::Vector<SkeletonInstance> instances;
+	core::Vector<SkeletonInstance*> skeletons;
+	core::Vector<u32> offsets;
+	core::Vector<math::Transform<>> palette = core::Vector<math::Transform<>>(Instances * bench_bones, math::Transform<>());
+
+	template<typename F>
+	Skeletons(F&& setup) {
+		for(usize i = 0; i != Instances; ++i) {
+			instances << SkeletonInstance(&skeleton);
+		}
+		for(auto& s : instances) {
+			setup(s);
+			offsets << u32(skeletons.size() * skeleton.bones().size());
+			skeletons << &s;
+		}
+	}
+
+	void update() {
+		update_skeletons(skeletons, offsets, palette.begin());
+		do_not_optimize(palette);
+	}
+};
+
+template<usize Instances>
+static Skeletons<Instances>& animated_skeletons() {
+	static AssetPtr<Animation> animation = make_asset<Animation>(bench_animation());
+	static Skeletons<Instances> skeletons([](SkeletonInstance& s) { s.animate(animation); });
+	return skeletons;
+}
+
+// crossfade between two clips, with an additive layer and a masked upper body
+template<usize Instances>
+static Skeletons<Instances>& blended_skeletons() {
+	static AssetPtr<Animation> walk = make_asset<Animation>(bench_animation());
+	static AssetPtr<Animation> run = make_asset<Animation>(Animation(bench_duration * 0.5f, bench_channels()));
+	static Skeletons<Instances> skeletons([](SkeletonInstance& s) {
+		core::Vector<float> mask(bench_bones, 0.0f);
+		std::fill(mask.begin() + mask.size() / 2, mask.end(), 1.0f);
+
+		BlendTree& tree = s.blend_tree();
+		u32 locomotion = tree.add_lerp(tree.add_clip(walk), tree.add_clip(run), 0.3f);
+		u32 breathing = tree.add_additive(locomotion, tree.add_clip(walk, 2.0f), 0.5f);
+		tree.set_root(tree.add_masked(breathing, tree.add_clip(run), std::move(mask), 0.8f));
+	});
+	return skeletons;
+}
+
+// lookup by bone name, as SkeletonInstance used to do
+template<usize Instances>
+static void sample_by_name() {
+	auto& s = Sampling<Instances>::get();
+	float time = next_frame_time();
+	const auto& bones = s.skeleton.bones();
+	for(usize i = 0; i != Instances; ++i) {
+		for(usize b = 0; b != bones.size(); ++b) {
+			(*s.pose)[b] = s.animation.bone_transform(bones[b].name, time).value_or(s.skeleton.bone_transforms()[b]);
+		}
+	}
+	do_not_optimize(*s.pose);
+}
+
+template<usize Instances>
+static void sample_bound(bool skinning) {
+	auto& s = Sampling<Instances>::get();
+	float time = next_frame_time();
+	for(auto& sampler : s.samplers) {
+		sampler.sample(time, *s.local);
+		if(skinning) {
+			compute_skinning(s.skeleton, *s.local, *s.pose);
+		}
+	}
+	do_not_optimize(*s.local);
+	do_not_optimize(*s.pose);
+}
+
+template<usize Instances>
+static void sample_raw() {
+	auto& s = Sampling<Instances>::get();
+	float time = next_frame_time();
+	for(usize i = 0; i != Instances; ++i) {
+		for(usize c = 0; c != s.raw.size(); ++c) {
+			(*s.pose)[c] = s.raw[c].bone_transform(time, s.raw_cursors[i * s.raw.size() + c]);
+		}
+	}
+	do_not_optimize(*s.pose);
+}
+
+y_bench_func("100 instances, lookup by name") {
+	sample_by_name<100>();
+}
+
+y_bench_func("100 instances, bound sampler") {
+	sample_bound<100>(false);
+}
+
+y_bench_func("100 instances, bound sampler with skinning") {
+	sample_bound<100>(true);
+}
+
+y_bench_func("1000 instances, lookup by name") {
+	sample_by_name<1000>();
+}
+
+y_bench_func("1000 instances, bound sampler") {
+	sample_bound<1000>(false);
+}
+
+y_bench_func("1000 instances, bound sampler with skinning") {
+	sample_bound<1000>(true);
+}
+
+y_bench_func("1000 instances, raw keys") {
+	sample_raw<1000>();
+}
+
+y_bench_func("1000 instances, palette update") {
+	animated_skeletons<1000>().update();
+}
+
+y_bench_func("10000 instances, palette update") {
+	animated_skeletons<10000>().update();
+}
+
+y_bench_func("1000 instances, 4 clips blend tree") {
+	blended_skeletons<1000>().update();
+}
+
+static void print_compression_stats() {
+	core::Vector<AnimationChannel> raw = bench_channels();
+	Animation animation = bench_animation();
+
+	usize raw_keys = 0;
+	usize compressed_keys = 0;
+	for(usize c = 0; c != raw.size(); ++c) {
+		raw_keys += raw[c].key_count();
+		compressed_keys += animation.channels()[c].key_count();
+	}
+	log_msg(fmt("% channels, raw: % keys, % KB, compressed: % track keys, % KB", raw.size(),
+		raw_keys, raw_keys * sizeof(AnimationChannel::BoneKey) / 1024, compressed_keys, animation.byte_size() / 1024));
+
+	float max_position_error = 0.0f;
+	float max_basis_error = 0.0f;
+	for(usize c = 0; c != raw.size(); ++c) {
+		CompressedChannel::Cursor cursor;
+		// raw channels wrap around after the last key, compressed ones hold it
+		for(float t = 0.0f; t < bench_duration * (bench_keys - 1) / bench_keys; t += 0.001f) {
+			math::Transform<> a = raw[c].bone_transform(t);
+			math::Transform<> b = animation.channels()[c].bone_transform(t / bench_duration, cursor);
+			max_position_error = std::max(max_position_error, (a.position() - b.position()).length());
+			for(usize i = 0; i != 3; ++i) {
+				max_basis_error = std::max(max_basis_error, (a.column(i) - b.column(i)).length());
+			}
+		}
+	}
+	log_msg(fmt("    max error: position = %, basis = %", max_position_error, max_basis_error));
+	log_msg(fmt("palette updates run on % threads", concurrent::default_thread_pool().concurency()));
+}
+
+int main(int argc, char** argv) {
+	print_compression_stats();
+	return run_benchmarks(argc, argv);
+}
@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/FlatHashMap.h>
+#include <y/core/AssocVector.h>
+
+#include <y/core/Vector.h>
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+#include <unordered_map>
+
+using namespace y;
+using namespace y::test;
+
+static constexpr usize bench_lookups = 1 << 16;
+
+template<typename Map>
+static void insert(Map& map, u64 key, u64 value) {
+	if constexpr(std::is_base_of_v<core::Vector<core::MapEntry<u64, u64>>, Map>) {
+		map.insert(key, value);
+	} else {
+		map.emplace(key, value);
+	}
+}
+
+// twice as many keys as entries: half of the lookups miss
+template<usize Size>
+static const core::Vector<u64>& keys() {
+	static const core::Vector<u64> keys = [] {
+		math::FastRandom rng(Size);
+		core::Vector<u64> k;
+		for(usize i = 0; i != Size * 2; ++i) {
+			k << (u64(rng()) << 32 | rng());
+		}
+		return k;
+	}();
+	return keys;
+}
+
+template<typename Map, usize Size>
+static Map create_map() {
+	Map map;
+	for(usize i = 0; i != Size; ++i) {
+		insert(map, keys<Size>()[i], i);
+	}
+	return map;
+}
+
+template<typename Map, usize Size>
+static void bench_insert() {
+	Map map = create_map<Map, Size>();
+	do_not_optimize(map);
+}
+
+template<typename Map, usize Size>
+static void bench_lookup() {
+	static const Map map = create_map<Map, Size>();
+	const auto& k = keys<Size>();
+	u64 sum = 0;
+	for(usize i = 0; i != bench_lookups; ++i) {
+		auto it = map.find(k[i % k.size()]);
+		if(it != map.end()) {
+			sum += it->second;
+		}
+	}
+	do_not_optimize(sum);
+}
+
+y_bench_func("AssocVector insert 32") {
+	bench_insert<core::AssocVector<u64, u64>, 32>();
+}
+
+y_bench_func("SortedAssocVector insert 32") {
+	bench_insert<core::SortedAssocVector<u64, u64>, 32>();
+}
+
+y_bench_func("std::unordered_map insert 32") {
+	bench_insert<std::unordered_map<u64, u64>, 32>();
+}
+
+y_bench_func("FlatHashMap insert 32") {
+	bench_insert<core::FlatHashMap<u64, u64>, 32>();
+}
+
+y_bench_func("AssocVector 64k lookups in 32") {
+	bench_lookup<core::AssocVector<u64, u64>, 32>();
+}
+
+y_bench_func("SortedAssocVector 64k lookups in 32") {
+	bench_lookup<core::SortedAssocVector<u64, u64>, 32>();
+}
+
+y_bench_func("std::unordered_map 64k lookups in 32") {
+	bench_lookup<std::unordered_map<u64, u64>, 32>();
+}
+
+y_bench_func("FlatHashMap 64k lookups in 32") {
+	bench_lookup<core::FlatHashMap<u64, u64>, 32>();
+}
+
+y_bench_func("SortedAssocVector 64k lookups in 1k") {
+	bench_lookup<core::SortedAssocVector<u64, u64>, 1 << 10>();
+}
+
+y_bench_func("std::unordered_map insert 64k") {
+	bench_insert<std::unordered_map<u64, u64>, 1 << 16>();
+}
+
+y_bench_func("FlatHashMap insert 64k") {
+	bench_insert<core::FlatHashMap<u64, u64>, 1 << 16>();
+}
+
+y_bench_func("std::unordered_map 64k lookups in 64k") {
+	bench_lookup<std::unordered_map<u64, u64>, 1 << 16>();
+}
+
+y_bench_func("FlatHashMap 64k lookups in 64k") {
+	bench_lookup<core::FlatHashMap<u64, u64>, 1 << 16>();
+}
+
+y_bench_func("std::unordered_map 64k lookups in 1M") {
+	bench_lookup<std::unordered_map<u64, u64>, 1 << 20>();
+}
+
+y_bench_func("FlatHashMap 64k lookups in 1M") {
+	bench_lookup<core::FlatHashMap<u64, u64>, 1 << 20>();
+}
+
+int main(int argc, char** argv) {
+	return run_benchmarks(argc, argv);
+}
@@ -0,0 +1,77 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/Vector.h>
+#include <y/test/bench.h>
+
+#include <thread>
+
+using namespace y;
+using namespace y::test;
+
+static constexpr usize bench_threads = 16;
+
+// bursts fit in the thread ring buffers, sustained logging is bound by the logging thread
+template<typename F>
+static void log_from_threads(usize messages, F&& log) {
+	core::Vector<std::thread> threads;
+	for(usize i = 0; i != bench_threads; ++i) {
+		threads << std::thread([&, i] {
+			for(usize k = 0; k != messages; ++k) {
+				log(i, k);
+			}
+		});
+	}
+	for(auto& t : threads) {
+		t.join();
+	}
+	flush_log();
+}
+
+// messages are warnings so that they go to stderr: run with it redirected
+y_bench_func("log_msg 16 threads x 512") {
+	log_from_threads(512, [](usize thread, usize k) { log_msg(fmt("thread % message %", thread, k), Log::Warning); });
+}
+
+y_bench_func("log_fmt 16 threads x 512") {
+	log_from_threads(512, [](usize thread, usize k) { log_fmt(Log::Warning, "thread % message %", thread, k); });
+}
+
+y_bench_func("repeated 16 threads x 512") {
+	log_from_threads(512, [](usize, usize) { log_msg("repeated message", Log::Warning); });
+}
+
+y_bench_func("log_msg 16 threads x 64k") {
+	log_from_threads(1 << 16, [](usize thread, usize k) { log_msg(fmt("thread % message %", thread, k), Log::Warning); });
+}
+
+y_bench_func("log_fmt 16 threads x 64k") {
+	log_from_threads(1 << 16, [](usize thread, usize k) { log_fmt(Log::Warning, "thread % message %", thread, k); });
+}
+
+y_bench_func("repeated 16 threads x 64k") {
+	log_from_threads(1 << 16, [](usize, usize) { log_msg("repeated message", Log::Warning); });
+}
+
+int main(int argc, char** argv) {
+	return run_benchmarks(argc, argv);
+}
@@ -0,0 +1,246 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/Transform.h>
+#include <y/math/batch.h>
+
+#include <y/core/Vector.h>
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+using namespace y;
+using namespace y::math;
+using namespace y::test;
+
+static constexpr usize data_size = 1024;
+
+static float random_float(FastRandom& rng) {
+	return float(rng() % 2001) / 100.0f - 10.0f;
+}
+
+static Transform<> random_transform(FastRandom& rng) {
+	Vec3 pos(random_float(rng), random_float(rng), random_float(rng));
+	auto quat = Quaternion<>::from_euler(random_float(rng), random_float(rng), random_float(rng));
+	return Transform<>(pos, quat, Vec3(1.0f + std::abs(random_float(rng))));
+}
+
+struct Data {
+	core::Vector<Transform<>> transforms;
+	core::Vector<Quaternion<>> quats;
+	core::Vector<Vec4> vecs;
+};
+
+static const Data& data() {
+	static const Data data = [] {
+		FastRandom rng;
+		Data d;
+		for(usize i = 0; i != data_size; ++i) {
+			d.transforms << random_transform(rng);
+			d.quats << Quaternion<>::from_euler(random_float(rng), random_float(rng), random_float(rng));
+			d.vecs << Vec4(random_float(rng), random_float(rng), random_float(rng), 1.0f);
+		}
+		return d;
+	}();
+	return data;
+}
+
+// every iteration runs func over the whole data set
+template<typename F>
+static void bench_op(F&& func) {
+	const Data& d = data();
+	float sink = 0.0f;
+	for(usize i = 0; i != data_size; ++i) {
+		sink += func(d, i);
+	}
+	do_not_optimize(sink);
+}
+
+y_bench_func("1k Matrix4 * Matrix4") {
+	bench_op([](const Data& d, usize i) {
+		Matrix4<> m = d.transforms[i] * d.transforms[(i + 1) % data_size];
+		return m[3][0];
+	});
+}
+
+y_bench_func("1k Matrix4 * Vec4") {
+	bench_op([](const Data& d, usize i) { return (d.transforms[i] * d.vecs[i]).x(); });
+}
+
+y_bench_func("1k Matrix4 inverse") {
+	bench_op([](const Data& d, usize i) { return d.transforms[i].Matrix4<>::inverse()[3][0]; });
+}
+
+y_bench_func("1k Transform inverse") {
+	bench_op([](const Data& d, usize i) { return d.transforms[i].inverse()[3][0]; });
+}
+
+y_bench_func("1k Quaternion slerp") {
+	bench_op([](const Data& d, usize i) { return d.quats[i].slerp(d.quats[(i + 1) % data_size], 0.3f).x(); });
+}
+
+y_bench_func("1k Vec4 madd") {
+	bench_op([](const Data& d, usize i) {
+		Vec4 v = d.vecs[i];
+		v *= 0.5f;
+		v += d.vecs[(i + 1) % data_size];
+		return v.w();
+	});
+}
+
+
+template<usize Size>
+struct BatchData {
+	Transform<> tr;
+	core::Vector<Vec4> planes;
+	core::Vector<Vec4> spheres;
+	SphereArray soa_spheres = SphereArray(Size);
+	core::Vector<Transform<>> a;
+	core::Vector<Transform<>> b;
+
+	static const BatchData& get() {
+		static const BatchData data;
+		return data;
+	}
+
+	private:
+		BatchData() {
+			FastRandom rng(Size);
+			tr = random_transform(rng);
+			for(usize i = 0; i != 6; ++i) {
+				planes << Vec4(Vec3(random_float(rng), random_float(rng), random_float(rng)).normalized(), random_float(rng));
+			}
+			for(usize i = 0; i != Size; ++i) {
+				spheres << Vec4(random_float(rng), random_float(rng), random_float(rng), std::abs(random_float(rng)));
+			}
+			to_soa(spheres, soa_spheres);
+			a = core::Vector<Transform<>>(Size, tr);
+			b = core::Vector<Transform<>>(Size, tr.inverse());
+		}
+};
+
+template<usize Size>
+static void aos_transform_points() {
+	const auto& d = BatchData<Size>::get();
+	static core::Vector<Vec3> out(Size, Vec3());
+	for(usize i = 0; i != Size; ++i) {
+		out[i] = (d.tr * Vec4(d.spheres[i].template to<3>(), 1.0f)).template to<3>();
+	}
+	do_not_optimize(out);
+}
+
+template<usize Size>
+static void soa_transform_points() {
+	const auto& d = BatchData<Size>::get();
+	static PointArray out(Size);
+	ConstSoASpan<3> centers({d.soa_spheres[0], d.soa_spheres[1], d.soa_spheres[2]}, Size);
+	transform_points(d.tr, centers, out);
+	do_not_optimize(out);
+}
+
+template<usize Size>
+static void aos_frustum_test() {
+	const auto& d = BatchData<Size>::get();
+	static core::Vector<u8> visible(Size, u8(0));
+	for(usize i = 0; i != Size; ++i) {
+		const Vec4& s = d.spheres[i];
+		visible[i] = std::none_of(d.planes.begin(), d.planes.end(), [&](const Vec4& p) { return p.dot({s.template to<3>(), 1.0f}) + s.w() < 0.0f; });
+	}
+	do_not_optimize(visible);
+}
+
+template<usize Size>
+static void soa_frustum_test() {
+	const auto& d = BatchData<Size>::get();
+	static core::Vector<u8> visible(Size, u8(0));
+	sphere_frustum_test(d.planes, d.soa_spheres, visible.data());
+	do_not_optimize(visible);
+}
+
+template<usize Size>
+static void aos_multiply_transforms() {
+	const auto& d = BatchData<Size>::get();
+	static core::Vector<Transform<>> out(Size, Transform<>());
+	for(usize i = 0; i != Size; ++i) {
+		out[i] = d.a[i] * d.b[i];
+	}
+	do_not_optimize(out);
+}
+
+template<usize Size>
+static void soa_multiply_transforms() {
+	const auto& d = BatchData<Size>::get();
+	static core::Vector<Transform<>> out(Size, Transform<>());
+	multiply_transforms(d.a.data(), d.b.data(), out.data(), Size);
+	do_not_optimize(out);
+}
+
+y_bench_func("1k AoS transform points") {
+	aos_transform_points<1000>();
+}
+
+y_bench_func("1k SoA transform_points") {
+	soa_transform_points<1000>();
+}
+
+y_bench_func("100k AoS transform points") {
+	aos_transform_points<100000>();
+}
+
+y_bench_func("100k SoA transform_points") {
+	soa_transform_points<100000>();
+}
+
+y_bench_func("1k AoS sphere frustum test") {
+	aos_frustum_test<1000>();
+}
+
+y_bench_func("1k SoA sphere_frustum_test") {
+	soa_frustum_test<1000>();
+}
+
+y_bench_func("100k AoS sphere frustum test") {
+	aos_frustum_test<100000>();
+}
+
+y_bench_func("100k SoA sphere_frustum_test") {
+	soa_frustum_test<100000>();
+}
+
+y_bench_func("1k Transform * Transform") {
+	aos_multiply_transforms<1000>();
+}
+
+y_bench_func("1k multiply_transforms") {
+	soa_multiply_transforms<1000>();
+}
+
+y_bench_func("100k Transform * Transform") {
+	aos_multiply_transforms<100000>();
+}
+
+y_bench_func("100k multiply_transforms") {
+	soa_multiply_transforms<100000>();
+}
+
+int main(int argc, char** argv) {
+	return run_benchmarks(argc, argv);
+}
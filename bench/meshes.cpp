@@ -0,0 +1,195 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/meshes/MeshOptimizer.h>
+#include <yave/meshes/MeshSimplifier.h>
+#include <yave/meshes/Meshlet.h>
+
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+using namespace yave;
+using namespace y::test;
+
+// unindexed triangle soup of a tesselated sphere, in random triangle order
+static MeshData sphere_soup(usize rings, usize segments) {
+	auto vertex = [&](usize r, usize s) {
+		float theta = math::pi<float> * float(r) / float(rings);
+		float phi = 2.0f * math::pi<float> * float(s % segments) / float(segments);
+		math::Vec3 n(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+		return Vertex{n, n, math::Vec3(-std::sin(phi), std::cos(phi), 0.0f), math::Vec2(float(s) / float(segments), float(r) / float(rings))};
+	};
+
+	core::Vector<Vertex> vertices;
+	core::Vector<IndexedTriangle> triangles;
+	auto add_triangle = [&](const Vertex& a, const Vertex& b, const Vertex& c) {
+		u32 first = u32(vertices.size());
+		vertices << a << b << c;
+		triangles << IndexedTriangle{first, first + 1, first + 2};
+	};
+
+	for(usize r = 0; r != rings; ++r) {
+		for(usize s = 0; s != segments; ++s) {
+			add_triangle(vertex(r, s), vertex(r + 1, s), vertex(r + 1, s + 1));
+			add_triangle(vertex(r, s), vertex(r + 1, s + 1), vertex(r, s + 1));
+		}
+	}
+
+	math::FastRandom rng;
+	for(usize i = triangles.size() - 1; i > 0; --i) {
+		std::swap(triangles[i], triangles[rng() % (i + 1)]);
+	}
+
+	return MeshData::from_parts(std::move(vertices), std::move(triangles));
+}
+
+template<usize Rings, usize Segments>
+static const MeshData& soup() {
+	static const MeshData mesh = sphere_soup(Rings, Segments);
+	return mesh;
+}
+
+template<usize Rings, usize Segments>
+static const MeshData& optimized() {
+	static const MeshData mesh = optimize_mesh(soup<Rings, Segments>());
+	return mesh;
+}
+
+template<usize Rings, usize Segments>
+static void bench_optimize_mesh() {
+	MeshData mesh = optimize_mesh(soup<Rings, Segments>());
+	do_not_optimize(mesh);
+}
+
+template<usize Rings, usize Segments>
+static void bench_vertex_cache() {
+	static const auto welded = [] {
+		const MeshData& mesh = soup<Rings, Segments>();
+		auto parts = std::pair(mesh.vertices(), mesh.triangles());
+		weld_vertices(parts.first, parts.second);
+		return parts;
+	}();
+	core::Vector<IndexedTriangle> triangles = welded.second;
+	optimize_vertex_cache(triangles, welded.first.size());
+	do_not_optimize(triangles);
+}
+
+template<usize Rings, usize Segments>
+static void bench_generate_lods() {
+	MeshData with_lods = generate_lods(optimized<Rings, Segments>());
+	do_not_optimize(with_lods);
+}
+
+template<usize Rings, usize Segments>
+static void bench_meshlets() {
+	const MeshData& mesh = optimized<Rings, Segments>();
+	core::Vector<Meshlet> meshlets = build_meshlets(mesh.vertices(), mesh.triangles());
+	do_not_optimize(meshlets);
+}
+
+y_bench_func("sphere 16x32 optimize_mesh") {
+	bench_optimize_mesh<16, 32>();
+}
+
+y_bench_func("sphere 128x256 optimize_mesh") {
+	bench_optimize_mesh<128, 256>();
+}
+
+y_bench_func("sphere 512x1024 optimize_mesh") {
+	bench_optimize_mesh<512, 1024>();
+}
+
+y_bench_func("sphere 128x256 optimize_vertex_cache") {
+	bench_vertex_cache<128, 256>();
+}
+
+y_bench_func("sphere 512x1024 optimize_vertex_cache") {
+	bench_vertex_cache<512, 1024>();
+}
+
+y_bench_func("sphere 128x256 generate_lods") {
+	bench_generate_lods<128, 256>();
+}
+
+y_bench_func("sphere 512x1024 generate_lods") {
+	bench_generate_lods<512, 1024>();
+}
+
+y_bench_func("sphere 128x256 build_meshlets") {
+	bench_meshlets<128, 256>();
+}
+
+y_bench_func("sphere 512x1024 build_meshlets") {
+	bench_meshlets<512, 1024>();
+}
+
+
+static void print_stats(const char* name, const VertexCacheStats& stats) {
+	log_msg(fmt("    %: ACMR = %, ATVR = %", name, stats.acmr, stats.atvr));
+}
+
+template<usize Rings, usize Segments>
+static void print_mesh_stats() {
+	const MeshData& mesh = soup<Rings, Segments>();
+	log_msg(fmt("sphere %x%: % vertices, % triangles", Rings, Segments, mesh.vertices().size(), mesh.triangles().size()));
+
+	MeshOptimizationStats stats;
+	MeshData optimized = optimize_mesh(mesh, &stats);
+	log_msg(fmt("    % vertices welded", stats.welded_vertices));
+	print_stats("before", stats.before);
+	print_stats("after", vertex_cache_stats(optimized.triangles(), optimized.vertices().size()));
+
+	// vertex cache only, to compare against the full pipeline
+	core::Vector<Vertex> vertices = mesh.vertices();
+	core::Vector<IndexedTriangle> triangles = mesh.triangles();
+	weld_vertices(vertices, triangles);
+	print_stats("welded, unoptimized", vertex_cache_stats(triangles, vertices.size()));
+	optimize_vertex_cache(triangles, vertices.size());
+	print_stats("vertex cache only", vertex_cache_stats(triangles, vertices.size()));
+
+	MeshData with_lods = generate_lods(optimized);
+	for(const MeshLod& lod : with_lods.lods()) {
+		log_msg(fmt("    LOD: % triangles, error = %", lod.triangles.size(), lod.error));
+	}
+
+	core::Vector<Meshlet> meshlets = build_meshlets(optimized.vertices(), optimized.triangles());
+	usize meshlet_vertices = 0;
+	for(const Meshlet& m : meshlets) {
+		meshlet_vertices += m.vertex_count;
+	}
+	log_msg(fmt("    % meshlets, % triangles and % vertices per meshlet", meshlets.size(),
+		float(optimized.triangles().size()) / meshlets.size(), float(meshlet_vertices) / meshlets.size()));
+
+	// looking at the sphere from the side, about half of the meshlets should be back facing
+	Frustum frustum(std::array<math::Vec4, 6>{math::Vec4(1.0f, 0.0f, 0.0f, 10.0f), math::Vec4(-1.0f, 0.0f, 0.0f, 10.0f),
+											   math::Vec4(0.0f, 1.0f, 0.0f, 10.0f), math::Vec4(0.0f, -1.0f, 0.0f, 10.0f),
+											   math::Vec4(0.0f, 0.0f, 1.0f, 10.0f), math::Vec4(0.0f, 0.0f, -1.0f, 10.0f)});
+	MeshletCullData data = meshlet_cull_data(math::Transform<>(), frustum, math::Vec3(5.0f, 0.0f, 0.0f));
+	usize culled = std::count_if(meshlets.begin(), meshlets.end(), [&](const Meshlet& m) { return !is_meshlet_visible(m, data); });
+	log_msg(fmt("    % meshlets out of % are back facing", culled, meshlets.size()));
+}
+
+int main(int argc, char** argv) {
+	print_mesh_stats<16, 32>();
+	print_mesh_stats<128, 256>();
+	return run_benchmarks(argc, argv);
+}
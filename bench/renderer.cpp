@@ -0,0 +1,416 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/device/Device.h>
+#include <yave/scene/SceneView.h>
+#include <yave/renderer/ToneMappingPass.h>
+#include <yave/objects/SkinnedMeshInstance.h>
+#include <yave/material/Material.h>
+#include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/images/ImageView.h>
+
+#include <y/core/Chrono.h>
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace yave;
+using namespace y::test;
+
+// Renders procedurally generated scenes offscreen, without any window or swapchain.
+// Works on software implementations (lavapipe, SwiftShader): VK_ICD_FILENAMES can be used to select one.
+// Like the editor, it needs the compiled shaders in the working directory.
+// Scene arguments are parsed here, everything else is forwarded to run_benchmarks.
+
+struct BenchParams {
+	usize meshes = 1024;
+	usize lights = 64;
+	usize shadowed = 8;
+	usize skinned = 16;
+	math::Vec2ui size = math::Vec2ui(1280, 720);
+	bool debug = false;
+	bool occlusion = true;
+};
+
+static constexpr usize skinned_bones = 16;
+static constexpr float skinned_duration = 2.0f;
+static constexpr float scene_extent = 100.0f;
+
+static math::Vec3 sphere_normal(usize r, usize s, usize rings, usize segments) {
+	float theta = math::pi<float> * float(r) / float(rings);
+	float phi = 2.0f * math::pi<float> * float(s) / float(segments);
+	return math::Vec3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+}
+
+static MeshData sphere_mesh(usize rings, usize segments) {
+	core::Vector<Vertex> vertices;
+	for(usize r = 0; r <= rings; ++r) {
+		for(usize s = 0; s <= segments; ++s) {
+			float phi = 2.0f * math::pi<float> * float(s) / float(segments);
+			math::Vec3 n = sphere_normal(r, s, rings, segments);
+			vertices << Vertex{n, n, math::Vec3(-std::sin(phi), std::cos(phi), 0.0f), math::Vec2(float(s) / float(segments), float(r) / float(rings))};
+		}
+	}
+
+	core::Vector<IndexedTriangle> triangles;
+	const u32 stride = u32(segments + 1);
+	for(u32 r = 0; r != rings; ++r) {
+		for(u32 s = 0; s != segments; ++s) {
+			u32 a = r * stride + s;
+			u32 b = a + stride;
+			triangles << IndexedTriangle{a, b, b + 1} << IndexedTriangle{a, b + 1, a + 1};
+		}
+	}
+
+	return MeshData::from_parts(std::move(vertices), std::move(triangles));
+}
+
+// a tube along z, made of skinned_bones chained segments
+static MeshData tube_mesh(usize rings_per_bone, usize segments) {
+	const usize rings = skinned_bones * rings_per_bone;
+
+	core::Vector<Vertex> vertices;
+	core::Vector<SkinWeights> skin;
+	for(usize r = 0; r <= rings; ++r) {
+		float z = float(r) / float(rings_per_bone);
+		u32 bone = u32(std::min(r / rings_per_bone, skinned_bones - 1));
+		u32 next = u32(std::min(usize(bone) + 1, skinned_bones - 1));
+		float blend = float(r % rings_per_bone) / float(rings_per_bone);
+		for(usize s = 0; s <= segments; ++s) {
+			float phi = 2.0f * math::pi<float> * float(s) / float(segments);
+			math::Vec3 n(std::cos(phi), std::sin(phi), 0.0f);
+			vertices << Vertex{n * 0.25f + math::Vec3(0.0f, 0.0f, z), n, math::Vec3(0.0f, 0.0f, 1.0f), math::Vec2(float(s) / float(segments), float(r) / float(rings))};
+			skin << SkinWeights{math::Vec<4, u32>(bone, next, 0u, 0u), math::Vec4(1.0f - blend, blend, 0.0f, 0.0f)};
+		}
+	}
+
+	core::Vector<IndexedTriangle> triangles;
+	const u32 stride = u32(segments + 1);
+	for(u32 r = 0; r != rings; ++r) {
+		for(u32 s = 0; s != segments; ++s) {
+			u32 a = r * stride + s;
+			u32 b = a + stride;
+			triangles << IndexedTriangle{a, a + 1, b + 1} << IndexedTriangle{a, b + 1, b};
+		}
+	}
+
+	core::Vector<Bone> bones;
+	for(usize i = 0; i != skinned_bones; ++i) {
+		bones << Bone{core::String("bone_") + i, i ? u32(i - 1) : u32(-1), BoneTransform{math::Vec3(0.0f, 0.0f, i ? 1.0f : 0.0f)}};
+	}
+
+	return MeshData::from_parts(std::move(vertices), std::move(triangles), std::move(skin), std::move(bones));
+}
+
+// every bone sways so that poses change every frame
+static Animation sway_animation() {
+	static constexpr usize keys_per_channel = 30;
+
+	core::Vector<AnimationChannel> channels;
+	for(usize i = 1; i != skinned_bones; ++i) {
+		core::Vector<AnimationChannel::BoneKey> keys;
+		for(usize k = 0; k <= keys_per_channel; ++k) {
+			float t = skinned_duration * k / keys_per_channel;
+			float a = std::sin(2.0f * math::pi<float> * (t / skinned_duration + float(i) / skinned_bones)) * 0.2f;
+			BoneTransform tr{math::Vec3(0.0f, 0.0f, 1.0f)};
+			tr.rotation = math::Quaternion<>::from_euler(a, 0.0f, a * 0.5f);
+			keys << AnimationChannel::BoneKey{t, tr};
+		}
+		channels << AnimationChannel(core::String("bone_") + i, std::move(keys));
+	}
+	return Animation(skinned_duration, std::move(channels));
+}
+
+struct BenchScene : NonMovable {
+	Scene scene;
+	SceneView view;
+
+	BenchScene(DevicePtr dptr, const BenchParams& params) : view(scene) {
+		math::FastRandom rng;
+		auto random = [&](float min, float max) { return min + (max - min) * float(rng() % 4096) / 4096.0f; };
+		auto random_position = [&](float z) { return math::Vec3(random(-scene_extent, scene_extent), random(-scene_extent, scene_extent), z); };
+
+		auto material = make_asset<Material>(dptr->device_resources()[DeviceResources::BasicMaterialTemplate]);
+
+		{
+			auto mesh = make_asset<StaticMesh>(dptr, sphere_mesh(32, 64));
+			for(usize i = 0; i != params.meshes; ++i) {
+				auto instance = std::make_unique<StaticMeshInstance>(mesh, material);
+				instance->position() = random_position(random(0.0f, 4.0f));
+				scene.static_meshes() << std::move(instance);
+			}
+		}
+
+		{
+			auto mesh = make_asset<SkinnedMesh>(dptr, tube_mesh(4, 16));
+			auto animation = make_asset<Animation>(sway_animation());
+			for(usize i = 0; i != params.skinned; ++i) {
+				auto instance = std::make_unique<SkinnedMeshInstance>(mesh, material);
+				instance->position() = random_position(0.0f);
+				instance->animate(animation);
+				scene.renderables() << std::move(instance);
+			}
+		}
+
+		{
+			Light sun(Light::Directional);
+			sun.cast_shadows() = params.shadowed != 0;
+			sun.transform().set_basis(math::Vec3{1.0f, 0.5f, -1.0f}.normalized(), {1.0f, 0.0f, 0.0f});
+			sun.color() = 2.0f;
+			scene.lights() << std::make_unique<Light>(sun);
+
+			for(usize i = 0; i != params.lights; ++i) {
+				auto light = std::make_unique<Light>(Light::Point);
+				light->position() = random_position(random(1.0f, 8.0f));
+				light->color() = math::Vec3(random(0.2f, 1.0f), random(0.2f, 1.0f), random(0.2f, 1.0f)) * 10.0f;
+				light->radius() = random(5.0f, 20.0f);
+				light->cast_shadows() = i < params.shadowed;
+				scene.lights() << std::move(light);
+			}
+		}
+
+		const float aspect = float(params.size.x()) / float(params.size.y());
+		view.camera().set_proj(math::perspective(math::to_rad(60.0f), aspect, 0.1f));
+		view.camera().set_view(math::look_at(math::Vec3(-scene_extent, -scene_extent, scene_extent * 0.5f), math::Vec3(0.0f), math::Vec3(0.0f, 0.0f, 1.0f)));
+	}
+};
+
+
+enum Stage {
+	GBufferSetup,
+	ShadowSetup,
+	LightingSetup,
+	ToneMappingSetup,
+	Record,
+	SubmitAndWait,
+	Frame,
+	StageCount
+};
+
+static const char* stage_names[] = {
+	"render_gbuffer",
+	"render_shadows",
+	"render_lighting",
+	"render_tone_mapping",
+	"record",
+	"submit + wait",
+	"frame"
+};
+
+static_assert(sizeof(stage_names) / sizeof(stage_names[0]) == StageCount);
+
+using StageTimes = std::array<u64, StageCount>;
+
+static StageTimes render_frame(DevicePtr dptr, const std::shared_ptr<FrameGraphResourcePool>& pool, const SceneView& view,
+							   const std::shared_ptr<IBLData>& ibl_data, const std::shared_ptr<ShadowMapCache>& shadow_cache, const std::shared_ptr<LightClusterCache>& clusters,
+							   const std::shared_ptr<OcclusionCuller>& culler, StorageTexture& output,
+							   LightingStats* light_stats = nullptr, ShadowMapStats* shadow_stats = nullptr) {
+	y_profile();
+
+	StageTimes times = {};
+	core::Chrono frame_timer;
+	core::Chrono timer;
+	auto lap = [&](Stage stage) { times[stage] = timer.reset().to_nanos(); };
+
+	FrameGraph graph(pool);
+	auto gbuffer = render_gbuffer(graph, &view, output.size(), culler);
+	lap(GBufferSetup);
+	auto shadows = render_shadows(graph, gbuffer, shadow_cache);
+	lap(ShadowSetup);
+	auto lighting = render_lighting(graph, gbuffer, ibl_data, shadows, clusters);
+	lap(LightingSetup);
+	auto tone_mapping = render_tone_mapping(graph, lighting);
+	lap(ToneMappingSetup);
+
+	{
+		const math::Vec2ui size = output.size();
+		FrameGraphPassBuilder builder = graph.add_pass("Output copy pass");
+		builder.add_uniform_input(tone_mapping.tone_mapped);
+		builder.add_uniform_input(StorageView(output));
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				recorder.dispatch_size(dptr->device_resources()[DeviceResources::CopyProgram], size, {self->descriptor_sets()[0]});
+			});
+	}
+
+	CmdBufferRecorder recorder = dptr->create_disposable_cmd_buffer();
+	std::move(graph).render(recorder);
+	lap(Record);
+
+	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
+	lap(SubmitAndWait);
+
+	times[Frame] = frame_timer.elapsed().to_nanos();
+
+	if(light_stats) {
+		*light_stats = *lighting.stats;
+	}
+	if(shadow_stats) {
+		*shadow_stats = shadows.frame->stats;
+	}
+	return times;
+}
+
+struct BenchContext : NonMovable {
+	Instance instance;
+	Device device;
+
+	std::shared_ptr<FrameGraphResourcePool> pool;
+	std::shared_ptr<IBLData> ibl_data;
+	std::shared_ptr<ShadowMapCache> shadow_cache;
+	std::shared_ptr<LightClusterCache> light_clusters;
+	std::shared_ptr<OcclusionCuller> culler;
+	StorageTexture output;
+
+	BenchScene scene;
+
+	LightingStats light_stats;
+	ShadowMapStats shadow_stats;
+	std::array<core::Vector<u64>, StageCount> stages;
+	usize frames = 0;
+
+	BenchContext(const BenchParams& params) :
+			instance(params.debug ? DebugParams::debug() : DebugParams::none(), true),
+			device(instance),
+			pool(std::make_shared<FrameGraphResourcePool>(&device)),
+			ibl_data(std::make_shared<IBLData>(&device)),
+			shadow_cache(std::make_shared<ShadowMapCache>(&device)),
+			light_clusters(std::make_shared<LightClusterCache>(&device)),
+			culler(params.occlusion ? std::make_shared<OcclusionCuller>(&device) : nullptr),
+			output(&device, ImageFormat(vk::Format::eR8G8B8A8Unorm), params.size),
+			scene(&device, params) {
+	}
+
+	~BenchContext() {
+		device.wait_all_queues();
+	}
+};
+
+static std::unique_ptr<BenchContext> context;
+
+y_bench_func("renderer frame") {
+	BenchContext& c = *context;
+	StageTimes times = render_frame(&c.device, c.pool, c.scene.view, c.ibl_data, c.shadow_cache, c.light_clusters, c.culler, c.output, &c.light_stats, &c.shadow_stats);
+	for(usize s = 0; s != StageCount; ++s) {
+		c.stages[s] << times[s];
+	}
+	++c.frames;
+}
+
+static void print_stage(const char* name, core::Vector<u64>& times) {
+	std::sort(times.begin(), times.end());
+	u64 total = 0;
+	for(u64 t : times) {
+		total += t;
+	}
+	auto ms = [](u64 ns) { return float(ns / 1000) / 1000.0f; };
+	log_msg(fmt("    %: median %ms, p95 %ms, mean %ms", name,
+		ms(times[times.size() / 2]), ms(times[std::min(times.size() * 95 / 100, times.size() - 1)]), ms(total / times.size())));
+}
+
+static BenchParams parse_args(int argc, char** argv, core::Vector<char*>& bench_args) {
+	BenchParams params;
+	bench_args << argv[0];
+	for(int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if(arg == "--debug") {
+			params.debug = true;
+			continue;
+		}
+		if(arg == "--no-occlusion") {
+			params.occlusion = false;
+			continue;
+		}
+		if(i + 1 == argc) {
+			y_fatal("Missing value for %.", arg);
+		}
+		if(arg == "--filter" || arg == "--min-time" || arg == "--json" || arg == "--compare" || arg == "--threshold") {
+			bench_args << argv[i] << argv[i + 1];
+			++i;
+			continue;
+		}
+		usize value = usize(std::strtoull(argv[++i], nullptr, 10));
+		if(arg == "--meshes") {
+			params.meshes = value;
+		} else if(arg == "--lights") {
+			params.lights = value;
+		} else if(arg == "--shadowed") {
+			params.shadowed = value;
+		} else if(arg == "--skinned") {
+			params.skinned = value;
+		} else if(arg == "--width") {
+			params.size.x() = u32(value);
+		} else if(arg == "--height") {
+			params.size.y() = u32(value);
+		} else {
+			y_fatal("Unknown argument %.", arg);
+		}
+	}
+	return params;
+}
+
+int main(int argc, char** argv) {
+	core::Vector<char*> bench_args;
+	BenchParams params = parse_args(argc, argv, bench_args);
+
+	context = std::make_unique<BenchContext>(params);
+	log_msg(fmt("% meshes, % skinned meshes, % lights, %x%", params.meshes, params.skinned, params.lights, params.size.x(), params.size.y()));
+
+	perf::reset_zone_stats();
+
+	int result = run_benchmarks(int(bench_args.size()), bench_args.data());
+
+	const BenchContext& c = *context;
+	if(c.frames) {
+		const LightingStats& light_stats = c.light_stats;
+		const ShadowMapStats& shadow_stats = c.shadow_stats;
+		log_msg(fmt("% frames, % / % point lights visible, % directional lights:", c.frames,
+			light_stats.visible_point_count, light_stats.point_count, light_stats.directional_count));
+		log_msg(fmt("% shadowed lights, % static shadow updates, % pending, % dynamic views, atlas usage %",
+			shadow_stats.shadowed_lights, shadow_stats.static_updates, shadow_stats.pending_updates, shadow_stats.dynamic_views, shadow_stats.atlas_usage));
+		if(c.culler) {
+			const OcclusionCullStats& stats = c.culler->stats();
+			log_msg(fmt("% static meshes, % frustum visible, % visible last frame, % disoccluded, % occluded",
+				stats.instances, stats.frustum_visible, stats.early_visible, stats.late_visible, stats.occluded));
+		}
+		for(usize s = 0; s != StageCount; ++s) {
+			core::Vector<u64> times = c.stages[s];
+			print_stage(stage_names[s], times);
+		}
+
+		// frame graph passes and everything else that ran at least once per frame
+		log_msg("zones:");
+		core::Vector<perf::ZoneStats> zones = perf::zone_stats();
+		std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) { return a.total_ns > b.total_ns; });
+		for(const perf::ZoneStats& zone : zones) {
+			if(zone.count < c.frames) {
+				continue;
+			}
+			log_msg(fmt("    %: % calls, %us per frame, p50 %us", zone.name, zone.count, zone.total_ns / 1000 / c.frames, zone.p50_ns / 1000));
+		}
+	}
+
+	context = nullptr;
+
+	return result;
+}
@@ -0,0 +1,101 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <ecs/SlotMap.h>
+
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+using namespace y;
+using namespace y::test;
+using namespace yave;
+
+struct Component {
+	math::Vec3 position;
+	u32 flags = 0;
+};
+
+using Map = ecs::SlotMap<Component>;
+
+static constexpr usize bench_size = 10000;
+
+struct Filled {
+	Map map;
+	core::Vector<Map::Id> shuffled_ids;
+
+	Filled() {
+		for(usize i = 0; i != bench_size; ++i) {
+			shuffled_ids << map.add();
+		}
+		math::FastRandom rng;
+		for(usize i = shuffled_ids.size(); i > 1; --i) {
+			std::swap(shuffled_ids[i - 1], shuffled_ids[rng() % i]);
+		}
+	}
+};
+
+static Filled& filled() {
+	static Filled f;
+	return f;
+}
+
+y_bench_func("SlotMap add 10k") {
+	Map map;
+	for(usize i = 0; i != bench_size; ++i) {
+		map.add();
+	}
+	do_not_optimize(map);
+}
+
+y_bench_func("SlotMap add/remove 10k") {
+	static Map map;
+	core::Vector<Map::Id> ids;
+	ids.set_min_capacity(bench_size);
+	for(usize i = 0; i != bench_size; ++i) {
+		ids << map.add();
+	}
+	for(Map::Id id : ids) {
+		map.remove(id);
+	}
+	do_not_optimize(map);
+}
+
+y_bench_func("SlotMap random get 10k") {
+	Filled& f = filled();
+	u32 sum = 0;
+	for(Map::Id id : f.shuffled_ids) {
+		sum += f.map.get(id)->flags;
+	}
+	do_not_optimize(sum);
+}
+
+y_bench_func("SlotMap iterate 10k") {
+	u32 sum = 0;
+	for(const Component& c : filled().map) {
+		sum += c.flags;
+	}
+	do_not_optimize(sum);
+}
+
+int main(int argc, char** argv) {
+	return run_benchmarks(argc, argv);
+}
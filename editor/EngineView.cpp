@@ -35,13 +35,25 @@ EngineView::EngineView(ContextPtr cptr) :
 		Widget(ICON_FA_DESKTOP " Engine View"),
 		ContextLinked(cptr),
 		_ibl_data(std::make_shared<IBLData>(device())),
+		_shadow_cache(std::make_shared<ShadowMapCache>(device())),
+		_light_clusters(std::make_shared<LightClusterCache>(device())),
+		_occlusion_culler(std::make_shared<OcclusionCuller>(device())),
+		_gpu_timestamps(device()),
 		_scene_view(context()->scene().scene()),
 		_gizmo(context(), &_scene_view) {
-	;
+
+	if(!context()->gpu_timestamps()) {
+		context()->set_gpu_timestamps(&_gpu_timestamps);
+	}
+	if(!context()->occlusion_culler()) {
+		context()->set_occlusion_culler(_occlusion_culler.get());
+	}
 }
 
 EngineView::~EngineView() {
 	context()->scene().reset_scene_view(&_scene_view);
+	context()->reset_gpu_timestamps(&_gpu_timestamps);
+	context()->reset_occlusion_culler(_occlusion_culler.get());
 }
 
 void EngineView::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token) {
@@ -52,8 +64,9 @@ void EngineView::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token)
 
 	{
 		FrameGraph graph(context()->resource_pool());
-		auto gbuffer = render_gbuffer(graph, &_scene_view, content_size());
-		auto lighting = render_lighting(graph, gbuffer, _ibl_data);
+		auto gbuffer = render_gbuffer(graph, &_scene_view, content_size(), _occlusion_culler);
+		auto shadows = render_shadows(graph, gbuffer, _shadow_cache);
+		auto lighting = render_lighting(graph, gbuffer, _ibl_data, shadows, _light_clusters);
 		auto tone_mapping = render_tone_mapping(graph, lighting);
 
 		FrameGraphImageId output_image = tone_mapping.tone_mapped;
@@ -67,7 +80,7 @@ void EngineView::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token)
 				});
 		}
 
-		std::move(graph).render(recorder);
+		std::move(graph).render(recorder, &_gpu_timestamps);
 	}
 
 	// ImGui
@@ -98,6 +111,8 @@ void EngineView::update() {
 
 	if(ImGui::IsWindowFocused()) {
 		context()->scene().set_scene_view(&_scene_view);
+		context()->set_gpu_timestamps(&_gpu_timestamps);
+		context()->set_occlusion_culler(_occlusion_culler.get());
 	}
 
 	// process inputs
@@ -54,6 +54,10 @@ class EngineView final : public Widget, public ContextLinked {
 		void update_picking();
 
 		std::shared_ptr<IBLData> _ibl_data;
+		std::shared_ptr<ShadowMapCache> _shadow_cache;
+		std::shared_ptr<LightClusterCache> _light_clusters;
+		std::shared_ptr<OcclusionCuller> _occlusion_culler;
+		TimeQuery _gpu_timestamps;
 
 		SceneView _scene_view;
 
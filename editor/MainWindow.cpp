@@ -41,6 +41,8 @@ SOFTWARE.
 
 #include <imgui/imgui.h>
 
+#include <y/mem/LinearAllocator.h>
+
 namespace editor {
 
 MainWindow::MainWindow(ContextPtr cptr) :
@@ -94,6 +96,8 @@ void MainWindow::exec() {
 				render(recorder, frame);
 				present(recorder, frame);
 			}
+
+			memory::frame_arena().end_frame();
 		}
 	} while(!context()->ui().confirm("Quit ?"));
 
@@ -44,6 +44,26 @@ EditorContext::EditorContext(DevicePtr dptr) :
 EditorContext::~EditorContext() {
 }
 
+void EditorContext::set_gpu_timestamps(const TimeQuery* timestamps) {
+	_gpu_timestamps = timestamps;
+}
+
+void EditorContext::reset_gpu_timestamps(const TimeQuery* timestamps) {
+	if(_gpu_timestamps == timestamps) {
+		_gpu_timestamps = nullptr;
+	}
+}
+
+void EditorContext::set_occlusion_culler(OcclusionCuller* culler) {
+	_occlusion_culler = culler;
+}
+
+void EditorContext::reset_occlusion_culler(OcclusionCuller* culler) {
+	if(_occlusion_culler == culler) {
+		_occlusion_culler = nullptr;
+	}
+}
+
 void EditorContext::flush_reload() {
 	defer([this]() {
 		y_profile_zone("flush reload");
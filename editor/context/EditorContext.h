@@ -29,6 +29,8 @@ SOFTWARE.
 #include <yave/utils/FileSystemModel.h>
 
 #include <yave/framegraph/FrameGraphResourcePool.h>
+#include <yave/graphics/commands/TimeQuery.h>
+#include <yave/renderer/OcclusionCullPass.h>
 
 #include "Settings.h"
 #include "SceneData.h"
@@ -60,6 +62,22 @@ class EditorContext : NonMovable, public DeviceLinked {
 			return _resource_pool;
 		}
 
+		// GPU timings of the focused view, null if no view is timed
+		const TimeQuery* gpu_timestamps() const {
+			return _gpu_timestamps;
+		}
+
+		void set_gpu_timestamps(const TimeQuery* timestamps);
+		void reset_gpu_timestamps(const TimeQuery* timestamps);
+
+		// occlusion culler of the focused view, null if no view is culled
+		OcclusionCuller* occlusion_culler() const {
+			return _occlusion_culler;
+		}
+
+		void set_occlusion_culler(OcclusionCuller* culler);
+		void reset_occlusion_culler(OcclusionCuller* culler);
+
 		Settings& settings() {
 			return _setting;
 		}
@@ -101,6 +119,8 @@ class EditorContext : NonMovable, public DeviceLinked {
 		bool _is_flushing_deferred = false;
 
 		std::shared_ptr<FrameGraphResourcePool> _resource_pool;
+		const TimeQuery* _gpu_timestamps = nullptr;
+		OcclusionCuller* _occlusion_culler = nullptr;
 
 		std::shared_ptr<AssetStore> _asset_store;
 		AssetLoader _loader;
@@ -58,7 +58,9 @@ static auto load_envmap() {
 ThumbmailCache::ThumbmailCache(ContextPtr ctx, usize size) :
 	ContextLinked(ctx),
 	_size(size),
-	_ibl_data(std::make_shared<IBLData>(device(), load_envmap())) {
+	_ibl_data(std::make_shared<IBLData>(device(), load_envmap())),
+	_shadow_cache(std::make_shared<ShadowMapCache>(device(), 256)),
+	_light_clusters(std::make_shared<LightClusterCache>(device())) {
 }
 
 void ThumbmailCache::clear() {
@@ -155,7 +157,8 @@ std::unique_ptr<ThumbmailCache::Thumbmail> ThumbmailCache::render_thumbmail(CmdB
 
 		FrameGraph graph(context()->resource_pool());
 		auto gbuffer = render_gbuffer(graph, &scene.view, thumbmail->image.size());
-		auto lighting = render_lighting(graph, gbuffer, _ibl_data);
+		auto shadows = render_shadows(graph, gbuffer, _shadow_cache);
+		auto lighting = render_lighting(graph, gbuffer, _ibl_data, shadows, _light_clusters);
 		auto tone_mapping = render_tone_mapping(graph, lighting);
 
 		FrameGraphImageId output_image = tone_mapping.tone_mapped;
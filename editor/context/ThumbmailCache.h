@@ -73,6 +73,8 @@ class ThumbmailCache : NonCopyable, public ContextLinked {
 		usize _size;
 
 		std::shared_ptr<IBLData> _ibl_data;
+		std::shared_ptr<ShadowMapCache> _shadow_cache;
+		std::shared_ptr<LightClusterCache> _light_clusters;
 		std::unordered_map<AssetId, std::unique_ptr<Thumbmail>> _thumbmails;
 		core::Vector<std::future<ThumbmailFunc>> _requests;
 };
@@ -22,6 +22,8 @@ SOFTWARE.
 
 #include "transforms.h"
 
+#include <y/math/batch.h>
+
 namespace editor {
 namespace import {
 
@@ -30,22 +32,30 @@ std::remove_const_t<std::remove_reference_t<T>> copy(T&& t) {
 	return t;
 }
 
-static math::Vec3 h_transform(const math::Vec3& v, const math::Transform<>& tr) {
-	auto h = tr * math::Vec4(v, 1.0f);
-	return h.to<3>() / h.w();
-}
-
-static math::Vec3 transform(const math::Vec3& v, const math::Transform<>& tr) {
-	return tr.to<3, 3>() * v;
-}
+static core::Vector<Vertex> transform(core::ArrayView<Vertex> vertices, const math::Transform<>& tr) {
+	math::PointArray positions(vertices.size());
+	math::PointArray normals(vertices.size());
+	math::PointArray tangents(vertices.size());
+	for(usize i = 0; i != vertices.size(); ++i) {
+		positions.set(i, vertices[i].position);
+		normals.set(i, vertices[i].normal);
+		tangents.set(i, vertices[i].tangent);
+	}
 
-static Vertex transform(const Vertex& v, const math::Transform<>& tr) {
-	return Vertex {
-			h_transform(v.position, tr),
-			transform(v.normal, tr),
-			transform(v.tangent, tr),
-			v.uv
-		};
+	math::transform_points(tr, positions, positions);
+	math::transform_vectors(tr, normals, normals);
+	math::transform_vectors(tr, tangents, tangents);
+
+	auto transformed = core::vector_with_capacity<Vertex>(vertices.size());
+	for(usize i = 0; i != vertices.size(); ++i) {
+		transformed << Vertex {
+				positions.get(i),
+				normals.get(i),
+				tangents.get(i),
+				vertices[i].uv
+			};
+	}
+	return transformed;
 }
 
 static BoneTransform transform(const BoneTransform& bone, const math::Transform<>& tr) {
@@ -59,8 +69,7 @@ static BoneTransform transform(const BoneTransform& bone, const math::Transform<
 
 
 MeshData transform(const MeshData& mesh, const math::Transform<>& tr) {
-	auto vertices = core::vector_with_capacity<Vertex>(mesh.vertices().size());
-	std::transform(mesh.vertices().begin(), mesh.vertices().end(), std::back_inserter(vertices), [=](const auto& vert) { return transform(vert, tr); });
+	auto vertices = transform(mesh.vertices(), tr);
 
 	if(mesh.has_skeleton()) {
 		auto bones = core::vector_with_capacity<Bone>(mesh.bones().size());
@@ -71,26 +80,22 @@ MeshData transform(const MeshData& mesh, const math::Transform<>& tr) {
 		return MeshData::from_parts(std::move(vertices), copy(mesh.triangles()), copy(mesh.skin()), std::move(bones));
 	}
 
-	return MeshData::from_parts(std::move(vertices), copy(mesh.triangles()));
+	MeshData transformed = MeshData::from_parts(std::move(vertices), copy(mesh.triangles()));
+	transformed.set_vertex_format(mesh.vertex_format());
+	transformed.set_lods(copy(mesh.lods()));
+	if(mesh.has_meshlets()) {
+		// meshlet bounds and cones are in model space
+		transformed.set_meshlets(build_meshlets(transformed.vertices(), transformed.triangles()));
+	}
+	return transformed;
 }
 
 
 
 
-static AnimationChannel set_speed(const AnimationChannel& anim, float speed) {
-	auto keys = core::vector_with_capacity<AnimationChannel::BoneKey>(anim.keys().size());
-	std::transform(anim.keys().begin(), anim.keys().end(), std::back_inserter(keys), [=](const auto& key){
-			return AnimationChannel::BoneKey{key.time / speed, key.local_transform};
-		});
-
-	return AnimationChannel(anim.name(), std::move(keys));
-}
-
 Animation set_speed(const Animation& anim, float speed) {
-	auto channels = core::vector_with_capacity<AnimationChannel>(anim.channels().size());
-	std::transform(anim.channels().begin(), anim.channels().end(), std::back_inserter(channels), [=](const auto& channel){ return set_speed(channel, speed); });
-
-	return Animation(anim.duration() / speed, std::move(channels));
+	// key times are relative to the duration
+	return Animation(anim.duration() / speed, copy(anim.channels()));
 }
 
 }
@@ -34,7 +34,7 @@ void crash_handler(int) {
 int main(int argc, char** argv) {
 	std::signal(SIGSEGV, crash_handler);
 
-	perf::set_output_file("perfdump.json");
+	perf::set_output_file("perfdump.yprof");
 
 
 	bool debug = true;
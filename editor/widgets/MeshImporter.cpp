@@ -27,6 +27,11 @@ SOFTWARE.
 
 #include <editor/import/transforms.h>
 
+#include <yave/meshes/MeshOptimizer.h>
+#include <yave/meshes/MeshSimplifier.h>
+
+#include <y/concurrent/concurrent.h>
+
 #include <imgui/imgui.h>
 
 namespace editor {
@@ -67,6 +72,13 @@ void MeshImporter::paint_ui(CmdBufferRecorder& recorder, const FrameToken& token
 			;
 
 
+		ImGui::Separator();
+
+		ImGui::Checkbox("Optimize meshes", &_optimize_meshes);
+		ImGui::Checkbox("Generate LODs", &_generate_lods);
+		ImGui::Checkbox("Build meshlets", &_build_meshlets);
+		ImGui::Checkbox("Compact vertices", &_packed_vertices);
+
 		ImGui::Separator();
 
 		const char* axes[] = {"+X", "-X", "+Y", "-Y", "+Z", "-Z"};
@@ -156,6 +168,42 @@ void MeshImporter::import(import::SceneData scene) {
 		}
 	}
 
+	if(_optimize_meshes) {
+		concurrent::parallel_for_each(scene.meshes.begin(), scene.meshes.end(), [](auto& mesh) {
+			MeshOptimizationStats stats;
+			mesh = optimize_mesh(mesh.obj(), &stats);
+			log_msg(fmt("Optimized \"%\": ACMR %/%, ATVR %/%, % vertices welded", mesh.name(),
+				stats.before.acmr, stats.after.acmr,
+				stats.before.atvr, stats.after.atvr,
+				stats.welded_vertices));
+		});
+	}
+
+	if(_generate_lods) {
+		concurrent::parallel_for_each(scene.meshes.begin(), scene.meshes.end(), [](auto& mesh) {
+			if(!mesh.obj().has_skeleton()) {
+				mesh = generate_lods(mesh.obj());
+				log_msg(fmt("Generated % LODs for \"%\"", mesh.obj().lods().size(), mesh.name()));
+			}
+		});
+	}
+
+	if(_build_meshlets) {
+		concurrent::parallel_for_each(scene.meshes.begin(), scene.meshes.end(), [](auto& mesh) {
+			if(!mesh.obj().has_skeleton()) {
+				mesh.obj().set_meshlets(build_meshlets(mesh.obj().vertices(), mesh.obj().triangles()));
+			}
+		});
+	}
+
+	if(_packed_vertices) {
+		for(auto& mesh : scene.meshes) {
+			if(!mesh.obj().has_skeleton()) {
+				mesh.obj().set_vertex_format(VertexFormat::Packed);
+			}
+		}
+	}
+
 	import_assets(scene.meshes);
 	import_assets(scene.animations);
 
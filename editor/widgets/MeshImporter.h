@@ -56,6 +56,11 @@ class MeshImporter final : public Widget, public ContextLinked {
 		core::String _filename;
 		import::SceneImportFlags _flags = import::SceneImportFlags::ImportAll;
 
+		bool _packed_vertices = false;
+		bool _optimize_meshes = true;
+		bool _generate_lods = true;
+		bool _build_meshlets = true;
+
 		usize _forward_axis = 0;
 		usize _up_axis = 4;
 
@@ -22,8 +22,12 @@ SOFTWARE.
 
 #include "PerformanceMetrics.h"
 
+#include <editor/context/EditorContext.h>
+
 #include <yave/device/Device.h>
 
+#include <y/utils/perf.h>
+
 #include <imgui/imgui.h>
 
 namespace editor {
@@ -35,6 +39,10 @@ PerformanceMetrics::PerformanceMetrics(ContextPtr cptr) : Widget("Performance",
 void PerformanceMetrics::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 	auto time = _timer.reset();
 	ImGui::Text("frame time: %.2fms", time.to_millis());
+	const TimeQuery* gpu_timestamps = context()->gpu_timestamps();
+	if(gpu_timestamps && gpu_timestamps->is_supported()) {
+		ImGui::Text("GPU frame time: %.2fms", gpu_timestamps->frame_time().to_millis());
+	}
 	ImGui::Text("%.3u waiting deletion", unsigned(device()->lifetime_manager().pending_deletions()));
 	ImGui::Text("Active command buffers: %.3u", unsigned(device()->lifetime_manager().active_cmd_buffers()));
 
@@ -42,6 +50,75 @@ void PerformanceMetrics::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 	_current_index = (_current_index + 1) % _frames.size();
 
 	ImGui::PlotLines("Timing", _frames.begin(), _frames.size(), _current_index, "", 0.0f, 100.0f, ImVec2(0, 80));
+
+	paint_gpu_passes();
+	paint_occlusion_culling();
+	paint_zones();
+}
+
+void PerformanceMetrics::paint_gpu_passes() {
+	const TimeQuery* gpu_timestamps = context()->gpu_timestamps();
+	if(!gpu_timestamps || !ImGui::CollapsingHeader("GPU passes")) {
+		return;
+	}
+
+	ImGui::Columns(2, "###gpupasses");
+	for(const auto& timing : gpu_timestamps->timings()) {
+		ImGui::TextUnformatted(timing.name.data(), timing.name.data() + timing.name.size());
+		ImGui::NextColumn();
+		ImGui::Text("%.3fms", timing.time.to_millis());
+		ImGui::NextColumn();
+	}
+	ImGui::Columns(1);
+}
+
+void PerformanceMetrics::paint_occlusion_culling() {
+	OcclusionCuller* culler = context()->occlusion_culler();
+	if(!culler || !ImGui::CollapsingHeader("Occlusion culling")) {
+		return;
+	}
+
+	ImGui::Checkbox("Enabled", &culler->enabled());
+
+	const OcclusionCullStats& stats = culler->stats();
+	ImGui::Text("Static meshes: %u", unsigned(stats.instances));
+	ImGui::Text("Frustum visible: %u", unsigned(stats.frustum_visible));
+	ImGui::Text("Visible last frame: %u", unsigned(stats.early_visible));
+	ImGui::Text("Disoccluded: %u", unsigned(stats.late_visible));
+	ImGui::Text("Occluded: %u", unsigned(stats.occluded));
+}
+
+void PerformanceMetrics::paint_zones() {
+	if(!ImGui::CollapsingHeader("Zones")) {
+		return;
+	}
+
+	if(ImGui::Button("Reset")) {
+		perf::reset_zone_stats();
+	}
+
+	auto stats = perf::zone_stats();
+	y::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.total_ns > b.total_ns; });
+
+	auto ms = [](u64 ns) { return float(ns / 1000000.0); };
+
+	ImGui::Columns(7, "###zones");
+	for(const char* header : {"zone", "count", "mean", "min", "max", "p50", "p99"}) {
+		ImGui::TextUnformatted(header);
+		ImGui::NextColumn();
+	}
+	ImGui::Separator();
+	for(const perf::ZoneStats& zone : stats) {
+		ImGui::TextUnformatted(zone.name.data(), zone.name.data() + zone.name.size());
+		ImGui::NextColumn();
+		ImGui::Text("%u", unsigned(zone.count));
+		ImGui::NextColumn();
+		for(u64 ns : {zone.mean_ns(), zone.min_ns, zone.max_ns, zone.p50_ns, zone.p99_ns}) {
+			ImGui::Text("%.3fms", ms(ns));
+			ImGui::NextColumn();
+		}
+	}
+	ImGui::Columns(1);
 }
 
 }
@@ -34,6 +34,9 @@ class PerformanceMetrics : public Widget, public ContextLinked {
 
 	private:
 		void paint_ui(CmdBufferRecorder&, const FrameToken&) override;
+		void paint_gpu_passes();
+		void paint_occlusion_culling();
+		void paint_zones();
 
 		core::Chrono _timer;
 
@@ -150,6 +150,7 @@ void PropertyPanel::paint_ui(CmdBufferRecorder&, const FrameToken&) {
 
 		ImGui::InputFloat("Intensity", &light->intensity(), 1.0f, 10.0f);
 		ImGui::InputFloat("Radius", &light->radius(), 1.0f, 10.0f);
+		ImGui::Checkbox("Cast shadows", &light->cast_shadows());
 
 
 	}
@@ -0,0 +1,39 @@
+#version 450
+
+#include "yave.glsl"
+
+out gl_PerVertex {
+	vec4 gl_Position;
+};
+
+layout(set = 0, binding = 0) uniform ViewProj {
+	mat4 matrix;
+} view_proj;
+
+layout(push_constant) uniform Dequantization {
+	vec4 offset;
+	vec4 scale;
+} dequantization;
+
+layout(location = 0) in vec4 in_position;
+layout(location = 1) in vec2 in_normal;
+layout(location = 2) in vec2 in_tangent;
+layout(location = 3) in vec2 in_uv;
+layout(location = 8) in mat4 in_model;
+
+layout(location = 0) out vec3 v_normal;
+layout(location = 1) out vec3 v_tangent;
+layout(location = 2) out vec3 v_bitangent;
+layout(location = 3) out vec2 v_uv;
+
+void main() {
+	v_uv = in_uv;
+
+	mat3 model = mat3(in_model);
+	v_normal = model * octahedral_decode(in_normal);
+	v_tangent = model * octahedral_decode(in_tangent);
+	v_bitangent = cross(v_tangent, v_normal);
+
+	vec3 position = dequantization.offset.xyz + in_position.xyz * dequantization.scale.xyz;
+	gl_Position = view_proj.matrix * in_model * vec4(position, 1.0);
+}
@@ -7,7 +7,12 @@ const float epsilon = 0.001;
 const uint max_uint = uint(0xFFFFFFF);
 
 const uint max_bones = 256;
-const uint max_tile_lights = 256;
+// light clusters, matches LightingPass.cpp
+const uint cluster_tile_size = 64;
+const uint cluster_slices = 24;
+const uint max_cluster_lights = 128;
+const float cluster_near = 1.0;
+const float cluster_far = 1000.0;
 
 
 // -------------------------------- TYPES --------------------------------
@@ -17,6 +22,18 @@ struct Light {
 	float radius;
 	vec3 color;
 	uint type;
+	uint shadow_index;
+	uint padding_0;
+	uint padding_1;
+	uint padding_2;
+};
+
+const uint no_shadow = 0xFFFFFFFF;
+
+struct ShadowMap {
+	mat4 view_proj;
+	vec2 uv_offset;
+	vec2 uv_mul;
 };
 
 struct Frustum {
@@ -62,6 +79,14 @@ float sqr(float x) {
 	return x * x;
 }
 
+// http://jcgt.org/published/0003/02/01/
+vec3 octahedral_decode(vec2 oct) {
+	vec3 n = vec3(oct, 1.0 - abs(oct.x) - abs(oct.y));
+	float t = max(-n.z, 0.0);
+	n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+	return normalize(n);
+}
+
 float noise(vec2 co) {
 	return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
 }
@@ -174,6 +199,26 @@ bool is_inside(Frustum4 frustum, vec3 pos, float radius) {
 }
 
 
+// -------------------------------- CLUSTERS --------------------------------
+
+// slices are exponentially distributed along the view direction, the first and last ones extend to 0 and infinity
+uint cluster_slice(float view_dist) {
+	float slice = log(max(view_dist, cluster_near) / cluster_near) / log(cluster_far / cluster_near);
+	return min(uint(slice * cluster_slices), cluster_slices - 1);
+}
+
+vec2 cluster_slice_range(uint slice) {
+	float ratio = cluster_far / cluster_near;
+	float begin = slice == 0 ? 0.0 : cluster_near * pow(ratio, slice / float(cluster_slices));
+	float end = slice + 1 == cluster_slices ? 3.4e38 : cluster_near * pow(ratio, (slice + 1) / float(cluster_slices));
+	return vec2(begin, end);
+}
+
+uint cluster_index(uvec2 tile, uint slice, uvec2 tile_count) {
+	return (slice * tile_count.y + tile.y) * tile_count.x + tile.x;
+}
+
+
 // -------------------------------- HDR --------------------------------
 
 vec3 reinhard(vec3 hdr, float k) {
@@ -0,0 +1,229 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/animations/BlendTree.h>
+
+#include <y/io/Buffer.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+static bool is_finite(const BoneTransform& tr) {
+	for(usize i = 0; i != 3; ++i) {
+		if(!std::isfinite(tr.position[i]) || !std::isfinite(tr.scale[i])) {
+			return false;
+		}
+	}
+	for(usize i = 0; i != 4; ++i) {
+		if(!std::isfinite(tr.rotation.as_vec()[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool is_same(const BoneTransform& a, const BoneTransform& b, float tolerance) {
+	return (a.position - b.position).length() <= tolerance &&
+		   (a.scale - b.scale).length() <= tolerance &&
+		   std::abs(std::abs(a.rotation.as_vec().dot(b.rotation.as_vec())) - 1.0f) <= tolerance;
+}
+
+static float random_float(math::FastRandom& rng) {
+	return float(rng() % 2048) / 1024.0f - 1.0f;
+}
+
+static math::Quaternion<> random_quaternion(math::FastRandom& rng) {
+	return math::Quaternion<>(random_float(rng), random_float(rng), random_float(rng), random_float(rng));
+}
+
+// angle between the two rotations, q and -q are the same rotation
+static float rotation_error(const math::Quaternion<>& a, const math::Quaternion<>& b) {
+	math::Vec4 va = a.as_vec();
+	math::Vec4 vb = va.dot(b.as_vec()) < 0.0f ? -b.as_vec() : b.as_vec();
+	return 4.0f * std::asin(std::min(2.0f, (va - vb).length()) * 0.5f);
+}
+
+// smooth curves sampled at 30 fps, with a constant scale
+static AnimationChannel create_channel(math::FastRandom& rng, float duration) {
+	math::Vec3 freq(random_float(rng), random_float(rng), random_float(rng));
+	core::Vector<AnimationChannel::BoneKey> keys;
+	for(float t = 0.0f; t <= duration; t += 1.0f / 30.0f) {
+		math::Vec3 a = freq * t * 2.0f * math::pi<float>;
+		BoneTransform tr;
+		tr.position = math::Vec3(std::sin(a.x()), std::cos(a.y()), t);
+		tr.rotation = math::Quaternion<>::from_euler(std::sin(a.x()), std::sin(a.y()) * 2.0f, a.z());
+		tr.scale = math::Vec3(2.0f);
+		keys << AnimationChannel::BoneKey{t, tr};
+	}
+	return AnimationChannel("bone", std::move(keys));
+}
+
+y_test_func("Animation quaternion packing") {
+	math::FastRandom rng;
+	float max_error = 0.0f;
+	for(usize i = 0; i != 4096; ++i) {
+		math::Quaternion<> q = random_quaternion(rng);
+		math::Quaternion<> unpacked = unpack_quaternion(pack_quaternion(q));
+		max_error = std::max(max_error, rotation_error(q, unpacked));
+	}
+	y_test_assert(max_error < 0.0002f);
+
+	// every component can be the dropped one, with either sign
+	for(usize i = 0; i != 4; ++i) {
+		for(float sign : {1.0f, -1.0f}) {
+			math::Vec4 v(0.1f, -0.2f, 0.3f, -0.25f);
+			v[i] = sign;
+			math::Quaternion<> q(v);
+
+			PackedQuaternion packed = pack_quaternion(q);
+			PackedQuaternion negated = pack_quaternion(math::Quaternion<>(-q.as_vec()));
+			y_test_assert(packed.a == negated.a && packed.b == negated.b && packed.c == negated.c);
+
+			math::Quaternion<> unpacked = unpack_quaternion(packed);
+			y_test_assert(std::abs(unpacked.as_vec().dot(q.as_vec())) > 0.99999f);
+			y_test_assert(rotation_error(q, unpacked) < 0.0002f);
+		}
+	}
+}
+
+y_test_func("Animation key reduction stays within tolerance") {
+	const float duration = 3.0f;
+	AnimationCompressionSettings settings;
+
+	math::FastRandom rng(7);
+	for(usize c = 0; c != 8; ++c) {
+		AnimationChannel channel = create_channel(rng, duration);
+		CompressedChannel compressed(channel, duration, settings);
+		y_test_assert(compressed.key_count() < channel.key_count() * 3);
+
+		// sampled at the quantized time of every original key
+		CompressedChannel::Cursor cursor;
+		for(const auto& key : channel.keys()) {
+			float time = std::round(key.time / duration * 65535.0f) / 65535.0f;
+			BoneTransform tr = compressed.sample(time, cursor);
+			y_test_assert((tr.position - key.local_transform.position).length() <= settings.position_tolerance * 1.001f);
+			y_test_assert(rotation_error(tr.rotation, key.local_transform.rotation) <= settings.rotation_tolerance * 1.01f);
+
+			// constant tracks keep their exact value
+			y_test_assert(tr.scale == key.local_transform.scale);
+		}
+	}
+}
+
+y_test_func("Animation compressed channel matches the uncompressed one") {
+	const float duration = 2.0f;
+	math::FastRandom rng(3);
+	AnimationChannel channel = create_channel(rng, duration);
+	CompressedChannel compressed(channel, duration);
+
+	float last_key = channel.keys().last().time;
+
+	// cursors are advanced incrementally, then moved backward when the time wraps around
+	CompressedChannel::Cursor cursor;
+	for(usize loop = 0; loop != 2; ++loop) {
+		for(float t = 0.0f; t < last_key; t += 0.0037f) {
+			math::Transform<> a = channel.bone_transform(t);
+			math::Transform<> b = compressed.bone_transform(t / duration, cursor);
+			y_test_assert((a.position() - b.position()).length() < 0.01f);
+			for(usize i = 0; i != 3; ++i) {
+				y_test_assert((a.column(i) - b.column(i)).length() < 0.01f);
+			}
+
+			CompressedChannel::Cursor fresh;
+			BoneTransform c = compressed.sample(t / duration, fresh);
+			BoneTransform d = compressed.sample(t / duration, cursor);
+			y_test_assert(c.position == d.position && c.scale == d.scale && c.rotation.as_vec() == d.rotation.as_vec());
+		}
+	}
+}
+
+y_test_func("Animation version 4 is compressed on load") {
+	const float duration = 2.0f;
+	math::FastRandom rng(5);
+	core::Vector<AnimationChannel> channels;
+	channels << create_channel(rng, duration);
+
+	io::Buffer buffer;
+	serde::serialize_all(buffer, fs::magic_number, AssetType::Animation, u32(4), duration, channels);
+
+	Animation anim;
+	anim.deserialize(buffer);
+	y_test_assert(anim.duration() == duration);
+	y_test_assert(anim.channels().size() == 1);
+
+	CompressedChannel::Cursor a;
+	CompressedChannel::Cursor b;
+	CompressedChannel compressed(channels[0], duration);
+	for(float t = 0.0f; t < 1.0f; t += 0.01f) {
+		y_test_assert(anim.channels()[0].sample(t, a).position == compressed.sample(t, b).position);
+	}
+
+	io::Buffer future;
+	serde::serialize_all(future, fs::magic_number, AssetType::Animation, u32(Animation::version + 1), duration, channels);
+	bool thrown = false;
+	try {
+		anim.deserialize(future);
+	} catch(...) {
+		thrown = true;
+	}
+	y_test_assert(thrown);
+}
+
+y_test_func("Animation single key clip has no duration") {
+	BoneTransform key;
+	key.position = math::Vec3(1.0f, 2.0f, 3.0f);
+	key.rotation = math::Quaternion<>::from_euler(0.5f, 1.0f, 0.0f);
+
+	core::Vector<AnimationChannel> channels;
+	channels << AnimationChannel("bone", core::Vector<AnimationChannel::BoneKey>({AnimationChannel::BoneKey{0.0f, key}}));
+	auto anim = make_asset<Animation>(0.0f, std::move(channels));
+
+	CompressedChannel::Cursor cursor;
+	y_test_assert(is_same(anim->channels()[0].sample(0.0f, cursor), key, 0.001f));
+
+	auto tr = anim->bone_transform("bone", 1.0f);
+	y_test_assert(tr && tr->position() == key.position);
+
+	Skeleton skeleton(core::Vector<Bone>({Bone{"bone", u32(-1), BoneTransform()}}));
+	AnimationSampler::LocalPose pose;
+	AnimationSampler sampler(anim.get(), &skeleton);
+	sampler.sample(1.0f, pose);
+	y_test_assert(is_finite(pose[0]) && is_same(pose[0], key, 0.001f));
+
+	BlendTree tree(&skeleton);
+	tree.set_root(tree.add_clip(anim));
+	tree.update(0.5f);
+
+	PosePool pool;
+	tree.evaluate(pool, pose);
+	y_test_assert(is_finite(pose[0]) && is_same(pose[0], key, 0.001f));
+
+	// the clip time stays at 0 so the pose never changes
+	y_test_assert(!tree.update(0.5f));
+	y_test_assert(!tree.update(-0.5f));
+	tree.evaluate(pool, pose);
+	y_test_assert(is_finite(pose[0]));
+}
+
+}
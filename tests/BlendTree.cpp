@@ -0,0 +1,174 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/animations/BlendTree.h>
+
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+static Skeleton create_skeleton() {
+	return Skeleton(core::Vector<Bone>({
+		Bone{"root", u32(-1), BoneTransform{math::Vec3(0.0f, 0.0f, 1.0f)}},
+		Bone{"child", 0, BoneTransform{math::Vec3(0.0f, 1.0f, 0.0f)}}
+	}));
+}
+
+// every bone holds the same transform for the whole clip
+static AssetPtr<Animation> create_pose(const BoneTransform& root, const BoneTransform& child) {
+	auto channel = [](const char* name, const BoneTransform& tr) {
+		return AnimationChannel(name, core::Vector<AnimationChannel::BoneKey>({AnimationChannel::BoneKey{0.0f, tr}, AnimationChannel::BoneKey{1.0f, tr}}));
+	};
+	core::Vector<AnimationChannel> channels;
+	channels << channel("root", root);
+	channels << channel("child", child);
+	return make_asset<Animation>(1.0f, std::move(channels));
+}
+
+static BoneTransform transform(const math::Vec3& pos, const math::Quaternion<>& rot = math::Quaternion<>()) {
+	BoneTransform tr;
+	tr.position = pos;
+	tr.rotation = rot;
+	return tr;
+}
+
+static bool is_same(const BoneTransform& a, const BoneTransform& b, float tolerance = 0.001f) {
+	return (a.position - b.position).length() <= tolerance &&
+		   (a.scale - b.scale).length() <= tolerance &&
+		   std::abs(std::abs(a.rotation.as_vec().dot(b.rotation.as_vec())) - 1.0f) <= tolerance;
+}
+
+struct Poses {
+	Skeleton skeleton = create_skeleton();
+
+	BoneTransform a0 = transform(math::Vec3(1.0f, 0.0f, 0.0f));
+	BoneTransform a1 = transform(math::Vec3(0.0f, 1.0f, 0.0f));
+	BoneTransform b0 = transform(math::Vec3(3.0f, 0.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.0f, 0.5f));
+	BoneTransform b1 = transform(math::Vec3(0.0f, 3.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.5f, 0.0f));
+
+	AssetPtr<Animation> a = create_pose(a0, a1);
+	AssetPtr<Animation> b = create_pose(b0, b1);
+
+	PosePool pool;
+	AnimationSampler::LocalPose pose;
+
+	void evaluate(BlendTree& tree) {
+		tree.update(0.0f);
+		tree.evaluate(pool, pose);
+	}
+};
+
+y_test_func("BlendTree lerp") {
+	Poses p;
+	BlendTree tree(&p.skeleton);
+	u32 lerp = tree.add_lerp(tree.add_clip(p.a), tree.add_clip(p.b), 0.0f);
+	tree.set_root(lerp);
+
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0) && is_same(p.pose[1], p.a1));
+
+	tree.set_weight(lerp, 1.0f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.b0) && is_same(p.pose[1], p.b1));
+
+	tree.set_weight(lerp, 0.5f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], transform(math::Vec3(2.0f, 0.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.0f, 0.25f))));
+	y_test_assert(is_same(p.pose[1], transform(math::Vec3(0.0f, 2.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.25f, 0.0f))));
+}
+
+y_test_func("BlendTree crossfade") {
+	Poses p;
+	BlendTree tree(&p.skeleton);
+	tree.set_root(tree.add_clip(p.a));
+	tree.crossfade(p.b, 1.0f);
+
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0) && is_same(p.pose[1], p.a1));
+
+	tree.update(0.25f);
+	tree.evaluate(p.pool, p.pose);
+	y_test_assert(is_same(p.pose[0], transform(math::Vec3(1.5f, 0.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.0f, 0.125f))));
+
+	// the tree is collapsed into the faded in clip
+	tree.update(1.0f);
+	tree.evaluate(p.pool, p.pose);
+	y_test_assert(is_same(p.pose[0], p.b0) && is_same(p.pose[1], p.b1));
+
+	tree.update(0.5f);
+	tree.evaluate(p.pool, p.pose);
+	y_test_assert(is_same(p.pose[0], p.b0) && is_same(p.pose[1], p.b1));
+
+	tree.crossfade(p.a, 0.0f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0) && is_same(p.pose[1], p.a1));
+}
+
+y_test_func("BlendTree additive") {
+	Poses p;
+	const auto& bind = p.skeleton.bones();
+
+	// root moves by (0, 0, 2) and turns relative to its bind pose, child stays in its bind pose
+	math::Quaternion<> turn = math::Quaternion<>::from_euler(0.0f, 0.0f, 0.5f);
+	AssetPtr<Animation> offset = create_pose(transform(bind[0].local_transform.position + math::Vec3(0.0f, 0.0f, 2.0f), turn), bind[1].local_transform);
+
+	BlendTree tree(&p.skeleton);
+	u32 additive = tree.add_additive(tree.add_clip(p.a), tree.add_clip(offset), 0.0f);
+	tree.set_root(additive);
+
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0) && is_same(p.pose[1], p.a1));
+
+	tree.set_weight(additive, 1.0f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], transform(math::Vec3(1.0f, 0.0f, 2.0f), turn)));
+	y_test_assert(is_same(p.pose[1], p.a1));
+
+	tree.set_weight(additive, 0.5f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], transform(math::Vec3(1.0f, 0.0f, 1.0f), math::Quaternion<>::from_euler(0.0f, 0.0f, 0.25f))));
+	y_test_assert(is_same(p.pose[1], p.a1));
+}
+
+y_test_func("BlendTree masked bones") {
+	Poses p;
+	BlendTree tree(&p.skeleton);
+	u32 masked = tree.add_masked(tree.add_clip(p.a), tree.add_clip(p.b), core::Vector<float>({0.0f, 1.0f}), 0.0f);
+	tree.set_root(masked);
+
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0) && is_same(p.pose[1], p.a1));
+
+	// the root is masked out and stays untouched
+	tree.set_weight(masked, 1.0f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0, 0.00001f));
+	y_test_assert(is_same(p.pose[1], p.b1));
+
+	tree.set_weight(masked, 0.5f);
+	p.evaluate(tree);
+	y_test_assert(is_same(p.pose[0], p.a0, 0.00001f));
+	y_test_assert(is_same(p.pose[1], transform(math::Vec3(0.0f, 2.0f, 0.0f), math::Quaternion<>::from_euler(0.0f, 0.25f, 0.0f))));
+}
+
+}
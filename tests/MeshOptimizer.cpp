@@ -0,0 +1,129 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/meshes/MeshOptimizer.h>
+
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+// grid with shared vertices, triangles shuffled so that the cache behaves poorly
+core::Vector<IndexedTriangle> shuffled_grid(u32 size) {
+	core::Vector<IndexedTriangle> triangles;
+	for(u32 y = 0; y != size; ++y) {
+		for(u32 x = 0; x != size; ++x) {
+			u32 i = y * (size + 1) + x;
+			triangles << IndexedTriangle{{i, i + 1, i + size + 2}};
+			triangles << IndexedTriangle{{i, i + size + 2, i + size + 1}};
+		}
+	}
+
+	math::FastRandom rng(size);
+	for(usize i = triangles.size() - 1; i != 0; --i) {
+		std::swap(triangles[i], triangles[rng() % (i + 1)]);
+	}
+	return triangles;
+}
+
+// rotates the smallest index first, which keeps the winding
+core::Vector<IndexedTriangle> canonical(core::Vector<IndexedTriangle> triangles) {
+	for(IndexedTriangle& tri : triangles) {
+		while(tri[0] > tri[1] || tri[0] > tri[2]) {
+			tri = IndexedTriangle{{tri[1], tri[2], tri[0]}};
+		}
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+y_test_func("MeshOptimizer vertex cache keeps triangles") {
+	const u32 size = 32;
+	const usize vertex_count = (size + 1) * (size + 1);
+	core::Vector<IndexedTriangle> triangles = shuffled_grid(size);
+	core::Vector<IndexedTriangle> optimized = triangles;
+	optimize_vertex_cache(optimized, vertex_count);
+
+	y_test_assert(optimized.size() == triangles.size());
+	y_test_assert(canonical(optimized) == canonical(triangles));
+}
+
+y_test_func("MeshOptimizer vertex cache lowers ACMR") {
+	const u32 size = 32;
+	const usize vertex_count = (size + 1) * (size + 1);
+	core::Vector<IndexedTriangle> triangles = shuffled_grid(size);
+	VertexCacheStats before = vertex_cache_stats(triangles, vertex_count);
+
+	optimize_vertex_cache(triangles, vertex_count);
+	VertexCacheStats after = vertex_cache_stats(triangles, vertex_count);
+	y_test_assert(after.acmr < before.acmr);
+	y_test_assert(after.acmr < 1.0f);
+
+	// already optimized input
+	optimize_vertex_cache(triangles, vertex_count);
+	y_test_assert(vertex_cache_stats(triangles, vertex_count).acmr <= after.acmr);
+}
+
+y_test_func("MeshOptimizer optimize_mesh keeps the surface") {
+	const u32 size = 16;
+	core::Vector<IndexedTriangle> grid = shuffled_grid(size);
+
+	// every triangle has its own vertices, to be welded back
+	core::Vector<Vertex> vertices;
+	core::Vector<IndexedTriangle> triangles;
+	for(const IndexedTriangle& tri : grid) {
+		IndexedTriangle t;
+		for(usize k = 0; k != 3; ++k) {
+			math::Vec3 pos(float(tri[k] % (size + 1)), float(tri[k] / (size + 1)), 0.0f);
+			t[k] = u32(vertices.size());
+			vertices << Vertex{pos, math::Vec3(0.0f, 0.0f, 1.0f), math::Vec3(1.0f, 0.0f, 0.0f), pos.to<2>()};
+		}
+		triangles << t;
+	}
+
+	auto positions = [](const MeshData& mesh) {
+		using Position = std::array<float, 3>;
+		core::Vector<std::array<Position, 3>> tris;
+		for(const IndexedTriangle& tri : mesh.triangles()) {
+			std::array<Position, 3> t;
+			for(usize k = 0; k != 3; ++k) {
+				const math::Vec3& p = mesh.vertices()[tri[k]].position;
+				t[k] = Position{p.x(), p.y(), p.z()};
+			}
+			std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+			tris << t;
+		}
+		std::sort(tris.begin(), tris.end());
+		return tris;
+	};
+
+	MeshData mesh = MeshData::from_parts(std::move(vertices), std::move(triangles));
+	MeshOptimizationStats stats;
+	MeshData optimized = optimize_mesh(mesh, &stats);
+
+	y_test_assert(optimized.vertices().size() == (size + 1) * (size + 1));
+	y_test_assert(stats.welded_vertices == mesh.vertices().size() - optimized.vertices().size());
+	y_test_assert(stats.after.acmr < stats.before.acmr);
+	y_test_assert(positions(optimized) == positions(mesh));
+}
+
+}
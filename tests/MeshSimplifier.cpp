@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/meshes/MeshSimplifier.h>
+
+#include <y/core/FlatHashMap.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+// unit sphere with shared vertices, closed and without attribute seams
+MeshData create_icosphere(usize subdivisions) {
+	const float t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+	core::Vector<math::Vec3> positions = {
+			{-1.0f, t, 0.0f}, {1.0f, t, 0.0f}, {-1.0f, -t, 0.0f}, {1.0f, -t, 0.0f},
+			{0.0f, -1.0f, t}, {0.0f, 1.0f, t}, {0.0f, -1.0f, -t}, {0.0f, 1.0f, -t},
+			{t, 0.0f, -1.0f}, {t, 0.0f, 1.0f}, {-t, 0.0f, -1.0f}, {-t, 0.0f, 1.0f}
+		};
+	core::Vector<IndexedTriangle> triangles = {
+			{{0, 11, 5}}, {{0, 5, 1}}, {{0, 1, 7}}, {{0, 7, 10}}, {{0, 10, 11}},
+			{{1, 5, 9}}, {{5, 11, 4}}, {{11, 10, 2}}, {{10, 7, 6}}, {{7, 1, 8}},
+			{{3, 9, 4}}, {{3, 4, 2}}, {{3, 2, 6}}, {{3, 6, 8}}, {{3, 8, 9}},
+			{{4, 9, 5}}, {{2, 4, 11}}, {{6, 2, 10}}, {{8, 6, 7}}, {{9, 8, 1}}
+		};
+
+	for(usize s = 0; s != subdivisions; ++s) {
+		core::FlatHashMap<u64, u32> midpoints;
+		auto midpoint = [&](u32 a, u32 b) {
+			u64 key = (u64(std::min(a, b)) << 32) | std::max(a, b);
+			auto [it, inserted] = midpoints.emplace(key, u32(positions.size()));
+			if(inserted) {
+				positions << (positions[a] + positions[b]) * 0.5f;
+			}
+			return it->second;
+		};
+
+		core::Vector<IndexedTriangle> subdivided;
+		for(const IndexedTriangle& tri : triangles) {
+			u32 ab = midpoint(tri[0], tri[1]);
+			u32 bc = midpoint(tri[1], tri[2]);
+			u32 ca = midpoint(tri[2], tri[0]);
+			subdivided << IndexedTriangle{{tri[0], ab, ca}} << IndexedTriangle{{tri[1], bc, ab}}
+						<< IndexedTriangle{{tri[2], ca, bc}} << IndexedTriangle{{ab, bc, ca}};
+		}
+		triangles = std::move(subdivided);
+	}
+
+	core::Vector<Vertex> vertices;
+	for(const math::Vec3& p : positions) {
+		math::Vec3 n = p.normalized();
+		vertices << Vertex{n, n, n.cross(math::Vec3(0.0f, 0.0f, 1.0f)), math::Vec2()};
+	}
+	return MeshData::from_parts(std::move(vertices), std::move(triangles));
+}
+
+float point_triangle_distance(const math::Vec3& p, const math::Vec3& a, const math::Vec3& b, const math::Vec3& c) {
+	math::Vec3 normal = (b - a).cross(c - a).normalized();
+	math::Vec3 projected = p - normal * normal.dot(p - a);
+
+	const math::Vec3 corners[] = {a, b, c};
+	bool inside = true;
+	for(usize k = 0; k != 3; ++k) {
+		const math::Vec3& e0 = corners[k];
+		const math::Vec3& e1 = corners[(k + 1) % 3];
+		inside &= (e1 - e0).cross(projected - e0).dot(normal) >= 0.0f;
+	}
+	if(inside) {
+		return std::abs(normal.dot(p - a));
+	}
+
+	float dist = std::numeric_limits<float>::max();
+	for(usize k = 0; k != 3; ++k) {
+		const math::Vec3& e0 = corners[k];
+		math::Vec3 edge = corners[(k + 1) % 3] - e0;
+		float t = std::clamp(edge.dot(p - e0) / edge.length2(), 0.0f, 1.0f);
+		dist = std::min(dist, (e0 + edge * t - p).length());
+	}
+	return dist;
+}
+
+float distance_to_mesh(const math::Vec3& p, const core::Vector<Vertex>& vertices, const core::Vector<IndexedTriangle>& triangles) {
+	float dist = std::numeric_limits<float>::max();
+	for(const IndexedTriangle& tri : triangles) {
+		dist = std::min(dist, point_triangle_distance(p, vertices[tri[0]].position, vertices[tri[1]].position, vertices[tri[2]].position));
+	}
+	return dist;
+}
+
+y_test_func("MeshSimplifier reaches target") {
+	MeshData sphere = create_icosphere(3);
+	y_test_assert(sphere.triangles().size() == 1280);
+
+	for(usize target : {640u, 320u, 100u}) {
+		core::Vector<IndexedTriangle> simplified = simplify_mesh(sphere.vertices(), sphere.triangles(), target);
+		y_test_assert(simplified.size() <= target);
+		y_test_assert(simplified.size() + 2 >= target);
+	}
+}
+
+y_test_func("MeshSimplifier stays within error") {
+	MeshData sphere = create_icosphere(3);
+
+	float previous_error = 0.0f;
+	for(usize target : {640u, 320u, 100u}) {
+		float error = 0.0f;
+		core::Vector<IndexedTriangle> simplified = simplify_mesh(sphere.vertices(), sphere.triangles(), target, &error);
+		y_test_assert(error > previous_error);
+		y_test_assert(error < 0.5f);
+
+		for(const Vertex& v : sphere.vertices()) {
+			y_test_assert(distance_to_mesh(v.position, sphere.vertices(), simplified) <= error * 1.0001f);
+		}
+		previous_error = error;
+	}
+}
+
+y_test_func("MeshSimplifier generate_lods") {
+	MeshData sphere = create_icosphere(3);
+	MeshData mesh = generate_lods(sphere);
+
+	y_test_assert(mesh.lods().size() == default_lod_ratios.size());
+	usize previous_size = mesh.triangles().size();
+	float previous_error = 0.0f;
+	for(const MeshLod& lod : mesh.lods()) {
+		y_test_assert(lod.triangles.size() < previous_size);
+		y_test_assert(lod.error > previous_error);
+		previous_size = lod.triangles.size();
+		previous_error = lod.error;
+	}
+}
+
+}
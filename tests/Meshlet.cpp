@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <yave/meshes/Meshlet.h>
+
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+// bumpy grid with shared vertices, triangles wound counter clockwise seen from +z
+struct Grid {
+	core::Vector<Vertex> vertices;
+	core::Vector<IndexedTriangle> triangles;
+};
+
+Grid create_grid(u32 size, float bump) {
+	math::FastRandom rng(size);
+	Grid grid;
+	for(u32 y = 0; y != size + 1; ++y) {
+		for(u32 x = 0; x != size + 1; ++x) {
+			float z = float(rng() % 1024) / 1024.0f * bump;
+			grid.vertices << Vertex{math::Vec3(float(x), float(y), z), math::Vec3(0.0f, 0.0f, 1.0f), math::Vec3(1.0f, 0.0f, 0.0f), math::Vec2()};
+		}
+	}
+	for(u32 y = 0; y != size; ++y) {
+		for(u32 x = 0; x != size; ++x) {
+			u32 i = y * (size + 1) + x;
+			grid.triangles << IndexedTriangle{{i, i + 1, i + size + 2}};
+			grid.triangles << IndexedTriangle{{i, i + size + 2, i + size + 1}};
+		}
+	}
+	return grid;
+}
+
+math::Vec3 triangle_normal(const Grid& grid, const IndexedTriangle& tri) {
+	const auto& v = grid.vertices;
+	return (v[tri[1]].position - v[tri[0]].position).cross(v[tri[2]].position - v[tri[0]].position);
+}
+
+y_test_func("Meshlet covers triangles") {
+	Grid grid = create_grid(40, 0.5f);
+	core::Vector<Meshlet> meshlets = build_meshlets(grid.vertices, grid.triangles);
+	y_test_assert(meshlets.size() > 1);
+
+	u32 next = 0;
+	for(const Meshlet& meshlet : meshlets) {
+		y_test_assert(meshlet.first_triangle == next);
+		y_test_assert(meshlet.triangle_count && meshlet.triangle_count <= max_meshlet_triangles);
+		y_test_assert(meshlet.vertex_count && meshlet.vertex_count <= max_meshlet_vertices);
+
+		core::Vector<u32> unique;
+		for(u32 i = 0; i != meshlet.triangle_count; ++i) {
+			for(u32 v : grid.triangles[meshlet.first_triangle + i]) {
+				if(std::find(unique.begin(), unique.end(), v) == unique.end()) {
+					unique << v;
+				}
+				y_test_assert((grid.vertices[v].position - meshlet.center).length() <= meshlet.radius * 1.0001f);
+			}
+		}
+		y_test_assert(unique.size() == meshlet.vertex_count);
+
+		next += meshlet.triangle_count;
+	}
+	y_test_assert(next == grid.triangles.size());
+}
+
+y_test_func("Meshlet degenerate triangles") {
+	core::Vector<Vertex> vertices(4, Vertex{});
+	core::Vector<IndexedTriangle> triangles;
+	for(u32 i = 0; i != 300; ++i) {
+		triangles << IndexedTriangle{{i % 4, i % 4, (i + 1) % 4}};
+	}
+
+	core::Vector<Meshlet> meshlets = build_meshlets(vertices, triangles);
+	usize triangle_count = 0;
+	for(const Meshlet& meshlet : meshlets) {
+		y_test_assert(meshlet.vertex_count <= 4);
+		y_test_assert(meshlet.triangle_count <= max_meshlet_triangles);
+		y_test_assert(meshlet.cone_cutoff == 1.0f);
+		triangle_count += meshlet.triangle_count;
+	}
+	y_test_assert(triangle_count == triangles.size());
+}
+
+y_test_func("Meshlet cone culling is conservative") {
+	Grid grid = create_grid(32, 0.2f);
+	core::Vector<Meshlet> meshlets = build_meshlets(grid.vertices, grid.triangles);
+
+	MeshletCullData data;
+	data.cone_culling = 1;
+
+	math::FastRandom rng;
+	auto random_float = [&] { return float(rng() % 2048) / 1024.0f - 1.0f; };
+
+	usize culled = 0;
+	for(usize i = 0; i != 2048; ++i) {
+		data.eye = math::Vec3(random_float(), random_float(), random_float()) * 64.0f + math::Vec3(16.0f, 16.0f, 0.0f);
+		for(const Meshlet& meshlet : meshlets) {
+			if(!is_meshlet_backfacing(meshlet, data)) {
+				continue;
+			}
+			++culled;
+			for(u32 t = 0; t != meshlet.triangle_count; ++t) {
+				const IndexedTriangle& tri = grid.triangles[meshlet.first_triangle + t];
+				y_test_assert(triangle_normal(grid, tri).dot(grid.vertices[tri[0]].position - data.eye) >= 0.0f);
+			}
+		}
+	}
+	y_test_assert(culled);
+
+	data.cone_culling = 0;
+	data.eye = math::Vec3(16.0f, 16.0f, -100.0f);
+	for(const Meshlet& meshlet : meshlets) {
+		y_test_assert(!is_meshlet_backfacing(meshlet, data));
+	}
+}
+
+y_test_func("Meshlet cone culling is disabled for mirrored transforms") {
+	Frustum frustum(std::array<Plane, 6>{});
+	math::Transform<> transform;
+	y_test_assert(meshlet_cull_data(transform, frustum, math::Vec3()).cone_culling);
+
+	transform.set_basis(math::Vec3(1.0f, 0.0f, 0.0f), math::Vec3(0.0f, -1.0f, 0.0f), math::Vec3(0.0f, 0.0f, 1.0f));
+	y_test_assert(!meshlet_cull_data(transform, frustum, math::Vec3()).cone_culling);
+
+	transform.set_basis(math::Vec3(2.0f, 0.0f, 0.0f), math::Vec3(0.0f, 2.0f, 0.0f), math::Vec3(0.0f, 0.0f, -2.0f));
+	y_test_assert(!meshlet_cull_data(transform, frustum, math::Vec3()).cone_culling);
+}
+
+}
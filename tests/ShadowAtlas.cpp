@@ -0,0 +1,140 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#include <yave/renderer/ShadowAtlas.h>
+
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace yave;
+
+bool overlap(const ShadowAtlas::Tile& a, const ShadowAtlas::Tile& b) {
+	return a.offset.x() < b.offset.x() + b.size && b.offset.x() < a.offset.x() + a.size &&
+		   a.offset.y() < b.offset.y() + b.size && b.offset.y() < a.offset.y() + a.size;
+}
+
+bool is_valid(const ShadowAtlas& atlas, const core::Vector<ShadowAtlas::Tile>& tiles) {
+	usize area = 0;
+	for(usize i = 0; i != tiles.size(); ++i) {
+		const auto& tile = tiles[i];
+		if(tile.offset.x() % tile.size || tile.offset.y() % tile.size) {
+			return false;
+		}
+		if(tile.offset.x() + tile.size > atlas.size() || tile.offset.y() + tile.size > atlas.size()) {
+			return false;
+		}
+		for(usize j = 0; j != i; ++j) {
+			if(overlap(tile, tiles[j])) {
+				return false;
+			}
+		}
+		area += usize(tile.size) * tile.size;
+	}
+	return area == atlas.allocated_area();
+}
+
+y_test_func("ShadowAtlas alloc") {
+	ShadowAtlas atlas(1024, 64);
+	y_test_assert(atlas.tile_size(1) == 64);
+	y_test_assert(atlas.tile_size(100) == 128);
+	y_test_assert(atlas.tile_size(4096) == 1024);
+
+	core::Vector<ShadowAtlas::Tile> tiles;
+	for(u32 size : {512u, 100u, 64u, 256u, 128u}) {
+		auto tile = atlas.alloc(size);
+		y_test_assert(tile);
+		y_test_assert(tile->size == atlas.tile_size(size));
+		tiles << *tile;
+	}
+	y_test_assert(is_valid(atlas, tiles));
+
+	while(auto tile = atlas.alloc(64)) {
+		tiles << *tile;
+	}
+	y_test_assert(is_valid(atlas, tiles));
+	y_test_assert(atlas.allocated_area() == usize(1024) * 1024);
+	y_test_assert(!atlas.alloc(64));
+}
+
+y_test_func("ShadowAtlas free") {
+	ShadowAtlas atlas(1024, 64);
+
+	auto a = atlas.alloc(512);
+	auto b = atlas.alloc(512);
+	y_test_assert(a && b);
+
+	atlas.free(*a);
+	y_test_assert(atlas.allocated_area() == usize(512) * 512);
+
+	auto c = atlas.alloc(512);
+	y_test_assert(c);
+	y_test_assert(c->offset == a->offset);
+	y_test_assert(!overlap(*b, *c));
+}
+
+y_test_func("ShadowAtlas coalesce") {
+	ShadowAtlas atlas(1024, 64);
+
+	core::Vector<ShadowAtlas::Tile> tiles;
+	while(auto tile = atlas.alloc(64)) {
+		tiles << *tile;
+	}
+	y_test_assert(tiles.size() == 256);
+	y_test_assert(!atlas.alloc(1024));
+
+	// freeing in reverse order leaves every quadrant complete last
+	for(usize i = tiles.size(); i != 0; --i) {
+		atlas.free(tiles[i - 1]);
+	}
+	y_test_assert(atlas.allocated_area() == 0);
+
+	auto whole = atlas.alloc(1024);
+	y_test_assert(whole);
+	y_test_assert(whole->offset == math::Vec2ui(0));
+	atlas.free(*whole);
+	y_test_assert(atlas.allocated_area() == 0);
+}
+
+y_test_func("ShadowAtlas random") {
+	ShadowAtlas atlas(2048, 64);
+	math::FastRandom rng;
+
+	core::Vector<ShadowAtlas::Tile> tiles;
+	for(usize i = 0; i != 2048; ++i) {
+		if(!tiles.is_empty() && rng() % 2) {
+			usize index = rng() % tiles.size();
+			atlas.free(tiles[index]);
+			tiles.erase_unordered(tiles.begin() + index);
+		} else if(auto tile = atlas.alloc(64u << (rng() % 5))) {
+			tiles << *tile;
+		}
+	}
+	y_test_assert(is_valid(atlas, tiles));
+
+	for(const auto& tile : tiles) {
+		atlas.free(tile);
+	}
+	y_test_assert(atlas.allocated_area() == 0);
+	y_test_assert(atlas.alloc(2048));
+}
+
+}
@@ -0,0 +1,67 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/String.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::test;
+
+y_bench_func("String short construct") {
+	core::String s("short");
+	do_not_optimize(s);
+}
+
+y_bench_func("String long construct") {
+	core::String s("some long long long, very long, even longer string (to bypass SSO)");
+	do_not_optimize(s);
+}
+
+y_bench_func("String append 100 chars") {
+	core::String s;
+	for(usize i = 0; i != 100; ++i) {
+		s.push_back(char('a' + i % 26));
+	}
+	do_not_optimize(s);
+}
+
+y_bench_func("String concat") {
+	static const core::String a = "some/asset/folder";
+	static const core::String b = "some_asset_name";
+	core::String s = a + "/" + b;
+	do_not_optimize(s);
+}
+
+y_bench_func("String compare") {
+	static const core::String a = "some/asset/folder/some_asset_name";
+	static const core::String b = "some/asset/folder/some_asset_namf";
+	bool eq = a == b;
+	do_not_optimize(eq);
+}
+
+y_bench_func("String fmt") {
+	core::String s = fmt("% %: %", "entry", 42, 3.5f);
+	do_not_optimize(s);
+}
+
+}
@@ -0,0 +1,77 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/Vector.h>
+#include <y/test/bench.h>
+
+#include <numeric>
+
+namespace {
+using namespace y;
+using namespace y::test;
+
+static core::Vector<int> make_data(usize size) {
+	core::Vector<int> v;
+	v.set_min_capacity(size);
+	for(usize i = 0; i != size; ++i) {
+		v.push_back(int(i));
+	}
+	return v;
+}
+
+y_bench_func("Vector push_back 1k") {
+	core::Vector<int> v;
+	for(int i = 0; i != 1000; ++i) {
+		v.push_back(i);
+	}
+	do_not_optimize(v);
+}
+
+y_bench_func("Vector push_back 1k reserved") {
+	core::Vector<int> v;
+	v.set_min_capacity(1000);
+	for(int i = 0; i != 1000; ++i) {
+		v.push_back(i);
+	}
+	do_not_optimize(v);
+}
+
+y_bench_func("Vector push_back range 100k") {
+	static const core::Vector<int> data = make_data(100000);
+	core::Vector<int> v;
+	v.push_back(data.begin(), data.end());
+	do_not_optimize(v);
+}
+
+y_bench_func("Vector copy 10k") {
+	static const core::Vector<int> data = make_data(10000);
+	core::Vector<int> v = data;
+	do_not_optimize(v);
+}
+
+y_bench_func("Vector iterate 100k") {
+	static const core::Vector<int> data = make_data(100000);
+	int sum = std::accumulate(data.begin(), data.end(), 0);
+	do_not_optimize(sum);
+}
+
+}
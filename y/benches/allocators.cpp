@@ -0,0 +1,143 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/mem/allocators.h>
+#include <y/mem/SlabAllocator.h>
+#include <y/core/Vector.h>
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+using namespace y;
+using namespace y::test;
+using namespace y::memory;
+
+template<typename T, template<typename...> typename A>
+using Vec = core::Vector<T, core::DefaultVectorResizePolicy, A<T>>;
+
+y_bench_func("Vector 1M emplace_back, std::allocator") {
+	core::Vector<int> v;
+	for(int i = 0; i != 1000000; ++i) {
+		v.emplace_back(i);
+	}
+	do_not_optimize(v);
+}
+
+y_bench_func("Vector 1M emplace_back, StdAllocatorAdapter") {
+	Vec<int, StdAllocatorAdapter> v;
+	for(int i = 0; i != 1000000; ++i) {
+		v.emplace_back(i);
+	}
+	do_not_optimize(v);
+}
+
+static constexpr usize thread_count = 4;
+static constexpr usize thread_allocations = 1 << 16;
+static constexpr usize live_allocations = 1024;
+
+// every thread keeps a window of live small allocations and frees them in random order
+template<typename Allocator>
+static void allocate_threads() {
+	Allocator allocator;
+	core::Vector<std::thread> threads;
+	for(usize t = 0; t != thread_count; ++t) {
+		threads << std::thread([&allocator, t] {
+			math::FastRandom rng(u32(t + 1));
+			std::array<std::pair<void*, usize>, live_allocations> live = {};
+			for(usize i = 0; i != thread_allocations; ++i) {
+				auto& [ptr, size] = live[rng() % live.size()];
+				if(ptr) {
+					allocator.deallocate(ptr, size);
+				}
+				size = 8 + rng() % 248;
+				ptr = allocator.allocate(size);
+				static_cast<u8*>(ptr)[0] = u8(i);
+			}
+			for(auto& [ptr, size] : live) {
+				if(ptr) {
+					allocator.deallocate(ptr, size);
+				}
+			}
+		});
+	}
+	for(auto& t : threads) {
+		t.join();
+	}
+}
+
+// one thread allocates, another frees
+template<typename Allocator>
+static void allocate_cross_thread() {
+	static constexpr usize slot_count = 4096;
+
+	Allocator allocator;
+	std::array<std::atomic<void*>, slot_count> slots = {};
+
+	std::thread consumer([&] {
+		for(usize i = 0; i != thread_allocations; ++i) {
+			auto& slot = slots[i % slots.size()];
+			void* ptr = nullptr;
+			while(!(ptr = slot.exchange(nullptr))) {
+				std::this_thread::yield();
+			}
+			allocator.deallocate(ptr, 64);
+		}
+	});
+
+	for(usize i = 0; i != thread_allocations; ++i) {
+		auto& slot = slots[i % slots.size()];
+		while(slot.load()) {
+			std::this_thread::yield();
+		}
+		slot = allocator.allocate(64);
+	}
+	consumer.join();
+}
+
+y_bench_func("Mallocator 4 threads 64k allocations") {
+	allocate_threads<Mallocator>();
+}
+
+y_bench_func("ThreadSafeAllocator 4 threads 64k allocations") {
+	allocate_threads<ThreadSafeAllocator<Mallocator>>();
+}
+
+y_bench_func("SmallObjectAllocator 4 threads 64k allocations") {
+	allocate_threads<SmallObjectAllocator>();
+}
+
+y_bench_func("Mallocator 64k cross thread frees") {
+	allocate_cross_thread<Mallocator>();
+}
+
+y_bench_func("ThreadSafeAllocator 64k cross thread frees") {
+	allocate_cross_thread<ThreadSafeAllocator<Mallocator>>();
+}
+
+y_bench_func("SmallObjectAllocator 64k cross thread frees") {
+	allocate_cross_thread<SmallObjectAllocator>();
+}
+
+}
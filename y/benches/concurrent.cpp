@@ -0,0 +1,59 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/concurrent/StaticThreadPool.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::test;
+
+static concurrent::StaticThreadPool& thread_pool() {
+	static concurrent::StaticThreadPool pool(4);
+	return pool;
+}
+
+y_bench_func("StaticThreadPool 64 tasks") {
+	std::atomic<usize> done = 0;
+	for(usize i = 0; i != 64; ++i) {
+		thread_pool().schedule([&] { ++done; });
+	}
+	thread_pool().process_until_empty();
+	while(done != 64) {
+		std::this_thread::yield();
+	}
+}
+
+y_bench_func("StaticThreadPool parallel_for_each 100k") {
+	static core::Vector<u32> data(100000, u32(1));
+	std::atomic<usize> done = 0;
+	thread_pool().parallel_for_each(data.begin(), data.end(), [&](u32& e) {
+		e = e * 3 + 1;
+		++done;
+	});
+	thread_pool().process_until_empty();
+	while(done != data.size()) {
+		std::this_thread::yield();
+	}
+}
+
+}
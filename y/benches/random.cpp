@@ -0,0 +1,50 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/random.h>
+#include <y/test/bench.h>
+
+#include <random>
+
+namespace {
+using namespace y;
+using namespace y::test;
+
+y_bench_func("FastRandom 1k") {
+	static math::FastRandom rng;
+	u32 sum = 0;
+	for(usize i = 0; i != 1000; ++i) {
+		sum += rng();
+	}
+	do_not_optimize(sum);
+}
+
+y_bench_func("std::mt19937 1k") {
+	static std::mt19937 rng;
+	u32 sum = 0;
+	for(usize i = 0; i != 1000; ++i) {
+		sum += u32(rng());
+	}
+	do_not_optimize(sum);
+}
+
+}
@@ -0,0 +1,150 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/serde2/archives.h>
+#include <y/io2/Buffer.h>
+#include <y/math/Vec.h>
+#include <y/test/bench.h>
+
+namespace {
+using namespace y;
+using namespace y::test;
+
+struct Entry {
+	core::String name;
+	u64 id = 0;
+	math::Vec3 pos;
+
+	y_serde2(name, id, pos)
+};
+
+// same layout as yave::Vertex and yave::MeshData's geometry
+struct Vertex {
+	math::Vec3 position;
+	math::Vec3 normal;
+	math::Vec3 tangent;
+	math::Vec2 uv;
+};
+
+struct Mesh {
+	core::Vector<Vertex> vertices;
+	core::Vector<std::array<u32, 3>> triangles;
+
+	y_serde2(vertices, triangles)
+};
+
+static const core::Vector<math::Vec3>& vecs() {
+	static const core::Vector<math::Vec3> data(10000, math::Vec3(1.0f, 2.0f, 3.0f));
+	return data;
+}
+
+static const core::Vector<Entry>& entries() {
+	static const core::Vector<Entry> data(1000, Entry{"some/asset/folder/some_asset_name", 0xdeadbeef, {}});
+	return data;
+}
+
+static const Mesh& mesh() {
+	static const Mesh data = [] {
+		static constexpr u32 vertex_count = 100000;
+		Mesh m;
+		for(u32 i = 0; i != vertex_count; ++i) {
+			float f = float(i);
+			m.vertices << Vertex{{f, f, f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {f, f}};
+		}
+		for(u32 i = 0; i != vertex_count * 2; ++i) {
+			m.triangles << std::array<u32, 3>{{i % vertex_count, (i + 1) % vertex_count, (i + 2) % vertex_count}};
+		}
+		return m;
+	}();
+	return data;
+}
+
+template<typename T>
+static void serialize(io2::Buffer& buffer, const T& t) {
+	serde2::WritableArchive ar(buffer);
+	unused(ar(t));
+}
+
+template<typename T>
+static void deserialize(const T& t, bool type_erased) {
+	static io2::Buffer data = [&] {
+		io2::Buffer buffer;
+		serialize(buffer, t);
+		return buffer;
+	}();
+	core::Vector<u8> bytes;
+	unused(data.read_all(bytes));
+
+	io2::Buffer buffer(bytes.size());
+	unused(buffer.write(bytes.data(), bytes.size()));
+
+	T out;
+	if(type_erased) {
+		io2::Reader reader(buffer);
+		serde2::ReadableArchive<> ar(reader);
+		unused(ar(out));
+	} else {
+		serde2::ReadableArchive ar(buffer);
+		unused(ar(out));
+	}
+	do_not_optimize(out);
+}
+
+y_bench_func("serde2 serialize 10k Vec3") {
+	io2::Buffer buffer;
+	serialize(buffer, vecs());
+	do_not_optimize(buffer);
+}
+
+y_bench_func("serde2 serialize 1k entries") {
+	io2::Buffer buffer;
+	serialize(buffer, entries());
+	do_not_optimize(buffer);
+}
+
+y_bench_func("serde2 serialize 100k vertices mesh") {
+	io2::Buffer buffer;
+	serialize(buffer, mesh());
+	do_not_optimize(buffer);
+}
+
+y_bench_func("serde2 deserialize 10k Vec3") {
+	deserialize(vecs(), false);
+}
+
+y_bench_func("serde2 deserialize 1k entries") {
+	deserialize(entries(), false);
+}
+
+y_bench_func("serde2 deserialize 1k entries, io2::Reader") {
+	deserialize(entries(), true);
+}
+
+y_bench_func("serde2 deserialize 100k vertices mesh") {
+	deserialize(mesh(), false);
+}
+
+y_bench_func("serde2 deserialize 100k vertices mesh, io2::Reader") {
+	deserialize(mesh(), true);
+}
+
+}
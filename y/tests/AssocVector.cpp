@@ -73,4 +73,36 @@ y_test_func("AssocVector movable values") {
 		y_test_assert(value.value == int(i));
 	}
 }
+
+y_test_func("SortedAssocVector sorted") {
+	SortedAssocVector<usize, usize> av;
+	for(usize i = 0; i != 64; ++i) {
+		const usize k = (i * 37) % 64;
+		y_test_assert(av[k] == 0);
+		av[k] = k + 1;
+	}
+	y_test_assert(av.size() == 64);
+	for(usize i = 0; i != av.size(); ++i) {
+		y_test_assert(av.begin()[i].first == i);
+		y_test_assert(av.begin()[i].second == i + 1);
+	}
+}
+
+y_test_func("SortedAssocVector find") {
+	SortedAssocVector<String, int> av;
+	av.insert(String("b"), 2);
+	av.insert(String("d"), 4);
+	av.insert(String("a"), 1);
+	av.insert(String("c"), 3);
+
+	y_test_assert(av.find("a")->second == 1);
+	y_test_assert(av.find("d")->second == 4);
+	y_test_assert(av.find("e") == av.end());
+	y_test_assert(av.find("0") == av.end());
+
+	av.erase(av.find("b"));
+	y_test_assert(av.find("b") == av.end());
+	y_test_assert(av.find("c")->second == 3);
+	y_test_assert(std::is_sorted(av.begin(), av.end(), [](const auto& a, const auto& b) { return a.first < b.first; }));
+}
 }
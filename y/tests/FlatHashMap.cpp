@@ -0,0 +1,148 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/core/FlatHashMap.h>
+#include <y/core/String.h>
+#include <y/core/Vector.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+#include <unordered_map>
+
+namespace {
+using namespace y;
+using namespace y::core;
+
+static String name(int i) {
+	return String("key_") + i;
+}
+
+y_test_func("FlatHashMap basic") {
+	FlatHashMap<usize, usize> map;
+	y_test_assert(map.is_empty());
+	y_test_assert(map.find(7) == map.end());
+	y_test_assert(map.begin() == map.end());
+
+	for(usize i = 0; i != 1000; ++i) {
+		map[i] = i * 2;
+	}
+	y_test_assert(map.size() == 1000);
+
+	for(usize i = 0; i != 1000; ++i) {
+		auto it = map.find(i);
+		y_test_assert(it != map.end() && it->second == i * 2);
+	}
+	y_test_assert(!map.contains(1000));
+
+	usize sum = 0;
+	for(const auto& [k, v] : map) {
+		y_test_assert(v == k * 2);
+		sum += k;
+	}
+	y_test_assert(sum == 999 * 1000 / 2);
+
+	y_test_assert(!map.emplace(usize(4), usize(0)).second);
+	y_test_assert(map[4] == 8);
+}
+
+y_test_func("FlatHashMap erase") {
+	FlatHashMap<String, std::unique_ptr<int>> map;
+	for(int i = 0; i != 100; ++i) {
+		map[name(i)] = std::make_unique<int>(i);
+	}
+
+	// erasing doesn't invalidate other iterators
+	core::Vector<decltype(map)::iterator> to_remove;
+	for(auto it = map.begin(); it != map.end(); ++it) {
+		if(*it->second % 2) {
+			to_remove << it;
+		}
+	}
+	for(const auto& it : to_remove) {
+		map.erase(it);
+	}
+
+	y_test_assert(map.size() == 50);
+	for(int i = 0; i != 100; ++i) {
+		auto it = map.find(name(i));
+		y_test_assert((it == map.end()) == bool(i % 2));
+	}
+	y_test_assert(map.erase(name(0)) == 1);
+	y_test_assert(map.erase(name(1)) == 0);
+	y_test_assert(map.size() == 49);
+}
+
+y_test_func("FlatHashMap tombstones") {
+	FlatHashMap<u32, u32> map;
+	map.reserve(64);
+	usize capacity = map.capacity();
+
+	// churn without growing: deleted slots must be recycled
+	for(u32 i = 0; i != 10000; ++i) {
+		map[i] = i;
+		if(i >= 32) {
+			y_test_assert(map.erase(i - 32) == 1);
+		}
+	}
+	y_test_assert(map.size() == 32);
+	y_test_assert(map.capacity() == capacity);
+	for(u32 i = 10000 - 32; i != 10000; ++i) {
+		y_test_assert(map.find(i)->second == i);
+	}
+}
+
+y_test_func("FlatHashMap random") {
+	math::FastRandom rng;
+	FlatHashMap<u32, u32> map;
+	std::unordered_map<u32, u32> reference;
+
+	for(usize i = 0; i != 100000; ++i) {
+		u32 key = u32(rng() % 4096);
+		switch(rng() % 3) {
+			case 0:
+				map[key] = u32(i);
+				reference[key] = u32(i);
+			break;
+
+			case 1:
+				y_test_assert(map.erase(key) == reference.erase(key));
+			break;
+
+			default: {
+				auto it = map.find(key);
+				auto ref = reference.find(key);
+				y_test_assert((it == map.end()) == (ref == reference.end()));
+				y_test_assert(it == map.end() || it->second == ref->second);
+			}
+		}
+	}
+	y_test_assert(map.size() == reference.size());
+
+	FlatHashMap<u32, u32> copy = map;
+	FlatHashMap<u32, u32> moved = std::move(map);
+	y_test_assert(copy.size() == reference.size() && moved.size() == reference.size());
+	for(const auto& [k, v] : reference) {
+		y_test_assert(copy[k] == v && moved[k] == v);
+	}
+}
+
+}
@@ -21,6 +21,7 @@ SOFTWARE.
 **********************************/
 
 #include <y/math/Matrix.h>
+#include <y/math/random.h>
 #include <y/test/test.h>
 
 namespace {
@@ -68,6 +69,64 @@ y_test_func("Matrix inverse") {
 	y_test_assert(e == i);
 }
 
+static Matrix4<> random_matrix(FastRandom& rnd) {
+	Matrix4<> m;
+	for(float& f : m) {
+		f = float(rnd() % 2001) / 100.0f - 10.0f;
+	}
+	return m;
+}
+
+y_test_func("Matrix4 multiply") {
+	FastRandom rnd;
+	for(usize n = 0; n != 100; ++n) {
+		Matrix4<> a = random_matrix(rnd);
+		Matrix4<> b = random_matrix(rnd);
+		Vec4 v = random_matrix(rnd).column(0);
+
+		Matrix4<> ab = a * b;
+		Vec4 av = a * v;
+		// operator[] returns columns
+		for(usize row = 0; row != 4; ++row) {
+			float t = 0.0f;
+			for(usize col = 0; col != 4; ++col) {
+				float s = 0.0f;
+				for(usize k = 0; k != 4; ++k) {
+					s = s + a[k][row] * b[col][k];
+				}
+				y_test_assert(ab[col][row] == s);
+				t = t + a[col][row] * v[col];
+			}
+			y_test_assert(av[row] == t);
+		}
+	}
+}
+
+y_test_func("Matrix4 inverse") {
+	FastRandom rnd;
+	for(usize n = 0; n != 100; ++n) {
+		Matrix4<> m = random_matrix(rnd);
+		Matrix<4, 4, double> d;
+		std::copy(m.begin(), m.end(), d.begin());
+
+		Matrix4<> inv = m.inverse();
+		Matrix<4, 4, double> ref = d.inverse();
+		Matrix4<> id = m * inv;
+		for(usize i = 0; i != 4; ++i) {
+			for(usize j = 0; j != 4; ++j) {
+				y_test_assert(std::abs(inv[i][j] - ref[i][j]) < 0.001 * (1.0 + std::abs(ref[i][j])));
+				y_test_assert(std::abs(id[i][j] - (i == j ? 1.0f : 0.0f)) < 0.001f);
+			}
+		}
+	}
+
+	Matrix4<> singular(1, 2, 3, 4,
+					   2, 4, 6, 8,
+					   0, 1, 0, 1,
+					   5, 0, 2, 1);
+	y_test_assert(singular.inverse() == Matrix4<>());
+}
+
 
 y_test_func("Matrix asymetrical") {
 	Matrix<2, 3> mat(1, 2, 3,
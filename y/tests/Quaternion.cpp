@@ -71,6 +71,21 @@ y_test_func("Quaternion rotation") {
 	y_test_assert(((mat * Vec4(t1, 0.0f)).to<3>() - quat(t1)).length2() < 0.01f);
 }
 
+y_test_func("Quaternion slerp") {
+	Quaternion<> a;
+	auto b = Quaternion<>::from_euler(0, to_rad(90), 0);
+	auto half = Quaternion<>::from_euler(0, to_rad(45), 0);
+
+	Vec3 v(1.0f, 0.0f, 0.0f);
+	y_test_assert((a.slerp(b, 0.0f)(v) - a(v)).length() < 0.001f);
+	y_test_assert((a.slerp(b, 1.0f)(v) - b(v)).length() < 0.001f);
+	y_test_assert((a.slerp(b, 0.5f)(v) - half(v)).length() < 0.001f);
+
+	// takes the shortest path
+	Quaternion<> neg_b = -b.as_vec();
+	y_test_assert((a.slerp(neg_b, 0.5f)(v) - half(v)).length() < 0.001f);
+}
+
 y_test_func("Quaternion euler") {
 	int step = 7;
 	for(int p = -180; p < 180; p += step) {
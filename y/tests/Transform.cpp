@@ -46,6 +46,29 @@ y_test_func("Transform decompose basic") {
 	y_test_assert(s == scale);
 }
 
+y_test_func("Transform inverse") {
+	int step = 23;
+	for(int p = -180; p < 180; p += step) {
+		for(int y = -180; y < 180; y += step) {
+			for(int r = -180; r < 180; r += step) {
+				auto quat = Quaternion<>::from_euler(to_rad(p), to_rad(y), to_rad(r));
+				Vec3 pos(y, r, p);
+				Vec3 scale(0.5f + (p + 180) * 0.01f, 1.0f, 2.0f);
+				Transform<> tr(pos, quat, scale);
+
+				Transform<> inv = tr.inverse();
+				Matrix4<> ref = tr.Matrix4<>::inverse();
+				for(usize i = 0; i != 16; ++i) {
+					y_test_assert(std::abs(inv.begin()[i] - ref.begin()[i]) < 0.001f);
+				}
+
+				Vec3 v(0.5f, 0.75f, 1.0f);
+				y_test_assert(((inv * (tr * Vec4(v, 1.0f))).to<3>() - v).length() < 0.001f);
+			}
+		}
+	}
+}
+
 y_test_func("Transform decompose") {
 	int step = 7;
 	for(int p = -180; p < 180; p += step) {
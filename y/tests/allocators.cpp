@@ -21,12 +21,84 @@ SOFTWARE.
 **********************************/
 #include <y/test/test.h>
 #include <y/mem/allocators.h>
+#include <y/mem/SlabAllocator.h>
 #include <y/core/Vector.h>
 
+#include <thread>
+
 namespace {
 using namespace y;
 using namespace memory;
 
+y_test_func("SlabAllocator basic") {
+	SlabAllocator allocator;
+	y_test_assert(allocator.allocate(SlabAllocator::max_block_size + 1) == nullptr);
+
+	void* a = allocator.allocate(24);
+	void* b = allocator.allocate(24);
+	void* c = allocator.allocate(SlabAllocator::max_block_size);
+	y_test_assert(a && b && c);
+	y_test_assert(reinterpret_cast<usize>(a) % SlabAllocator::min_block_size == 0);
+	y_test_assert(reinterpret_cast<usize>(c) % SlabAllocator::max_block_size == 0);
+	y_test_assert(std::abs(static_cast<u8*>(b) - static_cast<u8*>(a)) >= 32);
+
+	allocator.deallocate(b, 24);
+	y_test_assert(allocator.allocate(32) == b);
+
+	allocator.deallocate(a, 24);
+	allocator.deallocate(b, 32);
+	allocator.deallocate(c, SlabAllocator::max_block_size);
+}
+
+y_test_func("SlabAllocator remote free") {
+	SlabAllocator allocator;
+
+	core::Vector<void*> ptrs;
+	std::thread([&] {
+		for(usize i = 0; i != 1024; ++i) {
+			ptrs << allocator.allocate(64);
+		}
+	}).join();
+
+	usize abandoned = SlabAllocator::stats().abandoned_slab_count;
+	y_test_assert(abandoned >= 1);
+
+	// freed by another thread than the one that allocated them, then adopted
+	for(void* p : ptrs) {
+		allocator.deallocate(p, 64);
+	}
+
+	usize slabs = SlabAllocator::stats().slab_count;
+	for(void*& p : ptrs) {
+		p = allocator.allocate(64);
+	}
+	y_test_assert(SlabAllocator::stats().slab_count == slabs);
+
+	// and freed from another thread while the owner is alive
+	std::thread([&] {
+		for(void* p : ptrs) {
+			allocator.deallocate(p, 64);
+		}
+	}).join();
+
+	for(void*& p : ptrs) {
+		p = allocator.allocate(64);
+	}
+	y_test_assert(SlabAllocator::stats().slab_count == slabs);
+	for(void* p : ptrs) {
+		allocator.deallocate(p, 64);
+	}
+}
+
+y_test_func("SmallObjectAllocator") {
+	PolymorphicAllocator<SmallObjectAllocator> allocator;
+	void* small = allocator.allocate(100);
+	void* large = allocator.allocate(SlabAllocator::max_block_size * 4);
+	y_test_assert(small && large);
+	allocator.deallocate(small, 100);
+	allocator.deallocate(large, SlabAllocator::max_block_size * 4);
+}
+
 /*y_test_func("StackBlockAllocator basic") {
 	static constexpr usize size = align_up_to_max(1024);
 	StackBlockAllocator<size, Mallocator> allocator;
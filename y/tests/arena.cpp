@@ -0,0 +1,147 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/mem/LinearAllocator.h>
+#include <y/test/test.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// counts every global heap allocation of the test binary
+static std::atomic<y::usize> global_allocations = 0;
+
+void* operator new(std::size_t size) {
+	++global_allocations;
+	if(void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace {
+using namespace y;
+using namespace y::memory;
+
+// the kind of temporaries a frame builds: barriers, bindings, semaphores...
+template<typename V>
+static usize simulate_frame() {
+	usize sum = 0;
+	for(usize pass = 0; pass != 16; ++pass) {
+		V a;
+		V b;
+		for(usize i = 0; i != 24; ++i) {
+			a << i;
+			b << i * pass;
+		}
+		for(usize i = 0; i != a.size(); ++i) {
+			sum += a[i] + b[i];
+		}
+	}
+	return sum;
+}
+
+template<typename V>
+static usize allocations_per_frame() {
+	simulate_frame<V>();
+	usize before = global_allocations;
+	for(usize i = 0; i != 8; ++i) {
+		simulate_frame<V>();
+		frame_arena().end_frame();
+	}
+	return (global_allocations - before) / 8;
+}
+
+y_test_func("LinearAllocator basic") {
+	LinearAllocator allocator(1024);
+
+	void* a = allocator.allocate(100);
+	void* b = allocator.allocate(1);
+	y_test_assert(a && b);
+	y_test_assert(reinterpret_cast<usize>(a) % max_alignment == 0);
+	y_test_assert(reinterpret_cast<usize>(b) % max_alignment == 0);
+	y_test_assert(static_cast<u8*>(b) == static_cast<u8*>(a) + align_up_to_max(100));
+
+	// last allocation is reused
+	allocator.deallocate(b, 1);
+	y_test_assert(allocator.allocate(16) == b);
+	y_test_assert(allocator.allocated() == align_up_to_max(100) + align_up_to_max(16));
+
+	allocator.deallocate(a, 100);
+	allocator.deallocate(b, 16);
+	y_test_assert(allocator.allocated() == 0);
+	y_test_assert(allocator.allocate(8) == a);
+	allocator.deallocate(a, 8);
+
+	allocator.end_frame();
+	y_test_assert(allocator.frame_high_water_mark() == 0);
+	y_test_assert(allocator.high_water_mark() == align_up_to_max(100) + align_up_to_max(16));
+}
+
+y_test_func("LinearAllocator block merging") {
+	LinearAllocator allocator(256);
+
+	core::Vector<void*> ptrs;
+	for(usize i = 0; i != 64; ++i) {
+		ptrs << allocator.allocate(64);
+	}
+	y_test_assert(allocator.block_count() > 1);
+	y_test_assert(allocator.high_water_mark() == 64 * align_up_to_max(64));
+
+	for(void* p : ptrs) {
+		allocator.deallocate(p, 64);
+	}
+	y_test_assert(allocator.block_count() == 1);
+	y_test_assert(allocator.capacity() >= 64 * 64);
+
+	// same frame again: no new block
+	usize capacity = allocator.capacity();
+	ptrs.make_empty();
+	for(usize i = 0; i != 64; ++i) {
+		ptrs << allocator.allocate(64);
+	}
+	y_test_assert(allocator.block_count() == 1);
+	y_test_assert(allocator.capacity() == capacity);
+	for(void* p : ptrs) {
+		allocator.deallocate(p, 64);
+	}
+}
+
+y_test_func("FrameVector allocations") {
+	y_test_assert(simulate_frame<core::Vector<usize>>() == simulate_frame<core::FrameVector<usize>>());
+
+	usize heap = allocations_per_frame<core::Vector<usize>>();
+	usize arena = allocations_per_frame<core::FrameVector<usize>>();
+	y_test_assert(heap >= 32);
+	y_test_assert(arena == 0);
+	y_test_assert(frame_arena().allocated() == 0);
+}
+
+}
@@ -0,0 +1,154 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/batch.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::math;
+
+static float random_float(FastRandom& rnd) {
+	return float(rnd() % 2001) / 100.0f - 10.0f;
+}
+
+static Vec4 random_vec(FastRandom& rnd) {
+	return Vec4(random_float(rnd), random_float(rnd), random_float(rnd), random_float(rnd));
+}
+
+static Transform<> random_transform(FastRandom& rnd) {
+	auto quat = Quaternion<>::from_euler(random_float(rnd), random_float(rnd), random_float(rnd));
+	return Transform<>(random_vec(rnd).to<3>(), quat, Vec3(random_float(rnd), 1.0f, 2.0f));
+}
+
+// not a multiple of simd::width to test the tail
+static constexpr usize test_size = 103;
+
+y_test_func("Batch soa roundtrip") {
+	FastRandom rnd;
+	core::Vector<Vec4> aos;
+	for(usize i = 0; i != test_size; ++i) {
+		aos << random_vec(rnd);
+	}
+
+	SphereArray soa(aos.size());
+	to_soa(aos, soa);
+	y_test_assert(soa.get(17) == aos[17]);
+	y_test_assert(soa[2][17] == aos[17].z());
+
+	core::Vector<Vec4> back(aos.size(), Vec4());
+	from_soa(soa, back.data());
+	y_test_assert(std::equal(aos.begin(), aos.end(), back.begin()));
+}
+
+y_test_func("Batch transform points") {
+	FastRandom rnd;
+	Transform<> tr = random_transform(rnd);
+
+	PointArray points(test_size);
+	for(usize i = 0; i != test_size; ++i) {
+		points.set(i, random_vec(rnd).to<3>());
+	}
+
+	PointArray transformed(test_size);
+	PointArray vectors(test_size);
+	transform_points(tr, points, transformed);
+	transform_vectors(tr, points, vectors);
+	for(usize i = 0; i != test_size; ++i) {
+		y_test_assert(transformed.get(i) == (tr * Vec4(points.get(i), 1.0f)).to<3>());
+		y_test_assert((vectors.get(i) - (tr * Vec4(points.get(i), 0.0f)).to<3>()).length() < 0.0001f);
+	}
+
+	// in place
+	transform_points(tr, points, points);
+	y_test_assert(points.get(test_size - 1) == transformed.get(test_size - 1));
+}
+
+y_test_func("Batch transform spheres") {
+	FastRandom rnd;
+	Transform<> tr(Vec3(1.0f, 2.0f, 3.0f), Quaternion<>::from_euler(0.3f, 0.2f, 0.1f), Vec3(1.0f, 4.0f, 2.0f));
+
+	SphereArray spheres(test_size);
+	for(usize i = 0; i != test_size; ++i) {
+		Vec4 s = random_vec(rnd);
+		s.w() = std::abs(s.w());
+		spheres.set(i, s);
+	}
+
+	SphereArray transformed(test_size);
+	transform_spheres(tr, spheres, transformed);
+	for(usize i = 0; i != test_size; ++i) {
+		Vec4 s = spheres.get(i);
+		y_test_assert(transformed.get(i).to<3>() == (tr * Vec4(s.to<3>(), 1.0f)).to<3>());
+		y_test_assert(std::abs(transformed.get(i).w() - s.w() * 4.0f) < 0.0001f);
+	}
+}
+
+y_test_func("Batch sphere frustum test") {
+	FastRandom rnd;
+	core::Vector<Vec4> planes;
+	for(usize i = 0; i != 6; ++i) {
+		Vec4 p = random_vec(rnd);
+		p.to<3>().normalize();
+		planes << p;
+	}
+
+	SphereArray spheres(test_size * 10);
+	for(usize i = 0; i != spheres.size(); ++i) {
+		spheres.set(i, random_vec(rnd) * Vec4(1.0f, 1.0f, 1.0f, 0.5f));
+	}
+
+	core::Vector<u8> visible(spheres.size(), u8(2));
+	sphere_frustum_test(planes, spheres, visible.data());
+
+	usize visible_count = 0;
+	for(usize i = 0; i != spheres.size(); ++i) {
+		Vec4 s = spheres.get(i);
+		bool inside = std::none_of(planes.begin(), planes.end(), [&](const Vec4& p) { return p.dot({s.to<3>(), 1.0f}) + s.w() < 0.0f; });
+		y_test_assert(visible[i] == u8(inside));
+		visible_count += inside;
+	}
+	y_test_assert(visible_count != 0 && visible_count != spheres.size());
+}
+
+y_test_func("Batch multiply matrices") {
+	FastRandom rnd;
+	core::Vector<Transform<>> a;
+	core::Vector<Transform<>> b;
+	for(usize i = 0; i != test_size; ++i) {
+		a << random_transform(rnd);
+		b << random_transform(rnd);
+	}
+
+	core::Vector<Matrix4<>> full(a.size(), Matrix4<>());
+	core::Vector<Transform<>> affine(a.size(), Transform<>());
+	multiply_matrices(a.data(), b.data(), full.data(), a.size());
+	multiply_transforms(a.data(), b.data(), affine.data(), a.size());
+	for(usize i = 0; i != a.size(); ++i) {
+		Matrix4<> expected = a[i] * b[i];
+		y_test_assert(full[i] == expected);
+		y_test_assert(affine[i] == expected);
+	}
+}
+
+}
@@ -0,0 +1,51 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/concurrent/concurrent.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::concurrent;
+
+y_test_func("parallel_for_each visits once") {
+	for(usize size : {0, 1, 2, 7, 1000, 100000}) {
+		core::Vector<u32> values(size, 0u);
+		parallel_for_each(values.begin(), values.end(), [](u32& v) { ++v; });
+		y_test_assert(std::all_of(values.begin(), values.end(), [](u32 v) { return v == 1; }));
+	}
+}
+
+y_test_func("parallel_indexed_block_for covers range") {
+	core::Vector<u32> values(10000, 0u);
+	std::atomic<usize> total = 0;
+	parallel_indexed_block_for(values.begin(), values.end(), [&](usize, auto&& range) {
+		for(auto& v : range) {
+			++v;
+			++total;
+		}
+	});
+	y_test_assert(total == values.size());
+	y_test_assert(std::all_of(values.begin(), values.end(), [](u32 v) { return v == 1; }));
+}
+
+}
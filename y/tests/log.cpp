@@ -0,0 +1,107 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/log.h>
+#include <y/io/File.h>
+#include <y/core/Vector.h>
+#include <y/core/FlatHashMap.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <cstdio>
+
+namespace {
+using namespace y;
+
+// only called by the logging thread, or by flush_log under the same lock
+static usize handled_messages = 0;
+static usize handled_deferred = 0;
+
+static void count_messages(std::string_view msg, Log) {
+	if(msg == "log test") {
+		++handled_messages;
+	} else if(msg == "log test 7 25") {
+		++handled_deferred;
+	}
+}
+
+y_test_func("log binary file") {
+	static constexpr usize thread_count = 8;
+	static constexpr usize message_count = 4096;
+	const char* filename = "log_test.ylog";
+
+	y_test_assert(set_log_file(filename));
+	set_log_handler(count_messages);
+
+	core::Vector<std::thread> threads;
+	for(usize i = 0; i != thread_count; ++i) {
+		threads << std::thread([] {
+			for(usize k = 0; k != message_count; ++k) {
+				log_msg("log test", Log::Debug);
+			}
+			log_fmt(Log::Debug, "log test % %", 7, u64(25));
+		});
+	}
+	for(auto& t : threads) {
+		t.join();
+	}
+	flush_log();
+
+	// later tests should not log into a deleted file
+	y_test_assert(set_log_file(nullptr));
+	set_log_handler(nullptr);
+
+	y_test_assert(handled_messages == thread_count * message_count);
+	y_test_assert(handled_deferred == thread_count);
+
+	auto file = io::File::open(filename);
+	y_test_assert(file);
+
+	usize messages = 0;
+	usize deferred = 0;
+	core::FlatHashMap<u32, u64> last_time;
+	bool ordered = true;
+
+	BinaryLogEntry entry;
+	char buffer[8 * 1024];
+	while(file.unwrap().read(&entry, sizeof(entry)) == sizeof(entry)) {
+		file.unwrap().read(buffer, entry.length);
+		const std::string_view text(buffer, entry.length);
+		if(text == "log test") {
+			++messages;
+		} else if(text == "log test 7 25") {
+			++deferred;
+		} else {
+			continue;
+		}
+		ordered &= last_time[entry.thread] <= entry.time_ns;
+		last_time[entry.thread] = entry.time_ns;
+	}
+
+	y_test_assert(messages == thread_count * message_count);
+	y_test_assert(deferred == thread_count);
+	y_test_assert(ordered);
+
+	std::remove(filename);
+}
+
+}
@@ -0,0 +1,77 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/math/packing.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::math;
+
+y_test_func("packing half float") {
+	float values[] = {0.0f, 1.0f, -1.0f, 0.5f, 0.333251953125f, 65504.0f, -2.0f, 6.103515625e-05f, 5.960464477539063e-08f};
+	for(float f : values) {
+		y_test_assert(from_half(to_half(f)) == f);
+	}
+	y_test_assert(to_half(0.0f) == 0x0000);
+	y_test_assert(to_half(1.0f) == 0x3C00);
+	y_test_assert(to_half(-2.0f) == 0xC000);
+	y_test_assert(to_half(1.0e10f) == 0x7C00);
+	y_test_assert(from_half(to_half(1.0e-9f)) == 0.0f);
+
+	for(float f = -100.0f; f < 100.0f; f += 0.37f) {
+		y_test_assert(std::abs(from_half(to_half(f)) - f) <= std::abs(f) / 1024.0f);
+	}
+}
+
+y_test_func("packing unorm snorm") {
+	y_test_assert(quantize_unorm16(0.0f) == 0);
+	y_test_assert(quantize_unorm16(1.0f) == 65535);
+	y_test_assert(quantize_unorm16(2.0f) == 65535);
+	y_test_assert(quantize_snorm16(-1.0f) == -32767);
+	y_test_assert(dequantize_snorm16(-32768) == -1.0f);
+
+	for(float f = 0.0f; f <= 1.0f; f += 0.01f) {
+		y_test_assert(std::abs(dequantize_unorm16(quantize_unorm16(f)) - f) < 1.0f / 65535.0f);
+		y_test_assert(std::abs(dequantize_snorm16(quantize_snorm16(-f)) + f) < 1.0f / 32767.0f);
+	}
+}
+
+y_test_func("packing octahedral") {
+	FastRandom rng;
+	for(usize i = 0; i != 10000; ++i) {
+		auto rand = [&] { return float(rng()) / float(std::numeric_limits<u32>::max()) - 0.5f; };
+		Vec3 n = Vec3(rand(), rand(), rand()).normalized();
+		Vec2 oct = octahedral_encode(n);
+		Vec2 quant(dequantize_snorm16(quantize_snorm16(oct.x())), dequantize_snorm16(quantize_snorm16(oct.y())));
+		y_test_assert(octahedral_decode(oct).dot(n) > 0.99999f);
+		y_test_assert(octahedral_decode(quant).dot(n) > 0.9999f);
+	}
+
+	Vec3 axes[] = {{1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+	for(const auto& a : axes) {
+		y_test_assert(octahedral_decode(octahedral_encode(a)).dot(a) > 0.99999f);
+	}
+}
+
+}
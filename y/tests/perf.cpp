@@ -0,0 +1,151 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/perf.h>
+#include <y/io/File.h>
+#include <y/test/test.h>
+
+#include <thread>
+#include <cstdio>
+
+namespace {
+using namespace y;
+
+static const perf::ZoneStats* find_stats(const core::Vector<perf::ZoneStats>& stats, std::string_view name) {
+	for(const auto& s : stats) {
+		if(s.name == name) {
+			return &s;
+		}
+	}
+	return nullptr;
+}
+
+static usize count(std::string_view str, std::string_view pattern) {
+	usize n = 0;
+	for(usize pos = str.find(pattern); pos != std::string_view::npos; pos = str.find(pattern, pos + 1)) {
+		++n;
+	}
+	return n;
+}
+
+y_test_func("perf zone stats") {
+	perf::reset_zone_stats();
+
+	const u32 outer = perf::zone_id("perf test outer");
+	for(usize i = 0; i != 100; ++i) {
+		perf::ZoneScope scope(outer);
+		for(usize k = 0; k != 10; ++k) {
+			perf::ZoneScope inner(perf::zone_id("perf test inner(usize)"));
+		}
+	}
+
+	std::thread([] {
+		for(usize k = 0; k != 50; ++k) {
+			perf::ZoneScope inner(perf::zone_id("perf test inner"));
+		}
+	}).join();
+
+	y_test_assert(perf::zone_id("perf test inner(int)") == perf::zone_id("perf test inner"));
+
+	const auto stats = perf::zone_stats();
+	const perf::ZoneStats* o = find_stats(stats, "perf test outer");
+	const perf::ZoneStats* i = find_stats(stats, "perf test inner");
+	y_test_assert(o && i);
+	y_test_assert(o->count == 100);
+	y_test_assert(i->count == 1050);
+	y_test_assert(o->min_ns <= o->p50_ns && o->p50_ns <= o->p90_ns && o->p90_ns <= o->p99_ns && o->p99_ns <= o->max_ns);
+	y_test_assert(o->mean_ns() >= i->mean_ns());
+
+	perf::reset_zone_stats();
+	y_test_assert(!find_stats(perf::zone_stats(), "perf test outer"));
+}
+
+y_test_func("perf capture") {
+	const char* capture = "perf_test.yprof";
+	const char* json = "perf_test.json";
+
+	perf::set_output_file(capture);
+	std::thread([] {
+		for(usize k = 0; k != 5000; ++k) {
+			perf::ZoneScope zone(perf::zone_id("perf capture \"zone\""));
+		}
+	}).join();
+	perf::event("perf", "perf capture event");
+	perf::flush();
+
+	y_test_assert(perf::capture_to_json(capture, json));
+
+	core::Vector<u8> data;
+	perf::flush();
+	auto file = io::File::open(json);
+	y_test_assert(file);
+	file.unwrap().read_all(data);
+	const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+
+	y_test_assert(text.substr(0, 15) == R"({"traceEvents":)");
+	y_test_assert(count(text, R"("name":"perf capture \"zone\"","cat":"","ph":"B")") == 5000);
+	y_test_assert(count(text, R"("name":"perf capture \"zone\"","cat":"","ph":"E")") == 5000);
+	y_test_assert(count(text, R"("name":"perf capture event","cat":"perf","ph":"i")") == 1);
+
+	std::remove(capture);
+	std::remove(json);
+}
+
+y_test_func("perf tracks") {
+	const char* capture = "perf_track_test.yprof";
+	const char* json = "perf_track_test.json";
+
+	perf::reset_zone_stats();
+	perf::set_output_file(capture);
+
+	const u32 track = perf::create_track();
+	const u32 zone = perf::zone_id("perf track zone", "gpu");
+	const u64 start = perf::now();
+	for(u64 i = 0; i != 10; ++i) {
+		const u64 begin = start + perf::nanos_to_ticks(i * 2000);
+		perf::track_zone(track, zone, begin, begin + perf::nanos_to_ticks(1000));
+	}
+	perf::flush();
+
+	const auto all_stats = perf::zone_stats();
+	const perf::ZoneStats* stats = find_stats(all_stats, "perf track zone");
+	y_test_assert(stats && stats->count == 10);
+	y_test_assert(stats->category == "gpu");
+
+	y_test_assert(perf::capture_to_json(capture, json));
+
+	core::Vector<u8> data;
+	auto file = io::File::open(json);
+	y_test_assert(file);
+	file.unwrap().read_all(data);
+	const std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+
+	const core::String tid = core::String(R"("tid":)") + track + ",";
+	y_test_assert(count(text, R"("name":"perf track zone","cat":"gpu","ph":"B")") == 10);
+	y_test_assert(count(text, R"("name":"perf track zone","cat":"gpu","ph":"E")") == 10);
+	y_test_assert(count(text, tid) == 20);
+
+	std::remove(capture);
+	std::remove(json);
+}
+
+}
@@ -138,4 +138,58 @@ y_test_func("serde complex") {
 	}
 }
 
+y_test_func("serde concrete archives") {
+	io2::Buffer buffer;
+	Trivial t0{7, 3.1416f, {0.0f, 1.0f, 2.7f}};
+	Easy e0{t0, {"flublbu", __LINE__}};
+	Complex comp{{e0, e0}, {1, 2, 3, 4, 5, 6, 7, 999}, -798, "some other string"};
+
+	{
+		WritableArchive ar(buffer);
+		static_assert(std::is_same_v<decltype(ar), WritableArchive<BinaryFormat, io2::Buffer>>);
+		unused(ar(comp, t0));
+	}
+	{
+		ReadableArchive ar(buffer);
+		static_assert(std::is_same_v<decltype(ar), ReadableArchive<BinaryFormat, io2::Buffer>>);
+
+		Complex c;
+		Trivial t;
+		y_test_assert(ar(c, t));
+		y_test_assert(c == comp);
+		y_test_assert(t == t0);
+	}
+}
+
+y_test_func("serde bulk vector") {
+	io2::Buffer buffer;
+	core::Vector<math::Vec3> vecs;
+	for(usize i = 0; i != 1000; ++i) {
+		vecs << math::Vec3(float(i), -float(i), 0.5f);
+	}
+
+	{
+		WritableArchive ar(buffer);
+		unused(ar(vecs));
+	}
+	{
+		ReadableArchive ar(buffer);
+		core::Vector<math::Vec3> v = {math::Vec3(1.0f)};
+		y_test_assert(ar(v));
+		y_test_assert(v == vecs);
+	}
+
+	io2::Buffer truncated;
+	{
+		WritableArchive ar(truncated);
+		unused(ar(u64(vecs.size())));
+		unused(ar.array(vecs.data(), 10));
+	}
+	{
+		ReadableArchive ar(truncated);
+		core::Vector<math::Vec3> v;
+		y_test_assert(!ar(v));
+		y_test_assert(v.is_empty());
+	}
+}
 }
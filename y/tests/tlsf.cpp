@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/mem/TlsfAllocator.h>
+#include <y/math/random.h>
+#include <y/test/test.h>
+
+namespace {
+using namespace y;
+using namespace y::memory;
+
+y_test_func("TlsfAllocator basic") {
+	TlsfAllocator allocator(1024, 16);
+	y_test_assert(allocator.is_consistent());
+
+	usize a = allocator.allocate(100);
+	usize b = allocator.allocate(16);
+	y_test_assert(a != TlsfAllocator::invalid_offset);
+	y_test_assert(b != TlsfAllocator::invalid_offset);
+	y_test_assert(a % 16 == 0 && b % 16 == 0);
+	y_test_assert(b >= a + 112 || a >= b + 16);
+	y_test_assert(allocator.stats().used_size == 128);
+	y_test_assert(allocator.is_consistent());
+
+	y_test_assert(allocator.allocate(1024) == TlsfAllocator::invalid_offset);
+
+	allocator.free(a);
+	allocator.free(b);
+	y_test_assert(allocator.is_consistent());
+	y_test_assert(allocator.stats().free_block_count == 1);
+	y_test_assert(allocator.allocate(1024) == 0);
+}
+
+y_test_func("TlsfAllocator alignment") {
+	TlsfAllocator allocator(1 << 20, 256);
+
+	usize small = allocator.allocate(256);
+	usize aligned = allocator.allocate(4096, 4096);
+	y_test_assert(small != TlsfAllocator::invalid_offset);
+	y_test_assert(aligned != TlsfAllocator::invalid_offset);
+	y_test_assert(aligned % 4096 == 0);
+	y_test_assert(allocator.is_consistent());
+
+	allocator.free(small);
+	allocator.free(aligned);
+	y_test_assert(allocator.stats().free_block_count == 1);
+	y_test_assert(allocator.is_consistent());
+}
+
+y_test_func("TlsfAllocator coalescing") {
+	TlsfAllocator allocator(64 * 32, 32);
+
+	core::Vector<usize> offsets;
+	for(usize i = 0; i != 64; ++i) {
+		offsets << allocator.allocate(32);
+	}
+	y_test_assert(allocator.allocate(32) == TlsfAllocator::invalid_offset);
+
+	// free every other block: fully fragmented
+	for(usize i = 0; i < offsets.size(); i += 2) {
+		allocator.free(offsets[i]);
+	}
+	TlsfAllocator::Stats stats = allocator.stats();
+	y_test_assert(stats.free_block_count == 32);
+	y_test_assert(stats.largest_free_block == 32);
+	y_test_assert(stats.fragmentation() > 0.9f);
+	y_test_assert(allocator.allocate(64) == TlsfAllocator::invalid_offset);
+
+	for(usize i = 1; i < offsets.size(); i += 2) {
+		allocator.free(offsets[i]);
+	}
+	stats = allocator.stats();
+	y_test_assert(stats.free_block_count == 1);
+	y_test_assert(stats.fragmentation() == 0.0f);
+	y_test_assert(allocator.is_consistent());
+}
+
+y_test_func("TlsfAllocator fuzz") {
+	static constexpr usize size = 1 << 24;
+	TlsfAllocator allocator(size, 256);
+	math::FastRandom rng;
+
+	struct Alloc {
+		usize offset;
+		usize size;
+	};
+	core::Vector<Alloc> allocs;
+
+	for(usize i = 0; i != 20000; ++i) {
+		if(allocs.is_empty() || rng() % 3) {
+			usize alloc_size = 1 + rng() % (rng() % 8 ? 4096 : 1 << 20);
+			usize alignment = usize(256) << (rng() % 5);
+			usize offset = allocator.allocate(alloc_size, alignment);
+			if(offset != TlsfAllocator::invalid_offset) {
+				y_test_assert(offset % alignment == 0);
+				y_test_assert(offset + alloc_size <= size);
+				for(const Alloc& a : allocs) {
+					y_test_assert(offset + alloc_size <= a.offset || a.offset + a.size <= offset);
+				}
+				allocs << Alloc{offset, alloc_size};
+			}
+		} else {
+			usize index = rng() % allocs.size();
+			allocator.free(allocs[index].offset);
+			allocs.erase_unordered(allocs.begin() + index);
+		}
+		if(i % 1000 == 0) {
+			y_test_assert(allocator.is_consistent());
+		}
+	}
+
+	for(const Alloc& a : allocs) {
+		allocator.free(a.offset);
+	}
+	y_test_assert(allocator.is_consistent());
+	y_test_assert(allocator.stats().free_block_count == 1);
+	y_test_assert(allocator.stats().used_size == 0);
+}
+
+}
@@ -24,6 +24,7 @@ SOFTWARE.
 #include <y/test/test.h>
 
 #include <y/core/Vector.h>
+#include <y/core/Chrono.h>
 
 namespace {
 using namespace y;
@@ -54,6 +55,13 @@ y_test_func("utils do_not_destroy") {
 	}
 	y_test_assert(i == 1);
 }
+
+y_test_func("Duration nanoseconds") {
+	const core::Duration d = core::Duration::nanoseconds(2500000000);
+	y_test_assert(d.seconds() == 2);
+	y_test_assert(d.subsec_nanos() == 500000000);
+	y_test_assert(d.to_nanos() == 2500000000);
+}
 }
 
 
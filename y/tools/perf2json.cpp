@@ -0,0 +1,42 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include <y/utils/perf.h>
+#include <y/core/String.h>
+
+using namespace y;
+
+int main(int argc, char** argv) {
+	if(argc < 2) {
+		log_msg("Usage: perf2json capture [output]", Log::Error);
+		return 1;
+	}
+
+	const core::String output = argc > 2 ? core::String(argv[2]) : core::String(argv[1]) + ".json";
+	if(!perf::capture_to_json(argv[1], output)) {
+		log_msg(fmt("Unable to convert \"%\".", argv[1]), Log::Error);
+		return 1;
+	}
+
+	log_msg(fmt("Trace written to \"%\".", output));
+	return 0;
+}
@@ -39,10 +39,15 @@ usize probable_block_count(usize size);
 template<typename F>
 void schedule_n(F&& f, usize n) {
 	StaticThreadPool& pool = default_thread_pool();
+	std::atomic<usize> done = 0;
 	for(usize i = 0; i != n; ++i) {
-		pool.schedule([&] { f(i); });
+		pool.schedule([&, i] { f(i); ++done; });
+	}
+	// tasks may still be running on workers once the queue is empty
+	while(done != n) {
+		pool.process_until_empty();
+		std::this_thread::yield();
 	}
-	pool.process_until_empty();
 }
 
 }
@@ -67,12 +72,12 @@ auto async(F&& func) {
 template<typename It, typename Func>
 void parallel_indexed_block_for(It begin, It end, Func&& func) {
 	usize size = end - begin;
-	usize chunk = std::max(usize(1), size / (detail::probable_block_count(size) - 1));
-
 	if(!size) {
 		return;
 	}
 
+	usize chunk = std::max(usize(1), size / std::max(usize(1), detail::probable_block_count(size) - 1));
+
 	usize chunk_count = size / chunk;
 	chunk_count += chunk_count * chunk != size;
 
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "Vector.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace y {
 namespace core {
 template<typename Key, typename Value>
@@ -40,9 +43,13 @@ struct MapEntry : public std::pair<Key, Value> {
 };
 
 
-template<typename Key, typename Value, typename ResizePolicy = DefaultVectorResizePolicy>
+// With Compare = void lookups are linear scans and entries keep their insertion order.
+// Otherwise entries are kept sorted and lookups are binary searches.
+template<typename Key, typename Value, typename ResizePolicy = DefaultVectorResizePolicy, typename Compare = void>
 class AssocVector : public Vector<MapEntry<Key, Value>, ResizePolicy> {
 
+	static constexpr bool is_sorted = !std::is_void_v<Compare>;
+
 	public:
 		using value_type = MapEntry<Key, Value>;
 		using Vector<value_type, ResizePolicy>::Vector;
@@ -52,30 +59,70 @@ class AssocVector : public Vector<MapEntry<Key, Value>, ResizePolicy> {
 
 		template<typename K, typename T>
 		void insert(K&& key, T&& value) {
-			this->push_back(value_type(y_fwd(key), y_fwd(value)));
+			if constexpr(is_sorted) {
+				const usize index = upper_bound(key) - this->begin();
+				this->push_back(value_type(y_fwd(key), y_fwd(value)));
+				std::rotate(this->begin() + index, this->end() - 1, this->end());
+			} else {
+				this->push_back(value_type(y_fwd(key), y_fwd(value)));
+			}
 		}
 
 		Value& operator[](const Key& key) {
-			for(value_type& e : *this) {
-				if(e == key) {
-					return e.second;
+			if constexpr(is_sorted) {
+				auto it = lower_bound(key);
+				if(it != this->end() && !Compare()(key, it->first)) {
+					return it->second;
 				}
+				const usize index = it - this->begin();
+				this->push_back(value_type(key, Value()));
+				std::rotate(this->begin() + index, this->end() - 1, this->end());
+				return this->begin()[index].second;
+			} else {
+				for(value_type& e : *this) {
+					if(e == key) {
+						return e.second;
+					}
+				}
+				insert(key, Value());
+				return this->last().second;
 			}
-			insert(key, Value());
-			return this->last().second;
 		}
 
 		iterator find(const Key& key) {
-			return std::find_if(this->begin(), this->end(), [&](const auto& k) { return k == key; });
+			if constexpr(is_sorted) {
+				auto it = lower_bound(key);
+				return it != this->end() && !Compare()(key, it->first) ? it : this->end();
+			} else {
+				return std::find_if(this->begin(), this->end(), [&](const auto& k) { return k == key; });
+			}
 		}
 
 		const_iterator find(const Key& key) const {
-			return std::find_if(this->begin(), this->end(), [&](const auto& k) { return k == key; });
+			if constexpr(is_sorted) {
+				auto it = lower_bound(key);
+				return it != this->end() && !Compare()(key, it->first) ? it : this->end();
+			} else {
+				return std::find_if(this->begin(), this->end(), [&](const auto& k) { return k == key; });
+			}
 		}
 
 	private:
+		auto lower_bound(const Key& key) {
+			return std::lower_bound(this->begin(), this->end(), key, [](const value_type& e, const Key& k) { return Compare()(e.first, k); });
+		}
+
+		auto lower_bound(const Key& key) const {
+			return std::lower_bound(this->begin(), this->end(), key, [](const value_type& e, const Key& k) { return Compare()(e.first, k); });
+		}
+
+		auto upper_bound(const Key& key) {
+			return std::upper_bound(this->begin(), this->end(), key, [](const Key& k, const value_type& e) { return Compare()(k, e.first); });
+		}
 };
 
+template<typename Key, typename Value, typename ResizePolicy = DefaultVectorResizePolicy>
+using SortedAssocVector = AssocVector<Key, Value, ResizePolicy, std::less<Key>>;
 
 }
 }
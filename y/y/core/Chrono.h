@@ -46,7 +46,7 @@ class Duration {
 		}
 
 		static constexpr Duration nanoseconds(u64 ns) {
-			return Duration(ns / 100000000, ns % 100000000);
+			return Duration(ns / 1000000000, u32(ns % 1000000000));
 		}
 
 		constexpr explicit Duration(u64 seconds = 0, u32 subsec_nanos = 0) : _secs(seconds), _subsec_ns(subsec_nanos) {
@@ -0,0 +1,460 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_CORE_FLATHASHMAP_H
+#define Y_CORE_FLATHASHMAP_H
+
+#include <y/utils.h>
+
+#include <memory>
+
+#ifdef Y_SSE
+#include <emmintrin.h>
+#endif
+
+namespace y {
+namespace core {
+
+namespace detail {
+
+// full slots store the low 7 bits of their hash, empty and deleted slots are negative
+enum FlatHashCtrl : i8 {
+	ctrl_empty = -128,
+	ctrl_deleted = -2
+};
+
+class FlatHashGroup {
+	public:
+		static constexpr usize size = 16;
+
+		FlatHashGroup(const i8* ctrl) {
+#ifdef Y_SSE
+			_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+			std::copy_n(ctrl, size, _ctrl.begin());
+#endif
+		}
+
+		// bit i is set if the i-th byte matches
+		u32 match(i8 h2) const {
+#ifdef Y_SSE
+			return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+#else
+			return match_if([=](i8 c) { return c == h2; });
+#endif
+		}
+
+		u32 match_empty() const {
+			return match(ctrl_empty);
+		}
+
+		u32 match_empty_or_deleted() const {
+#ifdef Y_SSE
+			return u32(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), _ctrl)));
+#else
+			return match_if([](i8 c) { return c < -1; });
+#endif
+		}
+
+	private:
+#ifdef Y_SSE
+		__m128i _ctrl;
+#else
+		template<typename F>
+		u32 match_if(F&& f) const {
+			u32 mask = 0;
+			for(usize i = 0; i != size; ++i) {
+				mask |= u32(f(_ctrl[i])) << i;
+			}
+			return mask;
+		}
+
+		std::array<i8, size> _ctrl;
+#endif
+};
+
+inline usize first_bit(u32 mask) {
+	return usize(__builtin_ctz(mask));
+}
+
+// std::hash is the identity for integers on some platforms: spread the bits so h2 isn't always 0
+inline usize mix_hash(usize h) {
+	u64 x = u64(h);
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdull;
+	x ^= x >> 33;
+	return usize(x);
+}
+
+}
+
+// Open addressing hash map with one control byte per slot, probed 16 at a time (Swiss tables).
+// Unlike std::unordered_map, inserting can move elements and invalidates iterators and references.
+// Erasing doesn't move anything, iterators to other elements stay valid.
+template<typename Key, typename Value, typename Hasher = std::hash<Key>, typename Equal = std::equal_to<Key>>
+class FlatHashMap : Hasher, Equal {
+
+	using Group = detail::FlatHashGroup;
+
+	static constexpr usize npos = usize(-1);
+	static constexpr usize min_capacity = Group::size;
+
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<Key, Value>;
+		using size_type = usize;
+
+		template<bool Const>
+		class Iterator {
+			using map_type = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+
+			public:
+				using value_type = std::conditional_t<Const, const FlatHashMap::value_type, FlatHashMap::value_type>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = value_type*;
+				using reference = value_type&;
+				using iterator_category = std::forward_iterator_tag;
+
+				Iterator() = default;
+
+				Iterator(const Iterator<false>& other) : _map(other._map), _index(other._index) {
+				}
+
+				reference operator*() const {
+					return _map->_slots[_index];
+				}
+
+				pointer operator->() const {
+					return &_map->_slots[_index];
+				}
+
+				Iterator& operator++() {
+					_index = _map->next_full(_index + 1);
+					return *this;
+				}
+
+				Iterator operator++(int) {
+					Iterator it = *this;
+					++*this;
+					return it;
+				}
+
+				bool operator==(const Iterator& other) const {
+					return _index == other._index;
+				}
+
+				bool operator!=(const Iterator& other) const {
+					return _index != other._index;
+				}
+
+			private:
+				friend class FlatHashMap;
+				template<bool>
+				friend class Iterator;
+
+				Iterator(map_type* map, usize index) : _map(map), _index(index) {
+				}
+
+				map_type* _map = nullptr;
+				usize _index = 0;
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+
+		FlatHashMap() = default;
+
+		FlatHashMap(const FlatHashMap& other) {
+			reserve(other.size());
+			for(const auto& e : other) {
+				insert(e);
+			}
+		}
+
+		FlatHashMap(FlatHashMap&& other) {
+			swap(other);
+		}
+
+		FlatHashMap& operator=(const FlatHashMap& other) {
+			if(&other != this) {
+				FlatHashMap copy(other);
+				swap(copy);
+			}
+			return *this;
+		}
+
+		FlatHashMap& operator=(FlatHashMap&& other) {
+			swap(other);
+			return *this;
+		}
+
+		~FlatHashMap() {
+			clear();
+			deallocate();
+		}
+
+		void swap(FlatHashMap& other) {
+			std::swap(_ctrl, other._ctrl);
+			std::swap(_slots, other._slots);
+			std::swap(_capacity, other._capacity);
+			std::swap(_size, other._size);
+			std::swap(_deleted, other._deleted);
+		}
+
+
+		usize size() const {
+			return _size;
+		}
+
+		bool is_empty() const {
+			return !_size;
+		}
+
+		usize capacity() const {
+			return _capacity;
+		}
+
+
+		iterator begin() {
+			return iterator(this, next_full(0));
+		}
+
+		iterator end() {
+			return iterator(this, _capacity);
+		}
+
+		const_iterator begin() const {
+			return const_iterator(this, next_full(0));
+		}
+
+		const_iterator end() const {
+			return const_iterator(this, _capacity);
+		}
+
+
+		iterator find(const Key& key) {
+			usize index = find_index(key);
+			return iterator(this, index == npos ? _capacity : index);
+		}
+
+		const_iterator find(const Key& key) const {
+			usize index = find_index(key);
+			return const_iterator(this, index == npos ? _capacity : index);
+		}
+
+		bool contains(const Key& key) const {
+			return find_index(key) != npos;
+		}
+
+
+		Value& operator[](const Key& key) {
+			return emplace(key).first->second;
+		}
+
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+			usize hash = hash_key(key);
+			if(usize index = find_index(key, hash); index != npos) {
+				return {iterator(this, index), false};
+			}
+
+			usize index = prepare_insert(hash);
+			new(&_slots[index]) value_type(std::piecewise_construct, std::forward_as_tuple(y_fwd(key)), std::forward_as_tuple(y_fwd(args)...));
+			return {iterator(this, index), true};
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value) {
+			return emplace(value.first, value.second);
+		}
+
+		std::pair<iterator, bool> insert(value_type&& value) {
+			return emplace(std::move(value.first), std::move(value.second));
+		}
+
+
+		void erase(const_iterator it) {
+			y_debug_assert(it._map == this && it._index < _capacity);
+			_slots[it._index].~value_type();
+			set_ctrl(it._index, detail::ctrl_deleted);
+			--_size;
+			++_deleted;
+		}
+
+		usize erase(const Key& key) {
+			if(usize index = find_index(key); index != npos) {
+				erase(const_iterator(this, index));
+				return 1;
+			}
+			return 0;
+		}
+
+		void clear() {
+			for(usize i = 0; i != _capacity; ++i) {
+				if(is_full(_ctrl[i])) {
+					_slots[i].~value_type();
+				}
+			}
+			if(_capacity) {
+				std::fill_n(_ctrl.get(), _capacity + Group::size, detail::ctrl_empty);
+			}
+			_size = 0;
+			_deleted = 0;
+		}
+
+		void reserve(usize size) {
+			if(size > max_load(_capacity)) {
+				usize capacity = min_capacity;
+				while(size > max_load(capacity)) {
+					capacity *= 2;
+				}
+				rehash(capacity);
+			}
+		}
+
+	private:
+		static bool is_full(i8 ctrl) {
+			return ctrl >= 0;
+		}
+
+		static usize max_load(usize capacity) {
+			return capacity - capacity / 8;
+		}
+
+		usize hash_key(const Key& key) const {
+			return detail::mix_hash(Hasher::operator()(key));
+		}
+
+		usize next_full(usize index) const {
+			while(index < _capacity && !is_full(_ctrl[index])) {
+				++index;
+			}
+			return index;
+		}
+
+		void set_ctrl(usize index, i8 ctrl) {
+			_ctrl[index] = ctrl;
+			// the first group is mirrored after the end so groups can be loaded anywhere
+			if(index < Group::size) {
+				_ctrl[_capacity + index] = ctrl;
+			}
+		}
+
+		usize find_index(const Key& key) const {
+			return find_index(key, hash_key(key));
+		}
+
+		usize find_index(const Key& key, usize hash) const {
+			if(!_capacity) {
+				return npos;
+			}
+
+			usize mask = _capacity - 1;
+			i8 h2 = i8(hash & 0x7F);
+			for(usize pos = (hash >> 7) & mask, step = Group::size;; pos = (pos + step) & mask, step += Group::size) {
+				Group group(&_ctrl[pos]);
+				for(u32 match = group.match(h2); match; match &= match - 1) {
+					usize index = (pos + detail::first_bit(match)) & mask;
+					if(Equal::operator()(_slots[index].first, key)) {
+						return index;
+					}
+				}
+				if(group.match_empty()) {
+					return npos;
+				}
+			}
+		}
+
+		usize find_insert_index(usize hash) const {
+			usize mask = _capacity - 1;
+			for(usize pos = (hash >> 7) & mask, step = Group::size;; pos = (pos + step) & mask, step += Group::size) {
+				if(u32 match = Group(&_ctrl[pos]).match_empty_or_deleted()) {
+					return (pos + detail::first_bit(match)) & mask;
+				}
+			}
+		}
+
+		usize prepare_insert(usize hash) {
+			if(_size + _deleted + 1 > max_load(_capacity)) {
+				// mostly tombstones: clean them up without growing
+				bool grow = _size + 1 > max_load(_capacity) / 2;
+				rehash(grow ? std::max(min_capacity, _capacity * 2) : _capacity);
+			}
+
+			usize index = find_insert_index(hash);
+			if(_ctrl[index] == detail::ctrl_deleted) {
+				--_deleted;
+			}
+			set_ctrl(index, i8(hash & 0x7F));
+			++_size;
+			return index;
+		}
+
+		void rehash(usize capacity) {
+			y_debug_assert(capacity >= min_capacity && !(capacity & (capacity - 1)));
+
+			std::unique_ptr<i8[]> ctrl = std::move(_ctrl);
+			value_type* slots = _slots;
+			usize old_capacity = _capacity;
+
+			_ctrl = std::make_unique<i8[]>(capacity + Group::size);
+			std::fill_n(_ctrl.get(), capacity + Group::size, detail::ctrl_empty);
+			_slots = std::allocator<value_type>().allocate(capacity);
+			_capacity = capacity;
+			_deleted = 0;
+
+			for(usize i = 0; i != old_capacity; ++i) {
+				if(is_full(ctrl[i])) {
+					usize hash = hash_key(slots[i].first);
+					usize index = find_insert_index(hash);
+					set_ctrl(index, i8(hash & 0x7F));
+					new(&_slots[index]) value_type(std::move(slots[i]));
+					slots[i].~value_type();
+				}
+			}
+
+			if(slots) {
+				std::allocator<value_type>().deallocate(slots, old_capacity);
+			}
+		}
+
+		void deallocate() {
+			if(_slots) {
+				std::allocator<value_type>().deallocate(_slots, _capacity);
+			}
+			_ctrl = nullptr;
+			_slots = nullptr;
+			_capacity = 0;
+		}
+
+		std::unique_ptr<i8[]> _ctrl;
+		value_type* _slots = nullptr;
+		usize _capacity = 0;
+
+		usize _size = 0;
+		usize _deleted = 0;
+};
+
+}
+}
+
+#endif // Y_CORE_FLATHASHMAP_H
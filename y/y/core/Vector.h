@@ -201,13 +201,19 @@ class Vector : ResizePolicy, Allocator {
 
 		template<typename It>
 		void push_back(It beg_it, It end_it) {
-			set_min_capacity(size() + std::distance(beg_it, end_it));
-			std::copy(beg_it, end_it, std::back_inserter(*this));
+			const usize n = std::distance(beg_it, end_it);
+			reserve_for(n);
+			if constexpr(is_data_trivial && std::is_pointer_v<It>) {
+				std::copy_n(beg_it, n, _data_end);
+				_data_end += n;
+			} else {
+				std::copy(beg_it, end_it, std::back_inserter(*this));
+			}
 		}
 
 		template<typename It>
 		void emplace_back(It beg_it, const It end_it) {
-			set_min_capacity(size() + std::distance(beg_it, end_it));
+			reserve_for(std::distance(beg_it, end_it));
 			std::move(beg_it, end_it, std::back_inserter(*this));
 		}
 
@@ -326,6 +332,15 @@ class Vector : ResizePolicy, Allocator {
 			_data_end = _data;
 		}
 
+		// new elements are left uninitialized and must be written before being read
+		void resize_uninitialized(usize new_size) {
+			static_assert(std::is_trivially_copyable_v<data_type> && std::is_trivially_destructible_v<data_type>);
+			if(new_size > capacity()) {
+				set_min_capacity(new_size);
+			}
+			_data_end = _data + new_size;
+		}
+
 	private:
 		static constexpr bool is_data_trivial = std::is_trivial_v<data_type>;
 
@@ -351,6 +366,13 @@ class Vector : ResizePolicy, Allocator {
 			}
 		}
 
+		// only reallocates if needed, set_min_capacity always does
+		void reserve_for(usize n) {
+			if(size() + n > capacity()) {
+				set_min_capacity(size() + n);
+			}
+		}
+
 		void expend() {
 			unsafe_set_capacity(this->ideal_capacity(size() + 1));
 		}
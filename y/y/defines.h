@@ -65,6 +65,14 @@ struct Nothing;
 #define Y_OS_LINUX
 #endif
 
+#if !defined(Y_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define Y_SSE
+#endif
+
+#if !defined(Y_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define Y_NEON
+#endif
+
 
 
 
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <y/utils.h>
 #include "Vec.h"
+#include "simd.h"
 
 namespace y {
 namespace math {
@@ -191,6 +192,11 @@ class Matrix {
 		}
 
 		Matrix inverse() const {
+			if constexpr(is_simd) {
+				Matrix inv;
+				simd::mat4_inverse(begin(), inv.begin());
+				return inv;
+			}
 			T d = determinant();
 			if(d == 0) {
 				return Matrix();
@@ -237,6 +243,10 @@ class Matrix {
 
 		Column operator*(const Row& v) const {
 			Column tr;
+			if constexpr(is_simd) {
+				simd::mat4_mul_vec(begin(), v.begin(), tr.begin());
+				return tr;
+			}
 			for(usize i = 0; i != M; ++i) {
 				tr += column(i) * v[i];
 			}
@@ -246,6 +256,10 @@ class Matrix {
 		template<typename U, usize P>
 		auto operator*(const Matrix<M, P, U>& m) const {
 			Matrix<N, P, decltype(std::declval<T>() * std::declval<U>())> mat;
+			if constexpr(is_simd && P == 4 && std::is_same_v<U, float>) {
+				simd::mat4_mul(begin(), m.begin(), mat.begin());
+				return mat;
+			}
 			for(usize i = 0; i != N; ++i) {
 				for(usize j = 0; j != P; ++j) {
 					decltype(std::declval<T>() * std::declval<U>()) tmp(0);
@@ -274,6 +288,8 @@ class Matrix {
 		template<usize X, usize Y, typename U>
 		friend class Matrix;
 
+		static constexpr bool is_simd = N == 4 && M == 4 && std::is_same_v<T, float>;
+
 		static constexpr void chk_sq() {
 			static_assert(is_square(), "The matrix must be square");
 		}
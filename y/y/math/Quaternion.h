@@ -153,7 +153,8 @@ class Quaternion {
 
 			if(T(1.0) - dot > epsilon<T>) {
 				T omega = std::acos(dot);
-				T sin = std::sin(omega);
+				// sin(acos(x)) = sqrt(1 - x^2), factored to limit cancellation near 1
+				T sin = std::sqrt((T(1.0) - dot) * (T(1.0) + dot));
 				T p = std::sin((T(1.0) - factor) * omega) / sin;
 				T q = std::sin(factor * omega) / sin;
 
@@ -91,6 +91,40 @@ struct Transform : Matrix4<T> {
 		set_basis(forward, forward.cross(up), up);
 	}
 
+	// assumes the last row is (0, 0, 0, 1)
+	Transform inverse() const {
+		if constexpr(std::is_same_v<T, float>) {
+			Matrix4<T> inv;
+			simd::mat4_affine_inverse(this->begin(), inv.begin());
+			return inv;
+		}
+
+		const auto& x = this->column(0).template to<3>();
+		const auto& y = this->column(1).template to<3>();
+		const auto& z = this->column(2).template to<3>();
+
+		Vec<3, T> r0 = y.cross(z);
+		Vec<3, T> r1 = z.cross(x);
+		Vec<3, T> r2 = x.cross(y);
+		T det = x.dot(r0);
+		if(det == 0) {
+			return Matrix4<T>();
+		}
+
+		T inv_det = 1 / det;
+		r0 *= inv_det;
+		r1 *= inv_det;
+		r2 *= inv_det;
+
+		const auto& pos = position();
+		Transform inv;
+		inv.column(0) = Vec<4, T>(r0.x(), r1.x(), r2.x(), 0);
+		inv.column(1) = Vec<4, T>(r0.y(), r1.y(), r2.y(), 0);
+		inv.column(2) = Vec<4, T>(r0.z(), r1.z(), r2.z(), 0);
+		inv.column(3) = Vec<4, T>(-r0.dot(pos), -r1.dot(pos), -r2.dot(pos), 1);
+		return inv;
+	}
+
 	std::tuple<Vec<3, T>,  Quaternion<T>, Vec<3, T>> decompose() const {
 		const auto& x = this->column(0).template to<3>();
 		const auto& y = this->column(1).template to<3>();
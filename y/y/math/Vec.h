@@ -23,6 +23,7 @@ SOFTWARE.
 #define Y_MATH_VEC_H
 
 #include <y/utils.h>
+#include "simd.h"
 #include <cmath>
 
 namespace y {
@@ -296,15 +297,23 @@ class Vec
 
 		Vec operator-() const {
 			Vec t;
-			for(usize i = 0; i != N; ++i) {
-				t[i] = -_vec[i];
+			if constexpr(is_simd) {
+				simd::store(t._vec, simd::neg(simd::load(_vec)));
+			} else {
+				for(usize i = 0; i != N; ++i) {
+					t[i] = -_vec[i];
+				}
 			}
 			return t;
 		}
 
 		Vec& operator*=(const T& t) {
-			for(usize i = 0; i != N; ++i) {
-				_vec[i] *= t;
+			if constexpr(is_simd) {
+				simd::store(_vec, simd::mul(simd::load(_vec), simd::splat(t)));
+			} else {
+				for(usize i = 0; i != N; ++i) {
+					_vec[i] *= t;
+				}
 			}
 			return *this;
 		}
@@ -333,8 +342,12 @@ class Vec
 
 
 		Vec& operator*=(const Vec& v) {
-			for(usize i = 0; i != N; ++i) {
-				_vec[i] *= v[i];
+			if constexpr(is_simd) {
+				simd::store(_vec, simd::mul(simd::load(_vec), simd::load(v._vec)));
+			} else {
+				for(usize i = 0; i != N; ++i) {
+					_vec[i] *= v[i];
+				}
 			}
 			return *this;
 		}
@@ -347,15 +360,23 @@ class Vec
 		}
 
 		Vec& operator+=(const Vec& v) {
-			for(usize i = 0; i != N; ++i) {
-				_vec[i] += v[i];
+			if constexpr(is_simd) {
+				simd::store(_vec, simd::add(simd::load(_vec), simd::load(v._vec)));
+			} else {
+				for(usize i = 0; i != N; ++i) {
+					_vec[i] += v[i];
+				}
 			}
 			return *this;
 		}
 
 		Vec& operator-=(const Vec& v) {
-			for(usize i = 0; i != N; ++i) {
-				_vec[i] -= v[i];
+			if constexpr(is_simd) {
+				simd::store(_vec, simd::sub(simd::load(_vec), simd::load(v._vec)));
+			} else {
+				for(usize i = 0; i != N; ++i) {
+					_vec[i] -= v[i];
+				}
 			}
 			return *this;
 		}
@@ -372,6 +393,8 @@ class Vec
 		template<usize M, typename U>
 		friend class Vec;
 
+		static constexpr bool is_simd = N == 4 && std::is_same_v<T, float>;
+
 		T _vec[N] = {T(0)};
 
 };
@@ -0,0 +1,160 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "batch.h"
+
+#include <algorithm>
+
+namespace y {
+namespace math {
+
+using namespace simd;
+
+template<usize N, typename V>
+static void to_soa_impl(core::ArrayView<V> in, SoASpan<N> out) {
+	y_debug_assert(in.size() == out.size);
+	for(usize i = 0; i != in.size(); ++i) {
+		for(usize c = 0; c != N; ++c) {
+			out[c][i] = in[i][c];
+		}
+	}
+}
+
+template<usize N, typename V>
+static void from_soa_impl(ConstSoASpan<N> in, V* out) {
+	for(usize i = 0; i != in.size; ++i) {
+		for(usize c = 0; c != N; ++c) {
+			out[i][c] = in[c][i];
+		}
+	}
+}
+
+void to_soa(core::ArrayView<Vec3> in, SoASpan<3> out) {
+	to_soa_impl<3>(in, out);
+}
+
+void to_soa(core::ArrayView<Vec4> in, SoASpan<4> out) {
+	to_soa_impl<4>(in, out);
+}
+
+void from_soa(ConstSoASpan<3> in, Vec3* out) {
+	from_soa_impl<3>(in, out);
+}
+
+void from_soa(ConstSoASpan<4> in, Vec4* out) {
+	from_soa_impl<4>(in, out);
+}
+
+
+// m is column major, rows are accumulated in the same order as Matrix::operator*(Row)
+template<bool Translate>
+static void transform_soa(const float* m, const float* const* in, float* const* out, usize size) {
+	usize i = 0;
+	for(; i + width <= size; i += width) {
+		const float4 x = load(in[0] + i);
+		const float4 y = load(in[1] + i);
+		const float4 z = load(in[2] + i);
+		for(usize r = 0; r != 3; ++r) {
+			float4 v = add(add(mul(splat(m[r]), x), mul(splat(m[4 + r]), y)), mul(splat(m[8 + r]), z));
+			if constexpr(Translate) {
+				v = add(v, splat(m[12 + r]));
+			}
+			store(out[r] + i, v);
+		}
+	}
+	for(; i != size; ++i) {
+		const float x = in[0][i];
+		const float y = in[1][i];
+		const float z = in[2][i];
+		for(usize r = 0; r != 3; ++r) {
+			float v = m[r] * x + m[4 + r] * y + m[8 + r] * z;
+			if constexpr(Translate) {
+				v = v + m[12 + r];
+			}
+			out[r][i] = v;
+		}
+	}
+}
+
+void transform_points(const Matrix4<>& tr, ConstSoASpan<3> in, SoASpan<3> out) {
+	y_debug_assert(in.size == out.size);
+	transform_soa<true>(tr.begin(), in.components.data(), out.components.data(), in.size);
+}
+
+void transform_vectors(const Matrix4<>& tr, ConstSoASpan<3> in, SoASpan<3> out) {
+	y_debug_assert(in.size == out.size);
+	transform_soa<false>(tr.begin(), in.components.data(), out.components.data(), in.size);
+}
+
+void transform_spheres(const Transform<>& tr, ConstSoASpan<4> in, SoASpan<4> out) {
+	y_debug_assert(in.size == out.size);
+	transform_soa<true>(tr.begin(), in.components.data(), out.components.data(), in.size);
+
+	const float scale = std::max({tr.forward().length(), tr.left().length(), tr.up().length()});
+	usize i = 0;
+	for(; i + width <= in.size; i += width) {
+		store(out[3] + i, mul(load(in[3] + i), splat(scale)));
+	}
+	for(; i != in.size; ++i) {
+		out[3][i] = in[3][i] * scale;
+	}
+}
+
+// same test and rounding as yave::Frustum::is_inside
+void sphere_frustum_test(core::ArrayView<Vec4> planes, ConstSoASpan<4> spheres, u8* visible) {
+	const float4 zero = splat(0.0f);
+	usize i = 0;
+	for(; i + width <= spheres.size; i += width) {
+		const float4 x = load(spheres[0] + i);
+		const float4 y = load(spheres[1] + i);
+		const float4 z = load(spheres[2] + i);
+		const float4 r = load(spheres[3] + i);
+		u32 outside = 0;
+		for(const Vec4& p : planes) {
+			const float4 d = add(add(add(add(mul(splat(p.x()), x), mul(splat(p.y()), y)), mul(splat(p.z()), z)), splat(p.w())), r);
+			outside |= less_mask(d, zero);
+		}
+		for(usize k = 0; k != width; ++k) {
+			visible[i + k] = u8(!(outside & (1 << k)));
+		}
+	}
+	for(; i != spheres.size; ++i) {
+		const Vec3 pos(spheres[0][i], spheres[1][i], spheres[2][i]);
+		const float r = spheres[3][i];
+		visible[i] = u8(std::none_of(planes.begin(), planes.end(), [&](const Vec4& p) { return p.dot({pos, 1.0f}) + r < 0.0f; }));
+	}
+}
+
+void multiply_matrices(const Matrix4<>* a, const Matrix4<>* b, Matrix4<>* out, usize count) {
+	for(usize i = 0; i != count; ++i) {
+		mat4_mul(a[i].begin(), b[i].begin(), out[i].begin());
+	}
+}
+
+void multiply_transforms(const Transform<>* a, const Transform<>* b, Transform<>* out, usize count) {
+	for(usize i = 0; i != count; ++i) {
+		mat4_mul_affine(a[i].begin(), b[i].begin(), out[i].begin());
+	}
+}
+
+}
+}
@@ -0,0 +1,148 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_BATCH_H
+#define Y_MATH_BATCH_H
+
+#include "Transform.h"
+
+#include <y/core/Vector.h>
+#include <y/core/ArrayView.h>
+
+namespace y {
+namespace math {
+
+// Batch kernels process simd::width elements per iteration and finish the tail one element at a time.
+// Results are identical to the equivalent scalar Matrix and Vec operations.
+
+// Structure of arrays view: component i of element j is components[i][j]
+template<usize N, typename T = float>
+struct SoASpan {
+	std::array<T*, N> components = {};
+	usize size = 0;
+
+	SoASpan() = default;
+
+	SoASpan(const std::array<T*, N>& comps, usize s) : components(comps), size(s) {
+	}
+
+	template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	SoASpan(const SoASpan<N, U>& other) : size(other.size) {
+		for(usize i = 0; i != N; ++i) {
+			components[i] = other.components[i];
+		}
+	}
+
+	T* operator[](usize i) const {
+		return components[i];
+	}
+};
+
+template<usize N>
+using ConstSoASpan = SoASpan<N, const float>;
+
+
+template<usize N>
+class SoAArray {
+	public:
+		SoAArray(usize size = 0) : _data(size * N, 0.0f), _size(size) {
+		}
+
+		usize size() const {
+			return _size;
+		}
+
+		float* operator[](usize i) {
+			return _data.data() + i * _size;
+		}
+
+		const float* operator[](usize i) const {
+			return _data.data() + i * _size;
+		}
+
+		Vec<N> get(usize index) const {
+			Vec<N> v;
+			for(usize i = 0; i != N; ++i) {
+				v[i] = operator[](i)[index];
+			}
+			return v;
+		}
+
+		void set(usize index, const Vec<N>& v) {
+			for(usize i = 0; i != N; ++i) {
+				operator[](i)[index] = v[i];
+			}
+		}
+
+		operator SoASpan<N>() {
+			std::array<float*, N> comps;
+			for(usize i = 0; i != N; ++i) {
+				comps[i] = operator[](i);
+			}
+			return SoASpan<N>(comps, _size);
+		}
+
+		operator ConstSoASpan<N>() const {
+			std::array<const float*, N> comps;
+			for(usize i = 0; i != N; ++i) {
+				comps[i] = operator[](i);
+			}
+			return ConstSoASpan<N>(comps, _size);
+		}
+
+	private:
+		core::Vector<float> _data;
+		usize _size = 0;
+};
+
+// x, y, z
+using PointArray = SoAArray<3>;
+// x, y, z, radius
+using SphereArray = SoAArray<4>;
+
+
+void to_soa(core::ArrayView<Vec3> in, SoASpan<3> out);
+void to_soa(core::ArrayView<Vec4> in, SoASpan<4> out);
+void from_soa(ConstSoASpan<3> in, Vec3* out);
+void from_soa(ConstSoASpan<4> in, Vec4* out);
+
+// (tr * Vec4(p, 1)).to<3>(), in and out may alias
+void transform_points(const Matrix4<>& tr, ConstSoASpan<3> in, SoASpan<3> out);
+
+// (tr * Vec4(v, 0)).to<3>(), in and out may alias
+void transform_vectors(const Matrix4<>& tr, ConstSoASpan<3> in, SoASpan<3> out);
+
+// radii are scaled by the largest axis scale, in and out may alias
+void transform_spheres(const Transform<>& tr, ConstSoASpan<4> in, SoASpan<4> out);
+
+// out[i] is 1 if the sphere is on the positive side of every plane (or intersects it), 0 otherwise
+void sphere_frustum_test(core::ArrayView<Vec4> planes, ConstSoASpan<4> spheres, u8* visible);
+
+// out[i] = a[i] * b[i], out may alias a or b
+void multiply_matrices(const Matrix4<>* a, const Matrix4<>* b, Matrix4<>* out, usize count);
+
+// same as multiply_matrices but assumes that the last row of every b[i] is (0, 0, 0, 1)
+void multiply_transforms(const Transform<>* a, const Transform<>* b, Transform<>* out, usize count);
+
+}
+}
+
+#endif // Y_MATH_BATCH_H
@@ -0,0 +1,140 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_PACKING_H
+#define Y_MATH_PACKING_H
+
+#include "Vec.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace y {
+namespace math {
+
+// Decoding follows the Vulkan conversion rules so that the GPU sees the same values
+
+inline u16 quantize_unorm16(float f) {
+	f = std::min(std::max(f, 0.0f), 1.0f);
+	return u16(std::lround(f * 65535.0f));
+}
+
+inline float dequantize_unorm16(u16 u) {
+	return float(u) / 65535.0f;
+}
+
+inline i16 quantize_snorm16(float f) {
+	f = std::min(std::max(f, -1.0f), 1.0f);
+	return i16(std::lround(f * 32767.0f));
+}
+
+inline float dequantize_snorm16(i16 i) {
+	return std::max(float(i) / 32767.0f, -1.0f);
+}
+
+
+// round to nearest even, handles denormals, infinities and NaNs
+inline u16 to_half(float f) {
+	u32 bits = 0;
+	std::memcpy(&bits, &f, sizeof(f));
+
+	u32 sign = (bits >> 16) & 0x8000;
+	u32 abs = bits & 0x7FFFFFFF;
+
+	if(abs >= 0x7F800000) {
+		return u16(sign | (abs > 0x7F800000 ? 0x7E00 : 0x7C00));
+	}
+	if(abs >= 0x477FF000) {
+		return u16(sign | 0x7C00);
+	}
+	if(abs < 0x38800000) {
+		// denormal half
+		u32 shift = 126 - (abs >> 23);
+		if(shift > 24) {
+			return u16(sign);
+		}
+		u32 mant = (abs & 0x007FFFFF) | 0x00800000;
+		u32 half = mant >> shift;
+		u32 rem = mant & ((1u << shift) - 1);
+		u32 mid = 1u << (shift - 1);
+		half += (rem > mid || (rem == mid && (half & 1)));
+		return u16(sign | half);
+	}
+
+	u32 half = (abs - 0x38000000) >> 13;
+	u32 rem = abs & 0x1FFF;
+	half += (rem > 0x1000 || (rem == 0x1000 && (half & 1)));
+	return u16(sign | half);
+}
+
+inline float from_half(u16 h) {
+	u32 sign = u32(h & 0x8000) << 16;
+	u32 exp = (h >> 10) & 0x1F;
+	u32 mant = h & 0x3FF;
+
+	u32 bits = 0;
+	if(exp == 0x1F) {
+		bits = sign | 0x7F800000 | (mant << 13);
+	} else if(exp) {
+		bits = sign | ((exp + 112) << 23) | (mant << 13);
+	} else if(mant) {
+		exp = 113;
+		while(!(mant & 0x400)) {
+			mant <<= 1;
+			--exp;
+		}
+		bits = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+	} else {
+		bits = sign;
+	}
+
+	float f = 0.0f;
+	std::memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+
+// http://jcgt.org/published/0003/02/01/
+inline Vec2 octahedral_encode(const Vec3& n) {
+	float norm = std::abs(n.x()) + std::abs(n.y()) + std::abs(n.z());
+	if(norm <= 0.0f) {
+		return Vec2(0.0f, 0.0f);
+	}
+	Vec2 oct(n.x() / norm, n.y() / norm);
+	if(n.z() < 0.0f) {
+		oct = Vec2((1.0f - std::abs(oct.y())) * (oct.x() >= 0.0f ? 1.0f : -1.0f),
+				   (1.0f - std::abs(oct.x())) * (oct.y() >= 0.0f ? 1.0f : -1.0f));
+	}
+	return oct;
+}
+
+inline Vec3 octahedral_decode(const Vec2& oct) {
+	Vec3 n(oct.x(), oct.y(), 1.0f - std::abs(oct.x()) - std::abs(oct.y()));
+	float t = std::max(-n.z(), 0.0f);
+	n.x() += n.x() >= 0.0f ? -t : t;
+	n.y() += n.y() >= 0.0f ? -t : t;
+	return n.normalized();
+}
+
+}
+}
+
+#endif // Y_MATH_PACKING_H
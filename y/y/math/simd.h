@@ -0,0 +1,331 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MATH_SIMD_H
+#define Y_MATH_SIMD_H
+
+#include <y/utils.h>
+
+#if defined(Y_SSE)
+#include <xmmintrin.h>
+#elif defined(Y_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace y {
+namespace math {
+namespace simd {
+
+// 4 wide float registers, falls back to plain arrays when neither SSE nor NEON is available.
+// All element wise operations round exactly like their scalar counterparts.
+
+static constexpr usize width = 4;
+
+#if defined(Y_SSE)
+using float4 = __m128;
+#elif defined(Y_NEON)
+using float4 = float32x4_t;
+#else
+struct float4 {
+	float v[4];
+};
+#endif
+
+inline float4 load(const float* p) {
+#if defined(Y_SSE)
+	return _mm_loadu_ps(p);
+#elif defined(Y_NEON)
+	return vld1q_f32(p);
+#else
+	return float4{{p[0], p[1], p[2], p[3]}};
+#endif
+}
+
+inline void store(float* p, float4 v) {
+#if defined(Y_SSE)
+	_mm_storeu_ps(p, v);
+#elif defined(Y_NEON)
+	vst1q_f32(p, v);
+#else
+	for(usize i = 0; i != 4; ++i) {
+		p[i] = v.v[i];
+	}
+#endif
+}
+
+inline float4 splat(float f) {
+#if defined(Y_SSE)
+	return _mm_set1_ps(f);
+#elif defined(Y_NEON)
+	return vdupq_n_f32(f);
+#else
+	return float4{{f, f, f, f}};
+#endif
+}
+
+inline float4 set(float x, float y, float z, float w) {
+#if defined(Y_SSE)
+	return _mm_setr_ps(x, y, z, w);
+#else
+	const float v[] = {x, y, z, w};
+	return load(v);
+#endif
+}
+
+template<usize I>
+inline float get(float4 v) {
+	static_assert(I < 4);
+#if defined(Y_SSE)
+	return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I)));
+#elif defined(Y_NEON)
+	return vgetq_lane_f32(v, I);
+#else
+	return v.v[I];
+#endif
+}
+
+#if defined(Y_SSE)
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 neg(float4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+#elif defined(Y_NEON)
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+inline float4 div(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 neg(float4 a) { return vnegq_f32(a); }
+#else
+namespace detail {
+template<typename F>
+inline float4 map(float4 a, float4 b, F&& f) {
+	return float4{{f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3])}};
+}
+}
+inline float4 add(float4 a, float4 b) { return detail::map(a, b, [](float x, float y) { return x + y; }); }
+inline float4 sub(float4 a, float4 b) { return detail::map(a, b, [](float x, float y) { return x - y; }); }
+inline float4 mul(float4 a, float4 b) { return detail::map(a, b, [](float x, float y) { return x * y; }); }
+inline float4 div(float4 a, float4 b) { return detail::map(a, b, [](float x, float y) { return x / y; }); }
+inline float4 neg(float4 a) { return float4{{-a.v[0], -a.v[1], -a.v[2], -a.v[3]}}; }
+#endif
+
+// bit i is set if a[i] < b[i]
+inline u32 less_mask(float4 a, float4 b) {
+#if defined(Y_SSE)
+	return u32(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+#elif defined(Y_NEON)
+	const uint32x4_t m = vcltq_f32(a, b);
+	return (vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) | (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8);
+#else
+	u32 mask = 0;
+	for(usize i = 0; i != 4; ++i) {
+		mask |= u32(a.v[i] < b.v[i]) << i;
+	}
+	return mask;
+#endif
+}
+
+// returns {a[X], a[Y], b[Z], b[W]}
+template<usize X, usize Y, usize Z, usize W>
+inline float4 shuffle(float4 a, float4 b) {
+	static_assert(X < 4 && Y < 4 && Z < 4 && W < 4);
+#if defined(Y_SSE)
+	return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#else
+	return set(get<X>(a), get<Y>(a), get<Z>(b), get<W>(b));
+#endif
+}
+
+template<usize X, usize Y, usize Z, usize W>
+inline float4 swizzle(float4 a) {
+	return shuffle<X, Y, Z, W>(a, a);
+}
+
+template<usize I>
+inline float4 broadcast(float4 a) {
+	return swizzle<I, I, I, I>(a);
+}
+
+// sums in the same order as a scalar loop so results are identical
+inline float dot(float4 a, float4 b) {
+	float4 p = mul(a, b);
+	return ((get<0>(p) + get<1>(p)) + get<2>(p)) + get<3>(p);
+}
+// w is a.w * b.w - a.w * b.w
+inline float4 cross(float4 a, float4 b) {
+	return sub(mul(swizzle<1, 2, 0, 3>(a), swizzle<2, 0, 1, 3>(b)), mul(swizzle<2, 0, 1, 3>(a), swizzle<1, 2, 0, 3>(b)));
+}
+
+
+
+// Column major 4x4 kernels, outputs may alias inputs.
+
+inline void mat4_mul_vec(const float* m, const float* v, float* out) {
+	float4 r = mul(load(m), splat(v[0]));
+	r = add(r, mul(load(m + 4), splat(v[1])));
+	r = add(r, mul(load(m + 8), splat(v[2])));
+	r = add(r, mul(load(m + 12), splat(v[3])));
+	store(out, r);
+}
+
+inline void mat4_mul(const float* a, const float* b, float* out) {
+	const float4 c0 = load(a);
+	const float4 c1 = load(a + 4);
+	const float4 c2 = load(a + 8);
+	const float4 c3 = load(a + 12);
+	for(usize i = 0; i != 16; i += 4) {
+		const float4 col = load(b + i);
+		float4 r = mul(c0, broadcast<0>(col));
+		r = add(r, mul(c1, broadcast<1>(col)));
+		r = add(r, mul(c2, broadcast<2>(col)));
+		r = add(r, mul(c3, broadcast<3>(col)));
+		store(out + i, r);
+	}
+}
+
+namespace detail {
+// 2x2 blocks stored as {m00, m01, m10, m11}
+inline float4 mat2_mul(float4 a, float4 b) {
+	return add(mul(a, swizzle<0, 3, 0, 3>(b)), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+
+// adj(a) * b
+inline float4 mat2_adj_mul(float4 a, float4 b) {
+	return sub(mul(swizzle<3, 3, 0, 0>(a), b), mul(swizzle<1, 1, 2, 2>(a), swizzle<2, 3, 0, 1>(b)));
+}
+
+// a * adj(b)
+inline float4 mat2_mul_adj(float4 a, float4 b) {
+	return sub(mul(a, swizzle<3, 0, 3, 0>(b)), mul(swizzle<1, 0, 3, 2>(a), swizzle<2, 1, 2, 1>(b)));
+}
+}
+
+// Assumes the last row of b is (0, 0, 0, 1)
+inline void mat4_mul_affine(const float* a, const float* b, float* out) {
+	const float4 c0 = load(a);
+	const float4 c1 = load(a + 4);
+	const float4 c2 = load(a + 8);
+	const float4 c3 = load(a + 12);
+	for(usize i = 0; i != 16; i += 4) {
+		const float4 col = load(b + i);
+		float4 r = add(mul(c0, broadcast<0>(col)), mul(c1, broadcast<1>(col)));
+		r = add(r, mul(c2, broadcast<2>(col)));
+		store(out + i, i == 12 ? add(r, c3) : r);
+	}
+}
+
+// https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+// Works on 2x2 blocks, returns the determinant. out is left untouched if the matrix is singular.
+inline float mat4_inverse(const float* m, float* out) {
+	// the algorithm works on rows, running it on columns gives the inverse of the transpose, transposed
+	const float4 r0 = load(m);
+	const float4 r1 = load(m + 4);
+	const float4 r2 = load(m + 8);
+	const float4 r3 = load(m + 12);
+
+	const float4 a = shuffle<0, 1, 0, 1>(r0, r1);
+	const float4 b = shuffle<2, 3, 2, 3>(r0, r1);
+	const float4 c = shuffle<0, 1, 0, 1>(r2, r3);
+	const float4 d = shuffle<2, 3, 2, 3>(r2, r3);
+
+	// {|A|, |B|, |C|, |D|}
+	const float4 det_sub = sub(
+		mul(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+		mul(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3)));
+	const float4 det_a = broadcast<0>(det_sub);
+	const float4 det_b = broadcast<1>(det_sub);
+	const float4 det_c = broadcast<2>(det_sub);
+	const float4 det_d = broadcast<3>(det_sub);
+
+	const float4 d_c = detail::mat2_adj_mul(d, c);
+	const float4 a_b = detail::mat2_adj_mul(a, b);
+
+	float4 x = sub(mul(det_d, a), detail::mat2_mul(b, d_c));
+	float4 w = sub(mul(det_a, d), detail::mat2_mul(c, a_b));
+	float4 y = sub(mul(det_b, c), detail::mat2_mul_adj(d, a_b));
+	float4 z = sub(mul(det_c, b), detail::mat2_mul_adj(a, d_c));
+
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	const float4 tr = mul(a_b, swizzle<0, 2, 1, 3>(d_c));
+	const float trace = (get<0>(tr) + get<1>(tr)) + (get<2>(tr) + get<3>(tr));
+	const float det = get<0>(det_a) * get<0>(det_d) + get<0>(det_b) * get<0>(det_c) - trace;
+	if(det == 0.0f) {
+		return det;
+	}
+
+	const float4 rcp_det = div(set(1.0f, -1.0f, -1.0f, 1.0f), splat(det));
+	x = mul(x, rcp_det);
+	y = mul(y, rcp_det);
+	z = mul(z, rcp_det);
+	w = mul(w, rcp_det);
+
+	store(out, shuffle<3, 1, 3, 1>(x, y));
+	store(out + 4, shuffle<2, 0, 2, 0>(x, y));
+	store(out + 8, shuffle<3, 1, 3, 1>(z, w));
+	store(out + 12, shuffle<2, 0, 2, 0>(z, w));
+
+	return det;
+}
+
+// Assumes the last row is (0, 0, 0, 1). Returns the determinant, out is left untouched if the matrix is singular.
+inline float mat4_affine_inverse(const float* m, float* out) {
+	const float4 c0 = load(m);
+	const float4 c1 = load(m + 4);
+	const float4 c2 = load(m + 8);
+	const float4 pos = load(m + 12);
+
+	// rows of the inverse of the 3x3 part, times the determinant
+	float4 r0 = cross(c1, c2);
+	float4 r1 = cross(c2, c0);
+	float4 r2 = cross(c0, c1);
+
+	const float det = dot(c0, r0);
+	if(det == 0.0f) {
+		return det;
+	}
+
+	const float4 zero = splat(0.0f);
+	const float4 xy = shuffle<0, 1, 0, 1>(r0, r1);
+	const float4 zw = shuffle<2, 3, 2, 3>(r0, r1);
+	const float4 rcp_det = splat(1.0f / det);
+	const float4 t0 = mul(shuffle<0, 2, 0, 2>(xy, shuffle<0, 1, 0, 1>(r2, zero)), rcp_det);
+	const float4 t1 = mul(shuffle<1, 3, 1, 3>(xy, shuffle<0, 1, 0, 1>(r2, zero)), rcp_det);
+	const float4 t2 = mul(shuffle<0, 2, 0, 2>(zw, shuffle<2, 3, 2, 3>(r2, zero)), rcp_det);
+
+	float4 t3 = mul(t0, broadcast<0>(pos));
+	t3 = add(t3, mul(t1, broadcast<1>(pos)));
+	t3 = add(t3, mul(t2, broadcast<2>(pos)));
+	t3 = sub(set(0.0f, 0.0f, 0.0f, 1.0f), t3);
+
+	store(out, t0);
+	store(out + 4, t1);
+	store(out + 8, t2);
+	store(out + 12, t3);
+
+	return det;
+}
+
+}
+}
+}
+
+#endif // Y_MATH_SIMD_H
@@ -0,0 +1,136 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "LinearAllocator.h"
+
+namespace y {
+namespace memory {
+
+LinearAllocator::LinearAllocator(usize block_size) : _block_size(align_up_to_max(block_size)) {
+}
+
+LinearAllocator::~LinearAllocator() {
+	if(_alive) {
+		y_fatal("Memory was not freed before allocator destruction (% allocations leaked).", _alive);
+	}
+	for(const Block& block : _blocks) {
+		_allocator.deallocate(block.data, block.size);
+	}
+}
+
+void LinearAllocator::add_block(usize min_size) {
+	// blocks at least double the capacity so a frame never needs many of them
+	usize size = std::max({min_size, _block_size, capacity()});
+	_blocks << Block{static_cast<u8*>(_allocator.allocate(size)), size};
+	_offset = 0;
+}
+
+void LinearAllocator::rewind() {
+	if(_blocks.size() > 1) {
+		usize total = capacity();
+		for(const Block& block : _blocks) {
+			_allocator.deallocate(block.data, block.size);
+		}
+		_blocks.clear();
+		add_block(total);
+	}
+	_offset = 0;
+	_allocated = 0;
+}
+
+void* LinearAllocator::allocate(usize size) noexcept {
+	size = align_up_to_max(size);
+	if(_blocks.is_empty() || _offset + size > _blocks.last().size) {
+		add_block(size);
+	}
+
+	void* ptr = _blocks.last().data + _offset;
+	_offset += size;
+
+	++_alive;
+	_allocated += size;
+	_frame_high_water = std::max(_frame_high_water, _allocated);
+	_high_water = std::max(_high_water, _allocated);
+
+	return ptr;
+}
+
+void LinearAllocator::deallocate(void* ptr, usize size) noexcept {
+	if(!ptr) {
+		return;
+	}
+
+	y_debug_assert(_alive);
+	size = align_up_to_max(size);
+
+	if(!--_alive) {
+		rewind();
+		return;
+	}
+
+	// last allocation: can be reused right away (growing vectors)
+	const Block& block = _blocks.last();
+	if(static_cast<u8*>(ptr) + size == block.data + _offset) {
+		_offset -= size;
+		_allocated -= size;
+	}
+}
+
+void LinearAllocator::end_frame() {
+	if(_alive) {
+		y_fatal("Frame memory is still in use at the end of the frame (% allocations).", _alive);
+	}
+	_frame_high_water = 0;
+}
+
+usize LinearAllocator::allocated() const {
+	return _allocated;
+}
+
+usize LinearAllocator::capacity() const {
+	usize total = 0;
+	for(const Block& block : _blocks) {
+		total += block.size;
+	}
+	return total;
+}
+
+usize LinearAllocator::block_count() const {
+	return _blocks.size();
+}
+
+usize LinearAllocator::high_water_mark() const {
+	return _high_water;
+}
+
+usize LinearAllocator::frame_high_water_mark() const {
+	return _frame_high_water;
+}
+
+
+LinearAllocator& frame_arena() {
+	static thread_local LinearAllocator arena;
+	return arena;
+}
+
+}
+}
@@ -0,0 +1,110 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEM_LINEARALLOCATOR_H
+#define Y_MEM_LINEARALLOCATOR_H
+
+#include "allocators.h"
+
+#include <y/core/Vector.h>
+
+namespace y {
+namespace memory {
+
+// Bump allocator for short lived allocations.
+// Only the last allocation is actually freed, the whole arena is rewound once nothing is allocated anymore.
+// Blocks are merged when rewinding so an arena converges to a single block.
+class LinearAllocator : NonCopyable {
+
+	struct Block {
+		u8* data = nullptr;
+		usize size = 0;
+	};
+
+	public:
+		static constexpr usize default_block_size = 64 * 1024;
+
+		LinearAllocator(usize block_size = default_block_size);
+		~LinearAllocator();
+
+		[[nodiscard]] void* allocate(usize size) noexcept;
+		void deallocate(void* ptr, usize size) noexcept;
+
+		// reset point: fails if memory allocated during the frame is still alive
+		void end_frame();
+
+		usize allocated() const;
+		usize capacity() const;
+		usize block_count() const;
+
+		usize high_water_mark() const;
+		usize frame_high_water_mark() const;
+
+	private:
+		void add_block(usize min_size);
+		void rewind();
+
+		core::Vector<Block> _blocks;
+		usize _block_size = 0;
+		usize _offset = 0;
+
+		usize _alive = 0;
+		usize _allocated = 0;
+		usize _high_water = 0;
+		usize _frame_high_water = 0;
+
+		Mallocator _allocator;
+};
+
+
+// per thread arena, memory must be freed by the thread that allocated it
+LinearAllocator& frame_arena();
+
+class FrameAllocator : NonCopyable {
+	public:
+		[[nodiscard]] void* allocate(usize size) noexcept {
+			return frame_arena().allocate(size);
+		}
+
+		void deallocate(void* ptr, usize size) noexcept {
+			frame_arena().deallocate(ptr, size);
+		}
+};
+
+}
+
+namespace core {
+
+// for temporaries that don't outlive the frame
+template<typename T>
+using FrameVector = Vector<T, DefaultVectorResizePolicy, memory::StdAllocatorAdapter<T, memory::FrameAllocator>>;
+
+template<typename T>
+inline auto frame_vector_with_capacity(usize cap) {
+	auto vec = FrameVector<T>();
+	vec.set_min_capacity(cap);
+	return vec;
+}
+
+}
+}
+
+#endif // Y_MEM_LINEARALLOCATOR_H
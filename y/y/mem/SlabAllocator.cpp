@@ -0,0 +1,264 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SlabAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace y {
+namespace memory {
+
+static constexpr usize slabs_per_chunk = 16;
+
+struct ThreadCache;
+
+struct FreeBlock {
+	FreeBlock* next;
+};
+
+struct Slab {
+	std::atomic<ThreadCache*> owner = nullptr;
+	std::atomic<FreeBlock*> remote_free = nullptr;
+
+	Slab* next = nullptr;
+	usize size_class = 0;
+
+	u8* bump = nullptr;
+	u8* end = nullptr;
+};
+
+static constexpr usize slab_header_size = align_up_to(sizeof(Slab), SlabAllocator::max_block_size);
+static_assert(slab_header_size < SlabAllocator::slab_size / 4);
+
+static usize size_class(usize size) {
+	size = std::max(size, SlabAllocator::min_block_size);
+	return usize(64 - __builtin_clzll(u64(size - 1))) - 4;
+}
+
+static usize block_size(usize size_class) {
+	return SlabAllocator::min_block_size << size_class;
+}
+
+static Slab* slab_of(void* ptr) {
+	return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(SlabAllocator::slab_size - 1));
+}
+
+static void push_remote(Slab* slab, FreeBlock* block) {
+	FreeBlock* head = slab->remote_free.load(std::memory_order_relaxed);
+	do {
+		block->next = head;
+	} while(!slab->remote_free.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+
+// shared state, only touched when a thread needs a new slab or exits
+static struct SlabHeap : NonMovable {
+	std::mutex lock;
+
+	std::array<Slab*, SlabAllocator::size_class_count> abandoned = {};
+	u8* chunk_begin = nullptr;
+	u8* chunk_end = nullptr;
+
+	usize slab_count = 0;
+	usize abandoned_count = 0;
+
+	Slab* acquire(usize size_class, ThreadCache* owner) {
+		std::unique_lock l(lock);
+
+		Slab* slab = abandoned[size_class];
+		if(slab) {
+			abandoned[size_class] = slab->next;
+			--abandoned_count;
+		} else {
+			if(chunk_begin == chunk_end) {
+				// leaked on purpose: slabs live as long as the program
+				u8* chunk = static_cast<u8*>(std::malloc(SlabAllocator::slab_size * (slabs_per_chunk + 1)));
+				if(!chunk) {
+					return nullptr;
+				}
+				chunk_begin = reinterpret_cast<u8*>(align_up_to(reinterpret_cast<uintptr_t>(chunk), SlabAllocator::slab_size));
+				chunk_end = chunk_begin + SlabAllocator::slab_size * slabs_per_chunk;
+			}
+			slab = new(chunk_begin) Slab();
+			chunk_begin += SlabAllocator::slab_size;
+			++slab_count;
+
+			slab->size_class = size_class;
+			slab->bump = reinterpret_cast<u8*>(slab) + slab_header_size;
+			slab->end = reinterpret_cast<u8*>(slab) + SlabAllocator::slab_size;
+		}
+
+		slab->next = nullptr;
+		slab->owner.store(owner, std::memory_order_relaxed);
+		return slab;
+	}
+
+	void abandon(Slab* slab) {
+		std::unique_lock l(lock);
+		slab->owner.store(nullptr, std::memory_order_relaxed);
+		slab->next = abandoned[slab->size_class];
+		abandoned[slab->size_class] = slab;
+		++abandoned_count;
+	}
+
+} slab_heap;
+
+
+struct ThreadCache : NonMovable {
+	struct SizeClass {
+		FreeBlock* free = nullptr;
+		Slab* current = nullptr;
+		Slab* slabs = nullptr;
+	};
+
+	std::array<SizeClass, SlabAllocator::size_class_count> classes;
+
+	~ThreadCache() {
+		for(SizeClass& c : classes) {
+			// blocks freed locally are handed back to their slab so the next owner sees them
+			while(FreeBlock* block = c.free) {
+				c.free = block->next;
+				push_remote(slab_of(block), block);
+			}
+			while(Slab* slab = c.slabs) {
+				c.slabs = slab->next;
+				slab_heap.abandon(slab);
+			}
+		}
+	}
+
+	void* allocate(usize index) {
+		SizeClass& c = classes[index];
+		usize size = block_size(index);
+
+		for(;;) {
+			if(FreeBlock* block = c.free) {
+				c.free = block->next;
+				return block;
+			}
+
+			if(c.current && c.current->bump + size <= c.current->end) {
+				void* ptr = c.current->bump;
+				c.current->bump += size;
+				return ptr;
+			}
+
+			if(collect_remote(c)) {
+				continue;
+			}
+
+			Slab* slab = slab_heap.acquire(index, this);
+			if(!slab) {
+				return nullptr;
+			}
+			slab->next = c.slabs;
+			c.slabs = slab;
+			c.current = slab;
+		}
+	}
+
+	void deallocate_local(Slab* slab, void* ptr) {
+		SizeClass& c = classes[slab->size_class];
+		FreeBlock* block = static_cast<FreeBlock*>(ptr);
+		block->next = c.free;
+		c.free = block;
+	}
+
+	bool collect_remote(SizeClass& c) {
+		bool found = false;
+		for(Slab* slab = c.slabs; slab; slab = slab->next) {
+			FreeBlock* list = slab->remote_free.exchange(nullptr, std::memory_order_acquire);
+			while(list) {
+				FreeBlock* next = list->next;
+				list->next = c.free;
+				c.free = list;
+				list = next;
+				found = true;
+			}
+		}
+		return found;
+	}
+};
+
+
+// threads that allocate after their cache has been destroyed share this one
+static std::mutex orphan_lock;
+static ThreadCache orphan_cache;
+
+static thread_local ThreadCache* current_cache = nullptr;
+static thread_local bool cache_destroyed = false;
+
+struct ThreadCacheHolder : NonMovable {
+	ThreadCache cache;
+
+	~ThreadCacheHolder() {
+		current_cache = nullptr;
+		cache_destroyed = true;
+	}
+};
+
+static ThreadCache* thread_cache() {
+	if(!current_cache && !cache_destroyed) {
+		static thread_local ThreadCacheHolder holder;
+		current_cache = &holder.cache;
+	}
+	return current_cache;
+}
+
+
+void* SlabAllocator::allocate(usize size) noexcept {
+	if(size > max_block_size) {
+		return nullptr;
+	}
+	usize index = size_class(size);
+	if(ThreadCache* cache = thread_cache()) {
+		return cache->allocate(index);
+	}
+	std::unique_lock lock(orphan_lock);
+	return orphan_cache.allocate(index);
+}
+
+void SlabAllocator::deallocate(void* ptr, usize size) noexcept {
+	unused(size);
+	if(!ptr) {
+		return;
+	}
+
+	Slab* slab = slab_of(ptr);
+	y_debug_assert(slab->size_class == size_class(size));
+
+	ThreadCache* cache = current_cache;
+	if(cache && slab->owner.load(std::memory_order_relaxed) == cache) {
+		cache->deallocate_local(slab, ptr);
+	} else {
+		push_remote(slab, static_cast<FreeBlock*>(ptr));
+	}
+}
+
+SlabAllocator::Stats SlabAllocator::stats() {
+	std::unique_lock l(slab_heap.lock);
+	return Stats{slab_heap.slab_count, slab_heap.abandoned_count};
+}
+
+}
+}
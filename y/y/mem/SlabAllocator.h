@@ -0,0 +1,60 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEM_SLABALLOCATOR_H
+#define Y_MEM_SLABALLOCATOR_H
+
+#include "allocators.h"
+
+namespace y {
+namespace memory {
+
+// Size class slab allocator for small objects.
+// Each thread allocates from slabs it owns, without locking.
+// A block freed by another thread is pushed on its slab's lock free remote list,
+// the owner collects those lists when it runs out of blocks.
+// Slabs are never given back to the system: the slabs of a thread that exits are adopted by other threads.
+class SlabAllocator : NonCopyable {
+	public:
+		static constexpr usize slab_size = 64 * 1024;
+		static constexpr usize min_block_size = 16;
+		static constexpr usize max_block_size = 1024;
+		static constexpr usize size_class_count = 7;
+
+		struct Stats {
+			usize slab_count = 0;
+			usize abandoned_slab_count = 0;
+		};
+
+		// returns nullptr if size > max_block_size
+		[[nodiscard]] void* allocate(usize size) noexcept;
+		void deallocate(void* ptr, usize size) noexcept;
+
+		static Stats stats();
+};
+
+// small objects go to the slabs, everything else to malloc
+using SmallObjectAllocator = SegregatorAllocator<SlabAllocator::max_block_size, SlabAllocator, Mallocator>;
+
+}
+}
+
+#endif // Y_MEM_SLABALLOCATOR_H
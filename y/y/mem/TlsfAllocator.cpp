@@ -0,0 +1,339 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "TlsfAllocator.h"
+
+namespace y {
+namespace memory {
+
+static usize fls(usize x) {
+	y_debug_assert(x);
+	return usize(63 - __builtin_clzll(u64(x)));
+}
+
+static usize ffs(u32 x) {
+	y_debug_assert(x);
+	return usize(__builtin_ctz(x));
+}
+
+static bool is_pow_of_two(usize x) {
+	return x && !(x & (x - 1));
+}
+
+
+float TlsfAllocator::Stats::fragmentation() const {
+	return free_size ? 1.0f - float(largest_free_block) / float(free_size) : 0.0f;
+}
+
+
+TlsfAllocator::TlsfAllocator(usize size, usize granularity) {
+	if(!is_pow_of_two(granularity)) {
+		y_fatal("Granularity must be a power of 2.");
+	}
+	if(size % granularity) {
+		y_fatal("Size must be a multiple of granularity.");
+	}
+
+	for(auto& list : _free_lists) {
+		list.fill(null_block);
+	}
+
+	_granularity_log2 = fls(granularity);
+	_size = size >> _granularity_log2;
+	if(_size) {
+		if(mapping_insert(_size).first >= fl_count) {
+			y_fatal("Size is too big.");
+		}
+		insert_free(create_block(0, _size));
+	}
+}
+
+usize TlsfAllocator::allocate(usize size, usize alignment) {
+	y_debug_assert(is_pow_of_two(alignment));
+
+	usize granularity = usize(1) << _granularity_log2;
+	usize size_units = std::max(usize(1), (size + granularity - 1) >> _granularity_log2);
+	usize align_units = std::max(usize(1), alignment >> _granularity_log2);
+
+	u32 index = find_free_block(size_units + align_units - 1);
+	if(index == null_block) {
+		return invalid_offset;
+	}
+	remove_free(index);
+
+	usize offset = _blocks[index].offset;
+	usize aligned = (offset + align_units - 1) & ~(align_units - 1);
+	if(aligned != offset) {
+		u32 next = split(index, aligned - offset);
+		insert_free(index);
+		index = next;
+	}
+	if(_blocks[index].size > size_units) {
+		insert_free(split(index, size_units));
+	}
+
+	_used += _blocks[index].size;
+	_allocated[aligned] = index;
+
+	return aligned << _granularity_log2;
+}
+
+void TlsfAllocator::free(usize offset) {
+	auto it = _allocated.find(offset >> _granularity_log2);
+	if(it == _allocated.end() || offset & ((usize(1) << _granularity_log2) - 1)) {
+		y_fatal("Freed offset was not allocated.");
+	}
+
+	u32 index = it->second;
+	_allocated.erase(it);
+	_used -= _blocks[index].size;
+
+	u32 prev = _blocks[index].prev_phys;
+	if(prev != null_block && _blocks[prev].free) {
+		remove_free(prev);
+		index = merge(prev, index);
+	}
+	u32 next = _blocks[index].next_phys;
+	if(next != null_block && _blocks[next].free) {
+		remove_free(next);
+		index = merge(index, next);
+	}
+	insert_free(index);
+}
+
+usize TlsfAllocator::size() const {
+	return _size << _granularity_log2;
+}
+
+usize TlsfAllocator::granularity() const {
+	return usize(1) << _granularity_log2;
+}
+
+TlsfAllocator::Stats TlsfAllocator::stats() const {
+	Stats stats;
+	stats.total_size = size();
+	stats.used_size = _used << _granularity_log2;
+	stats.free_size = stats.total_size - stats.used_size;
+	stats.allocation_count = _allocated.size();
+	stats.free_block_count = _free_blocks;
+
+	// the largest block can only be in the last non empty list
+	if(_fl_bitmap) {
+		usize fl = fls(_fl_bitmap);
+		usize sl = fls(_sl_bitmaps[fl]);
+		usize largest = 0;
+		for(u32 i = _free_lists[fl][sl]; i != null_block; i = _blocks[i].next_free) {
+			largest = std::max(largest, _blocks[i].size);
+		}
+		stats.largest_free_block = largest << _granularity_log2;
+	}
+
+	return stats;
+}
+
+bool TlsfAllocator::is_consistent() const {
+	if(!_size) {
+		return _blocks.is_empty();
+	}
+
+	usize offset = 0;
+	usize used = 0;
+	usize free_blocks = 0;
+	usize used_blocks = 0;
+	u32 prev = null_block;
+	for(u32 i = 0; i != null_block; i = _blocks[i].next_phys) {
+		const Block& block = _blocks[i];
+		if(block.offset != offset || block.prev_phys != prev || !block.size) {
+			return false;
+		}
+		if(block.free) {
+			if(prev != null_block && _blocks[prev].free) {
+				return false;
+			}
+			auto [fl, sl] = mapping_insert(block.size);
+			bool found = false;
+			for(u32 f = _free_lists[fl][sl]; f != null_block; f = _blocks[f].next_free) {
+				found |= (f == i);
+			}
+			if(!found) {
+				return false;
+			}
+			++free_blocks;
+		} else {
+			auto it = _allocated.find(block.offset);
+			if(it == _allocated.end() || it->second != i) {
+				return false;
+			}
+			used += block.size;
+			++used_blocks;
+		}
+		offset += block.size;
+		prev = i;
+	}
+
+	for(usize fl = 0; fl != fl_count; ++fl) {
+		for(usize sl = 0; sl != sl_count; ++sl) {
+			bool has_bit = (_sl_bitmaps[fl] >> sl) & 1;
+			if(has_bit != (_free_lists[fl][sl] != null_block)) {
+				return false;
+			}
+		}
+		if(bool((_fl_bitmap >> fl) & 1) != bool(_sl_bitmaps[fl])) {
+			return false;
+		}
+	}
+
+	return offset == _size && used == _used && free_blocks == _free_blocks && used_blocks == _allocated.size();
+}
+
+
+std::pair<usize, usize> TlsfAllocator::mapping_insert(usize size) {
+	if(size < sl_count) {
+		return {0, size};
+	}
+	usize fl = fls(size);
+	usize sl = (size >> (fl - sl_log2)) ^ sl_count;
+	return {fl - sl_log2 + 1, sl};
+}
+
+std::pair<usize, usize> TlsfAllocator::mapping_search(usize size) {
+	// round up so that any block in the list is big enough
+	if(size >= sl_count) {
+		size += (usize(1) << (fls(size) - sl_log2)) - 1;
+	}
+	return mapping_insert(size);
+}
+
+u32 TlsfAllocator::find_free_block(usize size) const {
+	auto [fl, sl] = mapping_search(size);
+	if(fl >= fl_count) {
+		return null_block;
+	}
+
+	u32 sl_map = _sl_bitmaps[fl] & (~u32(0) << sl);
+	if(!sl_map) {
+		u32 fl_map = fl + 1 < fl_count ? _fl_bitmap & (~u32(0) << (fl + 1)) : 0;
+		if(!fl_map) {
+			return null_block;
+		}
+		fl = ffs(fl_map);
+		sl_map = _sl_bitmaps[fl];
+	}
+
+	return _free_lists[fl][ffs(sl_map)];
+}
+
+u32 TlsfAllocator::create_block(usize offset, usize size) {
+	u32 index = 0;
+	if(_recycled.is_empty()) {
+		index = u32(_blocks.size());
+		_blocks << Block();
+	} else {
+		index = _recycled.pop();
+		_blocks[index] = Block();
+	}
+	_blocks[index].offset = offset;
+	_blocks[index].size = size;
+	return index;
+}
+
+void TlsfAllocator::destroy_block(u32 index) {
+	_recycled << index;
+}
+
+void TlsfAllocator::insert_free(u32 index) {
+	auto [fl, sl] = mapping_insert(_blocks[index].size);
+
+	u32 head = _free_lists[fl][sl];
+	_blocks[index].free = true;
+	_blocks[index].prev_free = null_block;
+	_blocks[index].next_free = head;
+	if(head != null_block) {
+		_blocks[head].prev_free = index;
+	}
+
+	_free_lists[fl][sl] = index;
+	_sl_bitmaps[fl] |= u32(1) << sl;
+	_fl_bitmap |= u32(1) << fl;
+	++_free_blocks;
+}
+
+void TlsfAllocator::remove_free(u32 index) {
+	Block& block = _blocks[index];
+	y_debug_assert(block.free);
+
+	if(block.prev_free != null_block) {
+		_blocks[block.prev_free].next_free = block.next_free;
+	}
+	if(block.next_free != null_block) {
+		_blocks[block.next_free].prev_free = block.prev_free;
+	}
+
+	auto [fl, sl] = mapping_insert(block.size);
+	if(_free_lists[fl][sl] == index) {
+		_free_lists[fl][sl] = block.next_free;
+		if(block.next_free == null_block) {
+			_sl_bitmaps[fl] &= ~(u32(1) << sl);
+			if(!_sl_bitmaps[fl]) {
+				_fl_bitmap &= ~(u32(1) << fl);
+			}
+		}
+	}
+
+	block.free = false;
+	block.prev_free = block.next_free = null_block;
+	--_free_blocks;
+}
+
+u32 TlsfAllocator::split(u32 index, usize size) {
+	y_debug_assert(_blocks[index].size > size);
+
+	u32 rest = create_block(_blocks[index].offset + size, _blocks[index].size - size);
+	u32 next = _blocks[index].next_phys;
+
+	_blocks[rest].prev_phys = index;
+	_blocks[rest].next_phys = next;
+	if(next != null_block) {
+		_blocks[next].prev_phys = rest;
+	}
+	_blocks[index].next_phys = rest;
+	_blocks[index].size = size;
+
+	return rest;
+}
+
+u32 TlsfAllocator::merge(u32 first, u32 second) {
+	y_debug_assert(_blocks[first].next_phys == second);
+
+	u32 next = _blocks[second].next_phys;
+	_blocks[first].size += _blocks[second].size;
+	_blocks[first].next_phys = next;
+	if(next != null_block) {
+		_blocks[next].prev_phys = first;
+	}
+	destroy_block(second);
+
+	return first;
+}
+
+}
+}
@@ -0,0 +1,121 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_MEM_TLSFALLOCATOR_H
+#define Y_MEM_TLSFALLOCATOR_H
+
+#include <y/core/Vector.h>
+
+#include <array>
+#include <unordered_map>
+
+namespace y {
+namespace memory {
+
+// Two level segregated fit allocator (Masmano et al. 2004): O(1) allocation and coalescing.
+// It manages offsets in an abstract range and keeps its bookkeeping out of band,
+// so it can sub allocate memory that can't be written to (GPU memory for example).
+class TlsfAllocator : NonCopyable {
+
+	static constexpr usize sl_log2 = 5;
+	static constexpr usize sl_count = 1 << sl_log2;
+	static constexpr usize fl_count = 32;
+
+	static constexpr u32 null_block = u32(-1);
+
+	struct Block {
+		usize offset = 0;
+		usize size = 0;
+
+		u32 prev_phys = null_block;
+		u32 next_phys = null_block;
+
+		u32 prev_free = null_block;
+		u32 next_free = null_block;
+
+		bool free = false;
+	};
+
+	public:
+		static constexpr usize invalid_offset = usize(-1);
+
+		struct Stats {
+			usize total_size = 0;
+			usize used_size = 0;
+			usize free_size = 0;
+
+			usize allocation_count = 0;
+			usize free_block_count = 0;
+			usize largest_free_block = 0;
+
+			// 0 when all free memory is contiguous
+			float fragmentation() const;
+		};
+
+		TlsfAllocator() = default;
+
+		// granularity must be a power of 2, every size and offset is rounded up to it
+		TlsfAllocator(usize size, usize granularity = 1);
+
+		// alignment must be a power of 2, returns invalid_offset on failure
+		usize allocate(usize size, usize alignment = 1);
+		void free(usize offset);
+
+		usize size() const;
+		usize granularity() const;
+
+		Stats stats() const;
+
+		// walks every block, for tests
+		bool is_consistent() const;
+
+	private:
+		static std::pair<usize, usize> mapping_insert(usize size);
+		static std::pair<usize, usize> mapping_search(usize size);
+
+		u32 find_free_block(usize size) const;
+		u32 create_block(usize offset, usize size);
+		void destroy_block(u32 index);
+
+		void insert_free(u32 index);
+		void remove_free(u32 index);
+
+		u32 split(u32 index, usize size);
+		u32 merge(u32 first, u32 second);
+
+		core::Vector<Block> _blocks;
+		core::Vector<u32> _recycled;
+		std::unordered_map<usize, u32> _allocated;
+
+		u32 _fl_bitmap = 0;
+		std::array<u32, fl_count> _sl_bitmaps = {};
+		std::array<std::array<u32, sl_count>, fl_count> _free_lists;
+
+		usize _size = 0;
+		usize _granularity_log2 = 0;
+		usize _used = 0;
+		usize _free_blocks = 0;
+};
+
+}
+}
+
+#endif // Y_MEM_TLSFALLOCATOR_H
@@ -22,6 +22,7 @@ SOFTWARE.
 
 #include "memory.h"
 #include "allocators.h"
+#include "SlabAllocator.h"
 
 namespace y {
 namespace memory {
@@ -46,8 +47,9 @@ PolymorphicAllocatorBase* global_allocator() {
 	return &allocator;
 }
 
+// thread locality is handled by the slab allocator's per thread caches
 PolymorphicAllocatorBase* thread_local_allocator() {
-	static thread_local PolymorphicAllocator<GlobalAllocatorType> allocator;
+	static PolymorphicAllocator<SmallObjectAllocator> allocator;
 	return &allocator;
 }
 
@@ -29,12 +29,13 @@ SOFTWARE.
 namespace y {
 namespace serde2 {
 
-// TODO: We still pay a virtual call by read/write op, change that if possible
+// Archives are templated on the reader/writer type: archives built on io2::Reader/Writer pay a virtual call per op,
+// archives built directly on a concrete type (ie: ReadableArchive ar(buffer)) don't.
 
-template<typename Format = BinaryFormat>
+template<typename Format = BinaryFormat, typename R = io2::Reader>
 class ReadableArchive final {
 	public:
-		ReadableArchive(io2::Reader& reader) : _reader(reader) {
+		ReadableArchive(R& reader) : _reader(reader) {
 		}
 
 		template<typename T, typename... Args>
@@ -47,7 +48,7 @@ class ReadableArchive final {
 			return helper::deserialize_array(*this, t, n);
 		}
 
-		FormattedReader<Format>& reader() {
+		FormattedReader<Format, R>& reader() {
 			return _reader;
 		}
 
@@ -68,14 +69,17 @@ class ReadableArchive final {
 			return core::Ok();
 		}
 
-		FormattedReader<Format> _reader;
+		FormattedReader<Format, R> _reader;
 };
 
+template<typename R>
+ReadableArchive(R&) -> ReadableArchive<BinaryFormat, R>;
 
-template<typename Format = BinaryFormat>
+
+template<typename Format = BinaryFormat, typename W = io2::Writer>
 class WritableArchive final {
 	public:
-		WritableArchive(io2::Writer& writer) : _writer(writer) {
+		WritableArchive(W& writer) : _writer(writer) {
 		}
 
 		template<typename T, typename... Args>
@@ -88,7 +92,7 @@ class WritableArchive final {
 			return helper::serialize_array(*this, t, n);
 		}
 
-		FormattedWriter<Format>& writer() {
+		FormattedWriter<Format, W>& writer() {
 			return _writer;
 		}
 
@@ -109,9 +113,12 @@ class WritableArchive final {
 			return core::Ok();
 		}
 
-		FormattedWriter<Format> _writer;
+		FormattedWriter<Format, W> _writer;
 };
 
+template<typename W>
+WritableArchive(W&) -> WritableArchive<BinaryFormat, W>;
+
 
 }
 }
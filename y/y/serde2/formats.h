@@ -60,10 +60,10 @@ struct BinaryFormat {
 	}
 };
 
-template<typename Format = serde2::BinaryFormat>
+template<typename Format = serde2::BinaryFormat, typename R = io2::Reader>
 class FormattedReader : Format {
 	public:
-		FormattedReader(io2::Reader& reader) : _reader(reader) {
+		FormattedReader(R& reader) : _reader(reader) {
 		}
 
 		template<typename T>
@@ -79,14 +79,14 @@ class FormattedReader : Format {
 		}
 
 	private:
-		io2::Reader& _reader;
+		R& _reader;
 };
 
 
-template<typename Format = serde2::BinaryFormat>
+template<typename Format = serde2::BinaryFormat, typename W = io2::Writer>
 class FormattedWriter : Format {
 	public:
-		FormattedWriter(io2::Writer& writer) : _writer(writer) {
+		FormattedWriter(W& writer) : _writer(writer) {
 		}
 
 		template<typename T>
@@ -102,7 +102,7 @@ class FormattedWriter : Format {
 		}
 
 	private:
-		io2::Writer& _writer;
+		W& _writer;
 };
 
 }
@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include "formats.h"
 
+#include <y/core/Vector.h>
+#include <y/core/String.h>
+
 namespace y {
 namespace serde2 {
 
@@ -47,6 +50,10 @@ template<typename T>
 struct Deserializer {
 };
 
+// types read straight from the reader without going through deserialize or a Deserializer
+template<typename Arc, typename T>
+struct is_bulk_readable;
+
 template<typename T>
 struct Deserializer<std::unique_ptr<T>> {
 	template<typename Arc>
@@ -72,11 +79,20 @@ struct Deserializer<core::Vector<T, Args...>> {
 			return core::Err();
 		}
 		t.make_empty();
-		t.set_min_capacity(size);
-		for(u64 i = 0; i != size; ++i) {
-			t.emplace_back();
+		if constexpr(is_bulk_readable<Arc, T>::value) {
+			t.resize_uninitialized(size);
+			if(!ar.reader().read_array(t.data(), size)) {
+				t.make_empty();
+				return core::Err();
+			}
+			return core::Ok();
+		} else {
+			t.set_min_capacity(size);
+			for(u64 i = 0; i != size; ++i) {
+				t.emplace_back();
+			}
+			return deserialize_array(ar, t.data(), size);
 		}
-		return deserialize_array(ar, t.data(), size);
 	}
 };
 
@@ -129,6 +145,10 @@ using has_deserializer = bool_type<decltype(detail::has_deserializer<Arc, T>(nul
 template<typename Arc, typename T>
 using is_deserializable = bool_type<decltype(detail::has_deserialize<Arc, T>(nullptr))::value>;
 
+template<typename Arc, typename T>
+struct is_bulk_readable : bool_type<!is_deserializable<Arc, T>::value && !has_deserializer<Arc, T>::value> {
+};
+
 template<typename Arc, typename T>
 static Result deserialize_one(Arc& ar, T& t) {
 	if constexpr(is_deserializable<Arc, T>::value) {
@@ -0,0 +1,303 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "bench.h"
+
+#include <y/core/Chrono.h>
+#include <y/core/String.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static std::atomic<y::u64> allocations = 0;
+
+// y is a static library: this object is only linked into executables that call run_benchmarks,
+// so replacing the global allocation functions doesn't affect anything else.
+// Every other form of operator new/delete forwards to these.
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace y {
+namespace test {
+namespace detail {
+
+struct Bench {
+	const char* name;
+	void (*func)();
+};
+
+static core::Vector<Bench>& registered_benches() {
+	static core::Vector<Bench> benches;
+	return benches;
+}
+
+void register_bench(const char* name, void (*func)()) {
+	registered_benches() << Bench{name, func};
+}
+
+u64 allocation_count() {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+static double elapsed_ns(const core::Chrono& timer) {
+	return double(timer.elapsed().to_nanos());
+}
+
+static BenchResult run_bench(const Bench& bench, const BenchSettings& settings) {
+	// warmup also gives an estimate of how long an iteration takes
+	usize warmup_iterations = 0;
+	core::Chrono timer;
+	do {
+		bench.func();
+		++warmup_iterations;
+	} while(elapsed_ns(timer) < settings.warmup_ms * 1.0e6);
+	const double estimate_ns = elapsed_ns(timer) / warmup_iterations;
+
+	const usize samples = std::max(settings.samples, usize(1));
+	const double sample_ns = settings.min_time_ms * 1.0e6 / samples;
+	const usize iterations = std::max(usize(sample_ns / std::max(estimate_ns, 1.0)), usize(1));
+
+	core::Vector<double> times;
+	times.set_min_capacity(samples);
+
+	const u64 allocs = allocation_count();
+	for(usize s = 0; s != samples; ++s) {
+		timer.reset();
+		for(usize i = 0; i != iterations; ++i) {
+			bench.func();
+		}
+		times << elapsed_ns(timer) / iterations;
+	}
+	const u64 total_allocs = allocation_count() - allocs;
+
+	std::sort(times.begin(), times.end());
+
+	double mean = 0.0;
+	for(double t : times) {
+		mean += t;
+	}
+	mean /= samples;
+
+	double variance = 0.0;
+	for(double t : times) {
+		variance += (t - mean) * (t - mean);
+	}
+
+	BenchResult result;
+	result.name = bench.name;
+	result.samples = samples;
+	result.iterations = iterations;
+	result.median_ns = samples % 2 ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) * 0.5;
+	result.p95_ns = times[std::min(usize(std::ceil(samples * 0.95)), samples) - 1];
+	result.mean_ns = mean;
+	result.stddev_ns = samples > 1 ? std::sqrt(variance / (samples - 1)) : 0.0;
+	result.min_ns = times[0];
+	result.allocations = double(total_allocs) / double(samples * iterations);
+	return result;
+}
+
+static core::String format_time(double ns) {
+	char buffer[32];
+	if(ns < 1.0e3) {
+		std::snprintf(buffer, sizeof(buffer), "%.2fns", ns);
+	} else if(ns < 1.0e6) {
+		std::snprintf(buffer, sizeof(buffer), "%.2fus", ns / 1.0e3);
+	} else {
+		std::snprintf(buffer, sizeof(buffer), "%.2fms", ns / 1.0e6);
+	}
+	return buffer;
+}
+
+static void print_result(const BenchResult& r) {
+	usize len = std::strlen(r.name);
+	std::printf("%s:%*s median %10s  p95 %10s  stddev %10s  allocs %.2f\n",
+		r.name,
+		int(len < 48 ? 48 - len : 0), "",
+		format_time(r.median_ns).data(),
+		format_time(r.p95_ns).data(),
+		format_time(r.stddev_ns).data(),
+		r.allocations);
+}
+
+static void write_escaped(std::FILE* file, const char* str) {
+	for(; *str; ++str) {
+		if(*str == '"' || *str == '\\') {
+			std::fputc('\\', file);
+		}
+		std::fputc(*str, file);
+	}
+}
+
+// one benchmark per line so that read_json can stay trivial
+static bool write_json(const char* file_name, core::ArrayView<BenchResult> results) {
+	std::FILE* file = std::fopen(file_name, "w");
+	if(!file) {
+		return false;
+	}
+	std::fprintf(file, "{\n\t\"benchmarks\": [\n");
+	for(usize i = 0; i != results.size(); ++i) {
+		const BenchResult& r = results[i];
+		std::fprintf(file, "\t\t{\"name\": \"");
+		write_escaped(file, r.name);
+		std::fprintf(file, "\", \"samples\": %zu, \"iterations\": %zu, \"median_ns\": %.3f, \"p95_ns\": %.3f, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, \"min_ns\": %.3f, \"allocations\": %.3f}%s\n",
+			r.samples, r.iterations, r.median_ns, r.p95_ns, r.mean_ns, r.stddev_ns, r.min_ns, r.allocations,
+			i + 1 == results.size() ? "" : ",");
+	}
+	std::fprintf(file, "\t]\n}\n");
+	std::fclose(file);
+	return true;
+}
+
+struct Baseline {
+	core::String name;
+	double median_ns;
+};
+
+// only reads files written by write_json
+static core::Vector<Baseline> read_json(const char* file_name) {
+	core::Vector<Baseline> baselines;
+	std::FILE* file = std::fopen(file_name, "r");
+	if(!file) {
+		return baselines;
+	}
+
+	char line[4096];
+	while(std::fgets(line, sizeof(line), file)) {
+		const char* name = std::strstr(line, "\"name\": \"");
+		const char* median = std::strstr(line, "\"median_ns\": ");
+		if(!name || !median) {
+			continue;
+		}
+		core::String unescaped;
+		for(name += 9; *name && *name != '"'; ++name) {
+			if(*name == '\\' && name[1]) {
+				++name;
+			}
+			unescaped.push_back(*name);
+		}
+		baselines << Baseline{std::move(unescaped), std::strtod(median + 13, nullptr)};
+	}
+	std::fclose(file);
+	return baselines;
+}
+
+static bool compare(core::ArrayView<BenchResult> results, core::ArrayView<Baseline> baselines, double threshold) {
+	bool regressed = false;
+	std::printf("\ncompared to baseline (threshold %.1f%%):\n", threshold);
+	for(const BenchResult& r : results) {
+		auto it = std::find_if(baselines.begin(), baselines.end(), [&](const Baseline& b) { return b.name == r.name; });
+		if(it == baselines.end()) {
+			std::printf("%s: new\n", r.name);
+			continue;
+		}
+		double delta = (r.median_ns / it->median_ns - 1.0) * 100.0;
+		bool slower = delta > threshold;
+		regressed |= slower;
+		std::printf("%s: %s -> %s (%+.1f%%)%s\n", r.name, format_time(it->median_ns).data(), format_time(r.median_ns).data(), delta, slower ? "  REGRESSION" : "");
+	}
+	return !regressed;
+}
+
+}
+
+core::Vector<BenchResult> run_benchmarks(const BenchSettings& settings) {
+	core::Vector<BenchResult> results;
+	for(const auto& bench : detail::registered_benches()) {
+		if(settings.filter && !std::strstr(bench.name, settings.filter)) {
+			continue;
+		}
+		results << detail::run_bench(bench, settings);
+		detail::print_result(results.last());
+	}
+	return results;
+}
+
+int run_benchmarks(int argc, char** argv) {
+	BenchSettings settings;
+	const char* json = nullptr;
+	const char* baseline = nullptr;
+	double threshold = 10.0;
+
+	for(int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if(!value) {
+			std::fprintf(stderr, "missing value for %s\n", argv[i]);
+			return 2;
+		}
+		if(arg == "--filter") {
+			settings.filter = value;
+		} else if(arg == "--min-time") {
+			settings.min_time_ms = std::atof(value);
+		} else if(arg == "--json") {
+			json = value;
+		} else if(arg == "--compare") {
+			baseline = value;
+		} else if(arg == "--threshold") {
+			threshold = std::atof(value);
+		} else {
+			std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+			return 2;
+		}
+		++i;
+	}
+
+	core::Vector<detail::Baseline> baselines;
+	if(baseline) {
+		baselines = detail::read_json(baseline);
+		if(baselines.is_empty()) {
+			std::fprintf(stderr, "unable to read baseline \"%s\"\n", baseline);
+			return 2;
+		}
+	}
+
+	core::Vector<BenchResult> results = run_benchmarks(settings);
+
+	if(json && !detail::write_json(json, results)) {
+		std::fprintf(stderr, "unable to write \"%s\"\n", json);
+		return 2;
+	}
+	if(baseline && !detail::compare(results, baselines, threshold)) {
+		return 1;
+	}
+	return 0;
+}
+
+}
+}
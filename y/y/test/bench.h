@@ -0,0 +1,121 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef Y_TEST_BENCH_H
+#define Y_TEST_BENCH_H
+
+#include <y/utils.h>
+#include <y/core/Vector.h>
+
+#include <atomic>
+
+namespace y {
+namespace test {
+
+// Keeps the compiler from optimizing t (or the computation that produced it) away
+template<typename T>
+inline void do_not_optimize(T&& t) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&t) : "memory");
+#else
+	static volatile const void* sink = nullptr;
+	sink = &t;
+#endif
+}
+
+// Forces pending writes to memory to be considered observable
+inline void clobber_memory() {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : : "memory");
+#else
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+struct BenchResult {
+	const char* name = nullptr;
+
+	usize samples = 0;
+	usize iterations = 0;
+
+	// per iteration
+	double median_ns = 0.0;
+	double p95_ns = 0.0;
+	double mean_ns = 0.0;
+	double stddev_ns = 0.0;
+	double min_ns = 0.0;
+	double allocations = 0.0;
+};
+
+struct BenchSettings {
+	const char* filter = nullptr;
+	usize samples = 25;
+	double warmup_ms = 20.0;
+	double min_time_ms = 250.0;
+};
+
+core::Vector<BenchResult> run_benchmarks(const BenchSettings& settings = BenchSettings());
+
+// Runs every registered benchmark. Arguments:
+//   --filter <str>       only run benchmarks whose name contains str
+//   --min-time <ms>      measuring time per benchmark
+//   --json <file>        writes the results as json
+//   --compare <file>     compares the medians against a previous json output,
+//                        returns 1 if any regressed by more than --threshold percents (10 by default)
+int run_benchmarks(int argc, char** argv);
+
+namespace detail {
+
+void register_bench(const char* name, void (*func)());
+
+// number of calls to operator new since the start of the program (only counts in bench executables)
+u64 allocation_count();
+
+}
+}
+}
+
+#define Y_BENCH_FUNC y_create_name_with_prefix(bench_func)
+#define Y_BENCH_RUNNER y_create_name_with_prefix(bench_runner)
+
+#ifdef Y_BUILD_BENCHES
+
+#define y_bench_func(name)																				\
+static void Y_BENCH_FUNC();																				\
+namespace {																								\
+	class Y_BENCH_RUNNER {																				\
+		Y_BENCH_RUNNER() {																				\
+			y::test::detail::register_bench(name, &Y_BENCH_FUNC);										\
+		}																								\
+		static Y_BENCH_RUNNER runner;																	\
+	};																									\
+	Y_BENCH_RUNNER Y_BENCH_RUNNER::runner = Y_BENCH_RUNNER();											\
+}																										\
+void Y_BENCH_FUNC()
+
+#else
+
+#define y_bench_func(name)																				\
+[[maybe_unused]] static void Y_BENCH_FUNC()
+
+#endif
+
+#endif // Y_TEST_BENCH_H
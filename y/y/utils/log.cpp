@@ -22,19 +22,437 @@ SOFTWARE.
 #include "log.h"
 #include <y/utils.h>
 
-#include <mutex>
+#include <y/core/String.h>
+#include <y/core/Vector.h>
+#include <y/io/File.h>
 
-#include <iostream>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 namespace y {
 
 static constexpr std::array<const char*, 5> log_type_str = {{"info", "warning", "error", "debug", "perf"}};
 
+static constexpr usize ring_size = 64 * 1024;
+static constexpr usize max_msg_len = 8 * 1024;
+static constexpr u64 repeat_report_ns = 1000000000;
+
+enum class RecordKind : u8 {
+	Text,
+	Deferred,
+	Padding
+};
+
+struct RecordHeader {
+	u64 time_ns;
+	u32 size;
+	u16 length;
+	u8 type;
+	RecordKind kind;
+};
+
+static_assert(sizeof(RecordHeader) == 16);
+static_assert(sizeof(detail::deferred_fmt_t) <= 16);
+
+static usize record_size(usize payload_size) {
+	return (sizeof(RecordHeader) + payload_size + 15) & ~usize(15);
+}
+
+static u64 now_ns() {
+	return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void write_line(std::FILE* file, std::string_view line) {
+	std::fwrite(line.data(), 1, line.size(), file);
+}
+
+static std::FILE* output_file(Log type) {
+	return type == Log::Error || type == Log::Warning ? stderr : stdout;
+}
+
+
+// written by its thread, read by whoever holds the drain lock
+struct LogRing : NonMovable {
+	alignas(64) std::atomic<u64> head = 0;
+	alignas(64) std::atomic<u64> tail = 0;
+	std::atomic<bool> closed = false;
+	u32 thread = 0;
+
+	alignas(16) u8 data[ring_size];
+};
+
+class LogBackend : NonMovable {
+	struct Entry {
+		u64 time_ns;
+		u32 thread;
+		Log type;
+		core::String text;
+	};
+
+	public:
+		LogBackend();
+		~LogBackend();
+
+		std::shared_ptr<LogRing> create_ring();
+
+		void notify();
+		void flush();
+
+		bool set_file(const char* filename);
+		void set_handler(log_handler_t handler);
+
+	private:
+		void run();
+		void drain(bool flush_repeats);
+		void drain_ring(LogRing& ring);
+
+		void output(const Entry& entry);
+		void report_repeats();
+		void write(Log type, std::string_view line);
+
+		std::mutex _rings_lock;
+		// shared with the thread that writes in it, whichever is destroyed first
+		core::Vector<std::shared_ptr<LogRing>> _rings;
+		u32 _thread_ids = 0;
+
+		std::mutex _drain_lock;
+		core::Vector<Entry> _batch;
+		io::File _file;
+		log_handler_t _handler = nullptr;
+
+		core::String _last_text;
+		Log _last_type = Log::Info;
+		u64 _repeats = 0;
+		u64 _last_report_ns = 0;
+
+		core::String _line;
+		Log _line_type = Log::Info;
+
+		std::mutex _wait_lock;
+		std::condition_variable _condition;
+		// set by the first message pushed since the last drain
+		std::atomic<bool> _pending = false;
+		bool _stop = false;
+
+		std::thread _thread;
+};
+
+enum BackendState : u32 {
+	None,
+	Alive,
+	Destroyed
+};
+
+static std::atomic<u32> backend_state = None;
+
+static LogBackend* backend() {
+	if(backend_state.load(std::memory_order_acquire) == Destroyed) {
+		return nullptr;
+	}
+	static LogBackend backend;
+	return &backend;
+}
+
+LogBackend::LogBackend() : _thread([this] { run(); }) {
+	backend_state = Alive;
+}
+
+LogBackend::~LogBackend() {
+	// messages logged from now on are written synchronously
+	backend_state = Destroyed;
+	{
+		std::unique_lock lock(_wait_lock);
+		_stop = true;
+	}
+	_condition.notify_one();
+	_thread.join();
+
+	flush();
+}
+
+std::shared_ptr<LogRing> LogBackend::create_ring() {
+	auto ring = std::make_shared<LogRing>();
+
+	std::unique_lock lock(_rings_lock);
+	ring->thread = ++_thread_ids;
+	_rings << ring;
+	return ring;
+}
+
+void LogBackend::notify() {
+	if(!_pending.load(std::memory_order_relaxed) && !_pending.exchange(true)) {
+		// the lock makes sure the logging thread is either waiting or has yet to check _pending
+		std::unique_lock lock(_wait_lock);
+		_condition.notify_one();
+	}
+}
+
+void LogBackend::flush() {
+	drain(true);
+}
+
+bool LogBackend::set_file(const char* filename) {
+	std::unique_lock lock(_drain_lock);
+	if(!filename) {
+		_file = io::File();
+		return true;
+	}
+	if(auto file = io::File::create(filename)) {
+		_file = std::move(file.unwrap());
+		return true;
+	}
+	return false;
+}
+
+void LogBackend::set_handler(log_handler_t handler) {
+	std::unique_lock lock(_drain_lock);
+	_handler = handler;
+}
+
+void LogBackend::run() {
+	std::unique_lock lock(_wait_lock);
+	while(!_stop) {
+		// also wakes up to report repeated messages when nothing else is logged
+		_condition.wait_for(lock, std::chrono::nanoseconds(repeat_report_ns), [this] { return _stop || _pending; });
+		_pending = false;
+		lock.unlock();
+		drain(false);
+		lock.lock();
+	}
+}
+
+void LogBackend::drain(bool flush_repeats) {
+	std::unique_lock lock(_drain_lock);
+
+	{
+		std::unique_lock rings_lock(_rings_lock);
+		for(usize i = 0; i < _rings.size();) {
+			LogRing& ring = *_rings[i];
+			// closed needs to be read before head
+			const bool closed = ring.closed.load(std::memory_order_acquire);
+			drain_ring(ring);
+			if(closed) {
+				_rings.erase_unordered(_rings.begin() + i);
+			} else {
+				++i;
+			}
+		}
+	}
+
+	std::stable_sort(_batch.begin(), _batch.end(), [](const Entry& a, const Entry& b) { return a.time_ns < b.time_ns; });
+	for(const Entry& entry : _batch) {
+		output(entry);
+	}
+	_batch.make_empty();
+
+	if(_repeats && (flush_repeats || now_ns() - _last_report_ns > repeat_report_ns)) {
+		report_repeats();
+	}
+
+	write(_line_type, "");
+	std::fflush(stdout);
+	std::fflush(stderr);
+	if(_file.is_open()) {
+		_file.flush();
+	}
+}
+
+void LogBackend::drain_ring(LogRing& ring) {
+	const u64 head = ring.head.load(std::memory_order_acquire);
+	u64 tail = ring.tail.load(std::memory_order_relaxed);
+	while(tail != head) {
+		const u8* record = ring.data + (tail & (ring_size - 1));
+		const u8* payload = record + sizeof(RecordHeader);
+
+		RecordHeader header;
+		std::memcpy(&header, record, sizeof(header));
+		tail += header.size;
+
+		switch(header.kind) {
+			case RecordKind::Text:
+				_batch.emplace_back(Entry{header.time_ns, ring.thread, Log(header.type), core::String(reinterpret_cast<const char*>(payload), header.length)});
+			break;
+
+			case RecordKind::Deferred: {
+				detail::deferred_fmt_t format = nullptr;
+				std::memcpy(&format, payload, sizeof(format));
+				_batch.emplace_back(Entry{header.time_ns, ring.thread, Log(header.type), format(payload + 16)});
+			} break;
+
+			default:
+			break;
+		}
+	}
+	ring.tail.store(tail, std::memory_order_release);
+}
+
+void LogBackend::output(const Entry& entry) {
+	if(_file.is_open()) {
+		const usize len = std::min(entry.text.size(), max_msg_len);
+		const BinaryLogEntry header{entry.time_ns, entry.thread, u16(len), u8(entry.type), 0};
+		_file.write(&header, sizeof(header));
+		_file.write(entry.text.data(), len);
+	}
+
+	if(_handler) {
+		_handler(entry.text, entry.type);
+		return;
+	}
+
+	if(entry.type == _last_type && entry.text == _last_text) {
+		++_repeats;
+		if(entry.time_ns - _last_report_ns > repeat_report_ns) {
+			report_repeats();
+		}
+		return;
+	}
+
+	report_repeats();
+	write(entry.type, fmt("[%] %\n", log_type_str[usize(entry.type)], entry.text));
+
+	_last_type = entry.type;
+	_last_text = entry.text;
+	_last_report_ns = entry.time_ns;
+}
+
+void LogBackend::report_repeats() {
+	if(_repeats) {
+		write(_last_type, fmt("[%] last message repeated % times\n", log_type_str[usize(_last_type)], _repeats));
+		_repeats = 0;
+	}
+	_last_report_ns = now_ns();
+}
+
+// lines are batched until the output stream changes
+void LogBackend::write(Log type, std::string_view line) {
+	if(output_file(type) != output_file(_line_type) || line.empty()) {
+		write_line(output_file(_line_type), _line);
+		_line.make_empty();
+	}
+	_line_type = type;
+	_line += line;
+}
+
+
+static LogRing* thread_ring() {
+	static thread_local LogRing* ring = nullptr;
+	static thread_local bool exited = false;
+
+	if(!ring && !exited) {
+		if(LogBackend* b = backend()) {
+			static thread_local struct Closer {
+				std::shared_ptr<LogRing> owned;
+
+				~Closer() {
+					if(owned) {
+						owned->closed.store(true, std::memory_order_release);
+					}
+					ring = nullptr;
+					exited = true;
+				}
+			} closer;
+
+			closer.owned = b->create_ring();
+			ring = closer.owned.get();
+		}
+	}
+	return ring;
+}
+
+template<typename F>
+static bool push_record(Log type, RecordKind kind, usize payload_size, usize length, F&& fill) {
+	LogRing* ring = thread_ring();
+	if(!ring || !backend()) {
+		return false;
+	}
+
+	const usize size = record_size(payload_size);
+	u64 head = ring->head.load(std::memory_order_relaxed);
+	usize offset = head & (ring_size - 1);
+	const usize padding = offset + size > ring_size ? ring_size - offset : 0;
+
+	u64 tail = ring->tail.load(std::memory_order_acquire);
+	while(ring_size - (head - tail) < size + padding) {
+		LogBackend* b = backend();
+		if(!b) {
+			// nothing will drain the ring anymore
+			return false;
+		}
+		b->notify();
+		std::this_thread::yield();
+		tail = ring->tail.load(std::memory_order_acquire);
+	}
+
+	if(padding) {
+		const RecordHeader header{0, u32(padding), 0, 0, RecordKind::Padding};
+		std::memcpy(ring->data + offset, &header, sizeof(header));
+		head += padding;
+		offset = 0;
+	}
+
+	const RecordHeader header{now_ns(), u32(size), u16(length), u8(type), kind};
+	std::memcpy(ring->data + offset, &header, sizeof(header));
+	fill(ring->data + offset + sizeof(header));
+
+	head += size;
+	ring->head.store(head, std::memory_order_release);
+
+	if(LogBackend* b = backend()) {
+		b->notify();
+	}
+	return true;
+}
+
 void log_msg(std::string_view msg, Log type) {
-	static std::mutex lock;
-	std::lock_guard<decltype(lock)> _(lock);
+	const usize len = std::min(msg.size(), max_msg_len);
+	const bool pushed = push_record(type, RecordKind::Text, len, len, [&](u8* payload) {
+		std::memcpy(payload, msg.data(), len);
+	});
+
+	if(!pushed) {
+		// logging while or after the backend is destroyed
+		write_line(output_file(type), fmt("[%] %\n", log_type_str[usize(type)], msg));
+	} else if(type == Log::Error) {
+		flush_log();
+	}
+}
+
+void flush_log() {
+	if(LogBackend* b = backend()) {
+		b->flush();
+	}
+}
 
-	(type == Log::Error || type == Log::Warning ? std::cerr : std::cout) << "[" << log_type_str[usize(type)] << "] " << msg << std::endl;
+bool set_log_file(const char* filename) {
+	if(LogBackend* b = backend()) {
+		return b->set_file(filename);
+	}
+	return false;
+}
+
+void set_log_handler(log_handler_t handler) {
+	if(LogBackend* b = backend()) {
+		b->set_handler(handler);
+	}
+}
+
+namespace detail {
+void log_deferred(deferred_fmt_t format, const void* args, usize size, Log type) {
+	const bool pushed = push_record(type, RecordKind::Deferred, size + 16, 0, [&](u8* payload) {
+		std::memcpy(payload, &format, sizeof(format));
+		std::memcpy(payload + 16, args, size);
+	});
+
+	if(!pushed) {
+		log_msg(format(args), type);
+	}
+}
 }
 
 }
@@ -34,9 +34,64 @@ enum class Log {
 	Perf
 };
 
-
+// Messages are pushed into a per thread ring buffer and written by a background thread.
+// Consecutive identical messages are collapsed into a single "repeated" line.
 void log_msg(std::string_view msg, Log type = Log::Info);
 
+// Writes all pending messages before returning
+void flush_log();
+
+// Also writes every message to a binary log file: a sequence of BinaryLogEntry each followed by its text
+// nullptr closes the current file
+bool set_log_file(const char* filename);
+
+// Called by the logging thread with every message instead of writing it to stdout or stderr.
+// Messages are not collapsed, the binary log file is still written. nullptr restores the default output
+using log_handler_t = void (*)(std::string_view msg, Log type);
+void set_log_handler(log_handler_t handler);
+
+struct BinaryLogEntry {
+	u64 time_ns;
+	u32 thread;
+	u16 length;
+	u8 type;
+	u8 padding;
+};
+
+
+namespace detail {
+using deferred_fmt_t = std::string_view (*)(const void*);
+
+void log_deferred(deferred_fmt_t format, const void* args, usize size, Log type);
+
+template<typename T>
+static constexpr bool is_deferrable_v = std::is_arithmetic_v<T> && alignof(T) <= sizeof(u64);
+
+template<typename... Args>
+struct DeferredFmt {
+	const char* fmt;
+	std::tuple<Args...> args;
+
+	static std::string_view format(const void* data) {
+		const DeferredFmt* self = static_cast<const DeferredFmt*>(data);
+		return std::apply([=](const auto&... args) { return y::fmt(self->fmt, args...); }, self->args);
+	}
+};
+}
+
+// Like log_msg(fmt(...)) but arithmetic arguments are formatted by the logging thread.
+// fmt must outlive the program (a string literal)
+template<typename... Args>
+void log_fmt(Log type, const char* fmt, Args&&... args) {
+	if constexpr((detail::is_deferrable_v<std::decay_t<Args>> && ...)) {
+		using Deferred = detail::DeferredFmt<std::decay_t<Args>...>;
+		const Deferred deferred{fmt, {args...}};
+		detail::log_deferred(&Deferred::format, &deferred, sizeof(deferred), type);
+	} else {
+		log_msg(y::fmt(fmt, y_fwd(args)...), type);
+	}
+}
+
 }
 
 #endif // Y_UTILS_LOG_H
@@ -21,136 +21,646 @@ SOFTWARE.
 **********************************/
 
 #include "perf.h"
-#include <y/core/Chrono.h>
+
+#include <y/core/FlatHashMap.h>
+#include <y/core/String.h>
 #include <y/io/File.h>
 
-#include <thread>
+#include <atomic>
 #include <mutex>
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 
-#include <list>
-
-#include "os.h"
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define Y_PERF_RDTSC
+#endif
 
 namespace y {
 namespace perf {
 
-#ifdef Y_PERF_LOG_ENABLED
-static constexpr usize buffer_size = 16 * 1024;
-static constexpr usize print_buffer_len = 512;
+static constexpr usize max_zones = 4096;
+static constexpr usize zones_per_page = 64;
+static constexpr usize max_depth = 128;
+static constexpr usize events_per_buffer = 4096;
+static constexpr usize bucket_count = 80;
 
-static std::mutex mutex;
-static bool initialized = false;
-static std::shared_ptr<io::File> output = std::make_shared<io::File>();
-#endif
+static constexpr u32 capture_version = 1;
+static constexpr std::array<char, 4> capture_magic = {{'y', 'p', 'r', 'f'}};
 
-void set_output_file(const char* out) {
-	unused(out);
-#ifdef Y_PERF_LOG_ENABLED
-	std::unique_lock lock(mutex);
-	initialized = false;
-	*output = std::move(io::File::create(out).expected("Unable to open output file."));
+
+enum class EventType : u32 {
+	Enter,
+	Leave,
+	Instant
+};
+
+enum class BlockType : u32 {
+	Zone,
+	Clock,
+	Events
+};
+
+struct Event {
+	u64 ticks;
+	u32 zone;
+	EventType type;
+};
+
+struct CaptureHeader {
+	std::array<char, 4> magic;
+	u32 version;
+};
+
+struct BlockHeader {
+	BlockType type;
+	u32 size;
+};
+
+struct ClockBlock {
+	u64 ticks;
+	u64 nanos;
+};
+
+// followed by the category and the name
+struct ZoneBlock {
+	u32 id;
+	u32 category_len;
+	u32 name_len;
+};
+
+// followed by the events
+struct EventsBlock {
+	u32 thread;
+	u32 count;
+};
+
+
+static u64 nanos() {
+	return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static u64 ticks() {
+#ifdef Y_PERF_RDTSC
+	return __rdtsc();
+#else
+	return nanos();
 #endif
 }
 
-#ifdef Y_PERF_LOG_ENABLED
+static ClockBlock clock() {
+	return ClockBlock{ticks(), nanos()};
+}
+
+static double nanos_per_tick(const ClockBlock& start, const ClockBlock& end) {
+	if(end.ticks <= start.ticks || end.nanos <= start.nanos) {
+		return 1.0;
+	}
+	return double(end.nanos - start.nanos) / double(end.ticks - start.ticks);
+}
+
+// 2 buckets per power of 2
+static usize bucket_index(u64 ticks) {
+	if(ticks < 2) {
+		return usize(ticks);
+	}
+	const usize octave = 63 - __builtin_clzll(ticks);
+	const usize sub = (ticks >> (octave - 1)) & 1;
+	return std::min(octave * 2 + sub, bucket_count - 1);
+}
 
-static double micros() {
-	return core::Chrono::program().to_micros();
+static u64 bucket_start(usize index) {
+	if(index < 2) {
+		return index;
+	}
+	return u64(2 + index % 2) << (index / 2 - 1);
 }
 
-static u32 thread_id() {
-	static u32 id = 0;
-	static thread_local u32 tid = ++id;
-	return tid;
+
+struct Zone {
+	core::String name;
+	core::String category;
+};
+
+struct ZoneCounters : NonMovable {
+	std::atomic<u64> count = 0;
+	std::atomic<u64> total = 0;
+	std::atomic<u64> min = u64(-1);
+	std::atomic<u64> max = 0;
+	std::array<std::atomic<u32>, bucket_count> buckets = {};
+
+	void clear() {
+		count.store(0, std::memory_order_relaxed);
+		total.store(0, std::memory_order_relaxed);
+		min.store(u64(-1), std::memory_order_relaxed);
+		max.store(0, std::memory_order_relaxed);
+		for(auto& b : buckets) {
+			b.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// only called by the owning thread
+	void add(u64 ticks) {
+		count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		total.store(total.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+		min.store(std::min(min.load(std::memory_order_relaxed), ticks), std::memory_order_relaxed);
+		max.store(std::max(max.load(std::memory_order_relaxed), ticks), std::memory_order_relaxed);
+		auto& bucket = buckets[bucket_index(ticks)];
+		bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+};
+
+struct StatsPage : NonMovable {
+	std::array<ZoneCounters, zones_per_page> zones;
+};
+
+struct ThreadStats : NonMovable {
+	std::array<std::atomic<StatsPage*>, max_zones / zones_per_page> pages = {};
+	std::atomic<u32> epoch = 0;
+
+	~ThreadStats() {
+		for(auto& page : pages) {
+			delete page.load();
+		}
+	}
+};
+
+struct ZoneAggregate {
+	u64 count = 0;
+	u64 total = 0;
+	u64 min = u64(-1);
+	u64 max = 0;
+	std::array<u64, bucket_count> buckets = {};
+
+	void add(const ZoneCounters& counters) {
+		count += counters.count.load(std::memory_order_relaxed);
+		total += counters.total.load(std::memory_order_relaxed);
+		min = std::min(min, counters.min.load(std::memory_order_relaxed));
+		max = std::max(max, counters.max.load(std::memory_order_relaxed));
+		for(usize i = 0; i != bucket_count; ++i) {
+			buckets[i] += counters.buckets[i].load(std::memory_order_relaxed);
+		}
+	}
+
+	u64 percentile(double p) const {
+		const u64 target = std::max(u64(1), u64(p * count + 0.5));
+		u64 acc = 0;
+		for(usize i = 0; i != bucket_count; ++i) {
+			acc += buckets[i];
+			if(acc >= target) {
+				const u64 mid = (bucket_start(i) + bucket_start(i + 1)) / 2;
+				return std::min(std::max(mid, min), max);
+			}
+		}
+		return max;
+	}
+};
+
+
+// never destroyed: threads might still record during static destruction
+struct Profiler : NonMovable {
+	std::mutex zones_lock;
+	core::FlatHashMap<core::String, u32> zone_ids;
+	std::array<std::atomic<const Zone*>, max_zones> zones = {};
+	std::atomic<u32> zone_count = 0;
+
+	std::mutex stats_lock;
+	core::Vector<ThreadStats*> threads;
+	core::Vector<ZoneAggregate> retired;
+	std::atomic<u32> epoch = 0;
+	const ClockBlock start = clock();
+
+	std::mutex file_lock;
+	io::File file;
+	std::atomic<bool> capturing = false;
+	u32 thread_ids = 0;
+
+	template<typename T>
+	void write_block(BlockType type, const T& block, usize extra_size = 0) {
+		const BlockHeader header{type, u32(sizeof(T) + extra_size)};
+		file.write(&header, sizeof(header));
+		file.write(&block, sizeof(block));
+	}
+
+	void write_zone(u32 id, const Zone& zone) {
+		write_block(BlockType::Zone, ZoneBlock{id, u32(zone.category.size()), u32(zone.name.size())}, zone.category.size() + zone.name.size());
+		file.write(zone.category.data(), zone.category.size());
+		file.write(zone.name.data(), zone.name.size());
+	}
+};
+
+static Profiler& profiler() {
+	static Profiler* profiler = new Profiler();
+	return *profiler;
 }
 
-#warning TLS destructors not called on windows
 
 static thread_local struct ThreadData : NonMovable {
-	std::shared_ptr<io::File> keep_alive;
-	std::unique_ptr<char[]> buffer;
-	usize buffer_offset = 0;
-	u32 tid = 0;
+	u32 id = 0;
+	std::unique_ptr<ThreadStats> stats;
 
-	ThreadData() :
-			keep_alive(output),
-			buffer(std::make_unique<char[]>(buffer_size)),
-			tid(thread_id()) {
+	std::array<std::pair<u32, u64>, max_depth> stack;
+	usize depth = 0;
+
+	std::unique_ptr<Event[]> events;
+	usize event_count = 0;
+
+	ThreadData() : stats(std::make_unique<ThreadStats>()) {
+		Profiler& prof = profiler();
+		{
+			std::unique_lock lock(prof.file_lock);
+			id = ++prof.thread_ids;
+		}
+		std::unique_lock lock(prof.stats_lock);
+		stats->epoch = prof.epoch.load();
+		prof.threads << stats.get();
 	}
 
 	~ThreadData() {
-		char b[print_buffer_len];
-		usize len = std::snprintf(b, sizeof(b), R"({"name":"thread closed","cat":"perf","ph":"i","pid":0,"tid":%u,"ts":%f}]})", tid, micros());
-		if(len >= sizeof(b)) {
-			y_fatal("Too long.");
+		write_events();
+
+		Profiler& prof = profiler();
+		std::unique_lock lock(prof.stats_lock);
+		prof.threads.erase_unordered(std::find(prof.threads.begin(), prof.threads.end(), stats.get()));
+		if(stats->epoch.load() == prof.epoch.load()) {
+			for(usize i = 0; i != stats->pages.size(); ++i) {
+				if(const StatsPage* page = stats->pages[i].load()) {
+					prof.retired.set_min_capacity((i + 1) * zones_per_page);
+					while(prof.retired.size() < (i + 1) * zones_per_page) {
+						prof.retired.emplace_back();
+					}
+					for(usize k = 0; k != zones_per_page; ++k) {
+						prof.retired[i * zones_per_page + k].add(page->zones[k]);
+					}
+				}
+			}
 		}
-		write(b, len);
-		write_buffer();
-		if(output->is_open()) {
-			output->flush();
+	}
+
+	void record(u32 zone, EventType type, u64 t) {
+		if(!profiler().capturing.load(std::memory_order_relaxed)) {
+			return;
+		}
+		if(!events) {
+			events = std::make_unique<Event[]>(events_per_buffer);
+		}
+		events[event_count++] = Event{t, zone, type};
+		if(event_count == events_per_buffer) {
+			write_events();
 		}
 	}
 
-	void write(const char* str, usize len) {
-		usize remaining = buffer_size - buffer_offset;
-		if(len >= remaining) {
-			write_buffer();
+	void write_events() {
+		if(!event_count) {
+			return;
+		}
+
+		Profiler& prof = profiler();
+		std::unique_lock lock(prof.file_lock);
+		if(prof.file.is_open()) {
+			prof.write_block(BlockType::Clock, clock());
+			prof.write_block(BlockType::Events, EventsBlock{id, u32(event_count)}, event_count * sizeof(Event));
+			prof.file.write(events.get(), event_count * sizeof(Event));
 		}
-		std::memcpy(buffer.get() + buffer_offset, str, len);
-		buffer_offset += len;
+		event_count = 0;
 	}
 
-	void write_buffer() {
-		std::unique_lock lock(mutex);
-		if(output->is_open() && buffer) {
-			if(!initialized) {
-				initialized = true;
-				const char beg[] = R"({"traceEvents":[)";
-				output->write(beg, sizeof(beg) - 1);
+	void add_sample(u32 zone, u64 ticks) {
+		const u32 epoch = profiler().epoch.load(std::memory_order_relaxed);
+		if(stats->epoch.load(std::memory_order_relaxed) != epoch) {
+			for(auto& page : stats->pages) {
+				if(StatsPage* p = page.load(std::memory_order_relaxed)) {
+					for(auto& z : p->zones) {
+						z.clear();
+					}
+				}
 			}
-			output->write(buffer.get(), buffer_offset);
-			buffer_offset = 0;
-			event("perf", "done writing buffer");
+			stats->epoch.store(epoch, std::memory_order_release);
+		}
+
+		auto& page = stats->pages[zone / zones_per_page];
+		StatsPage* p = page.load(std::memory_order_relaxed);
+		if(!p) {
+			p = new StatsPage();
+			page.store(p, std::memory_order_release);
 		}
+		p->zones[zone % zones_per_page].add(ticks);
 	}
 } thread_data;
 
-static int paren(const char* buff) {
-	if(const char* p = std::strchr(buff, '('); p) {
-		return p - buff;
+
+void set_output_file(const char* out) {
+	Profiler& prof = profiler();
+	std::unique_lock zones_lock(prof.zones_lock);
+	std::unique_lock lock(prof.file_lock);
+
+	prof.file = std::move(io::File::create(out).expected("Unable to open output file."));
+
+	const CaptureHeader header{capture_magic, capture_version};
+	prof.file.write(&header, sizeof(header));
+	prof.write_block(BlockType::Clock, clock());
+	for(u32 i = 0; i != prof.zone_count; ++i) {
+		prof.write_zone(i, *prof.zones[i].load());
 	}
-	return print_buffer_len;
+
+	prof.capturing = true;
 }
 
-void enter(const char* cat, const char* func) {
-	char b[print_buffer_len];
-	usize len = std::snprintf(b, sizeof(b), R"({"name":"%.*s","cat":"%s","ph":"B","pid":0,"tid":%u,"ts":%f},)", paren(func), func, cat, thread_data.tid, micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+void flush() {
+	thread_data.write_events();
+
+	Profiler& prof = profiler();
+	std::unique_lock lock(prof.file_lock);
+	if(prof.file.is_open()) {
+		prof.file.flush();
 	}
-	thread_data.write(b, len);
 }
 
-void leave(const char* cat, const char* func) {
-	char b[print_buffer_len];
-	usize len = std::snprintf(b, sizeof(b), R"({"name":"%.*s","cat":"%s","ph":"E","pid":0,"tid":%u,"ts":%f},)", paren(func), func, cat, thread_data.tid, micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+static u32 intern_zone(std::string_view name, std::string_view category) {
+	Profiler& prof = profiler();
+	std::unique_lock lock(prof.zones_lock);
+
+	core::String key = core::String(category) + "\x1f" + name;
+	if(auto it = prof.zone_ids.find(key); it != prof.zone_ids.end()) {
+		return it->second;
+	}
+
+	const u32 id = prof.zone_count;
+	if(id == max_zones) {
+		y_fatal("Too many profiling zones.");
+	}
+
+	const Zone* zone = new Zone{name, category};
+	prof.zones[id].store(zone, std::memory_order_release);
+	prof.zone_count.store(id + 1, std::memory_order_release);
+	prof.zone_ids.emplace(std::move(key), id);
+
+	std::unique_lock file_lock(prof.file_lock);
+	if(prof.file.is_open()) {
+		prof.write_zone(id, *zone);
+	}
+
+	return id;
+}
+
+u32 zone_id(std::string_view name, std::string_view category) {
+	name = name.substr(0, name.find('('));
+	const u64 hash = std::hash<std::string_view>()(name) ^ (std::hash<std::string_view>()(category) * 0x9E3779B97F4A7C15);
+
+	static thread_local core::FlatHashMap<u64, u32> cache;
+	if(auto it = cache.find(hash); it != cache.end()) {
+		const Zone* zone = profiler().zones[it->second].load(std::memory_order_acquire);
+		if(name == std::string_view(zone->name) && category == std::string_view(zone->category)) {
+			return it->second;
+		}
+	}
+
+	const u32 id = intern_zone(name, category);
+	cache[hash] = id;
+	return id;
+}
+
+void enter(u32 zone) {
+	ThreadData& data = thread_data;
+	const u64 t = ticks();
+	if(data.depth < max_depth) {
+		data.stack[data.depth] = {zone, t};
+	}
+	++data.depth;
+	data.record(zone, EventType::Enter, t);
+}
+
+void leave(u32 zone) {
+	ThreadData& data = thread_data;
+	const u64 t = ticks();
+	data.record(zone, EventType::Leave, t);
+	if(data.depth && --data.depth < max_depth) {
+		const auto [start_zone, start] = data.stack[data.depth];
+		if(start_zone == zone) {
+			data.add_sample(zone, t - start);
+		}
 	}
-	thread_data.write(b, len);
+}
+
+void event(u32 zone) {
+	thread_data.record(zone, EventType::Instant, ticks());
+}
+
+void enter(const char* cat, const char* func) {
+	enter(zone_id(func, cat));
+}
+
+void leave(const char* cat, const char* func) {
+	leave(zone_id(func, cat));
 }
 
 void event(const char* cat, const char* name) {
-	char b[print_buffer_len];
-	usize len = std::snprintf(b, sizeof(b), R"({"name":"%s","cat":"%s","ph":"i","pid":0,"tid":%u,"ts":%f},)", name, cat, thread_data.tid, micros());
-	if(len >= sizeof(b)) {
-		y_fatal("Too long.");
+	event(zone_id(name, cat));
+}
+
+u32 create_track() {
+	Profiler& prof = profiler();
+	std::unique_lock lock(prof.file_lock);
+	return ++prof.thread_ids;
+}
+
+u64 now() {
+	return ticks();
+}
+
+u64 nanos_to_ticks(u64 nanos) {
+	return u64(nanos / nanos_per_tick(profiler().start, clock()));
+}
+
+void track_zone(u32 track, u32 zone, u64 begin, u64 end) {
+	end = std::max(begin, end);
+	thread_data.add_sample(zone, end - begin);
+
+	Profiler& prof = profiler();
+	if(!prof.capturing.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	const std::array<Event, 2> events = {{{begin, zone, EventType::Enter}, {end, zone, EventType::Leave}}};
+	std::unique_lock lock(prof.file_lock);
+	if(prof.file.is_open()) {
+		prof.write_block(BlockType::Events, EventsBlock{track, u32(events.size())}, sizeof(events));
+		prof.file.write(events.data(), sizeof(events));
 	}
-	thread_data.write(b, len);
 }
 
-#endif
+
+core::Vector<ZoneStats> zone_stats() {
+	Profiler& prof = profiler();
+	const u32 zone_count = prof.zone_count.load(std::memory_order_acquire);
+
+	core::Vector<ZoneAggregate> aggregates(usize(zone_count), ZoneAggregate{});
+	{
+		std::unique_lock lock(prof.stats_lock);
+		const u32 epoch = prof.epoch.load();
+		for(usize i = 0; i != std::min(usize(zone_count), prof.retired.size()); ++i) {
+			aggregates[i] = prof.retired[i];
+		}
+		for(const ThreadStats* stats : prof.threads) {
+			if(stats->epoch.load(std::memory_order_acquire) != epoch) {
+				continue;
+			}
+			for(usize i = 0; i < zone_count; i += zones_per_page) {
+				if(const StatsPage* page = stats->pages[i / zones_per_page].load(std::memory_order_acquire)) {
+					for(usize k = 0; k != zones_per_page && i + k < zone_count; ++k) {
+						aggregates[i + k].add(page->zones[k]);
+					}
+				}
+			}
+		}
+	}
+
+	const double ns_per_tick = nanos_per_tick(prof.start, clock());
+	auto to_nanos = [=](u64 t) { return u64(t * ns_per_tick); };
+
+	core::Vector<ZoneStats> stats;
+	for(u32 i = 0; i != zone_count; ++i) {
+		const ZoneAggregate& agg = aggregates[i];
+		if(!agg.count) {
+			continue;
+		}
+
+		const Zone* zone = prof.zones[i].load(std::memory_order_acquire);
+		ZoneStats& s = stats.emplace_back();
+		s.name = zone->name;
+		s.category = zone->category;
+		s.count = agg.count;
+		s.total_ns = to_nanos(agg.total);
+		s.min_ns = to_nanos(agg.min);
+		s.max_ns = to_nanos(agg.max);
+		s.p50_ns = to_nanos(agg.percentile(0.5));
+		s.p90_ns = to_nanos(agg.percentile(0.9));
+		s.p99_ns = to_nanos(agg.percentile(0.99));
+	}
+	return stats;
+}
+
+void reset_zone_stats() {
+	Profiler& prof = profiler();
+	std::unique_lock lock(prof.stats_lock);
+	prof.retired.clear();
+	++prof.epoch;
+}
+
+
+static void write_json_string(io::File& out, std::string_view str) {
+	for(char c : str) {
+		if(c == '"' || c == '\\') {
+			out.write("\\", 1);
+		}
+		out.write(&c, 1);
+	}
+}
+
+bool capture_to_json(const char* capture, const char* json) {
+	auto in = io::File::open(capture);
+	if(!in) {
+		return false;
+	}
+	core::Vector<u8> data;
+	in.unwrap().read_all(data);
+
+	CaptureHeader header;
+	if(data.size() < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+	if(header.magic != capture_magic || header.version != capture_version) {
+		return false;
+	}
+
+	core::Vector<Zone> zones;
+	core::Vector<std::pair<u32, Event>> events;
+	ClockBlock first = {};
+	ClockBlock last = {};
+	bool has_clock = false;
+
+	for(usize offset = sizeof(header); offset + sizeof(BlockHeader) <= data.size();) {
+		BlockHeader block;
+		std::memcpy(&block, data.data() + offset, sizeof(block));
+		offset += sizeof(block);
+		if(offset + block.size > data.size()) {
+			return false;
+		}
+
+		const u8* payload = data.data() + offset;
+		offset += block.size;
+
+		switch(block.type) {
+			case BlockType::Clock: {
+				std::memcpy(&last, payload, sizeof(last));
+				if(!has_clock) {
+					first = last;
+					has_clock = true;
+				}
+			} break;
+
+			case BlockType::Zone: {
+				ZoneBlock zone;
+				std::memcpy(&zone, payload, sizeof(zone));
+				const char* str = reinterpret_cast<const char*>(payload + sizeof(zone));
+				while(zones.size() <= zone.id) {
+					zones.emplace_back();
+				}
+				zones[zone.id] = Zone{core::String(str + zone.category_len, zone.name_len), core::String(str, zone.category_len)};
+			} break;
+
+			case BlockType::Events: {
+				EventsBlock thread;
+				std::memcpy(&thread, payload, sizeof(thread));
+				for(usize i = 0; i != thread.count; ++i) {
+					Event e;
+					std::memcpy(&e, payload + sizeof(thread) + i * sizeof(Event), sizeof(e));
+					events.emplace_back(thread.thread, e);
+				}
+			} break;
+
+			default:
+			break;
+		}
+	}
+
+	auto out = io::File::create(json);
+	if(!out) {
+		return false;
+	}
+	io::File& file = out.unwrap();
+
+	const Zone unknown_zone;
+	const double ns_per_tick = nanos_per_tick(first, last);
+	const std::array<const char*, 3> phases = {{"B", "E", "i"}};
+
+	const char beg[] = R"({"traceEvents":[)";
+	file.write(beg, sizeof(beg) - 1);
+	for(usize i = 0; i != events.size(); ++i) {
+		const auto& [thread, e] = events[i];
+		const Zone& zone = e.zone < zones.size() ? zones[e.zone] : unknown_zone;
+
+		file.write(R"({"name":")", 9);
+		write_json_string(file, zone.name);
+		file.write(R"(","cat":")", 9);
+		write_json_string(file, zone.category);
+
+		char b[128];
+		const double micros = (double(e.ticks) - double(first.ticks)) * ns_per_tick / 1000.0;
+		const int len = std::snprintf(b, sizeof(b), R"(","ph":"%s","pid":0,"tid":%u,"ts":%f}%s)", phases[usize(e.type) % phases.size()], thread, micros, i + 1 == events.size() ? "" : ",");
+		file.write(b, usize(len));
+	}
+	const char end[] = "]}";
+	file.write(end, sizeof(end) - 1);
+
+	return true;
+}
 
 }
 }
@@ -23,38 +23,80 @@ SOFTWARE.
 #define Y_UTILS_PERF_H
 
 #include <y/utils.h>
-#include <memory>
+#include <y/core/Vector.h>
 
 namespace y {
 namespace perf {
 
-// For use with chrome://tracing
+// Zones are recorded as binary events into per thread buffers.
+// Captures can be converted for chrome://tracing using perf2json (or capture_to_json).
 
 void set_output_file(const char* out);
+bool capture_to_json(const char* capture, const char* json);
+
+// Writes the calling thread's pending events
+void flush();
+
+// Zone names are interned, everything after the first '(' is dropped
+u32 zone_id(std::string_view name, std::string_view category = "");
+
+void enter(u32 zone);
+void leave(u32 zone);
+void event(u32 zone);
 
 void enter(const char* cat, const char* func);
 void leave(const char* cat, const char* func);
 void event(const char* cat, const char* name);
 
-inline auto log_func(const char* func, const char* cat = "") {
-	class Logger : NonCopyable {
-		const char* _cat;
-		const char* _func;
-		public:
-			Logger(const char* cat, const char* func) : _cat(cat), _func(func) {
-				enter(cat, func);
-			}
-			~Logger() {
-				leave(_cat, _func);
-			}
-	};
-
-	return Logger(cat, func);
-}
+
+// Work that doesn't run on a CPU thread (GPU passes for example) is recorded on a track of its own.
+// begin and end are profiler ticks, built from now() and nanos_to_ticks()
+u32 create_track();
+u64 now();
+u64 nanos_to_ticks(u64 nanos);
+void track_zone(u32 track, u32 zone, u64 begin, u64 end);
+
+
+// Durations are aggregated for every zone, percentiles are approximated from a log histogram
+struct ZoneStats {
+	std::string_view name;
+	std::string_view category;
+
+	u64 count = 0;
+	u64 total_ns = 0;
+	u64 min_ns = 0;
+	u64 max_ns = 0;
+
+	u64 p50_ns = 0;
+	u64 p90_ns = 0;
+	u64 p99_ns = 0;
+
+	u64 mean_ns() const {
+		return count ? total_ns / count : 0;
+	}
+};
+
+core::Vector<ZoneStats> zone_stats();
+void reset_zone_stats();
+
+
+class ZoneScope : NonCopyable {
+	public:
+		ZoneScope(u32 zone) : _zone(zone) {
+			enter(zone);
+		}
+
+		~ZoneScope() {
+			leave(_zone);
+		}
+
+	private:
+		u32 _zone;
+};
 
 #ifdef Y_PERF_LOG_ENABLED
-#define y_profile() auto y_create_name_with_prefix(prof) = y::perf::log_func(__PRETTY_FUNCTION__)
-#define y_profile_zone(name) auto y_create_name_with_prefix(prof) = y::perf::log_func(name)
+#define y_profile() static const y::u32 y_create_name_with_prefix(zone) = y::perf::zone_id(__PRETTY_FUNCTION__); y::perf::ZoneScope y_create_name_with_prefix(prof)(y_create_name_with_prefix(zone))
+#define y_profile_zone(name) y::perf::ZoneScope y_create_name_with_prefix(prof)(y::perf::zone_id(name))
 #else
 #define y_profile_zone(cat) do {} while(false)
 #define y_profile() do {} while(false)
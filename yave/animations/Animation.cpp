@@ -24,13 +24,30 @@ SOFTWARE.
 
 namespace yave {
 
-Animation::Animation(float duration, core::Vector<AnimationChannel>&& channels) : _duration(duration), _channels(std::move(channels)) {
+Animation::Animation(float duration, core::Vector<AnimationChannel>&& channels, const AnimationCompressionSettings& settings) :
+		_duration(duration),
+		_channels(core::vector_with_capacity<CompressedChannel>(channels.size())) {
+
+	for(const auto& channel : channels) {
+		_channels << CompressedChannel(channel, duration, settings);
+	}
 }
 
-const core::Vector<AnimationChannel>& Animation::channels() const {
+Animation::Animation(float duration, core::Vector<CompressedChannel>&& channels) : _duration(duration), _channels(std::move(channels)) {
+}
+
+const core::Vector<CompressedChannel>& Animation::channels() const {
 	return _channels;
 }
 
+usize Animation::byte_size() const {
+	usize size = sizeof(*this);
+	for(const auto& channel : _channels) {
+		size += channel.byte_size();
+	}
+	return size;
+}
+
 float Animation::duration() const {
 	return _duration;
 }
@@ -42,7 +59,18 @@ std::optional<math::Transform<>> Animation::bone_transform(const core::String& n
 		return std::optional<math::Transform<>>();
 	}
 
-	return std::optional(channel->bone_transform(time));
+	CompressedChannel::Cursor cursor;
+	return std::optional(channel->bone_transform(_duration > 0.0f ? time / _duration : 0.0f, cursor));
+}
+
+core::Vector<u32> Animation::bind(const Skeleton& skeleton) const {
+	const auto& bones = skeleton.bones();
+	auto channels = core::vector_with_capacity<u32>(bones.size());
+	for(const auto& bone : bones) {
+		auto channel = std::find_if(_channels.begin(), _channels.end(), [&](const auto& ch) { return ch.name() == bone.name; });
+		channels << (channel == _channels.end() ? unbound_channel : u32(channel - _channels.begin()));
+	}
+	return channels;
 }
 
 }
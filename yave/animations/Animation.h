@@ -22,7 +22,9 @@ SOFTWARE.
 #ifndef YAVE_ANIMATIONS_ANIMATION_H
 #define YAVE_ANIMATIONS_ANIMATION_H
 
-#include "AnimationChannel.h"
+#include "CompressedChannel.h"
+
+#include <yave/meshes/Skeleton.h>
 
 #include <optional>
 
@@ -30,20 +32,47 @@ namespace yave {
 
 class Animation {
 	public:
+		static constexpr u32 unbound_channel = u32(-1);
+
+		static constexpr u32 version = 5;
+		// version 4 stores uncompressed channels, they are compressed on load
+		static constexpr u32 min_version = 4;
+
 		Animation() = default;
 
-		Animation(float duration, core::Vector<AnimationChannel>&& channels);
+		// channels are compressed
+		Animation(float duration, core::Vector<AnimationChannel>&& channels, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+		Animation(float duration, core::Vector<CompressedChannel>&& channels);
 
-		y_serde(fs::magic_number, AssetType::Animation, u32(4), _duration, _channels)
+		y_serialize(fs::magic_number, AssetType::Animation, version, _duration, _channels)
+
+		y_deserialize(fs::magic_number, AssetType::Animation,
+			y_serde_call([&](u32 v) {
+				if(v < min_version || v > version) {
+					y_throw("Unsupported animation version.");
+				}
+				if(v < 5) {
+					core::Vector<AnimationChannel> channels;
+					y_serde_process(_duration, channels);
+					*this = Animation(_duration, std::move(channels));
+				} else {
+					y_serde_process(_duration, _channels);
+				}
+			}))
 
 		float duration() const;
-		const core::Vector<AnimationChannel>& channels() const;
+		const core::Vector<CompressedChannel>& channels() const;
+
+		usize byte_size() const;
 
 		std::optional<math::Transform<>> bone_transform(const core::String& name, float time) const;
 
+		// returns the channel index of every skeleton bone, or unbound_channel
+		core::Vector<u32> bind(const Skeleton& skeleton) const;
+
 	private:
 		float _duration = 0.0f;
-		core::Vector<AnimationChannel> _channels;
+		core::Vector<CompressedChannel> _channels;
 
 };
 
@@ -24,24 +24,59 @@ SOFTWARE.
 
 namespace yave {
 
-AnimationChannel::AnimationChannel(const core::String& name, core::Vector<BoneKey>&& keys) : _name(name), _keys(keys) {
-	if(_keys.is_empty()) {
+AnimationChannel::AnimationChannel(const core::String& name, core::Vector<BoneKey>&& keys) :
+		_name(name),
+		_times(core::vector_with_capacity<float>(keys.size())),
+		_transforms(core::vector_with_capacity<BoneTransform>(keys.size())) {
+
+	if(keys.is_empty()) {
 		y_fatal("Empty animation channel.");
 	}
+
+	for(const auto& key : keys) {
+		_times << key.time;
+		_transforms << key.local_transform;
+	}
+}
+
+usize AnimationChannel::next_key(float time) const {
+	return std::upper_bound(_times.begin(), _times.end(), time) - _times.begin();
+}
+
+math::Transform<> AnimationChannel::interpolate(usize next, float time) const {
+	usize key = next ? next - 1 : 0;
+	next = next == _times.size() ? 0 : next;
+
+	float delta = _times[next] - _times[key];
+	delta = delta < 0.0f ? delta + _times.last() : delta;
+
+	float factor = (time - _times[key]) / delta;
+
+	return _transforms[key].lerp(_transforms[next], factor);
 }
 
 math::Transform<> AnimationChannel::bone_transform(float time) const {
-	auto key = std::find_if(_keys.begin(), _keys.end(), [=](const auto& key) { return key.time > time; });
+	return interpolate(next_key(time), time);
+}
 
-	auto next = key == _keys.end() ? _keys.begin() : key;
-	key = key == _keys.begin() ? key : std::prev(key);
+math::Transform<> AnimationChannel::bone_transform(float time, u32& cursor) const {
+	usize key = cursor;
+	usize next = _times.size();
 
-	float delta = next->time - key->time;
-	delta = delta < 0.0f ? delta + _keys.last().time : delta;
+	auto in_range = [&](usize k) {
+		return k < _times.size() && _times[k] <= time && (k + 1 == _times.size() || time < _times[k + 1]);
+	};
 
-	float factor = (time - key->time) / delta;
+	if(in_range(key)) {
+		next = key + 1;
+	} else if(in_range(key + 1)) {
+		next = key + 2;
+	} else {
+		next = next_key(time);
+	}
 
-	return key->local_transform.lerp(next->local_transform, factor);
+	cursor = u32(next ? next - 1 : 0);
+	return interpolate(next, time);
 }
 
 
@@ -49,8 +84,16 @@ const core::String& AnimationChannel::name() const {
 	return _name;
 }
 
-const core::Vector<AnimationChannel::BoneKey>& AnimationChannel::keys() const {
-	return _keys;
+core::Vector<AnimationChannel::BoneKey> AnimationChannel::keys() const {
+	auto keys = core::vector_with_capacity<BoneKey>(_times.size());
+	for(usize i = 0; i != _times.size(); ++i) {
+		keys << BoneKey{_times[i], _transforms[i]};
+	}
+	return keys;
+}
+
+usize AnimationChannel::key_count() const {
+	return _times.size();
 }
 
 }
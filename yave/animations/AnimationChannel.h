@@ -35,20 +35,30 @@ class AnimationChannel {
 			BoneTransform local_transform;
 		};
 
-		y_serialize(_name, _keys)
+		y_serialize(_name, keys())
 		y_deserialize_func([](const core::String& name, core::Vector<BoneKey>&& keys) { return AnimationChannel(name, std::move(keys)); })
 
 		AnimationChannel(const core::String& name, core::Vector<BoneKey>&& keys);
 
 		math::Transform<> bone_transform(float time) const;
 
+		// cursor is the last sampled key, it is advanced incrementally when time moves forward
+		math::Transform<> bone_transform(float time, u32& cursor) const;
+
 
 		const core::String& name() const;
-		const core::Vector<BoneKey>& keys() const;
+		core::Vector<BoneKey> keys() const;
+
+		usize key_count() const;
 
 	private:
+		usize next_key(float time) const;
+		math::Transform<> interpolate(usize next, float time) const;
+
 		core::String _name;
-		core::Vector<BoneKey> _keys;
+
+		core::Vector<float> _times;
+		core::Vector<BoneTransform> _transforms;
 };
 
 }
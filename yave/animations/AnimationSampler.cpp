@@ -0,0 +1,75 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "AnimationSampler.h"
+
+#include <y/math/batch.h>
+
+namespace yave {
+
+AnimationSampler::AnimationSampler(const Animation* animation, const Skeleton* skeleton) :
+		_animation(animation),
+		_skeleton(skeleton),
+		_channels(animation->bind(*skeleton)),
+		_cursors(_channels.size(), CompressedChannel::Cursor()) {
+}
+
+void AnimationSampler::sample(float time, LocalPose& local) {
+	const auto& channels = _animation->channels();
+	const auto& bones = _skeleton->bones();
+
+	// single key animations have no duration
+	float duration = _animation->duration();
+	time = duration > 0.0f ? time / duration : 0.0f;
+
+	for(usize i = 0; i != _channels.size(); ++i) {
+		u32 channel = _channels[i];
+		local[i] = channel == Animation::unbound_channel
+			? bones[i].local_transform
+			: channels[channel].sample(time, _cursors[i]);
+	}
+}
+
+const Animation* AnimationSampler::animation() const {
+	return _animation;
+}
+
+const Skeleton* AnimationSampler::skeleton() const {
+	return _skeleton;
+}
+
+void compute_skinning(const Skeleton& skeleton, const AnimationSampler::LocalPose& local, AnimationSampler::Pose& out) {
+	const auto& bones = skeleton.bones();
+	const auto& invs = skeleton.inverse_absolute_transforms();
+
+	// parents always come before their children
+	for(usize i = 0; i != bones.size(); ++i) {
+		const auto& bone = bones[i];
+		out[i] = local[i].to_transform();
+		if(bone.has_parent()) {
+			math::multiply_transforms(&out[bone.parent], &out[i], &out[i], 1);
+		}
+	}
+	math::multiply_transforms(out.data(), invs.data(), out.data(), bones.size());
+}
+
+}
@@ -0,0 +1,57 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ANIMATIONS_ANIMATIONSAMPLER_H
+#define YAVE_ANIMATIONS_ANIMATIONSAMPLER_H
+
+#include "Animation.h"
+
+namespace yave {
+
+// caches the bone to channel mapping and the last sampled keys of one animated skeleton
+class AnimationSampler {
+	public:
+		using LocalPose = std::array<BoneTransform, Skeleton::max_bones>;
+		using Pose = std::array<math::Transform<>, Skeleton::max_bones>;
+
+		AnimationSampler() = default;
+		AnimationSampler(const Animation* animation, const Skeleton* skeleton);
+
+		// writes the local transform of every bone, non animated bones keep their bind pose
+		void sample(float time, LocalPose& local);
+
+		const Animation* animation() const;
+		const Skeleton* skeleton() const;
+
+	private:
+		const Animation* _animation = nullptr;
+		const Skeleton* _skeleton = nullptr;
+
+		core::Vector<u32> _channels;
+		core::Vector<CompressedChannel::Cursor> _cursors;
+};
+
+// concatenates the local transforms down the hierarchy into skinning matrices
+void compute_skinning(const Skeleton& skeleton, const AnimationSampler::LocalPose& local, AnimationSampler::Pose& out);
+
+}
+
+#endif // YAVE_ANIMATIONS_ANIMATIONSAMPLER_H
@@ -0,0 +1,241 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "BlendTree.h"
+
+namespace yave {
+
+static BoneTransform lerp(const BoneTransform& a, const BoneTransform& b, float factor) {
+	BoneTransform tr;
+	tr.position = a.position + (b.position - a.position) * factor;
+	tr.scale = a.scale + (b.scale - a.scale) * factor;
+	tr.rotation = a.rotation.lerp(b.rotation, factor);
+	return tr;
+}
+
+// applies the difference between additive and reference on top of base
+static BoneTransform add(const BoneTransform& base, const BoneTransform& additive, const BoneTransform& reference, float factor) {
+	math::Quaternion<> delta = reference.rotation.inverse() * additive.rotation;
+
+	BoneTransform tr;
+	tr.position = base.position + (additive.position - reference.position) * factor;
+	tr.scale = base.scale * (math::Vec3(1.0f) + (additive.scale / reference.scale - math::Vec3(1.0f)) * factor);
+	tr.rotation = base.rotation * math::Quaternion<>().lerp(delta, factor);
+	return tr;
+}
+
+
+PosePool::LocalPose& PosePool::acquire() {
+	if(_used == _poses.size()) {
+		_poses << std::make_unique<LocalPose>();
+	}
+	return *_poses[_used++];
+}
+
+void PosePool::release(LocalPose& pose) {
+	y_debug_assert(_used && _poses[_used - 1].get() == &pose);
+	unused(pose);
+	--_used;
+}
+
+usize PosePool::capacity() const {
+	return _poses.size();
+}
+
+
+
+BlendTree::BlendTree(const Skeleton* skeleton) : _skeleton(skeleton) {
+}
+
+u32 BlendTree::add_node(const Node& node) {
+	_changed = true;
+	_nodes << node;
+	return u32(_nodes.size() - 1);
+}
+
+u32 BlendTree::add_clip(const AssetPtr<Animation>& anim, float speed, bool loop) {
+	_clips << Clip{anim, AnimationSampler(anim.get(), _skeleton), 0.0f, speed, loop};
+	return add_node(Node{NodeType::Clip, {invalid_node, invalid_node}, u32(_clips.size() - 1), 1.0f});
+}
+
+u32 BlendTree::add_lerp(u32 a, u32 b, float weight) {
+	return add_node(Node{NodeType::Lerp, {a, b}, invalid_node, weight});
+}
+
+u32 BlendTree::add_additive(u32 base, u32 additive, float weight) {
+	return add_node(Node{NodeType::Additive, {base, additive}, invalid_node, weight});
+}
+
+u32 BlendTree::add_masked(u32 base, u32 layer, core::Vector<float>&& bone_weights, float weight) {
+	if(bone_weights.size() != _skeleton->bones().size()) {
+		y_fatal("Invalid bone mask.");
+	}
+	_masks << std::move(bone_weights);
+	return add_node(Node{NodeType::Masked, {base, layer}, u32(_masks.size() - 1), weight});
+}
+
+void BlendTree::set_root(u32 node) {
+	y_debug_assert(node < _nodes.size());
+	_changed |= _root != node;
+	_root = node;
+}
+
+void BlendTree::set_weight(u32 node, float weight) {
+	_changed |= _nodes[node].weight != weight;
+	_nodes[node].weight = weight;
+}
+
+void BlendTree::crossfade(const AssetPtr<Animation>& anim, float duration) {
+	u32 clip = add_clip(anim);
+	if(is_empty() || duration <= 0.0f) {
+		_fade = Fade{invalid_node, clip, 0.0f};
+		update(0.0f);
+		_changed = true;
+		return;
+	}
+	u32 lerp = add_lerp(_root, clip, 0.0f);
+	set_root(lerp);
+	_fade = Fade{lerp, clip, 1.0f / duration};
+}
+
+void BlendTree::clear() {
+	_nodes.clear();
+	_clips.clear();
+	_masks.clear();
+	_root = invalid_node;
+	_fade = Fade();
+	_changed = true;
+}
+
+bool BlendTree::is_empty() const {
+	return _root == invalid_node;
+}
+
+void BlendTree::flush_reload() {
+	for(auto& clip : _clips) {
+		if(clip.animation.flush_reload()) {
+			clip.sampler = AnimationSampler(clip.animation.get(), _skeleton);
+			_changed = true;
+		}
+	}
+}
+
+bool BlendTree::update(float dt) {
+	if(_fade.clip_node != invalid_node) {
+		bool done = _fade.node == invalid_node;
+		if(!done) {
+			float& weight = _nodes[_fade.node].weight;
+			weight = std::min(1.0f, weight + dt * _fade.speed);
+			done = weight >= 1.0f;
+			_changed = true;
+		}
+		if(done) {
+			// keep only the faded in clip
+			Clip clip = std::move(_clips[_nodes[_fade.clip_node].index]);
+			clear();
+			_clips << std::move(clip);
+			_root = add_node(Node{NodeType::Clip, {invalid_node, invalid_node}, 0, 1.0f});
+		}
+	}
+
+	for(auto& clip : _clips) {
+		float duration = clip.animation->duration();
+		float time = 0.0f;
+		if(duration > 0.0f) {
+			time = clip.time + dt * clip.speed;
+			time = clip.loop ? std::fmod(time, duration) : std::min(time, duration);
+			if(time < 0.0f) {
+				time += duration;
+			}
+		}
+		_changed |= time != clip.time;
+		clip.time = time;
+	}
+
+	return std::exchange(_changed, false);
+}
+
+void BlendTree::evaluate(PosePool& pool, LocalPose& out) {
+	if(is_empty()) {
+		const auto& bones = _skeleton->bones();
+		for(usize i = 0; i != bones.size(); ++i) {
+			out[i] = bones[i].local_transform;
+		}
+		return;
+	}
+	evaluate(_root, pool, out);
+}
+
+void BlendTree::evaluate(u32 index, PosePool& pool, LocalPose& out) {
+	const Node& node = _nodes[index];
+	const auto& bones = _skeleton->bones();
+
+	if(node.type == NodeType::Clip) {
+		Clip& clip = _clips[node.index];
+		clip.sampler.sample(clip.time, out);
+		return;
+	}
+
+	// a lerp or mask at 0 or 1 only needs one of its inputs
+	if(node.type != NodeType::Additive) {
+		if(node.weight <= 0.0f) {
+			evaluate(node.inputs[0], pool, out);
+			return;
+		}
+		if(node.weight >= 1.0f && node.type == NodeType::Lerp) {
+			evaluate(node.inputs[1], pool, out);
+			return;
+		}
+	}
+
+	evaluate(node.inputs[0], pool, out);
+	LocalPose& layer = pool.acquire();
+	evaluate(node.inputs[1], pool, layer);
+
+	switch(node.type) {
+		case NodeType::Lerp:
+			for(usize i = 0; i != bones.size(); ++i) {
+				out[i] = lerp(out[i], layer[i], node.weight);
+			}
+		break;
+
+		case NodeType::Additive:
+			for(usize i = 0; i != bones.size(); ++i) {
+				out[i] = add(out[i], layer[i], bones[i].local_transform, node.weight);
+			}
+		break;
+
+		case NodeType::Masked: {
+			const auto& mask = _masks[node.index];
+			for(usize i = 0; i != bones.size(); ++i) {
+				out[i] = lerp(out[i], layer[i], mask[i] * node.weight);
+			}
+		} break;
+
+		default:
+			y_fatal("Unknown blend node.");
+	}
+
+	pool.release(layer);
+}
+
+}
@@ -0,0 +1,125 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ANIMATIONS_BLENDTREE_H
+#define YAVE_ANIMATIONS_BLENDTREE_H
+
+#include <yave/assets/AssetPtr.h>
+
+#include "AnimationSampler.h"
+
+namespace yave {
+
+// intermediate poses of blend tree evaluations, released in reverse order
+// the pool only grows when a tree is deeper than all the previous ones
+class PosePool : NonCopyable {
+	public:
+		using LocalPose = AnimationSampler::LocalPose;
+
+		PosePool() = default;
+
+		LocalPose& acquire();
+		void release(LocalPose& pose);
+
+		usize capacity() const;
+
+	private:
+		core::Vector<std::unique_ptr<LocalPose>> _poses;
+		usize _used = 0;
+};
+
+class BlendTree {
+	public:
+		using LocalPose = AnimationSampler::LocalPose;
+
+		static constexpr u32 invalid_node = u32(-1);
+
+		enum class NodeType {
+			Clip,
+			Lerp,
+			Additive,
+			Masked
+		};
+
+		BlendTree() = default;
+		BlendTree(const Skeleton* skeleton);
+
+		// additive clips are applied relative to the skeleton's bind pose
+		u32 add_clip(const AssetPtr<Animation>& anim, float speed = 1.0f, bool loop = true);
+		u32 add_lerp(u32 a, u32 b, float weight);
+		u32 add_additive(u32 base, u32 additive, float weight);
+		u32 add_masked(u32 base, u32 layer, core::Vector<float>&& bone_weights, float weight = 1.0f);
+
+		void set_root(u32 node);
+		void set_weight(u32 node, float weight);
+
+		// fades from the current root to anim, the tree is collapsed into a single clip once the fade is complete
+		void crossfade(const AssetPtr<Animation>& anim, float duration);
+
+		void clear();
+		bool is_empty() const;
+
+		void flush_reload();
+
+		// advances clips and fades, returns false if the pose is the same as after the previous update
+		bool update(float dt);
+		void evaluate(PosePool& pool, LocalPose& out);
+
+	private:
+		struct Node {
+			NodeType type;
+			std::array<u32, 2> inputs = {invalid_node, invalid_node};
+			u32 index = invalid_node;
+			float weight = 1.0f;
+		};
+
+		struct Clip {
+			AssetPtr<Animation> animation;
+			AnimationSampler sampler;
+			float time = 0.0f;
+			float speed = 1.0f;
+			bool loop = true;
+		};
+
+		struct Fade {
+			u32 node = invalid_node;
+			u32 clip_node = invalid_node;
+			float speed = 0.0f;
+		};
+
+		u32 add_node(const Node& node);
+		void evaluate(u32 node, PosePool& pool, LocalPose& out);
+
+		const Skeleton* _skeleton = nullptr;
+
+		core::Vector<Node> _nodes;
+		core::Vector<Clip> _clips;
+		core::Vector<core::Vector<float>> _masks;
+
+		u32 _root = invalid_node;
+		Fade _fade;
+
+		bool _changed = true;
+};
+
+}
+
+#endif // YAVE_ANIMATIONS_BLENDTREE_H
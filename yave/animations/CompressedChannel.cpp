@@ -0,0 +1,298 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "CompressedChannel.h"
+
+namespace yave {
+
+static constexpr float max_time = 65535.0f;
+static constexpr float max_u16 = 65535.0f;
+static constexpr float max_u15 = 32767.0f;
+static constexpr float sqrt2 = 1.41421356f;
+
+PackedQuaternion pack_quaternion(const math::Quaternion<>& q) {
+	math::Vec4 v = q.as_vec();
+
+	usize largest = 0;
+	for(usize i = 1; i != 4; ++i) {
+		if(std::abs(v[i]) > std::abs(v[largest])) {
+			largest = i;
+		}
+	}
+	if(v[largest] < 0.0f) {
+		v = -v;
+	}
+
+	std::array<u16, 3> q15 = {};
+	for(usize i = 0, k = 0; i != 4; ++i) {
+		if(i != largest) {
+			// other components are in [-1/sqrt(2), 1/sqrt(2)]
+			float n = std::clamp(v[i] * sqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+			q15[k++] = u16(std::lround(n * max_u15));
+		}
+	}
+
+	return PackedQuaternion{u16(q15[0] | ((largest >> 1) << 15)), u16(q15[1] | ((largest & 1) << 15)), q15[2]};
+}
+
+// not normalized by Quaternion's constructor
+static math::Vec4 unpack_vec(const PackedQuaternion& q) {
+	usize largest = ((q.a >> 15) << 1) | (q.b >> 15);
+	std::array<u16, 3> q15 = {u16(q.a & 0x7FFF), u16(q.b & 0x7FFF), q.c};
+
+	math::Vec4 v;
+	float sq_len = 0.0f;
+	for(usize i = 0, k = 0; i != 4; ++i) {
+		if(i != largest) {
+			float c = (float(q15[k++]) / max_u15 - 0.5f) * 2.0f / sqrt2;
+			sq_len += c * c;
+			v[i] = c;
+		}
+	}
+	v[largest] = std::sqrt(std::max(0.0f, 1.0f - sq_len));
+	return v;
+}
+
+math::Quaternion<> unpack_quaternion(const PackedQuaternion& q) {
+	return math::Quaternion<>(unpack_vec(q));
+}
+
+math::Vec3 Vec3Track::value(usize key) const {
+	const auto& q = values[key];
+	return min + extent * math::Vec3(q[0], q[1], q[2]) / max_u16;
+}
+
+math::Quaternion<> RotationTrack::value(usize key) const {
+	return unpack_quaternion(values[key]);
+}
+
+
+
+// angle between the two rotations, acos(dot) is too imprecise for small angles
+static float rotation_error(const math::Quaternion<>& a, const math::Quaternion<>& b) {
+	math::Vec4 va = a.as_vec();
+	math::Vec4 vb = va.dot(b.as_vec()) < 0.0f ? -b.as_vec() : b.as_vec();
+	float chord = std::min(2.0f, (va - vb).length());
+	return 4.0f * std::asin(chord * 0.5f);
+}
+
+// greedily drops every key that can be interpolated from the previous kept key and the next one
+// decoded are the quantized values, the error is measured against the original ones
+template<typename T, typename Lerp, typename Error>
+static core::Vector<usize> reduce_keys(core::ArrayView<float> times, core::ArrayView<T> original, core::ArrayView<T> decoded, float tolerance, Lerp&& lerp, Error&& error) {
+	usize count = times.size();
+
+	core::Vector<usize> kept;
+	kept << 0;
+
+	bool constant = std::all_of(original.begin(), original.end(), [&](const T& v) { return error(decoded[0], v) <= tolerance; });
+	if(constant) {
+		return kept;
+	}
+
+	for(usize i = 1; i + 1 < count; ++i) {
+		usize prev = kept.last();
+		usize next = i + 1;
+		float span = times[next] - times[prev];
+
+		bool drop = true;
+		for(usize k = prev + 1; k <= i && drop; ++k) {
+			float factor = span > 0.0f ? (times[k] - times[prev]) / span : 0.0f;
+			drop = error(lerp(decoded[prev], decoded[next], factor), original[k]) <= tolerance;
+		}
+		if(!drop) {
+			kept << i;
+		}
+	}
+	kept << count - 1;
+
+	return kept;
+}
+
+static Vec3Track compress_track(core::ArrayView<float> times, core::ArrayView<u16> quantized_times, core::ArrayView<math::Vec3> values, float tolerance) {
+	Vec3Track track;
+
+	math::Vec3 max(-std::numeric_limits<float>::max());
+	track.min = math::Vec3(std::numeric_limits<float>::max());
+	for(const math::Vec3& v : values) {
+		for(usize i = 0; i != 3; ++i) {
+			track.min[i] = std::min(track.min[i], v[i]);
+			max[i] = std::max(max[i], v[i]);
+		}
+	}
+	track.extent = max - track.min;
+
+	auto quantized = core::vector_with_capacity<std::array<u16, 3>>(values.size());
+	auto decoded = core::vector_with_capacity<math::Vec3>(values.size());
+	for(const math::Vec3& v : values) {
+		std::array<u16, 3> q = {};
+		for(usize i = 0; i != 3; ++i) {
+			q[i] = track.extent[i] > 0.0f ? u16(std::lround((v[i] - track.min[i]) / track.extent[i] * max_u16)) : u16(0);
+		}
+		quantized << q;
+		decoded << track.min + track.extent * math::Vec3(q[0], q[1], q[2]) / max_u16;
+	}
+
+	auto lerp = [](const math::Vec3& a, const math::Vec3& b, float f) { return a + (b - a) * f; };
+	auto error = [](const math::Vec3& a, const math::Vec3& b) { return (a - b).length(); };
+	auto kept = reduce_keys<math::Vec3>(times, values, decoded, tolerance, lerp, error);
+
+	if(kept.size() == 1) {
+		// constant track: keep the exact value
+		track.min = values[0];
+		track.extent = math::Vec3();
+		track.times << 0;
+		track.values << std::array<u16, 3>{};
+		return track;
+	}
+
+	for(usize k : kept) {
+		track.times << quantized_times[k];
+		track.values << quantized[k];
+	}
+	return track;
+}
+
+static RotationTrack compress_track(core::ArrayView<float> times, core::ArrayView<u16> quantized_times, core::ArrayView<math::Quaternion<>> values, float tolerance) {
+	auto quantized = core::vector_with_capacity<PackedQuaternion>(values.size());
+	auto decoded = core::vector_with_capacity<math::Quaternion<>>(values.size());
+	for(const math::Quaternion<>& q : values) {
+		quantized << pack_quaternion(q);
+		decoded << unpack_quaternion(quantized.last());
+	}
+
+	auto lerp = [](const math::Quaternion<>& a, const math::Quaternion<>& b, float f) { return a.lerp(b, f); };
+	auto kept = reduce_keys<math::Quaternion<>>(times, values, decoded, tolerance, lerp, rotation_error);
+
+	RotationTrack track;
+	for(usize k : kept) {
+		track.times << (kept.size() == 1 ? u16(0) : quantized_times[k]);
+		track.values << quantized[k];
+	}
+	return track;
+}
+
+CompressedChannel::CompressedChannel(const AnimationChannel& channel, float duration, const AnimationCompressionSettings& settings) : _name(channel.name()) {
+	auto keys = channel.keys();
+
+	auto times = core::vector_with_capacity<float>(keys.size());
+	auto quantized_times = core::vector_with_capacity<u16>(keys.size());
+	auto positions = core::vector_with_capacity<math::Vec3>(keys.size());
+	auto rotations = core::vector_with_capacity<math::Quaternion<>>(keys.size());
+	auto scales = core::vector_with_capacity<math::Vec3>(keys.size());
+	for(const auto& key : keys) {
+		float normalized = duration > 0.0f ? key.time / duration : 0.0f;
+		u16 time = u16(std::lround(std::clamp(normalized, 0.0f, 1.0f) * max_time));
+		quantized_times << time;
+		times << float(time);
+		positions << key.local_transform.position;
+		rotations << key.local_transform.rotation;
+		scales << key.local_transform.scale;
+	}
+
+	_position = compress_track(times, quantized_times, positions, settings.position_tolerance);
+	_rotation = compress_track(times, quantized_times, rotations, settings.rotation_tolerance);
+	_scale = compress_track(times, quantized_times, scales, settings.scale_tolerance);
+}
+
+
+
+struct KeyFactor {
+	usize key;
+	usize next;
+	float factor;
+};
+
+static KeyFactor find_key(const core::Vector<u16>& times, float time, u32 cursor) {
+	usize count = times.size();
+	auto in_range = [&](usize k) {
+		return k < count && times[k] <= time && (k + 1 == count || time < times[k + 1]);
+	};
+
+	usize key = cursor;
+	if(!in_range(key)) {
+		if(in_range(key + 1)) {
+			++key;
+		} else {
+			key = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+			key = key ? key - 1 : 0;
+		}
+	}
+
+	// first and last keys are held
+	usize next = std::min(key + 1, count - 1);
+	if(next == key || time <= times[key]) {
+		return KeyFactor{key, next, 0.0f};
+	}
+	return KeyFactor{key, next, (time - times[key]) / float(times[next] - times[key])};
+}
+
+// keys are only decoded when the cursor moves to another key
+template<typename T, typename Decode>
+static T sample_track(const core::Vector<u16>& times, float time, u32& cursor, std::array<T, 2>& keys, Decode&& decode) {
+	KeyFactor k = find_key(times, time, cursor);
+	if(k.key != cursor) {
+		cursor = u32(k.key);
+		keys = decode(k.key, k.next);
+	}
+	return keys[0] + (keys[1] - keys[0]) * k.factor;
+}
+
+BoneTransform CompressedChannel::sample(float time, Cursor& cursor) const {
+	time = std::clamp(time, 0.0f, 1.0f) * max_time;
+
+	auto position = [this](usize a, usize b) { return std::array{_position.value(a), _position.value(b)}; };
+	auto scale = [this](usize a, usize b) { return std::array{_scale.value(a), _scale.value(b)}; };
+	auto rotation = [this](usize a, usize b) {
+		math::Vec4 r0 = unpack_vec(_rotation.values[a]);
+		math::Vec4 r1 = unpack_vec(_rotation.values[b]);
+		return std::array{r0, r0.dot(r1) < 0.0f ? -r1 : r1};
+	};
+
+	// normalized lerp, the quaternion is only normalized once
+	BoneTransform tr;
+	tr.position = sample_track(_position.times, time, cursor.position, cursor.positions, position);
+	tr.scale = sample_track(_scale.times, time, cursor.scale, cursor.scales, scale);
+	tr.rotation = math::Quaternion<>(sample_track(_rotation.times, time, cursor.rotation, cursor.rotations, rotation));
+	return tr;
+}
+
+math::Transform<> CompressedChannel::bone_transform(float time, Cursor& cursor) const {
+	return sample(time, cursor).to_transform();
+}
+
+const core::String& CompressedChannel::name() const {
+	return _name;
+}
+
+usize CompressedChannel::key_count() const {
+	return _position.times.size() + _rotation.times.size() + _scale.times.size();
+}
+
+usize CompressedChannel::byte_size() const {
+	return sizeof(*this) + _name.size() +
+		_position.times.size() * (sizeof(u16) + sizeof(std::array<u16, 3>)) +
+		_rotation.times.size() * (sizeof(u16) + sizeof(PackedQuaternion)) +
+		_scale.times.size() * (sizeof(u16) + sizeof(std::array<u16, 3>));
+}
+
+}
@@ -0,0 +1,111 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_ANIMATIONS_COMPRESSEDCHANNEL_H
+#define YAVE_ANIMATIONS_COMPRESSEDCHANNEL_H
+
+#include "AnimationChannel.h"
+
+namespace yave {
+
+struct AnimationCompressionSettings {
+	// maximum error of reduced tracks, in world units and radians
+	float position_tolerance = 0.0005f;
+	float rotation_tolerance = 0.0005f;
+	float scale_tolerance = 0.0005f;
+};
+
+// smallest three: the largest component is dropped, the other ones are stored on 15 bits
+// and the index of the dropped one in the top bits of a and b
+struct PackedQuaternion {
+	u16 a = 0;
+	u16 b = 0;
+	u16 c = 0;
+};
+
+PackedQuaternion pack_quaternion(const math::Quaternion<>& q);
+math::Quaternion<> unpack_quaternion(const PackedQuaternion& q);
+
+
+// key times are quantized over the animation duration, constant tracks have a single key
+struct Vec3Track {
+	y_serde(min, extent, times, values)
+
+	// values are quantized over [min, min + extent]
+	math::Vec3 min;
+	math::Vec3 extent;
+
+	core::Vector<u16> times;
+	core::Vector<std::array<u16, 3>> values;
+
+	math::Vec3 value(usize key) const;
+};
+
+struct RotationTrack {
+	y_serde(times, values)
+
+	core::Vector<u16> times;
+	core::Vector<PackedQuaternion> values;
+
+	math::Quaternion<> value(usize key) const;
+};
+
+
+class CompressedChannel {
+	public:
+		static constexpr u32 invalid_key = u32(-1);
+
+		// last sampled key of each track, with the values of the key and the next one decoded
+		struct Cursor {
+			u32 position = invalid_key;
+			u32 rotation = invalid_key;
+			u32 scale = invalid_key;
+
+			std::array<math::Vec3, 2> positions;
+			std::array<math::Vec4, 2> rotations;
+			std::array<math::Vec3, 2> scales;
+		};
+
+		y_serde(_name, _position, _rotation, _scale)
+
+		CompressedChannel() = default;
+		CompressedChannel(const AnimationChannel& channel, float duration, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+
+		// time is normalized over the animation duration
+		BoneTransform sample(float time, Cursor& cursor) const;
+		math::Transform<> bone_transform(float time, Cursor& cursor) const;
+
+		const core::String& name() const;
+
+		usize key_count() const;
+		usize byte_size() const;
+
+	private:
+		core::String _name;
+
+		Vec3Track _position;
+		RotationTrack _rotation;
+		Vec3Track _scale;
+};
+
+}
+
+#endif // YAVE_ANIMATIONS_COMPRESSEDCHANNEL_H
@@ -21,59 +21,80 @@ SOFTWARE.
 **********************************/
 
 #include "SkeletonInstance.h"
-#include <yave/graphics/buffers/TypedWrapper.h>
 
-namespace yave {
+#include <y/concurrent/concurrent.h>
 
-SkeletonInstance::SkeletonInstance(DevicePtr dptr, const Skeleton* skeleton) :
-		_skeleton(skeleton),
-		_bone_transforms(new std::array<math::Transform<>, Skeleton::max_bones>()),
-		_bone_transform_buffer(dptr, Skeleton::max_bones),
-		_descriptor_set(dptr, {Binding(_bone_transform_buffer)}) {
+namespace yave {
 
-	flush_data();
+SkeletonInstance::SkeletonInstance(const Skeleton* skeleton) : _skeleton(skeleton), _tree(skeleton) {
 }
 
 void SkeletonInstance::flush_reload() {
-	_animation.flush_reload();
+	_tree.flush_reload();
 }
 
 void SkeletonInstance::animate(const AssetPtr<Animation>& anim) {
-	_animation = anim;
+	_tree.clear();
+	_tree.set_root(_tree.add_clip(anim));
 	_anim_timer.reset();
 }
 
-void SkeletonInstance::update() {
-	if(!_animation) {
+void SkeletonInstance::crossfade(const AssetPtr<Animation>& anim, float duration) {
+	_tree.crossfade(anim, duration);
+}
+
+BlendTree& SkeletonInstance::blend_tree() {
+	return _tree;
+}
+
+usize SkeletonInstance::bone_count() const {
+	return _skeleton ? _skeleton->bones().size() : 0;
+}
+
+void SkeletonInstance::update(PosePool& pool, AnimationSampler::Pose& pose, math::Transform<>* palette) {
+	bool changed = _tree.update(float(_anim_timer.reset().to_secs()));
+	_pose_changed = changed || !_pose_valid;
+	_pose_valid = true;
+	if(!_pose_changed) {
 		return;
 	}
 
-	float time = std::fmod(_anim_timer.elapsed().to_secs(), _animation->duration());
+	if(_tree.is_empty()) {
+		std::fill_n(palette, bone_count(), math::Transform<>());
+		return;
+	}
+
+	AnimationSampler::LocalPose& local = pool.acquire();
+	_tree.evaluate(pool, local);
+	compute_skinning(*_skeleton, local, pose);
+	pool.release(local);
 
-	const auto& anim = *_animation;
-	const auto& bones = _skeleton->bones();
-	const auto& bone_transforms = _skeleton->bone_transforms();
-	const auto& invs = _skeleton->inverse_absolute_transforms();
+	// palette is likely to be write combined memory: never read from it
+	std::copy_n(pose.begin(), bone_count(), palette);
+}
 
-	auto& out_transforms = *_bone_transforms;
+bool SkeletonInstance::pose_changed() const {
+	return _pose_changed;
+}
 
+void SkeletonInstance::invalidate_pose() {
+	_pose_valid = false;
+}
 
-	for(usize i = 0; i != bones.size(); ++i) {
-		const auto& bone = bones[i];
-		auto bone_tr = anim.bone_transform(bone.name, time).value_or(bone_transforms[i]);
+void update_skeletons(core::ArrayView<SkeletonInstance*> skeletons, core::ArrayView<u32> offsets, math::Transform<>* palette) {
+	y_profile();
 
-		out_transforms[i] = (bone.has_parent() ? out_transforms[bone.parent] * bone_tr : bone_tr);
-	}
-	for(usize i = 0; i != bones.size(); ++i) {
-		out_transforms[i] *= invs[i];
-	}
+	y_debug_assert(skeletons.size() == offsets.size());
 
-	flush_data();
-}
+	concurrent::parallel_block_for(skeletons.begin(), skeletons.end(), [&](const auto& range) {
+		// reused across frames: no allocation once the pools are large enough
+		static thread_local PosePool pool;
+		static thread_local AnimationSampler::Pose pose;
 
-void SkeletonInstance::flush_data() {
-	auto map = TypedMapping(_bone_transform_buffer);
-	std::copy(_bone_transforms->begin(), _bone_transforms->end(), map.begin());
+		for(auto it = range.begin(); it != range.end(); ++it) {
+			(*it)->update(pool, pose, palette + offsets[it - skeletons.begin()]);
+		}
+	});
 }
 
 }
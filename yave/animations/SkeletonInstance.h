@@ -25,11 +25,8 @@ SOFTWARE.
 #include <y/core/Chrono.h>
 
 #include <yave/meshes/Skeleton.h>
-#include <yave/assets/AssetPtr.h>
-#include <yave/graphics/buffers/buffers.h>
-#include <yave/graphics/bindings/DescriptorSet.h>
 
-#include "Animation.h"
+#include "BlendTree.h"
 
 namespace yave {
 
@@ -39,32 +36,38 @@ class SkeletonInstance {
 		SkeletonInstance() = default;
 
 		// this seems unsafe...
-		SkeletonInstance(DevicePtr dptr, const Skeleton* skeleton);
+		SkeletonInstance(const Skeleton* skeleton);
 
 		void flush_reload();
 
+		// plays anim alone, from the start
 		void animate(const AssetPtr<Animation>& anim);
+		void crossfade(const AssetPtr<Animation>& anim, float duration);
 
-		void update();
+		BlendTree& blend_tree();
 
-		const auto& descriptor_set() const {
-			return _descriptor_set;
-		}
+		usize bone_count() const;
 
-	private:
-		void flush_data();
+		// writes bone_count() skinning matrices into palette, unless the pose didn't change since the last update
+		void update(PosePool& pool, AnimationSampler::Pose& pose, math::Transform<>* palette);
 
-		const Skeleton* _skeleton = nullptr;
-		std::unique_ptr<std::array<math::Transform<>, Skeleton::max_bones>> _bone_transforms;
+		bool pose_changed() const;
+		void invalidate_pose();
 
-		TypedUniformBuffer<math::Transform<>, MemoryType::CpuVisible> _bone_transform_buffer;
-		DescriptorSet _descriptor_set;
+	private:
+		const Skeleton* _skeleton = nullptr;
 
-		AssetPtr<Animation> _animation;
+		BlendTree _tree;
 		core::Chrono _anim_timer;
 
+		bool _pose_changed = true;
+		bool _pose_valid = false;
+
 };
 
+// updates every skeleton in parallel, skeletons[i] is written at palette + offsets[i] if its pose changed
+void update_skeletons(core::ArrayView<SkeletonInstance*> skeletons, core::ArrayView<u32> offsets, math::Transform<>* palette);
+
 }
 
 #endif // YAVE_ANIMATIONS_SKELETONINSTANCE_H
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <yave/device/DeviceLinked.h>
 #include <y/core/String.h>
+#include <y/core/FlatHashMap.h>
 #include <y/serde/serde.h>
 #include <y/io/Buffer.h>
 
@@ -112,7 +113,7 @@ class AssetLoader : NonCopyable, public DeviceLinked {
 				}
 
 			private:
-				std::unordered_map<AssetId, WeakAssetPtr<T>> _loaded;
+				core::FlatHashMap<AssetId, WeakAssetPtr<T>> _loaded;
 
 				std::mutex _lock;
 		};
@@ -129,7 +129,7 @@ AssetStore::Result<> FolderAssetStore::read_index() {
 		}
 	} catch(std::exception& e) {
 		log_msg(fmt("Exception while reading index file: %", e.what()), Log::Error);
-		log_msg(fmt("% assets imported", _from_id.size()), Log::Error);
+		log_fmt(Log::Error, "% assets imported", _from_id.size());
 		return core::Err(ErrorType::FilesytemError);
 	}
 
@@ -338,7 +338,7 @@ AssetStore::Result<> FolderAssetStore::rename(std::string_view from, std::string
 				if(name.starts_with(from)) {
 					name = fmt("%%", to, name.sub_str(from.size()));
 				}
-				from_name.emplace(std::make_pair(name, std::move(asset.second)));
+				from_name.emplace(name, std::move(asset.second));
 			}
 			std::swap(_from_name, from_name);
 			y_debug_assert(_from_id.size() == _from_name.size());
@@ -24,11 +24,11 @@ SOFTWARE.
 #define YAVE_ASSETS_FOLDERASSETSTORE_H
 
 #include <y/serde/serde.h>
+#include <y/core/FlatHashMap.h>
 #include <yave/utils/FileSystemModel.h>
 
 #include "AssetStore.h"
 
-#include <unordered_map>
 #include <mutex>
 
 
@@ -96,8 +96,8 @@ class FolderAssetStore final : public AssetStore {
 		mutable std::recursive_mutex _lock;
 
 		// TODO optimize ?
-		std::unordered_map<AssetId, Entry*> _from_id;
-		std::unordered_map<core::String, std::unique_ptr<Entry>> _from_name;
+		core::FlatHashMap<AssetId, Entry*> _from_id;
+		core::FlatHashMap<core::String, std::unique_ptr<Entry>> _from_name;
 
 		AssetIdFactory _id_factory;
 };
@@ -33,4 +33,8 @@ bool Frustum::is_inside(const math::Vec3& pos, float radius) const {
 	return true;
 }
 
+void Frustum::is_inside(math::ConstSoASpan<4> spheres, u8* visible) const {
+	math::sphere_frustum_test(*this, spheres, visible);
+}
+
 }
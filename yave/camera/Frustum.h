@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include <yave/yave.h>
 
+#include <y/math/batch.h>
+
 namespace yave {
 
 using Plane = math::Vec4;
@@ -37,6 +39,9 @@ class Frustum : public std::array<Plane, 6> {
 
 		bool is_inside(const math::Vec3& pos, float radius) const;
 
+		// spheres are (x, y, z, radius), visible[i] is set to 1 if the i-th sphere is inside
+		void is_inside(math::ConstSoASpan<4> spheres, u8* visible) const;
+
 	private:
 
 };
@@ -37,11 +37,17 @@ static void check_features(const vk::PhysicalDeviceFeatures& features, const vk:
 	}
 }
 
-static core::Vector<const char*> extensions(const DebugParams& debug) {
+static core::Vector<const char*> extensions(vk::PhysicalDevice physical, const Instance& instance) {
 	auto exts = core::vector_with_capacity<const char*>(4);
-	exts << VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+	if(!instance.is_headless()) {
+		exts << VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+	}
 
-	if(debug.debug_features_enabled()) {
+	if(DrawIndirectCount::is_supported(physical)) {
+		exts << DrawIndirectCount::name();
+	}
+
+	if(instance.debug_params().debug_features_enabled()) {
 		exts << DebugMarker::name();
 	}
 
@@ -51,7 +57,9 @@ static core::Vector<const char*> extensions(const DebugParams& debug) {
 static vk::Device create_device(
 		vk::PhysicalDevice physical,
 		const core::ArrayView<QueueFamily>& queue_families,
-		const DebugParams& debug) {
+		const Instance& instance) {
+
+	const DebugParams& debug = instance.debug_params();
 
 	auto queue_create_infos = core::vector_with_capacity<vk::DeviceQueueCreateInfo>(queue_families.size());
 
@@ -83,7 +91,7 @@ static vk::Device create_device(
 
 	check_features(physical.getFeatures(), required);
 
-	auto exts = extensions(debug);
+	auto exts = extensions(physical, instance);
 
 	return physical.createDevice(vk::DeviceCreateInfo()
 			.setEnabledExtensionCount(u32(exts.size()))
@@ -105,7 +113,7 @@ Device::Device(Instance& instance) :
 		_instance(instance),
 		_physical(instance),
 		_queue_families(QueueFamily::all(_physical)),
-		_device{create_device(_physical.vk_physical_device(), _queue_families, _instance.debug_params())},
+		_device{create_device(_physical.vk_physical_device(), _queue_families, _instance)},
 		_allocator(this),
 		_lifetime_manager(this),
 		_sampler(this) {
@@ -114,6 +122,10 @@ Device::Device(Instance& instance) :
 		_extensions.debug_marker = std::make_unique<DebugMarker>(_device.device);
 	}
 
+	if(DrawIndirectCount::is_supported(_physical.vk_physical_device())) {
+		_extensions.draw_indirect_count = std::make_unique<DrawIndirectCount>(_device.device);
+	}
+
 	for(const auto& family : _queue_families) {
 		for(auto& queue : family.queues(this)) {
 			_queues.push_back(std::move(queue));
@@ -220,6 +232,10 @@ const DebugMarker* Device::debug_marker() const {
 	return _extensions.debug_marker.get();
 }
 
+const DrawIndirectCount* Device::draw_indirect_count() const {
+	return _extensions.draw_indirect_count.get();
+}
+
 
 
 }
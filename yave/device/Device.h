@@ -29,6 +29,7 @@ SOFTWARE.
 #include "LifetimeManager.h"
 
 #include "extentions/DebugMarker.h"
+#include "extentions/DrawIndirectCount.h"
 
 #include <yave/graphics/images/Sampler.h>
 #include <yave/graphics/queues/QueueFamily.h>
@@ -75,6 +76,9 @@ class Device : NonMovable {
 
 		const DebugMarker* debug_marker() const;
 
+		// null if VK_KHR_draw_indirect_count isn't supported
+		const DrawIndirectCount* draw_indirect_count() const;
+
 		template<typename T>
 		auto create_descriptor_set_layout(T&& t) const {
 			return thread_device()->create_descriptor_set_layout(y_fwd(t));
@@ -117,6 +121,7 @@ class Device : NonMovable {
 
 		struct {
 			std::unique_ptr<DebugMarker> debug_marker;
+			std::unique_ptr<DrawIndirectCount> draw_indirect_count;
 		} _extensions;
 
 };
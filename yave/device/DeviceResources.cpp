@@ -40,6 +40,7 @@ struct DeviceMaterialData {
 	bool depth_tested;
 	bool culled = true;
 	bool blended = false;
+	SpirV packed_vert = SpirV::MaxSpirV;
 };
 
 static constexpr SpirV compute_spirvs[] = {
@@ -51,13 +52,18 @@ static constexpr SpirV compute_spirvs[] = {
 		SpirV::PickingComp,
 		SpirV::DepthAlphaComp,
 		SpirV::CopyComp,
+		SpirV::MeshletCullComp,
+		SpirV::SkinningComp,
+		SpirV::LightClusterComp,
+		SpirV::HiZComp,
+		SpirV::OcclusionCullComp,
 	};
 
 static constexpr DeviceMaterialData material_datas[] = {
-		{SpirV::BasicFrag, SpirV::BasicVert, true},
+		{SpirV::BasicFrag, SpirV::BasicVert, true, true, false, SpirV::PackedVert},
 		{SpirV::SkinnedFrag, SpirV::SkinnedVert, true},
 
-		{SpirV::TexturedFrag, SpirV::BasicVert, true},
+		{SpirV::TexturedFrag, SpirV::BasicVert, true, true, false, SpirV::PackedVert},
 
 		{SpirV::TonemapFrag, SpirV::ScreenVert, false},
 		{SpirV::ImguiFrag, SpirV::ImguiVert, false, false, true},
@@ -72,6 +78,11 @@ static constexpr const char* spirv_names[] = {
 		"picking.comp",
 		"depth_alpha.comp",
 		"copy.comp",
+		"meshlet_cull.comp",
+		"skinning.comp",
+		"light_cluster.comp",
+		"hiz.comp",
+		"occlusion_cull.comp",
 
 		"tonemap.frag",
 		"basic.frag",
@@ -81,6 +92,7 @@ static constexpr const char* spirv_names[] = {
 
 		"basic.vert",
 		"skinned.vert",
+		"packed.vert",
 		"screen.vert",
 		"imgui.vert",
 	};
@@ -131,6 +143,9 @@ DeviceResources::DeviceResources(DevicePtr dptr) :
 				.set_culled(data.culled)
 				.set_blended(data.blended)
 			;
+		if(data.packed_vert != SpirV::MaxSpirV) {
+			template_data.set_packed_vert_data(_spirv[data.packed_vert]);
+		}
 		_materials[i] = MaterialTemplate(dptr, std::move(template_data));
 	}
 
@@ -46,6 +46,11 @@ class DeviceResources final : NonCopyable {
 			PickingComp,
 			DepthAlphaComp,
 			CopyComp,
+			MeshletCullComp,
+			SkinningComp,
+			LightClusterComp,
+			HiZComp,
+			OcclusionCullComp,
 
 			TonemapFrag,
 			BasicFrag,
@@ -55,6 +60,7 @@ class DeviceResources final : NonCopyable {
 
 			BasicVert,
 			SkinnedVert,
+			PackedVert,
 			ScreenVert,
 			ImguiVert,
 
@@ -70,6 +76,11 @@ class DeviceResources final : NonCopyable {
 			PickingProgram,
 			DepthAlphaProgram,
 			CopyProgram,
+			MeshletCullProgram,
+			SkinningProgram,
+			LightClusterProgram,
+			HiZProgram,
+			OcclusionCullProgram,
 
 			MaxComputePrograms
 		};
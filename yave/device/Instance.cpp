@@ -24,9 +24,11 @@ SOFTWARE.
 
 namespace yave {
 
-Instance::Instance(DebugParams debug) : _debug_params(debug) {
+Instance::Instance(DebugParams debug, bool headless) : _debug_params(debug), _headless(headless) {
 	auto extention_names = core::vector_with_capacity<const char*>(4);
-	extention_names = {VK_KHR_SURFACE_EXTENSION_NAME};
+	if(!_headless) {
+		extention_names << VK_KHR_SURFACE_EXTENSION_NAME;
+	}
 
 	if(_debug_params.debug_features_enabled()) {
 		extention_names << DebugCallback::name();
@@ -34,7 +36,9 @@ Instance::Instance(DebugParams debug) : _debug_params(debug) {
 
 
 	#ifdef Y_OS_WIN
+	if(!_headless) {
 		extention_names << VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
+	}
 	#endif
 
 	auto app_info = vk::ApplicationInfo()
@@ -66,6 +70,10 @@ const DebugParams& Instance::debug_params() const {
 	return _debug_params;
 }
 
+bool Instance::is_headless() const {
+	return _headless;
+}
+
 vk::Instance Instance::vk_instance() const {
 	return _instance;
 }
@@ -33,10 +33,12 @@ namespace yave {
 
 class Instance : NonMovable {
 	public:
-		Instance(DebugParams debug);
+		// headless instances don't enable any surface extension and can only render offscreen
+		Instance(DebugParams debug, bool headless = false);
 		~Instance();
 
 		const DebugParams& debug_params() const;
+		bool is_headless() const;
 
 		vk::Instance vk_instance() const;
 
@@ -48,6 +50,8 @@ class Instance : NonMovable {
 		DebugParams _debug_params;
 		vk::Instance _instance;
 
+		bool _headless = false;
+
 };
 
 }
@@ -25,17 +25,51 @@ SOFTWARE.
 
 namespace yave {
 
-static bool is_device_ok(vk::PhysicalDevice device) {
-	return device.getProperties().deviceType == vk::PhysicalDeviceType::eDiscreteGpu;
+// discrete GPUs first, software implementations (lavapipe, SwiftShader) are only used as a last resort
+static u32 device_score(vk::PhysicalDevice device) {
+	switch(device.getProperties().deviceType) {
+		case vk::PhysicalDeviceType::eDiscreteGpu:
+			return 4;
+		case vk::PhysicalDeviceType::eIntegratedGpu:
+			return 3;
+		case vk::PhysicalDeviceType::eVirtualGpu:
+			return 2;
+		case vk::PhysicalDeviceType::eCpu:
+			return 1;
+		default:
+			return 0;
+	}
 }
 
 static vk::PhysicalDevice choose_device(vk::Instance instance) {
+	vk::PhysicalDevice best;
+	u32 best_score = 0;
 	for(auto dev : instance.enumeratePhysicalDevices()) {
-		if(is_device_ok(dev)) {
-			return dev;
+		u32 score = device_score(dev);
+		if(score > best_score) {
+			best = dev;
+			best_score = score;
 		}
 	}
-	return y_fatal("Unable to find a compatible device.");
+	if(!best_score) {
+		y_fatal("Unable to find a compatible device.");
+	}
+	return best;
+}
+
+static const char* device_type_name(vk::PhysicalDeviceType type) {
+	switch(type) {
+		case vk::PhysicalDeviceType::eDiscreteGpu:
+			return "discrete";
+		case vk::PhysicalDeviceType::eIntegratedGpu:
+			return "integrated";
+		case vk::PhysicalDeviceType::eVirtualGpu:
+			return "virtual";
+		case vk::PhysicalDeviceType::eCpu:
+			return "software";
+		default:
+			return "unknown";
+	}
 }
 
 
@@ -56,7 +90,7 @@ PhysicalDevice::PhysicalDevice(Instance& instance) :
 	const auto& v_ref = _properties.apiVersion;
 	auto version = reinterpret_cast<const Version&>(v_ref);
 	log_msg(fmt("Running Vulkan (%.%.%) % bits on % (%)", u32(version.major), u32(version.minor), u32(version.patch),
-			is_64_bits() ? 64 : 32, _properties.deviceName, (_properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu ? "discrete" : "integrated")));
+			is_64_bits() ? 64 : 32, _properties.deviceName, device_type_name(_properties.deviceType)));
 }
 
 PhysicalDevice::~PhysicalDevice() {
@@ -0,0 +1,47 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "DrawIndirectCount.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace yave {
+
+const char* DrawIndirectCount::name() {
+	return VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME;
+}
+
+bool DrawIndirectCount::is_supported(vk::PhysicalDevice physical) {
+	auto extensions = physical.enumerateDeviceExtensionProperties();
+	return std::any_of(extensions.begin(), extensions.end(), [](const vk::ExtensionProperties& ext) { return !std::strcmp(ext.extensionName, name()); });
+}
+
+DrawIndirectCount::DrawIndirectCount(vk::Device device) {
+	_draw_indexed = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(device.getProcAddr("vkCmdDrawIndexedIndirectCountKHR"));
+}
+
+void DrawIndirectCount::draw_indexed(vk::CommandBuffer buffer, vk::Buffer commands, vk::DeviceSize offset, vk::Buffer count, vk::DeviceSize count_offset, u32 max_draw_count, u32 stride) const {
+	_draw_indexed(buffer, commands, offset, count, count_offset, max_draw_count, stride);
+}
+
+}
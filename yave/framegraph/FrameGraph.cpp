@@ -22,6 +22,8 @@ SOFTWARE.
 
 #include "FrameGraph.h"
 
+#include <y/mem/LinearAllocator.h>
+
 namespace yave {
 
 FrameGraph::FrameGraph(const std::shared_ptr<FrameGraphResourcePool>& pool) : _pool(pool) {
@@ -35,8 +37,8 @@ const FrameGraphResourcePool* FrameGraph::resources() const {
 	return _pool.get();
 }
 
-template<typename C, typename B>
-static void build_barriers(const C& resources, B& barriers, std::unordered_map<FrameGraphResourceId, PipelineStage>& to_barrier, FrameGraphResourcePool* pool) {
+template<typename C, typename B, typename F>
+static void build_barriers(const C& resources, B& barriers, core::FlatHashMap<FrameGraphResourceId, PipelineStage>& to_barrier, F&& create_barrier) {
 	for(auto&& [res, info] : resources) {
 		auto it = to_barrier.find(res);
 		bool exists = it != to_barrier.end();
@@ -48,7 +50,7 @@ static void build_barriers(const C& resources, B& barriers, std::unordered_map<F
 		}
 
 		if(exists) {
-			barriers.emplace_back(pool->barrier(res, it->second, info.stage));
+			barriers.emplace_back(create_barrier(res, it->second, info.stage));
 			it->second = info.stage;
 		} else {
 			to_barrier[res] = info.stage;
@@ -61,18 +63,23 @@ static bool is_none(U u) {
 	return u == U::None;
 }
 
-void FrameGraph::render(CmdBufferRecorder& recorder) && {
+void FrameGraph::render(CmdBufferRecorder& recorder, TimeQuery* timestamps) && {
 	y_profile();
 #warning no pass culling
 
 	alloc_resources();
 
-	std::unordered_map<FrameGraphResourceId, PipelineStage> to_barrier;
-	core::Vector<BufferBarrier> buffer_barriers;
-	core::Vector<ImageBarrier> image_barriers;
+	if(timestamps) {
+		timestamps->begin_frame(recorder);
+	}
+
+	core::FlatHashMap<FrameGraphResourceId, PipelineStage> to_barrier;
+	core::FrameVector<BufferBarrier> buffer_barriers;
+	core::FrameVector<ImageBarrier> image_barriers;
 	for(const auto& pass : _passes) {
 		y_profile_zone(pass->name());
 		auto region = recorder.region(pass->name());
+		const u32 timestamp_zone = timestamps ? timestamps->begin_zone(recorder, pass->name()) : u32(-1);
 
 		{
 			y_profile_zone("init");
@@ -84,8 +91,9 @@ void FrameGraph::render(CmdBufferRecorder& recorder) && {
 			y_profile_zone("barriers");
 			buffer_barriers.make_empty();
 			image_barriers.make_empty();
-			build_barriers(pass->_buffers, buffer_barriers, to_barrier, _pool.get());
-			build_barriers(pass->_images, image_barriers, to_barrier, _pool.get());
+			auto create_barrier = [this](auto res, PipelineStage src, PipelineStage dst) { return barrier(res, src, dst); };
+			build_barriers(pass->_buffers, buffer_barriers, to_barrier, create_barrier);
+			build_barriers(pass->_images, image_barriers, to_barrier, create_barrier);
 			recorder.barriers(buffer_barriers, image_barriers);
 		}
 
@@ -93,6 +101,10 @@ void FrameGraph::render(CmdBufferRecorder& recorder) && {
 			y_profile_zone("render");
 			pass->render(recorder);
 		}
+
+		if(timestamps) {
+			timestamps->end_zone(recorder, timestamp_zone);
+		}
 	}
 
 #warning barrier resources at end
@@ -165,6 +177,24 @@ FrameGraphMutableBufferId FrameGraph::declare_buffer(usize byte_size) {
 	return res;
 }
 
+FrameGraphMutableBufferId FrameGraph::import_buffer(const SubBufferBase& buffer) {
+	FrameGraphMutableBufferId res;
+	res._id = _pool->create_resource_id();
+	_imported_buffers[res] = buffer;
+	return res;
+}
+
+ImageBarrier FrameGraph::barrier(FrameGraphImageId res, PipelineStage src, PipelineStage dst) const {
+	return _pool->barrier(res, src, dst);
+}
+
+BufferBarrier FrameGraph::barrier(FrameGraphBufferId res, PipelineStage src, PipelineStage dst) const {
+	if(auto it = _imported_buffers.find(res); it != _imported_buffers.end()) {
+		return BufferBarrier(it->second, src, dst);
+	}
+	return _pool->barrier(res, src, dst);
+}
+
 FrameGraphPassBuilder FrameGraph::add_pass(std::string_view name) {
 	auto pass = std::make_unique<FrameGraphPass>(name, this);
 	FrameGraphPass* ptr = pass.get();
@@ -188,6 +218,10 @@ void FrameGraph::add_usage(FrameGraphImageId res, ImageUsage usage) {
 }
 
 void FrameGraph::add_usage(FrameGraphBufferId res, BufferUsage usage) {
+	// imported buffers are created by their owner
+	if(_imported_buffers.find(res) != _imported_buffers.end()) {
+		return;
+	}
 	auto& info = check_exists(_buffers, res);
 	info.usage = info.usage | usage;
 }
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "FrameGraphPassBuilder.h"
 
 #include <yave/graphics/barriers/Barrier.h>
+#include <yave/graphics/commands/TimeQuery.h>
 
 namespace yave {
 
@@ -50,7 +51,8 @@ class FrameGraph : NonCopyable {
 		const FrameGraphResourcePool* resources() const;
 
 
-		void render(CmdBufferRecorder& recorder) &&;
+		// if timestamps isn't null, every pass is timed on the GPU
+		void render(CmdBufferRecorder& recorder, TimeQuery* timestamps = nullptr) &&;
 
 
 		FrameGraphPassBuilder add_pass(std::string_view name);
@@ -58,6 +60,9 @@ class FrameGraph : NonCopyable {
 		FrameGraphMutableImageId declare_image(ImageFormat format, const math::Vec2ui& size);
 		FrameGraphMutableBufferId declare_buffer(usize byte_size);
 
+		// persistent buffer owned by the caller, only synchronized between the passes of this graph
+		FrameGraphMutableBufferId import_buffer(const SubBufferBase& buffer);
+
 		template<typename T>
 		FrameGraphMutableTypedBufferId<T> declare_typed_buffer(usize size = 1) {
 			return FrameGraphMutableTypedBufferId<T>::from_untyped(declare_buffer(sizeof(T) * size));
@@ -77,13 +82,17 @@ class FrameGraph : NonCopyable {
 		void alloc_resources();
 		void release_resources(CmdBufferRecorder& recorder);
 
+		ImageBarrier barrier(FrameGraphImageId res, PipelineStage src, PipelineStage dst) const;
+		BufferBarrier barrier(FrameGraphBufferId res, PipelineStage src, PipelineStage dst) const;
+
 		std::shared_ptr<FrameGraphResourcePool> _pool;
 
 		core::Vector<std::unique_ptr<FrameGraphPass>> _passes;
 
 		using hash_t = std::hash<FrameGraphResourceId>;
-		std::unordered_map<FrameGraphImageId, ImageCreateInfo, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, BufferCreateInfo, hash_t> _buffers;
+		core::FlatHashMap<FrameGraphImageId, ImageCreateInfo, hash_t> _images;
+		core::FlatHashMap<FrameGraphBufferId, BufferCreateInfo, hash_t> _buffers;
+		core::FlatHashMap<FrameGraphBufferId, SubBufferBase, hash_t> _imported_buffers;
 
 };
 
@@ -23,6 +23,8 @@ SOFTWARE.
 #include "FrameGraphPass.h"
 #include "FrameGraph.h"
 
+#include <y/mem/LinearAllocator.h>
+
 namespace yave {
 
 FrameGraphPass::FrameGraphPass(std::string_view name, FrameGraph* parent) : _name(name), _parent(parent) {
@@ -62,14 +64,14 @@ void FrameGraphPass::init_framebuffer(FrameGraphResourcePool* pool) {
 		for(auto&& color : _colors) {
 			colors << pool->image<ImageUsage::ColorBit>(color);
 		}
-		_framebuffer = Framebuffer(pool->device(), depth, colors);
+		_framebuffer = Framebuffer(pool->device(), depth, colors, _load_op);
 	}
 }
 
 void FrameGraphPass::init_descriptor_sets(FrameGraphResourcePool* pool) {
 	y_profile();
 	for(const auto& set : _bindings) {
-		auto bindings = core::vector_with_capacity<Binding>(set.size());
+		auto bindings = core::frame_vector_with_capacity<Binding>(set.size());
 		std::transform(set.begin(), set.end(), std::back_inserter(bindings), [=](const FrameGraphDescriptorBinding& b) { return b.create_binding(pool); });
 		_descriptor_sets << DescriptorSet(pool->device(), bindings);
 	}
@@ -23,6 +23,7 @@ SOFTWARE.
 #define YAVE_FRAMEGRAPH_FRAMEGRAPHPASS_H
 
 #include <y/core/Functor.h>
+#include <y/core/FlatHashMap.h>
 
 #include <yave/graphics/bindings/DescriptorSet.h>
 
@@ -67,14 +68,15 @@ class FrameGraphPass : NonCopyable {
 		FrameGraph* _parent = nullptr;
 
 		using hash_t = std::hash<FrameGraphResourceId>;
-		std::unordered_map<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
+		core::FlatHashMap<FrameGraphImageId, ResourceUsageInfo, hash_t> _images;
+		core::FlatHashMap<FrameGraphBufferId, ResourceUsageInfo, hash_t> _buffers;
 
 		core::Vector<core::Vector<FrameGraphDescriptorBinding>> _bindings;
 		core::Vector<DescriptorSet> _descriptor_sets;
 
 		FrameGraphImageId _depth;
 		core::Vector<FrameGraphImageId> _colors;
+		Framebuffer::LoadOp _load_op = Framebuffer::LoadOp::Clear;
 
 		Framebuffer _framebuffer;
 };
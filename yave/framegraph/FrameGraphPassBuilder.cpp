@@ -40,18 +40,20 @@ void FrameGraphPassBuilder::add_texture_input(FrameGraphImageId res, PipelineSta
 	add_to_pass(res, ImageUsage::TextureBit, stage);
 }
 
-void FrameGraphPassBuilder::add_depth_output(FrameGraphMutableImageId res) {
+void FrameGraphPassBuilder::add_depth_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op) {
 	// transition is done by the renderpass
 	add_to_pass(res, ImageUsage::DepthBit, PipelineStage::None);
 	if(_pass->_depth.is_valid()) {
 		y_fatal("Pass already has a depth output.");
 	}
+	set_load_op(load_op);
 	_pass->_depth = res;
 }
 
-void FrameGraphPassBuilder::add_color_output(FrameGraphMutableImageId res) {
+void FrameGraphPassBuilder::add_color_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op) {
 	// transition is done by the renderpass
 	add_to_pass(res, ImageUsage::ColorBit, PipelineStage::None);
+	set_load_op(load_op);
 	_pass->_colors << res;
 }
 
@@ -75,6 +77,10 @@ void FrameGraphPassBuilder::add_storage_output(FrameGraphMutableBufferId res, us
 	add_uniform(FrameGraphDescriptorBinding::create_storage_binding(res), ds_index);
 }
 
+void FrameGraphPassBuilder::add_unbound_storage_output(FrameGraphMutableBufferId res, PipelineStage stage) {
+	add_to_pass(res, BufferUsage::StorageBit, stage);
+}
+
 
 // --------------------------------- Storage intput ---------------------------------
 
@@ -128,6 +134,10 @@ void FrameGraphPassBuilder::add_index_input(FrameGraphBufferId res, PipelineStag
 	add_to_pass(res, BufferUsage::IndexBit, stage);
 }
 
+void FrameGraphPassBuilder::add_indirect_input(FrameGraphBufferId res, PipelineStage stage) {
+	add_to_pass(res, BufferUsage::IndirectBit, stage);
+}
+
 
 // --------------------------------- stuff ---------------------------------
 
@@ -161,4 +171,11 @@ void FrameGraphPassBuilder::set_cpu_visible(FrameGraphMutableBufferId res) {
 	_pass->_parent->set_cpu_visible(res);
 }
 
+void FrameGraphPassBuilder::set_load_op(Framebuffer::LoadOp load_op) {
+	if(load_op != _pass->_load_op && (_pass->_depth.is_valid() || _pass->_colors.size())) {
+		y_fatal("Pass outputs have different load operations.");
+	}
+	_pass->_load_op = load_op;
+}
+
 }
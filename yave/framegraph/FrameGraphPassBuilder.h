@@ -31,14 +31,18 @@ class FrameGraphPassBuilder {
 	public:
 		void add_texture_input(FrameGraphImageId res, PipelineStage stage);
 
-		void add_depth_output(FrameGraphMutableImageId res);
-		void add_color_output(FrameGraphMutableImageId res);
+		// every attachment of a pass must use the same load operation
+		void add_depth_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op = Framebuffer::LoadOp::Clear);
+		void add_color_output(FrameGraphMutableImageId res, Framebuffer::LoadOp load_op = Framebuffer::LoadOp::Clear);
 
 		void add_copy_src(FrameGraphImageId res);
 
 		void add_storage_output(FrameGraphMutableImageId res, usize ds_index = 0, PipelineStage stage = PipelineStage::ComputeBit);
 		void add_storage_output(FrameGraphMutableBufferId res, usize ds_index = 0, PipelineStage stage = PipelineStage::ComputeBit);
 
+		// for buffers bound by the render func itself
+		void add_unbound_storage_output(FrameGraphMutableBufferId res, PipelineStage stage = PipelineStage::ComputeBit);
+
 		void add_storage_input(FrameGraphBufferId res, usize ds_index = 0, PipelineStage stage = PipelineStage::AllShadersBit);
 		void add_storage_input(FrameGraphImageId res, usize ds_index = 0, PipelineStage stage = PipelineStage::AllShadersBit);
 		void add_uniform_input(FrameGraphBufferId res, usize ds_index = 0, PipelineStage stage = PipelineStage::AllShadersBit);
@@ -50,6 +54,7 @@ class FrameGraphPassBuilder {
 
 		void add_attrib_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
 		void add_index_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::VertexInputBit);
+		void add_indirect_input(FrameGraphBufferId res, PipelineStage stage = PipelineStage::DrawIndirectBit);
 
 		template<typename T>
 		void map_update(FrameGraphMutableTypedBufferId<T> res) {
@@ -71,6 +76,7 @@ class FrameGraphPassBuilder {
 		void add_uniform(FrameGraphDescriptorBinding binding, usize ds_index);
 
 		void set_cpu_visible(FrameGraphMutableBufferId res);
+		void set_load_op(Framebuffer::LoadOp load_op);
 
 
 		FrameGraphPass* _pass = nullptr;
@@ -35,7 +35,7 @@ FrameGraphResourcePool::FrameGraphResourcePool(DevicePtr dptr) : DeviceLinked(dp
 }
 
 FrameGraphResourcePool::~FrameGraphResourcePool() {
-	if(!_images.empty() || !_buffers.empty()) {
+	if(!_images.is_empty() || !_buffers.is_empty()) {
 		y_fatal("Not all resources have been released.");
 	}
 }
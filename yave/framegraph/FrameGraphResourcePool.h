@@ -85,8 +85,8 @@ class FrameGraphResourcePool : NonCopyable, public DeviceLinked {
 		bool create_buffer_from_pool(TransientBuffer& res, usize byte_size, BufferUsage usage, MemoryType memory);
 
 		using hash_t = std::hash<FrameGraphResourceId>;
-		std::unordered_map<FrameGraphImageId, TransientImage<>, hash_t> _images;
-		std::unordered_map<FrameGraphBufferId, TransientBuffer, hash_t> _buffers;
+		core::FlatHashMap<FrameGraphImageId, TransientImage<>, hash_t> _images;
+		core::FlatHashMap<FrameGraphBufferId, TransientBuffer, hash_t> _buffers;
 
 		core::Vector<TransientImage<>> _released_images;
 		core::Vector<TransientBuffer> _released_buffers;
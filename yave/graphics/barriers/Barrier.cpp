@@ -97,6 +97,12 @@ static vk::AccessFlags vk_dst_access_flags(PipelineStage dst) {
 		case PipelineStage::HostBit:
 			return vk::AccessFlagBits::eHostRead;
 
+		case PipelineStage::VertexInputBit:
+			return vk::AccessFlagBits::eIndexRead | vk::AccessFlagBits::eVertexAttributeRead;
+
+		case PipelineStage::DrawIndirectBit:
+			return vk::AccessFlagBits::eIndirectCommandRead;
+
 		default:
 			break;
 	}
@@ -117,6 +123,10 @@ static vk::AccessFlags vk_src_access_flags(PipelineStage src) {
 		case PipelineStage::ColorAttachmentOutBit:
 			return vk::AccessFlagBits::eColorAttachmentWrite;
 
+		// vertices are only read, waiting for the stage is enough
+		case PipelineStage::VertexInputBit:
+			return vk::AccessFlags();
+
 		default:
 			break;
 	}
@@ -33,6 +33,7 @@ enum class PipelineStage {
 	EndOfPipe = uenum(vk::PipelineStageFlagBits::eTopOfPipe),
 
 	TransferBit = uenum(vk::PipelineStageFlagBits::eTransfer),
+	DrawIndirectBit = uenum(vk::PipelineStageFlagBits::eDrawIndirect),
 	HostBit = uenum(vk::PipelineStageFlagBits::eHost),
 	VertexInputBit = uenum(vk::PipelineStageFlagBits::eVertexInput),
 	VertexBit = uenum(vk::PipelineStageFlagBits::eVertexShader),
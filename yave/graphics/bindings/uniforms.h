@@ -40,15 +40,27 @@ struct Camera {
 
 using Frustum = yave::Frustum;
 
+static constexpr u32 no_shadow = u32(-1);
+
 struct Light {
 	math::Vec3 position;
 	float radius;
 	math::Vec3 color;
 	u32 type;
+	// index of the first ShadowMap, point lights use 6 consecutive maps
+	u32 shadow_index = no_shadow;
+	u32 padding[3] = {};
+};
+
+struct ShadowMap {
+	math::Matrix4<> view_proj;
+	math::Vec2 uv_offset;
+	math::Vec2 uv_mul;
 };
 
 static_assert(sizeof(Camera) % 16 == 0);
 static_assert(sizeof(Light) % 16 == 0);
+static_assert(sizeof(ShadowMap) % 16 == 0);
 
 }
 }
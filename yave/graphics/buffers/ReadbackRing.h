@@ -0,0 +1,126 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_GRAPHICS_BUFFERS_READBACKRING_H
+#define YAVE_GRAPHICS_BUFFERS_READBACKRING_H
+
+#include "TypedWrapper.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace yave {
+
+// Ring of host visible buffers written by the GPU, one slot per frame.
+// A slot is read back once the command buffer that keeps its frame alive is done, and only then reused.
+// Completed frames are read back oldest first, the ring grows if every slot is still in flight.
+template<typename T>
+class ReadbackRing : NonCopyable {
+
+	public:
+		using BufferType = TypedBuffer<T, BufferUsage::StorageBit, MemoryType::CpuVisible>;
+
+	private:
+		struct Slot : NonCopyable {
+			Slot(DevicePtr dptr, usize size) : buffer(dptr, size) {
+			}
+
+			BufferType buffer;
+			u64 frame = 0;
+			// written by a frame that hasn't been read back yet
+			bool pending = false;
+			std::atomic<bool> in_flight = false;
+		};
+
+	public:
+		// released once the GPU is done with the frame, pass it to CmdBufferRecorder::keep_alive
+		class Frame : NonCopyable {
+			public:
+				Frame(std::shared_ptr<Slot> slot) : _slot(std::move(slot)) {
+				}
+
+				~Frame() {
+					_slot->in_flight = false;
+				}
+
+				const BufferType& buffer() const {
+					return _slot->buffer;
+				}
+
+			private:
+				std::shared_ptr<Slot> _slot;
+		};
+
+		ReadbackRing() = default;
+
+		ReadbackRing(DevicePtr dptr, usize size) : _device(dptr), _size(size) {
+		}
+
+		// calls read_back with a TypedMapping<T> of every completed frame, oldest first, and returns the frame to write next, zero filled
+		template<typename F>
+		std::shared_ptr<Frame> next_frame(F&& read_back) {
+			while(Slot* oldest = oldest_pending()) {
+				if(oldest->in_flight) {
+					break;
+				}
+				TypedMapping<T> mapping(oldest->buffer);
+				read_back(mapping);
+				oldest->pending = false;
+			}
+
+			auto it = std::find_if(_slots.begin(), _slots.end(), [](const auto& slot) { return !slot->pending; });
+			if(it == _slots.end()) {
+				_slots << std::make_shared<Slot>(_device, _size);
+				it = _slots.end() - 1;
+			}
+
+			Slot& slot = **it;
+			{
+				TypedMapping<T> mapping(slot.buffer);
+				std::fill(mapping.begin(), mapping.end(), T());
+			}
+			slot.frame = ++_frame;
+			slot.pending = true;
+			slot.in_flight = true;
+			return std::make_shared<Frame>(*it);
+		}
+
+	private:
+		Slot* oldest_pending() const {
+			Slot* oldest = nullptr;
+			for(const auto& slot : _slots) {
+				if(slot->pending && (!oldest || slot->frame < oldest->frame)) {
+					oldest = slot.get();
+				}
+			}
+			return oldest;
+		}
+
+		DevicePtr _device = nullptr;
+		usize _size = 0;
+
+		core::Vector<std::shared_ptr<Slot>> _slots;
+		u64 _frame = 0;
+};
+
+}
+
+#endif // YAVE_GRAPHICS_BUFFERS_READBACKRING_H
@@ -52,11 +52,17 @@ using TypedUniformBuffer = TypedBuffer<T, BufferUsage::UniformBit, Memory>;
 template<MemoryType Memory = prefered_memory_type(BufferUsage::IndexBit)>
 using TriangleBuffer = TypedBuffer<IndexedTriangle, BufferUsage::IndexBit | BufferUsage::TransferDstBit, Memory>;
 
+template<MemoryType Memory = prefered_memory_type(BufferUsage::IndexBit)>
+using ShortTriangleBuffer = TypedBuffer<ShortIndexedTriangle, BufferUsage::IndexBit | BufferUsage::TransferDstBit, Memory>;
+
 template<MemoryType Memory = prefered_memory_type(BufferUsage::AttributeBit)>
 using VertexBuffer = TypedBuffer<Vertex, BufferUsage::AttributeBit | BufferUsage::TransferDstBit, Memory>;
 
 template<MemoryType Memory = prefered_memory_type(BufferUsage::AttributeBit)>
-using SkinnedVertexBuffer = TypedBuffer<SkinnedVertex, BufferUsage::AttributeBit | BufferUsage::TransferDstBit, Memory>;
+using PackedVertexBuffer = TypedBuffer<PackedVertex, BufferUsage::AttributeBit | BufferUsage::TransferDstBit, Memory>;
+
+template<MemoryType Memory = MemoryType::DeviceLocal>
+using SkinnedVertexBuffer = TypedBuffer<SkinnedVertex, BufferUsage::StorageBit | BufferUsage::TransferDstBit, Memory>;
 
 template<MemoryType Memory = prefered_memory_type(BufferUsage::IndirectBit)>
 using IndirectBuffer = TypedBuffer<vk::DrawIndexedIndirectCommand, BufferUsage::IndirectBit | BufferUsage::TransferDstBit, Memory>;
@@ -66,8 +72,9 @@ template<typename T>
 using AttribSubBuffer = TypedSubBuffer<T, BufferUsage::AttributeBit>;
 
 using TriangleSubBuffer = TypedSubBuffer<IndexedTriangle, BufferUsage::IndexBit>;
+using ShortTriangleSubBuffer = TypedSubBuffer<ShortIndexedTriangle, BufferUsage::IndexBit>;
 using VertexSubBuffer = TypedSubBuffer<Vertex, BufferUsage::AttributeBit>;
-using SkinnedVertexSubBuffer = TypedSubBuffer<SkinnedVertex, BufferUsage::AttributeBit>;
+using PackedVertexSubBuffer = TypedSubBuffer<PackedVertex, BufferUsage::AttributeBit>;
 using IndirectSubBuffer = TypedSubBuffer<vk::DrawIndexedIndirectCommand, BufferUsage::IndirectBit>;
 
 }
@@ -89,12 +89,13 @@ void RenderPassRecorder::bind_material(const Material& material) {
 	bind_material(material.mat_template(), {material.descriptor_set()});
 }
 
-void RenderPassRecorder::bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets) {
-	bind_pipeline(material->compile(*_cmd_buffer._render_pass), descriptor_sets);
+void RenderPassRecorder::bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets, VertexFormat vertex_format) {
+	bind_pipeline(material->compile(*_cmd_buffer._render_pass, vertex_format), descriptor_sets);
 }
 
 void RenderPassRecorder::bind_pipeline(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets) {
 	vk_cmd_buffer().bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.vk_pipeline());
+	_pipeline_layout = pipeline.vk_pipeline_layout();
 
 	auto ds = core::vector_with_capacity<vk::DescriptorSet>(descriptor_sets.size() + 1);
 	std::transform(descriptor_sets.begin(), descriptor_sets.end(), std::back_inserter(ds), [](const auto& ds) { return ds.get().vk_descriptor_set(); });
@@ -104,6 +105,14 @@ void RenderPassRecorder::bind_pipeline(const GraphicPipeline& pipeline, Descript
 	}
 }
 
+void RenderPassRecorder::push_constants(const PushConstant& push_constants, vk::ShaderStageFlags stages) {
+	if(!_pipeline_layout) {
+		y_fatal("No pipeline bound.");
+	}
+	if(!push_constants.is_empty()) {
+		vk_cmd_buffer().pushConstants(_pipeline_layout, stages, 0, push_constants.size(), push_constants.data());
+	}
+}
 
 void RenderPassRecorder::draw(const vk::DrawIndexedIndirectCommand& indirect) {
 	vk_cmd_buffer().drawIndexed(indirect.indexCount,
@@ -120,13 +129,28 @@ void RenderPassRecorder::draw(const vk::DrawIndirectCommand& indirect) {
 						 indirect.firstInstance);
 }
 
-void RenderPassRecorder::bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs) {
-	bind_index_buffer(indices);
+void RenderPassRecorder::draw_indirect(const IndirectSubBuffer& commands, usize index, usize count) {
+	usize stride = sizeof(vk::DrawIndexedIndirectCommand);
+	vk_cmd_buffer().drawIndexedIndirect(commands.vk_buffer(), commands.byte_offset() + index * stride, u32(count), stride);
+}
+
+void RenderPassRecorder::draw_indirect_count(const IndirectSubBuffer& commands, usize index, const TypedSubBuffer<u32, BufferUsage::IndirectBit>& counts, usize count_index, usize max_count) {
+	const DrawIndirectCount* ext = device()->draw_indirect_count();
+	if(!ext) {
+		y_fatal("VK_KHR_draw_indirect_count is not supported.");
+	}
+	usize stride = sizeof(vk::DrawIndexedIndirectCommand);
+	ext->draw_indexed(vk_cmd_buffer(), commands.vk_buffer(), commands.byte_offset() + index * stride,
+					  counts.vk_buffer(), counts.byte_offset() + count_index * sizeof(u32), u32(max_count), u32(stride));
+}
+
+void RenderPassRecorder::bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs, vk::IndexType index_type) {
+	bind_index_buffer(indices, index_type);
 	bind_attrib_buffers(attribs);
 }
 
-void RenderPassRecorder::bind_index_buffer(const SubBuffer<BufferUsage::IndexBit>& indices) {
-	vk_cmd_buffer().bindIndexBuffer(indices.vk_buffer(), indices.byte_offset(), vk::IndexType::eUint32);
+void RenderPassRecorder::bind_index_buffer(const SubBuffer<BufferUsage::IndexBit>& indices, vk::IndexType index_type) {
+	vk_cmd_buffer().bindIndexBuffer(indices.vk_buffer(), indices.byte_offset(), index_type);
 }
 
 void RenderPassRecorder::bind_attrib_buffers(const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs) {
@@ -144,6 +168,25 @@ const Viewport& RenderPassRecorder::viewport() const {
 	return _viewport;
 }
 
+void RenderPassRecorder::set_viewport(const Viewport& viewport) {
+	_viewport = viewport;
+	vk_cmd_buffer().setViewport(0, {vk::Viewport(viewport.offset.x(), viewport.offset.y(), viewport.extent.x(), viewport.extent.y(), viewport.depth.x(), viewport.depth.y())});
+	vk_cmd_buffer().setScissor(0, {vk::Rect2D(vk::Offset2D(i32(viewport.offset.x()), i32(viewport.offset.y())), vk::Extent2D(u32(viewport.extent.x()), u32(viewport.extent.y())))});
+}
+
+void RenderPassRecorder::clear_depth(float depth) {
+	auto attachment = vk::ClearAttachment()
+			.setAspectMask(vk::ImageAspectFlagBits::eDepth)
+			.setClearValue(vk::ClearDepthStencilValue(depth, 0))
+		;
+	auto rect = vk::ClearRect()
+			.setRect(vk::Rect2D(vk::Offset2D(i32(_viewport.offset.x()), i32(_viewport.offset.y())), vk::Extent2D(u32(_viewport.extent.x()), u32(_viewport.extent.y()))))
+			.setBaseArrayLayer(0)
+			.setLayerCount(1)
+		;
+	vk_cmd_buffer().clearAttachments(attachment, rect);
+}
+
 CmdBufferRegion RenderPassRecorder::region(const char* name, const math::Vec4& color) {
 	return _cmd_buffer.region(name, color);
 }
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <yave/yave.h>
 #include <yave/graphics/barriers/Barrier.h>
 #include <yave/graphics/framebuffer/Viewport.h>
+#include <yave/graphics/buffers/buffers.h>
 
 #include "CmdBuffer.h"
 
@@ -106,18 +107,34 @@ class RenderPassRecorder : NonCopyable {
 
 		// specific
 		void bind_material(const Material& material);
-		void bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets = {});
+		void bind_material(const MaterialTemplate* material, DescriptorSetList descriptor_sets = {}, VertexFormat vertex_format = VertexFormat::Full);
 		void bind_pipeline(const GraphicPipeline& pipeline, DescriptorSetList descriptor_sets);
 
+		// uses the layout of the last bound pipeline
+		void push_constants(const PushConstant& push_constants, vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eVertex);
+
 		void draw(const vk::DrawIndexedIndirectCommand& indirect);
 		void draw(const vk::DrawIndirectCommand& indirect);
 
-		void bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs);
-		void bind_index_buffer(const SubBuffer<BufferUsage::IndexBit>& indices);
+		// draws count consecutive commands read from the GPU
+		void draw_indirect(const IndirectSubBuffer& commands, usize index, usize count = 1);
+
+		// draws up to max_count consecutive commands, the actual count is read from counts[count_index]
+		// requires VK_KHR_draw_indirect_count, see Device::draw_indirect_count
+		void draw_indirect_count(const IndirectSubBuffer& commands, usize index, const TypedSubBuffer<u32, BufferUsage::IndirectBit>& counts, usize count_index, usize max_count);
+
+		void bind_buffers(const SubBuffer<BufferUsage::IndexBit>& indices, const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs, vk::IndexType index_type = vk::IndexType::eUint32);
+		void bind_index_buffer(const SubBuffer<BufferUsage::IndexBit>& indices, vk::IndexType index_type = vk::IndexType::eUint32);
 		void bind_attrib_buffers(const core::ArrayView<SubBuffer<BufferUsage::AttributeBit>>& attribs);
 
 		const Viewport& viewport() const;
 
+		// also sets the scissor to the viewport
+		void set_viewport(const Viewport& viewport);
+
+		// clears the depth attachment inside the current viewport
+		void clear_depth(float depth = 0.0f);
+
 		// proxies from _cmd_buffer
 		CmdBufferRegion region(const char* name, const math::Vec4& color = math::Vec4());
 		DevicePtr device() const;
@@ -130,6 +147,8 @@ class RenderPassRecorder : NonCopyable {
 
 		CmdBufferRecorder& _cmd_buffer;
 		Viewport _viewport;
+
+		vk::PipelineLayout _pipeline_layout;
 };
 
 class CmdBufferRecorder : public CmdBufferBase {
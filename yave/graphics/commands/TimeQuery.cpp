@@ -24,34 +24,129 @@ SOFTWARE.
 
 #include <yave/device/Device.h>
 
+#include <y/utils/perf.h>
+
 namespace yave {
 
-static vk::QueryPool create_pool(DevicePtr dptr) {
-	return dptr->vk_device().createQueryPool(vk::QueryPoolCreateInfo()
-			.setQueryCount(2)
-			.setQueryType(vk::QueryType::eTimestamp)
-		);
+static u64 timestamp_mask(DevicePtr dptr) {
+	if(!dptr->vk_limits().timestampComputeAndGraphics) {
+		return 0;
+	}
+	const u32 family = dptr->queue_family(QueueFamily::Graphics).index();
+	const u32 bits = dptr->physical_device().vk_physical_device().getQueueFamilyProperties()[family].timestampValidBits;
+	return bits >= 64 ? u64(-1) : (u64(1) << bits) - 1;
 }
 
-TimeQuery::TimeQuery(DevicePtr dptr)  : DeviceLinked(dptr), _pool(create_pool(dptr)) {
+TimeQuery::TimeQuery(DevicePtr dptr, usize latency) :
+		DeviceLinked(dptr),
+		_frames(std::max(latency, usize(1)), Frame()),
+		_period(dptr->vk_limits().timestampPeriod),
+		_mask(timestamp_mask(dptr)),
+		_track(perf::create_track()) {
+
+	if(is_supported()) {
+		_pool = dptr->vk_device().createQueryPool(vk::QueryPoolCreateInfo()
+				.setQueryCount(u32(_frames.size()) * max_zones_per_frame * 2)
+				.setQueryType(vk::QueryType::eTimestamp)
+			);
+	}
 }
 
 TimeQuery::~TimeQuery() {
-	destroy(_pool);
+	if(_pool) {
+		destroy(_pool);
+	}
+}
+
+bool TimeQuery::is_supported() const {
+	return _mask != 0;
+}
+
+u32 TimeQuery::first_query(usize frame) const {
+	return u32(frame) * max_zones_per_frame * 2;
 }
 
-void TimeQuery::start(CmdBufferRecorder& recorder) {
-	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eAllCommands, _pool, 0);
+void TimeQuery::begin_frame(CmdBufferRecorder& recorder) {
+	if(!_pool) {
+		return;
+	}
+
+	// oldest first, so that timings end up being the ones of the last completed frame
+	const usize next = (_current + 1) % _frames.size();
+	for(usize i = 0; i != _frames.size(); ++i) {
+		const usize index = (next + i) % _frames.size();
+		if(!read_back(_frames[index], index, index == next)) {
+			break;
+		}
+	}
+
+	_current = next;
+	Frame& frame = _frames[_current];
+	frame.cpu_start = perf::now();
+	recorder.vk_cmd_buffer().resetQueryPool(_pool, first_query(_current), max_zones_per_frame * 2);
+}
+
+u32 TimeQuery::begin_zone(CmdBufferRecorder& recorder, std::string_view name) {
+	Frame& frame = _frames[_current];
+	if(!_pool || frame.zones.size() == max_zones_per_frame) {
+		return u32(-1);
+	}
+
+	const u32 index = u32(frame.zones.size());
+	frame.zones << Zone{core::String(name), perf::zone_id(name, "gpu")};
+	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _pool, first_query(_current) + index * 2);
+	return index;
+}
+
+void TimeQuery::end_zone(CmdBufferRecorder& recorder, u32 index) {
+	if(index == u32(-1)) {
+		return;
+	}
+	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _pool, first_query(_current) + index * 2 + 1);
+}
+
+bool TimeQuery::read_back(Frame& frame, usize index, bool wait) {
+	if(frame.zones.is_empty()) {
+		return true;
+	}
+
+	const u32 query_count = u32(frame.zones.size() * 2);
+	core::Vector<u64> results(usize(query_count), u64(0));
+
+	// without the wait flag this returns eNotReady instead of blocking if the frame isn't done yet
+	const vk::QueryResultFlags flags = wait ? vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait : vk::QueryResultFlagBits::e64;
+	const vk::Result res = device()->vk_device().getQueryPoolResults(_pool, first_query(index), query_count,
+			results.size() * sizeof(u64), results.data(), sizeof(u64), flags);
+	if(res != vk::Result::eSuccess) {
+		return false;
+	}
+
+	auto to_nanos = [&](u64 begin, u64 end) { return u64(((end - begin) & _mask) * _period); };
+
+	_timings.make_empty();
+	const u64 origin = results[0];
+	for(usize i = 0; i != frame.zones.size(); ++i) {
+		const u64 begin = results[i * 2];
+		const u64 end = results[i * 2 + 1];
+		const u64 duration = to_nanos(begin, end);
+		_timings << Timing{frame.zones[i].name, core::Duration::nanoseconds(duration)};
+
+		// GPU and CPU clocks aren't calibrated: the frame is aligned on the start of its recording
+		const u64 track_begin = frame.cpu_start + perf::nanos_to_ticks(to_nanos(origin, begin));
+		perf::track_zone(_track, frame.zones[i].perf_zone, track_begin, track_begin + perf::nanos_to_ticks(duration));
+	}
+	_frame_time = core::Duration::nanoseconds(to_nanos(origin, results.last()));
+
+	frame.zones.make_empty();
+	return true;
 }
 
-void TimeQuery::stop(CmdBufferRecorder& recorder) {
-	recorder.vk_cmd_buffer().writeTimestamp(vk::PipelineStageFlagBits::eAllCommands, _pool, 1);
+core::ArrayView<TimeQuery::Timing> TimeQuery::timings() const {
+	return _timings;
 }
 
-core::Duration TimeQuery::get() {
-	std::array<u64, 2> results;
-	device()->vk_device().getQueryPoolResults<u64>(_pool, 0, 2, results, 0, vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
-	return core::Duration::nanoseconds(results[1] - results[0]);
+core::Duration TimeQuery::frame_time() const {
+	return _frame_time;
 }
 
 }
@@ -23,25 +23,70 @@ SOFTWARE.
 #define YAVE_GRAPHICS_COMMANDS_TIMEQUERY_H
 
 #include <y/core/Chrono.h>
+#include <y/core/String.h>
 
 #include <yave/yave.h>
 #include "CmdBufferRecorder.h"
 
 namespace yave {
 
+// Ring of timestamp queries, one slot per frame.
+// Completed frames are read back at the start of the next ones, usually with a single frame of latency.
+// The CPU only waits for the GPU if a frame is still running when its slot gets reused, latency frames later.
+// Every recorded frame must be submitted. Use one TimeQuery per view: zones are tracked per frame.
 class TimeQuery : NonCopyable, public DeviceLinked {
 
 	public:
-		TimeQuery(DevicePtr dptr);
+		static constexpr usize default_latency = 4;
+		static constexpr u32 max_zones_per_frame = 128;
+
+		struct Timing {
+			core::String name;
+			core::Duration time;
+		};
+
+		TimeQuery() = default;
+		TimeQuery(DevicePtr dptr, usize latency = default_latency);
 		~TimeQuery();
 
-		void start(CmdBufferRecorder& recorder);
-		void stop(CmdBufferRecorder& recorder);
+		bool is_supported() const;
+
+		// reads back every completed frame, and resets the queries of the oldest one to record a new frame
+		void begin_frame(CmdBufferRecorder& recorder);
 
-		core::Duration get();
+		// zones can not be nested, begin_zone returns the index to pass to end_zone
+		u32 begin_zone(CmdBufferRecorder& recorder, std::string_view name);
+		void end_zone(CmdBufferRecorder& recorder, u32 index);
+
+		// timings of the last frame read back, also recorded as profiler zones on their own track
+		core::ArrayView<Timing> timings() const;
+		core::Duration frame_time() const;
 
 	private:
+		struct Zone {
+			core::String name;
+			u32 perf_zone;
+		};
+
+		struct Frame {
+			core::Vector<Zone> zones;
+			u64 cpu_start = 0;
+		};
+
+		u32 first_query(usize frame) const;
+		bool read_back(Frame& frame, usize index, bool wait);
+
 		vk::QueryPool _pool;
+
+		core::Vector<Frame> _frames;
+		usize _current = 0;
+
+		core::Vector<Timing> _timings;
+		core::Duration _frame_time;
+
+		double _period = 1.0;
+		u64 _mask = 0;
+		u32 _track = 0;
 };
 
 }
@@ -41,25 +41,25 @@ static math::Vec2ui compute_size(const DepthAttachmentView& depth, core::ArrayVi
 	return ref;
 }
 
-static RenderPass* create_render_pass(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors) {
+static RenderPass* create_render_pass(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors, Framebuffer::LoadOp load_op) {
 	auto color_vec = core::vector_with_capacity<RenderPass::ImageData>(colors.size());
 	std::transform(colors.begin(), colors.end(), std::back_inserter(color_vec), [](const auto& c) { return RenderPass::ImageData(c); });
 	return depth.device()
-			? new RenderPass(dptr, depth, color_vec)
-			: new RenderPass(dptr, color_vec);
+			? new RenderPass(dptr, depth, color_vec, load_op)
+			: new RenderPass(dptr, color_vec, load_op);
 }
 
 
 
-Framebuffer::Framebuffer(DevicePtr dptr, core::ArrayView<ColorAttachmentView> colors) :
-		Framebuffer(dptr, DepthAttachmentView(), colors) {
+Framebuffer::Framebuffer(DevicePtr dptr, core::ArrayView<ColorAttachmentView> colors, LoadOp load_op) :
+		Framebuffer(dptr, DepthAttachmentView(), colors, load_op) {
 }
 
-Framebuffer::Framebuffer(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors) :
+Framebuffer::Framebuffer(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors, LoadOp load_op) :
 		DeviceLinked(dptr),
 		_size(compute_size(depth, colors)),
 		_attachment_count(colors.size()),
-		_render_pass(create_render_pass(dptr, depth, colors)),
+		_render_pass(create_render_pass(dptr, depth, colors, load_op)),
 		_depth(depth),
 		_colors(colors.begin(), colors.end()) {
 
@@ -33,12 +33,14 @@ namespace yave {
 class Framebuffer final : NonCopyable, public DeviceLinked {
 
 	public:
+		using LoadOp = RenderPass::LoadOp;
+
 		Framebuffer() = default;
 		Framebuffer(Framebuffer&&) = default;
 		Framebuffer& operator=(Framebuffer&&) = default;
 
-		Framebuffer(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors = {});
-		Framebuffer(DevicePtr dptr, core::ArrayView<ColorAttachmentView> colors);
+		Framebuffer(DevicePtr dptr, const DepthAttachmentView& depth, core::ArrayView<ColorAttachmentView> colors = {}, LoadOp load_op = LoadOp::Clear);
+		Framebuffer(DevicePtr dptr, core::ArrayView<ColorAttachmentView> colors, LoadOp load_op = LoadOp::Clear);
 
 		~Framebuffer();
 
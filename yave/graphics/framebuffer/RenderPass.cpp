@@ -93,8 +93,8 @@ static std::array<vk::SubpassDependency, 2> create_z_pass_dependencies() {
 }
 
 
-static vk::AttachmentDescription create_attachment(RenderPass::ImageData image) {
-	return vk::AttachmentDescription()
+static vk::AttachmentDescription create_attachment(RenderPass::ImageData image, RenderPass::LoadOp load_op) {
+	auto attachment = vk::AttachmentDescription()
 		.setFormat(image.format.vk_format())
 		.setSamples(vk::SampleCountFlagBits::e1)
 		.setLoadOp(vk::AttachmentLoadOp::eClear)
@@ -104,6 +104,14 @@ static vk::AttachmentDescription create_attachment(RenderPass::ImageData image)
 		//.setInitialLayout(vk_initial_image_layout(image.usage))
 		.setFinalLayout(vk_final_image_layout(image.usage))
 	;
+
+	if(load_op == RenderPass::LoadOp::Load) {
+		attachment
+			.setLoadOp(vk::AttachmentLoadOp::eLoad)
+			.setInitialLayout(vk_final_image_layout(image.usage))
+		;
+	}
+	return attachment;
 }
 
 static vk::AttachmentReference create_attachment_reference(ImageUsage usage, usize index) {
@@ -114,9 +122,9 @@ static vk::AttachmentReference create_attachment_reference(ImageUsage usage, usi
 }
 
 
-static vk::RenderPass create_renderpass(DevicePtr dptr, RenderPass::ImageData depth, core::ArrayView<RenderPass::ImageData> colors) {
+static vk::RenderPass create_renderpass(DevicePtr dptr, RenderPass::ImageData depth, core::ArrayView<RenderPass::ImageData> colors, RenderPass::LoadOp load_op) {
 	auto attachments = core::vector_with_capacity<vk::AttachmentDescription>(colors.size() + 1);
-	std::transform(colors.begin(), colors.end(), std::back_inserter(attachments), [=](const auto& color) { return create_attachment(color); });
+	std::transform(colors.begin(), colors.end(), std::back_inserter(attachments), [=](const auto& color) { return create_attachment(color, load_op); });
 
 	auto color_refs = core::vector_with_capacity<vk::AttachmentReference>(colors.size());
 	for(usize i = 0; i != colors.size(); ++i) {
@@ -131,7 +139,7 @@ static vk::RenderPass create_renderpass(DevicePtr dptr, RenderPass::ImageData de
 
 	vk::AttachmentReference depth_ref;
 	if(depth.usage != ImageUsage::None) {
-		attachments << create_attachment(depth);
+		attachments << create_attachment(depth, load_op);
 		depth_ref = create_attachment_reference(ImageUsage::DepthBit, color_refs.size());
 		subpass.setPDepthStencilAttachment(&depth_ref);
 	}
@@ -170,15 +178,15 @@ bool RenderPass::Layout::operator==(const Layout& other) const {
 }
 
 
-RenderPass::RenderPass(DevicePtr dptr, ImageData depth, core::ArrayView<ImageData> colors) :
+RenderPass::RenderPass(DevicePtr dptr, ImageData depth, core::ArrayView<ImageData> colors, LoadOp load_op) :
 		DeviceLinked(dptr),
 		_attachment_count(colors.size()),
-		_render_pass(create_renderpass(dptr, depth, colors)),
+		_render_pass(create_renderpass(dptr, depth, colors, load_op)),
 		_layout(depth, colors) {
 }
 
-RenderPass::RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors) :
-		RenderPass(dptr, ImageData(), colors) {
+RenderPass::RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors, LoadOp load_op) :
+		RenderPass(dptr, ImageData(), colors, load_op) {
 }
 
 RenderPass::~RenderPass() {
@@ -35,6 +35,12 @@ namespace yave {
 
 class RenderPass : NonCopyable, public DeviceLinked {
 	public:
+		// Load keeps the previous content of the attachments, which must already be in their default layout
+		enum class LoadOp {
+			Clear,
+			Load
+		};
+
 		struct ImageData {
 			const ImageFormat format = vk::Format::eUndefined;
 			const ImageUsage usage = ImageUsage::None;
@@ -71,8 +77,8 @@ class RenderPass : NonCopyable, public DeviceLinked {
 		RenderPass(RenderPass&&) = default;
 		RenderPass& operator=(RenderPass&&) = default;
 
-		RenderPass(DevicePtr dptr, ImageData depth, core::ArrayView<ImageData> colors);
-		RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors);
+		RenderPass(DevicePtr dptr, ImageData depth, core::ArrayView<ImageData> colors, LoadOp load_op = LoadOp::Clear);
+		RenderPass(DevicePtr dptr, core::ArrayView<ImageData> colors, LoadOp load_op = LoadOp::Clear);
 
 		~RenderPass();
 
@@ -31,23 +31,39 @@ DeviceAllocator::DeviceAllocator(DevicePtr dptr) :
 		DeviceLinked(dptr),
 		_max_allocs(dptr->vk_limits().maxMemoryAllocationCount) {
 
-	log_msg(fmt("Max device memory allocation count: %", _max_allocs));
+	log_fmt(Log::Info, "Max device memory allocation count: %", _max_allocs);
 }
 
 DeviceMemory DeviceAllocator::dedicated_alloc(vk::MemoryRequirements reqs, MemoryType type) {
 	y_profile();
-	auto& heap = _dedicated_heaps[type];
-	if(!heap) {
-		heap = std::make_unique<DedicatedDeviceMemoryAllocator>(device(), type);
+
+	DedicatedHeap* dedicated = nullptr;
+	{
+		std::unique_lock lock(_lock);
+		auto& heap = _dedicated_heaps[type];
+		if(!heap) {
+			heap = std::make_unique<DedicatedHeap>();
+			heap->heap = std::make_unique<DedicatedDeviceMemoryAllocator>(device(), type);
+		}
+		dedicated = heap.get();
+	}
+
+	std::unique_lock lock(dedicated->lock);
+	return std::move(dedicated->heap->alloc(reqs).unwrap());
+}
+
+DeviceAllocator::HeapList& DeviceAllocator::heap_list(HeapType type) {
+	std::unique_lock lock(_lock);
+	auto& list = _heaps[type];
+	if(!list) {
+		list = std::make_unique<HeapList>();
 	}
-	return std::move(heap->alloc(reqs).unwrap());
+	return *list;
 }
 
 DeviceMemory DeviceAllocator::alloc(vk::MemoryRequirements reqs, MemoryType type) {
 	y_profile();
 
-	std::unique_lock lock(_lock);
-
 	if(reqs.size >= dedicated_threshold) {
 		return dedicated_alloc(reqs, type);
 	}
@@ -57,8 +73,10 @@ DeviceMemory DeviceAllocator::alloc(vk::MemoryRequirements reqs, MemoryType type
 		return dedicated_alloc(reqs, type);
 	}
 
-	auto& heaps =_heaps[HeapType{reqs.memoryTypeBits, type}];
-	for(auto& heap : heaps) {
+	HeapList& list = heap_list(HeapType{reqs.memoryTypeBits, type});
+	std::unique_lock lock(list.lock);
+
+	for(auto& heap : list.heaps) {
 		if(auto r = heap->alloc(reqs)) {
 			return std::move(r.unwrap());
 		}
@@ -67,7 +85,7 @@ DeviceMemory DeviceAllocator::alloc(vk::MemoryRequirements reqs, MemoryType type
 	auto heap = std::make_unique<DeviceMemoryHeap>(device(), reqs.memoryTypeBits, type);
 	auto alloc = std::move(heap->alloc(reqs).unwrap());
 
-	heaps.push_back(std::move(heap));
+	list.heaps.push_back(std::move(heap));
 
 	return std::move(alloc);
 }
@@ -87,20 +105,23 @@ core::String DeviceAllocator::dump_info() const {
 	core::String str = "Allocator:\n";
 	str += fmt("  maximum allocations: %\n", _max_allocs);
 	for(auto& heaps : _heaps) {
-		//str += "  Memory type = "_s + usize(heaps.first.second) + "|" + heaps.first.first + "\n";
+		std::unique_lock heap_lock(heaps.second->lock);
 		str += fmt("  Memory type: % (%)\n", is_cpu_visible(heaps.first.second) ? "CPU" : "Device", heaps.first.first);
-		for(auto& h : heaps.second) {
-			auto available = h->available();
+		for(auto& h : heaps.second->heaps) {
+			auto stats = h->stats();
 
 			core::String bar = "                ";
-			float ratio = (available / float(h->heap_size));
+			float ratio = (stats.free_size / float(h->heap_size));
 			std::fill_n(bar.begin(), usize(std::round((1.0f - ratio) * bar.size())), '#');
 
 			str += "    heap:\n";
 			str += fmt("      |%|\n", bar);
 			str += fmt("      total: % KB\n", h->heap_size / 1024);
-			str += fmt("      free : % KB\n", available / 1024);
-			str += fmt("      used : % KB\n", (h->heap_size - available) / 1024);
+			str += fmt("      free : % KB\n", stats.free_size / 1024);
+			str += fmt("      used : % KB\n", stats.used_size / 1024);
+			str += fmt("      allocations: %\n", stats.allocation_count);
+			str += fmt("      free blocks: % (largest: % KB)\n", stats.free_block_count, stats.largest_free_block / 1024);
+			str += fmt("      fragmentation: %%\n", usize(std::round(stats.fragmentation() * 100.0f)), "%");
 		}
 	}
 	return str;
@@ -34,6 +34,17 @@ class DeviceAllocator : NonCopyable, public DeviceLinked {
 
 	using HeapType = std::pair<u32, MemoryType>;
 
+	// each memory type has its own lock, _lock only guards the maps
+	struct HeapList {
+		core::Vector<std::unique_ptr<DeviceMemoryHeap>> heaps;
+		std::mutex lock;
+	};
+
+	struct DedicatedHeap {
+		std::unique_ptr<DedicatedDeviceMemoryAllocator> heap;
+		std::mutex lock;
+	};
+
 	static constexpr usize dedicated_threshold = DeviceMemoryHeap::heap_size / 2;
 
 	public:
@@ -49,8 +60,10 @@ class DeviceAllocator : NonCopyable, public DeviceLinked {
 		DeviceMemory alloc(vk::MemoryRequirements reqs, MemoryType type);
 		DeviceMemory dedicated_alloc(vk::MemoryRequirements reqs, MemoryType type);
 
-		std::unordered_map<HeapType, core::Vector<std::unique_ptr<DeviceMemoryHeap>>> _heaps;
-		std::unordered_map<MemoryType, std::unique_ptr<DedicatedDeviceMemoryAllocator>> _dedicated_heaps;
+		HeapList& heap_list(HeapType type);
+
+		std::unordered_map<HeapType, std::unique_ptr<HeapList>> _heaps;
+		std::unordered_map<MemoryType, std::unique_ptr<DedicatedHeap>> _dedicated_heaps;
 
 		usize _max_allocs = 0;
 		mutable std::mutex _lock;
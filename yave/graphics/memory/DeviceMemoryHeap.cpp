@@ -23,44 +23,22 @@ SOFTWARE.
 #include "DeviceMemoryHeap.h"
 #include "alloc.h"
 
-#include <numeric>
-#include <mutex>
+#include <y/mem/memory.h>
 
 namespace yave {
 
-static usize align_size(usize total_byte_size, usize alignent) {
-	return (total_byte_size + alignent - 1) & ~(alignent - 1);
-}
-
-usize DeviceMemoryHeap::FreeBlock::end_offset() const {
-	return offset + size;
-}
-
-bool DeviceMemoryHeap::FreeBlock::contiguous(const FreeBlock& blck) const {
-	return end_offset() == blck.offset || blck.end_offset() == offset;
-}
-
-void DeviceMemoryHeap::FreeBlock::merge(const FreeBlock& block) {
-	y_debug_assert(contiguous(block));
-	std::tie(offset, size) = std::tuple{std::min(offset, block.offset), size + block.size};
-}
-
-
 DeviceMemoryHeap::DeviceMemoryHeap(DevicePtr dptr, u32 type_bits, MemoryType type) :
 		DeviceMemoryHeapBase(dptr),
 		_memory(alloc_memory(dptr, heap_size, type_bits, type)),
-		_blocks({FreeBlock{0, heap_size}}),
 		_mapping(is_cpu_visible(type)
 				? static_cast<u8*>(device()->vk_device().mapMemory(_memory, 0, heap_size))
 				: nullptr
-			) {
+			),
+		_allocator(heap_size, alignment) {
 }
 
 DeviceMemoryHeap::~DeviceMemoryHeap() {
-	if(_blocks.size() != 1) {
-		y_fatal("Not all memory has been free: heap fragmented.");
-	}
-	if(_blocks[0].offset || _blocks[0].size != heap_size) {
+	if(_allocator.stats().allocation_count) {
 		y_fatal("Not all memory has been freed.");
 	}
 	if(_mapping) {
@@ -69,77 +47,25 @@ DeviceMemoryHeap::~DeviceMemoryHeap() {
 	device()->vk_device().freeMemory(_memory);
 }
 
-DeviceMemory DeviceMemoryHeap::create(usize offset, usize size) {
-	return DeviceMemory(this, _memory, offset, size);
-}
-
 core::Result<DeviceMemory> DeviceMemoryHeap::alloc(vk::MemoryRequirements reqs) {
-	usize size = align_size(reqs.size, alignment);
-
-	for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-		usize full_size = it->size;
-
-		if(full_size < size) {
-			continue;
-		}
-
-		usize offset = it->offset;
-
-		usize aligned_offset = align_size(offset, reqs.alignment);
-		usize align_correction = aligned_offset - offset;
-		usize aligned_size = full_size - align_correction;
-
-		y_debug_assert(aligned_size % alignment == 0);
-		y_debug_assert(aligned_offset % alignment == 0);
-		y_debug_assert(aligned_offset % reqs.alignment == 0);
-
-		if(aligned_size == size) {
-			_blocks.erase_unordered(it);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		} else if(aligned_size > size) {
-			usize end = offset + full_size;
-			it->size = end - (it->offset = aligned_offset + size);
-			if(align_correction) {
-				_blocks << FreeBlock{offset, align_correction};
-			}
-			return core::Ok(create(aligned_offset, size));
-		}
+	std::unique_lock lock(_lock);
+
+	usize offset = _allocator.allocate(reqs.size, std::max(usize(reqs.alignment), alignment));
+	if(offset == memory::TlsfAllocator::invalid_offset) {
+		return core::Err();
 	}
 
-	return core::Err();
+	y_debug_assert(offset % alignment == 0);
+	y_debug_assert(offset % reqs.alignment == 0);
+
+	return core::Ok(DeviceMemory(this, _memory, offset, memory::align_up_to(reqs.size, alignment)));
 }
 
 void DeviceMemoryHeap::free(const DeviceMemory& memory) {
 	y_debug_assert(memory.vk_memory() == _memory);
-	free(FreeBlock {memory.vk_offset(), memory.vk_size()});
-}
 
-void DeviceMemoryHeap::free(const FreeBlock& block) {
-	y_debug_assert(block.end_offset() <= heap_size);
-	compact_block(block);
-}
-
-void DeviceMemoryHeap::compact_block(FreeBlock block) {
-	y_profile();
-	// sort ?
-	bool compacted = false;
-	do {
-		compacted = false;
-		for(auto it = _blocks.begin(); it != _blocks.end(); ++it) {
-			FreeBlock b = *it;
-			if(b.contiguous(block)) {
-				_blocks.erase_unordered(it);
-				b.merge(block);
-				block = b;
-				compacted = true;
-				break;
-			}
-		}
-	} while(compacted);
-	_blocks << block;
+	std::unique_lock lock(_lock);
+	_allocator.free(memory.vk_offset());
 }
 
 void* DeviceMemoryHeap::map(const DeviceMemoryView& view) {
@@ -150,11 +76,12 @@ void DeviceMemoryHeap::unmap(const DeviceMemoryView&) {
 }
 
 usize DeviceMemoryHeap::available() const {
-	usize tot = 0;
-	for(const auto& b : _blocks) {
-		tot += b.size;
-	}
-	return tot;
+	return stats().free_size;
+}
+
+memory::TlsfAllocator::Stats DeviceMemoryHeap::stats() const {
+	std::unique_lock lock(_lock);
+	return _allocator.stats();
 }
 
 }
@@ -22,24 +22,17 @@ SOFTWARE.
 #ifndef YAVE_GRAPHICS_MEMORY_DEVICEMEMORYHEAP_H
 #define YAVE_GRAPHICS_MEMORY_DEVICEMEMORYHEAP_H
 
-#include <y/concurrent/SpinLock.h>
+#include <y/mem/TlsfAllocator.h>
 
 #include "DeviceMemoryHeapBase.h"
 
+#include <mutex>
+
 namespace yave {
 
 // For DeviceAllocator, should not be used directly
 class DeviceMemoryHeap : public DeviceMemoryHeapBase {
 
-	struct FreeBlock {
-		usize offset;
-		usize size;
-
-		usize end_offset() const;
-		bool contiguous(const FreeBlock& blck) const;
-		void merge(const FreeBlock& block);
-	};
-
 	public:
 		static constexpr usize alignment = 256;
 
@@ -57,20 +50,16 @@ class DeviceMemoryHeap : public DeviceMemoryHeapBase {
 		void* map(const DeviceMemoryView& view) override;
 		void unmap(const DeviceMemoryView&) override;
 
-		usize available() const; // slow!
+		usize available() const;
+		memory::TlsfAllocator::Stats stats() const;
 		bool mapped() const;
 
 	private:
-		void swap(DeviceMemoryHeap& other);
-
-		DeviceMemory create(usize offset, usize size);
-		void free(const FreeBlock& block);
-		void compact_block(FreeBlock block);
-
 		vk::DeviceMemory _memory;
-		core::Vector<FreeBlock> _blocks;
 		u8* _mapping = nullptr;
 
+		memory::TlsfAllocator _allocator;
+		mutable std::mutex _lock;
 };
 
 }
@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "Queue.h"
 
+#include <y/mem/LinearAllocator.h>
+
 namespace yave {
 
 Queue::Queue(DevicePtr dptr, vk::Queue queue) :
@@ -61,9 +63,9 @@ void Queue::submit_base(CmdBufferBase& base) const {
 	auto cmd = base.vk_cmd_buffer();
 
 	const auto& wait = base._proxy->data()._waits;
-	auto wait_semaphores = core::vector_with_capacity<vk::Semaphore>(wait.size());
+	auto wait_semaphores = core::frame_vector_with_capacity<vk::Semaphore>(wait.size());
 	std::transform(wait.begin(), wait.end(), std::back_inserter(wait_semaphores), [](const auto& s) { return s.vk_semaphore(); });
-	core::Vector<vk::PipelineStageFlags> stages(wait.size(), vk::PipelineStageFlagBits::eAllCommands);
+	core::FrameVector<vk::PipelineStageFlags> stages(wait.size(), vk::PipelineStageFlagBits::eAllCommands);
 
 	const Semaphore& signal = base._proxy->data()._signal;
 	vk::Semaphore sig_semaphore = signal.device() ? signal.vk_semaphore() : vk::Semaphore();
@@ -66,6 +66,24 @@ static vk::Format vec_format(const ShaderModuleBase::Attribute& attr) {
 	return y_fatal("Unsupported vec format.");
 }
 
+// matches the layout of PackedVertex
+static std::pair<vk::Format, u32> packed_format(const ShaderModuleBase::Attribute& attr) {
+	switch(attr.location) {
+		case 0:
+			return {vk::Format::eR16G16B16A16Unorm, u32(sizeof(PackedVertex::position))};
+		case 1:
+			return {vk::Format::eR16G16Snorm, u32(sizeof(PackedVertex::normal))};
+		case 2:
+			return {vk::Format::eR16G16Snorm, u32(sizeof(PackedVertex::tangent))};
+		case 3:
+			return {vk::Format::eR16G16Sfloat, u32(sizeof(PackedVertex::uv))};
+
+		default:
+			break;
+	}
+	return y_fatal("Unsupported packed vertex attribute.");
+}
+
 static auto create_stage_info(core::Vector<vk::PipelineShaderStageCreateInfo>& stages, const ShaderModuleBase& mod) {
 	if(mod.vk_shader_module()) {
 		stages << vk::PipelineShaderStageCreateInfo()
@@ -81,12 +99,15 @@ static u32 create_vertex_attribs(u32 binding,
 								  vk::VertexInputRate rate,
 								  const core::Vector<ShaderModuleBase::Attribute>& vertex_attribs,
 								  Bindings& bindings,
-								  Attribs& attribs) {
+								  Attribs& attribs,
+								  bool packed = false) {
 
 	if(!vertex_attribs.is_empty()) {
 		u32 offset = 0;
 		for(const auto& attr : vertex_attribs) {
-			auto format = vec_format(attr);
+			auto [format, size] = packed
+				? packed_format(attr)
+				: std::pair(vec_format(attr), attr.vec_size * attr.component_size);
 			for(u32 i = 0; i != attr.columns; ++i) {
 				attribs << vk::VertexInputAttributeDescription()
 						.setBinding(binding)
@@ -94,7 +115,7 @@ static u32 create_vertex_attribs(u32 binding,
 						.setFormat(format)
 						.setOffset(offset)
 					;
-				offset += attr.vec_size * attr.component_size;
+				offset += size;
 			}
 		}
 		bindings << vk::VertexInputBindingDescription()
@@ -109,6 +130,7 @@ static u32 create_vertex_attribs(u32 binding,
 
 // Takes a SORTED (by location) Attribute list
 static void create_vertex_attribs(const core::Vector<ShaderModuleBase::Attribute>& vertex_attribs,
+								  VertexFormat vertex_format,
 								  Bindings& bindings,
 								  Attribs& attribs) {
 
@@ -119,13 +141,13 @@ static void create_vertex_attribs(const core::Vector<ShaderModuleBase::Attribute
 		(attr.location < ShaderProgram::PerInstanceLocation ? v_attribs : i_attribs) << attr;
 	}
 
-	u32 inst = create_vertex_attribs(0, vk::VertexInputRate::eVertex, v_attribs, bindings, attribs);
+	u32 inst = create_vertex_attribs(0, vk::VertexInputRate::eVertex, v_attribs, bindings, attribs, vertex_format == VertexFormat::Packed);
 	create_vertex_attribs(inst, vk::VertexInputRate::eInstance, i_attribs, bindings, attribs);
 }
 
 
 
-ShaderProgram::ShaderProgram(const FragmentShader& frag, const VertexShader& vert, const GeometryShader& geom) : DeviceLinked(frag.device()) {
+ShaderProgram::ShaderProgram(const FragmentShader& frag, const VertexShader& vert, const GeometryShader& geom, VertexFormat vertex_format) : DeviceLinked(frag.device()) {
 	{
 		merge_bindings(_bindings, frag.bindings());
 		merge_bindings(_bindings, vert.bindings());
@@ -151,7 +173,7 @@ ShaderProgram::ShaderProgram(const FragmentShader& frag, const VertexShader& ver
 	{
 		auto vertex_attribs = vert.attributes();
 		sort(vertex_attribs.begin(), vertex_attribs.end(), [](const auto& a, const auto& b) { return a.location < b.location; });
-		create_vertex_attribs(vertex_attribs, _vertex.bindings, _vertex.attribs);
+		create_vertex_attribs(vertex_attribs, vertex_format, _vertex.bindings, _vertex.attribs);
 	}
 }
 
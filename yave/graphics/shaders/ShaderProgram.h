@@ -24,6 +24,8 @@ SOFTWARE.
 
 #include "ShaderModule.h"
 
+#include <yave/meshes/Vertex.h>
+
 #include <y/core/AssocVector.h>
 
 namespace yave {
@@ -33,7 +35,7 @@ class ShaderProgram final : NonCopyable, public DeviceLinked {
 	public:
 		static constexpr u32 PerInstanceLocation = 8;
 
-		ShaderProgram(const FragmentShader& frag, const VertexShader& vert, const GeometryShader& geom);
+		ShaderProgram(const FragmentShader& frag, const VertexShader& vert, const GeometryShader& geom, VertexFormat vertex_format = VertexFormat::Full);
 
 
 		core::ArrayView<vk::PipelineShaderStageCreateInfo> vk_pipeline_stage_info() const;
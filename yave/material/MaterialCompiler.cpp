@@ -38,7 +38,7 @@ static core::ArrayView<vk::PipelineShaderStageCreateInfo> depth_only_stages(core
 MaterialCompiler::MaterialCompiler(DevicePtr dptr) : DeviceLinked(dptr) {
 }
 
-GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, const RenderPass& render_pass) const {
+GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, const RenderPass& render_pass, VertexFormat vertex_format) const {
 	y_profile();
 	core::DebugTimer _("MaterialCompiler::compile", core::Duration::milliseconds(2));
 #warning move program creation
@@ -46,10 +46,15 @@ GraphicPipeline MaterialCompiler::compile(const MaterialTemplate* material, cons
 	DevicePtr dptr = material->device();
 	const auto& mat_data = material->data();
 
+	// materials without a packed vertex shader use the default one, it has the same outputs as basic.vert
+	const bool packed = vertex_format == VertexFormat::Packed;
+	const SpirVData& vert_data = !packed ? mat_data._vert :
+		mat_data._packed_vert.is_empty() ? dptr->device_resources()[DeviceResources::PackedVert] : mat_data._packed_vert;
+
 	FragmentShader frag = FragmentShader(dptr, mat_data._frag);
-	VertexShader vert = VertexShader(dptr, mat_data._vert);
+	VertexShader vert = VertexShader(dptr, vert_data);
 	GeometryShader geom = mat_data._geom.is_empty() ? GeometryShader() : GeometryShader(dptr, mat_data._geom);
-	ShaderProgram program(frag, vert, geom);
+	ShaderProgram program(frag, vert, geom, vertex_format);
 
 	auto pipeline_shader_stage = program.vk_pipeline_stage_info();
 	if(render_pass.is_depth_only()) {
@@ -35,7 +35,7 @@ class MaterialCompiler : NonCopyable, public DeviceLinked {
 	public:
 		MaterialCompiler(DevicePtr dptr);
 
-		GraphicPipeline compile(const MaterialTemplate* material, const RenderPass& render_pass) const;
+		GraphicPipeline compile(const MaterialTemplate* material, const RenderPass& render_pass, VertexFormat vertex_format = VertexFormat::Full) const;
 
 	private:
 
@@ -33,13 +33,13 @@ MaterialTemplate::MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data)
 		_data(std::move(data)) {
 }
 
-const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass) const {
+const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass, VertexFormat vertex_format) const {
 #warning MaterialTemplate::compile not thread safe
 	if(!render_pass.vk_render_pass()) {
 		y_fatal("Unable to compile material: null renderpass.");
 	}
 
-	const auto& key = render_pass.layout();
+	const auto key = std::pair(render_pass.layout(), vertex_format);
 	auto it = _compiled.find(key);
 	if(it == _compiled.end()) {
 		if(_compiled.size() == max_compiled_pipelines) {
@@ -49,7 +49,7 @@ const GraphicPipeline& MaterialTemplate::compile(const RenderPass& render_pass)
 		}
 
 		MaterialCompiler compiler(device());
-		_compiled.insert(key, compiler.compile(this, render_pass));
+		_compiled.insert(key, compiler.compile(this, render_pass, vertex_format));
 		return _compiled.last().second;
 	}
 	return it->second;
@@ -27,6 +27,8 @@ SOFTWARE.
 #include <yave/graphics/framebuffer/RenderPass.h>
 #include <yave/graphics/bindings/DescriptorSet.h>
 
+#include <yave/meshes/Vertex.h>
+
 #include <y/core/AssocVector.h>
 
 #include "GraphicPipeline.h"
@@ -42,14 +44,14 @@ class MaterialTemplate final : NonCopyable, public DeviceLinked {
 		MaterialTemplate() = default;
 		MaterialTemplate(DevicePtr dptr, MaterialTemplateData&& data);
 
-		const GraphicPipeline& compile(const RenderPass& render_pass) const;
+		const GraphicPipeline& compile(const RenderPass& render_pass, VertexFormat vertex_format = VertexFormat::Full) const;
 
 		const MaterialTemplateData& data() const;
 
 	private:
 		//void swap(Material& other);
 
-		mutable core::AssocVector<RenderPass::Layout, GraphicPipeline> _compiled;
+		mutable core::AssocVector<std::pair<RenderPass::Layout, VertexFormat>, GraphicPipeline> _compiled;
 
 		MaterialTemplateData _data;
 };
@@ -36,6 +36,12 @@ MaterialTemplateData& MaterialTemplateData::set_vert_data(const SpirVData& data)
 	return *this;
 }
 
+MaterialTemplateData& MaterialTemplateData::set_packed_vert_data(const SpirVData& data) {
+	y_debug_assert(ShaderModuleBase::shader_type(data) == ShaderType::Vertex);
+	_packed_vert = data;
+	return *this;
+}
+
 MaterialTemplateData& MaterialTemplateData::set_geom_data(const SpirVData& data) {
 	y_debug_assert(ShaderModuleBase::shader_type(data) == ShaderType::Geomery);
 	_geom = data;
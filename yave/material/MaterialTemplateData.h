@@ -40,6 +40,7 @@ class MaterialTemplateData {
 	public:
 		MaterialTemplateData& set_frag_data(const SpirVData& data);
 		MaterialTemplateData& set_vert_data(const SpirVData& data);
+		MaterialTemplateData& set_packed_vert_data(const SpirVData& data);
 		MaterialTemplateData& set_geom_data(const SpirVData& data);
 
 		MaterialTemplateData& set_primitive_type(PrimitiveType type);
@@ -50,6 +51,7 @@ class MaterialTemplateData {
 
 		SpirVData _frag;
 		SpirVData _vert;
+		SpirVData _packed_vert;
 		SpirVData _geom;
 
 		PrimitiveType _primitive_type = PrimitiveType::Triangles;
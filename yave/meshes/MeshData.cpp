@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <y/io/BuffReader.h>
 #include <y/core/Chrono.h>
+#include <y/math/packing.h>
 
 namespace yave {
 
@@ -31,6 +32,26 @@ float MeshData::radius() const {
 	return _radius;
 }
 
+const math::Vec3& MeshData::aabb_min() const {
+	return _aabb_min;
+}
+
+const math::Vec3& MeshData::aabb_max() const {
+	return _aabb_max;
+}
+
+VertexFormat MeshData::vertex_format() const {
+	return _vertex_format;
+}
+
+void MeshData::set_vertex_format(VertexFormat format) {
+	_vertex_format = format;
+}
+
+bool MeshData::has_short_indices() const {
+	return _vertices.size() <= usize(std::numeric_limits<u16>::max()) + 1;
+}
+
 const core::Vector<Vertex>& MeshData::vertices() const {
 	return _vertices;
 }
@@ -39,6 +60,30 @@ const core::Vector<IndexedTriangle>& MeshData::triangles() const {
 	return _triangles;
 }
 
+usize MeshData::lod_count() const {
+	return _lods.size() + 1;
+}
+
+const core::Vector<MeshLod>& MeshData::lods() const {
+	return _lods;
+}
+
+void MeshData::set_lods(core::Vector<MeshLod>&& lods) {
+	_lods = std::move(lods);
+}
+
+bool MeshData::has_meshlets() const {
+	return !_meshlets.is_empty();
+}
+
+const core::Vector<Meshlet>& MeshData::meshlets() const {
+	return _meshlets;
+}
+
+void MeshData::set_meshlets(core::Vector<Meshlet>&& meshlets) {
+	_meshlets = std::move(meshlets);
+}
+
 const core::Vector<SkinWeights> MeshData::skin() const {
 	if(!_skeleton) {
 		y_fatal("Mesh has no skeleton.");
@@ -65,10 +110,48 @@ core::Vector<SkinnedVertex> MeshData::skinned_vertices() const {
 	return verts;
 }
 
+core::Vector<PackedVertex> MeshData::packed_vertices() const {
+	y_profile();
+
+	math::Vec3 extent = _aabb_max - _aabb_min;
+	math::Vec3 inv_extent;
+	for(usize i = 0; i != 3; ++i) {
+		inv_extent[i] = extent[i] > 0.0f ? 1.0f / extent[i] : 0.0f;
+	}
+
+	auto pack_direction = [](const math::Vec3& v) {
+		math::Vec2 oct = math::octahedral_encode(v);
+		return std::array<i16, 2>{math::quantize_snorm16(oct.x()), math::quantize_snorm16(oct.y())};
+	};
+
+	auto verts = core::vector_with_capacity<PackedVertex>(_vertices.size());
+	for(const Vertex& v : _vertices) {
+		math::Vec3 pos = (v.position - _aabb_min) * inv_extent;
+		verts << PackedVertex{
+				{math::quantize_unorm16(pos.x()), math::quantize_unorm16(pos.y()), math::quantize_unorm16(pos.z()), 0},
+				pack_direction(v.normal),
+				pack_direction(v.tangent),
+				{math::to_half(v.uv.x()), math::to_half(v.uv.y())}
+			};
+	}
+	return verts;
+}
+
 bool MeshData::has_skeleton() const {
 	return bool(_skeleton);
 }
 
+void MeshData::compute_aabb() {
+	_aabb_min = math::Vec3(_vertices.is_empty() ? 0.0f : std::numeric_limits<float>::max());
+	_aabb_max = math::Vec3(_vertices.is_empty() ? 0.0f : std::numeric_limits<float>::lowest());
+	for(const Vertex& v : _vertices) {
+		for(usize i = 0; i != 3; ++i) {
+			_aabb_min[i] = std::min(_aabb_min[i], v.position[i]);
+			_aabb_max[i] = std::max(_aabb_max[i], v.position[i]);
+		}
+	}
+}
+
 MeshData MeshData::from_parts(core::Vector<Vertex>&& vertices, core::Vector<IndexedTriangle>&& triangles, core::Vector<SkinWeights>&& skin, core::Vector<Bone>&& bones) {
 	if(bones.is_empty() != skin.is_empty()) {
 		y_fatal("Invalid skeleton.");
@@ -78,12 +161,15 @@ MeshData MeshData::from_parts(core::Vector<Vertex>&& vertices, core::Vector<Inde
 	}
 
 	float radius = 0.0f;
-	std::for_each(vertices.begin(), vertices.end(), [&](const auto& v) { radius = std::max(radius, v.position.length2()); });
+	std::for_each(vertices.begin(), vertices.end(), [&](const auto& v) {
+		radius = std::max(radius, v.position.length2());
+	});
 
 	MeshData mesh;
 	mesh._vertices = std::move(vertices);
 	mesh._triangles = std::move(triangles);
 	mesh._radius = std::sqrt(radius);
+	mesh.compute_aabb();
 
 	if(!skin.is_empty()) {
 		mesh._skeleton = std::make_unique<SkeletonData>(SkeletonData{std::move(skin), std::move(bones)});
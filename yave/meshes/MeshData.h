@@ -25,35 +25,86 @@ SOFTWARE.
 #include <yave/utils/serde.h>
 
 #include "Skeleton.h"
+#include "Meshlet.h"
 
 namespace yave {
 
+struct MeshLod {
+	core::Vector<IndexedTriangle> triangles;
+	// simplification error relative to the mesh radius
+	float error = 0.0f;
+
+	y_serde(triangles, error)
+};
+
 class MeshData {
 
 	public:
+		static constexpr u32 version = 9;
+		// versions 6 to 8 are read with the fields they had, as full format meshes
+		static constexpr u32 min_version = 6;
+
 		static MeshData from_parts(core::Vector<Vertex>&& vertices, core::Vector<IndexedTriangle>&& triangles, core::Vector<SkinWeights>&& skin = {}, core::Vector<Bone>&& bones = {});
 
 		float radius() const;
 
+		const math::Vec3& aabb_min() const;
+		const math::Vec3& aabb_max() const;
+
+		VertexFormat vertex_format() const;
+		void set_vertex_format(VertexFormat format);
+
+		bool has_short_indices() const;
+
 		const core::Vector<Vertex>& vertices() const;
 		const core::Vector<IndexedTriangle>& triangles() const;
 
+		// LODs past the base mesh, they index the same vertices
+		usize lod_count() const;
+		const core::Vector<MeshLod>& lods() const;
+		void set_lods(core::Vector<MeshLod>&& lods);
+
+		// clusters of the base mesh triangles
+		bool has_meshlets() const;
+		const core::Vector<Meshlet>& meshlets() const;
+		void set_meshlets(core::Vector<Meshlet>&& meshlets);
+
 		const core::Vector<SkinWeights> skin() const;
 		const core::Vector<Bone>& bones() const;
 		core::Vector<SkinnedVertex> skinned_vertices() const;
 
-		bool has_skeleton() const;
+		core::Vector<PackedVertex> packed_vertices() const;
 
+		bool has_skeleton() const;
 
 
-		y_serialize(fs::magic_number, AssetType::Mesh, u32(6),
-			_radius, _vertices, _triangles, _skeleton ? u32(1) : u32(0), y_serde_cond(_skeleton, *_skeleton))
 
-		y_deserialize(fs::magic_number, AssetType::Mesh, u32(6),
-			_radius, _vertices, _triangles,
+		y_serialize(fs::magic_number, AssetType::Mesh, version,
+			_radius, _aabb_min, _aabb_max, _vertex_format, _vertices, _triangles, _lods, _meshlets, _skeleton ? u32(1) : u32(0), y_serde_cond(_skeleton, *_skeleton))
+
+		y_deserialize(fs::magic_number, AssetType::Mesh,
+			y_serde_call([&](u32 v) {
+				if(v < min_version || v > version) {
+					y_throw("Unsupported mesh version.");
+				}
+				if(v < 7) {
+					y_serde_process(_radius, _vertices, _triangles);
+					compute_aabb();
+				} else {
+					y_serde_process(_radius, _aabb_min, _aabb_max, _vertex_format, _vertices, _triangles);
+				}
+				if(v >= 8) {
+					y_serde_process(_lods);
+				}
+				if(v >= 9) {
+					y_serde_process(_meshlets);
+				}
+			}),
 			y_serde_call([this](u32 s) { if(s) { _skeleton = std::make_unique<SkeletonData>(); } }), y_serde_cond(_skeleton, *_skeleton))
 
 	private:
+		void compute_aabb();
+
 		struct SkeletonData {
 			core::Vector<SkinWeights> skin;
 			core::Vector<Bone> bones;
@@ -62,9 +113,15 @@ class MeshData {
 		};
 
 		float _radius = 0.0f;
+		math::Vec3 _aabb_min;
+		math::Vec3 _aabb_max;
+
+		VertexFormat _vertex_format = VertexFormat::Full;
 
 		core::Vector<Vertex> _vertices;
 		core::Vector<IndexedTriangle> _triangles;
+		core::Vector<MeshLod> _lods;
+		core::Vector<Meshlet> _meshlets;
 
 		std::unique_ptr<SkeletonData> _skeleton;
 };
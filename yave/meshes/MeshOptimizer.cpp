@@ -0,0 +1,472 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MeshOptimizer.h"
+
+#include <numeric>
+#include <cstring>
+
+namespace yave {
+
+// -------------------------------------------------- analysis --------------------------------------------------
+
+namespace {
+class FifoCache {
+	public:
+		FifoCache(usize vertex_count, usize cache_size) : _timestamps(vertex_count, 0u), _cache_size(u32(cache_size)), _time(u32(cache_size) + 1) {
+		}
+
+		// returns true on miss
+		bool fetch(u32 vertex) {
+			if(_time - _timestamps[vertex] > _cache_size) {
+				_timestamps[vertex] = _time++;
+				return true;
+			}
+			return false;
+		}
+
+		usize fetch(const IndexedTriangle& tri) {
+			return usize(fetch(tri[0])) + usize(fetch(tri[1])) + usize(fetch(tri[2]));
+		}
+
+		void flush() {
+			_time += _cache_size + 1;
+		}
+
+	private:
+		core::Vector<u32> _timestamps;
+		u32 _cache_size;
+		u32 _time;
+};
+}
+
+VertexCacheStats vertex_cache_stats(core::ArrayView<IndexedTriangle> triangles, usize vertex_count, usize cache_size) {
+	if(triangles.is_empty() || !vertex_count) {
+		return VertexCacheStats();
+	}
+
+	FifoCache cache(vertex_count, cache_size);
+	usize misses = 0;
+	for(const auto& tri : triangles) {
+		misses += cache.fetch(tri);
+	}
+
+	return VertexCacheStats{float(misses) / float(triangles.size()), float(misses) / float(vertex_count)};
+}
+
+
+// -------------------------------------------------- welding --------------------------------------------------
+
+usize weld_vertices(core::Vector<Vertex>& vertices, core::Vector<IndexedTriangle>& triangles, core::Vector<SkinWeights>* skin) {
+	y_profile();
+
+	if(skin && skin->size() != vertices.size()) {
+		y_fatal("Invalid skin data.");
+	}
+
+	// SkinnedVertex has no padding, so vertices can be compared bitwise
+	auto keys = core::vector_with_capacity<SkinnedVertex>(vertices.size());
+	for(usize i = 0; i != vertices.size(); ++i) {
+		SkinnedVertex key;
+		std::memset(&key, 0, sizeof(key));
+		key.vertex = vertices[i];
+		if(skin) {
+			key.weights = (*skin)[i];
+		}
+		keys << key;
+	}
+
+	auto hash = [](const SkinnedVertex& key) {
+		std::array<u32, sizeof(SkinnedVertex) / sizeof(u32)> words;
+		std::memcpy(words.data(), &key, sizeof(key));
+		u32 h = 0;
+		for(u32 w : words) {
+			h = (h ^ w) * 0x9E3779B1u;
+			h ^= h >> 15;
+		}
+		h ^= h >> 16;
+		h *= 0x85EBCA6Bu;
+		h ^= h >> 13;
+		return h;
+	};
+
+	// open addressing, stores indices of unique vertices
+	usize table_size = usize(1) << (log2ui(std::max(usize(16), keys.size())) + 2);
+	core::Vector<u32> table(table_size, u32(-1));
+
+	core::Vector<u32> remap(vertices.size(), 0u);
+	auto welded = core::vector_with_capacity<Vertex>(vertices.size());
+	auto welded_skin = core::vector_with_capacity<SkinWeights>(skin ? vertices.size() : 0);
+	auto unique = core::vector_with_capacity<u32>(vertices.size());
+	for(usize i = 0; i != keys.size(); ++i) {
+		usize slot = hash(keys[i]) & (table_size - 1);
+		while(table[slot] != u32(-1) && std::memcmp(&keys[unique[table[slot]]], &keys[i], sizeof(SkinnedVertex))) {
+			slot = (slot + 1) & (table_size - 1);
+		}
+
+		if(table[slot] == u32(-1)) {
+			table[slot] = u32(welded.size());
+			unique << u32(i);
+			welded << vertices[i];
+			if(skin) {
+				welded_skin << (*skin)[i];
+			}
+		}
+		remap[i] = table[slot];
+	}
+
+	for(auto& tri : triangles) {
+		for(u32& i : tri) {
+			i = remap[i];
+		}
+	}
+
+	usize removed = vertices.size() - welded.size();
+	vertices = std::move(welded);
+	if(skin) {
+		*skin = std::move(welded_skin);
+	}
+	return removed;
+}
+
+
+// -------------------------------------------------- vertex cache --------------------------------------------------
+
+static float forsyth_score(i32 cache_pos, u32 remaining) {
+	if(!remaining) {
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if(cache_pos >= 0) {
+		score = cache_pos < 3
+			? 0.75f
+			: std::pow(1.0f - float(cache_pos - 3) / float(vertex_cache_size - 3), 1.5f);
+	}
+	return score + 2.0f / std::sqrt(float(remaining));
+}
+
+void optimize_vertex_cache(core::Vector<IndexedTriangle>& triangles, usize vertex_count) {
+	y_profile();
+
+	usize tri_count = triangles.size();
+	if(tri_count < 2) {
+		return;
+	}
+
+	// triangles adjacent to each vertex, emitted triangles are removed as we go
+	core::Vector<u32> offsets(vertex_count + 1, 0u);
+	for(const auto& tri : triangles) {
+		for(u32 v : tri) {
+			y_debug_assert(v < vertex_count);
+			++offsets[v + 1];
+		}
+	}
+	for(usize i = 0; i != vertex_count; ++i) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	core::Vector<u32> remaining(vertex_count, 0u);
+	core::Vector<u32> adjacency(tri_count * 3, 0u);
+	for(usize t = 0; t != tri_count; ++t) {
+		for(u32 v : triangles[t]) {
+			adjacency[offsets[v] + remaining[v]++] = u32(t);
+		}
+	}
+
+	core::Vector<i32> cache_pos(vertex_count, -1);
+	core::Vector<float> vertex_score(vertex_count, 0.0f);
+	for(usize v = 0; v != vertex_count; ++v) {
+		vertex_score[v] = forsyth_score(-1, remaining[v]);
+	}
+
+	auto triangle_score = [&](usize t) {
+		const auto& tri = triangles[t];
+		return vertex_score[tri[0]] + vertex_score[tri[1]] + vertex_score[tri[2]];
+	};
+
+	i64 best = 0;
+	{
+		float best_score = -1.0f;
+		for(usize t = 0; t != tri_count; ++t) {
+			float score = triangle_score(t);
+			if(score > best_score) {
+				best_score = score;
+				best = t;
+			}
+		}
+	}
+
+	core::Vector<u8> emitted(tri_count, u8(0));
+	auto output = core::vector_with_capacity<IndexedTriangle>(tri_count);
+
+	std::array<u32, vertex_cache_size + 3> cache = {};
+	std::array<u32, vertex_cache_size + 3> next_cache = {};
+	usize cache_count = 0;
+	usize input_cursor = 0;
+
+	while(output.size() != tri_count) {
+		if(best < 0) {
+			// dead end: restart from the first triangle not yet emitted
+			while(emitted[input_cursor]) {
+				++input_cursor;
+			}
+			best = input_cursor;
+		}
+
+		const IndexedTriangle tri = triangles[best];
+		emitted[best] = 1;
+		output << tri;
+
+		for(u32 v : tri) {
+			u32* begin = adjacency.begin() + offsets[v];
+			u32* end = begin + remaining[v];
+			*std::find(begin, end, u32(best)) = end[-1];
+			--remaining[v];
+		}
+
+		usize next_count = 0;
+		for(u32 v : tri) {
+			next_cache[next_count++] = v;
+		}
+		for(usize i = 0; i != cache_count; ++i) {
+			u32 v = cache[i];
+			if(v != tri[0] && v != tri[1] && v != tri[2]) {
+				next_cache[next_count++] = v;
+			}
+		}
+
+		for(usize i = 0; i != next_count; ++i) {
+			u32 v = next_cache[i];
+			cache_pos[v] = i < vertex_cache_size ? i32(i) : -1;
+			vertex_score[v] = forsyth_score(cache_pos[v], remaining[v]);
+		}
+
+		// only triangles touching the cache (or just evicted from it) can have changed
+		best = -1;
+		float best_score = -1.0f;
+		for(usize i = 0; i != next_count; ++i) {
+			u32 v = next_cache[i];
+			for(u32 k = 0; k != remaining[v]; ++k) {
+				u32 t = adjacency[offsets[v] + k];
+				float score = triangle_score(t);
+				if(score > best_score) {
+					best_score = score;
+					best = t;
+				}
+			}
+		}
+
+		std::swap(cache, next_cache);
+		cache_count = std::min(next_count, vertex_cache_size);
+	}
+
+	triangles = std::move(output);
+}
+
+
+// -------------------------------------------------- overdraw --------------------------------------------------
+
+// Sander et al. "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw"
+void optimize_overdraw(core::Vector<IndexedTriangle>& triangles, core::ArrayView<Vertex> vertices, float threshold) {
+	y_profile();
+
+	usize tri_count = triangles.size();
+	if(tri_count < 2) {
+		return;
+	}
+
+	// hard boundaries: triangles sharing nothing with the cache
+	core::Vector<usize> hard_boundaries;
+	{
+		FifoCache cache(vertices.size(), vertex_cache_analysis_size);
+		for(usize i = 0; i != tri_count; ++i) {
+			if(cache.fetch(triangles[i]) == 3) {
+				hard_boundaries << i;
+			}
+		}
+		hard_boundaries << tri_count;
+	}
+
+	// soft boundaries: split clusters where their ACMR is close enough to the one of the hard cluster
+	core::Vector<usize> clusters;
+	{
+		FifoCache cache(vertices.size(), vertex_cache_analysis_size);
+		for(usize c = 0; c + 1 < hard_boundaries.size(); ++c) {
+			usize begin = hard_boundaries[c];
+			usize end = hard_boundaries[c + 1];
+
+			cache.flush();
+			usize cluster_misses = 0;
+			for(usize i = begin; i != end; ++i) {
+				cluster_misses += cache.fetch(triangles[i]);
+			}
+			float cluster_threshold = threshold * float(cluster_misses) / float(end - begin);
+
+			cache.flush();
+			clusters << begin;
+			usize start = begin;
+			usize misses = 0;
+			for(usize i = begin; i != end; ++i) {
+				misses += cache.fetch(triangles[i]);
+				if(i + 1 != end && float(misses) / float(i + 1 - start) <= cluster_threshold) {
+					cache.flush();
+					clusters << i + 1;
+					start = i + 1;
+					misses = 0;
+				}
+			}
+		}
+	}
+
+	struct ClusterData {
+		math::Vec3 centroid;
+		math::Vec3 normal;
+		float area = 0.0f;
+	};
+
+	auto cluster_data = core::vector_with_capacity<ClusterData>(clusters.size());
+	ClusterData mesh_data;
+	for(usize c = 0; c != clusters.size(); ++c) {
+		usize begin = clusters[c];
+		usize end = c + 1 == clusters.size() ? tri_count : clusters[c + 1];
+
+		ClusterData data;
+		for(usize i = begin; i != end; ++i) {
+			const auto& tri = triangles[i];
+			const math::Vec3& a = vertices[tri[0]].position;
+			const math::Vec3& b = vertices[tri[1]].position;
+			const math::Vec3& c = vertices[tri[2]].position;
+
+			math::Vec3 normal = (b - a).cross(c - a);
+			float area = normal.length();
+			data.centroid += (a + b + c) * (area / 3.0f);
+			data.normal += normal;
+			data.area += area;
+		}
+
+		mesh_data.centroid += data.centroid;
+		mesh_data.area += data.area;
+
+		if(data.area > 0.0f) {
+			data.centroid /= data.area;
+		}
+		cluster_data << data;
+	}
+
+	if(mesh_data.area > 0.0f) {
+		mesh_data.centroid /= mesh_data.area;
+	}
+
+	// outward facing clusters are drawn first, they are more likely to occlude the rest
+	core::Vector<float> sort_keys(clusters.size(), 0.0f);
+	for(usize c = 0; c != clusters.size(); ++c) {
+		const auto& data = cluster_data[c];
+		float length = data.normal.length();
+		sort_keys[c] = length > 0.0f ? (data.centroid - mesh_data.centroid).dot(data.normal) / length : 0.0f;
+	}
+
+	core::Vector<u32> order(clusters.size(), 0u);
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) { return sort_keys[a] > sort_keys[b]; });
+
+	auto sorted = core::vector_with_capacity<IndexedTriangle>(tri_count);
+	for(u32 c : order) {
+		usize begin = clusters[c];
+		usize end = c + 1 == clusters.size() ? tri_count : clusters[c + 1];
+		for(usize i = begin; i != end; ++i) {
+			sorted << triangles[i];
+		}
+	}
+	triangles = std::move(sorted);
+}
+
+
+// -------------------------------------------------- vertex fetch --------------------------------------------------
+
+template<typename T>
+static core::Vector<T> apply_remap(const core::Vector<T>& elems, const core::Vector<u32>& remap, usize count) {
+	core::Vector<T> remapped(count, T());
+	for(usize i = 0; i != elems.size(); ++i) {
+		if(remap[i] != u32(-1)) {
+			remapped[remap[i]] = elems[i];
+		}
+	}
+	return remapped;
+}
+
+void optimize_vertex_fetch(core::Vector<Vertex>& vertices, core::Vector<IndexedTriangle>& triangles, core::Vector<SkinWeights>* skin) {
+	y_profile();
+
+	core::Vector<u32> remap(vertices.size(), u32(-1));
+	u32 next = 0;
+	for(auto& tri : triangles) {
+		for(u32& i : tri) {
+			if(remap[i] == u32(-1)) {
+				remap[i] = next++;
+			}
+			i = remap[i];
+		}
+	}
+
+	// unreferenced vertices are dropped
+	vertices = apply_remap(vertices, remap, next);
+	if(skin) {
+		*skin = apply_remap(*skin, remap, next);
+	}
+}
+
+
+// -------------------------------------------------- mesh --------------------------------------------------
+
+MeshData optimize_mesh(const MeshData& mesh, MeshOptimizationStats* stats) {
+	y_profile();
+
+	core::Vector<Vertex> vertices = mesh.vertices();
+	core::Vector<IndexedTriangle> triangles = mesh.triangles();
+	core::Vector<SkinWeights> skin;
+	core::Vector<Bone> bones;
+	if(mesh.has_skeleton()) {
+		skin = mesh.skin();
+		bones = mesh.bones();
+	}
+	core::Vector<SkinWeights>* skin_ptr = mesh.has_skeleton() ? &skin : nullptr;
+
+	MeshOptimizationStats optimization_stats;
+	optimization_stats.before = vertex_cache_stats(triangles, vertices.size());
+
+	optimization_stats.welded_vertices = weld_vertices(vertices, triangles, skin_ptr);
+	optimize_vertex_cache(triangles, vertices.size());
+	optimize_overdraw(triangles, vertices);
+	optimize_vertex_fetch(vertices, triangles, skin_ptr);
+
+	optimization_stats.after = vertex_cache_stats(triangles, vertices.size());
+	if(stats) {
+		*stats = optimization_stats;
+	}
+
+	MeshData optimized = MeshData::from_parts(std::move(vertices), std::move(triangles), std::move(skin), std::move(bones));
+	optimized.set_vertex_format(mesh.vertex_format());
+	return optimized;
+}
+
+}
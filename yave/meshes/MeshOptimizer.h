@@ -0,0 +1,66 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_MESHES_MESHOPTIMIZER_H
+#define YAVE_MESHES_MESHOPTIMIZER_H
+
+#include "MeshData.h"
+
+namespace yave {
+
+struct VertexCacheStats {
+	// average cache miss ratio, transformed vertices per triangle (0.5 is optimal, 3.0 is worst)
+	float acmr = 0.0f;
+	// average transformed vertex ratio, transformed vertices per vertex (1.0 is optimal)
+	float atvr = 0.0f;
+};
+
+struct MeshOptimizationStats {
+	VertexCacheStats before;
+	VertexCacheStats after;
+
+	usize welded_vertices = 0;
+};
+
+static constexpr usize vertex_cache_size = 32;
+static constexpr usize vertex_cache_analysis_size = 16;
+static constexpr float overdraw_threshold = 1.05f;
+
+// simulates a FIFO post transform cache
+VertexCacheStats vertex_cache_stats(core::ArrayView<IndexedTriangle> triangles, usize vertex_count, usize cache_size = vertex_cache_analysis_size);
+
+// merges bitwise identical vertices, returns the number of removed vertices
+usize weld_vertices(core::Vector<Vertex>& vertices, core::Vector<IndexedTriangle>& triangles, core::Vector<SkinWeights>* skin = nullptr);
+
+// Forsyth's linear speed vertex cache optimisation
+void optimize_vertex_cache(core::Vector<IndexedTriangle>& triangles, usize vertex_count);
+
+// sorts cache friendly clusters front to back, should run after optimize_vertex_cache
+void optimize_overdraw(core::Vector<IndexedTriangle>& triangles, core::ArrayView<Vertex> vertices, float threshold = overdraw_threshold);
+
+// reorders vertices in order of first use
+void optimize_vertex_fetch(core::Vector<Vertex>& vertices, core::Vector<IndexedTriangle>& triangles, core::Vector<SkinWeights>* skin = nullptr);
+
+MeshData optimize_mesh(const MeshData& mesh, MeshOptimizationStats* stats = nullptr);
+
+}
+
+#endif // YAVE_MESHES_MESHOPTIMIZER_H
@@ -0,0 +1,489 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace yave {
+
+namespace {
+enum class VertexKind : u8 {
+	Manifold,
+	Border,
+	Locked
+};
+
+// symmetric 4x4 matrix, error(p) = p.A.p + 2 b.p + c
+struct Quadric {
+	double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+	double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+	double c = 0.0;
+	double weight = 0.0;
+
+	static Quadric from_plane(const math::Vec3& normal, const math::Vec3& point, double w) {
+		double x = normal.x();
+		double y = normal.y();
+		double z = normal.z();
+		double d = -(x * point.x() + y * point.y() + z * point.z());
+
+		Quadric q;
+		q.a00 = w * x * x; q.a01 = w * x * y; q.a02 = w * x * z;
+		q.a11 = w * y * y; q.a12 = w * y * z;
+		q.a22 = w * z * z;
+		q.b0 = w * x * d; q.b1 = w * y * d; q.b2 = w * z * d;
+		q.c = w * d * d;
+		q.weight = w;
+		return q;
+	}
+
+	Quadric& operator+=(const Quadric& q) {
+		a00 += q.a00; a01 += q.a01; a02 += q.a02;
+		a11 += q.a11; a12 += q.a12;
+		a22 += q.a22;
+		b0 += q.b0; b1 += q.b1; b2 += q.b2;
+		c += q.c;
+		weight += q.weight;
+		return *this;
+	}
+
+	Quadric operator+(const Quadric& q) const {
+		Quadric r = *this;
+		return r += q;
+	}
+
+	// squared distance
+	double error(const math::Vec3& p) const {
+		double x = p.x();
+		double y = p.y();
+		double z = p.z();
+		double e = x * (a00 * x + 2.0 * (a01 * y + a02 * z + b0))
+				 + y * (a11 * y + 2.0 * (a12 * z + b1))
+				 + z * (a22 * z + 2.0 * b2)
+				 + c;
+		return weight > 0.0 ? std::abs(e) / weight : 0.0;
+	}
+};
+
+struct Collapse {
+	u32 from;
+	u32 to;
+	float error;
+};
+
+static constexpr double border_weight = 10.0;
+
+static u64 edge_key(u32 a, u32 b) {
+	return (u64(a) << 32) | u64(b);
+}
+
+class EdgeSet {
+	public:
+		EdgeSet(core::ArrayView<IndexedTriangle> triangles) : _edges(core::vector_with_capacity<u64>(triangles.size() * 3)) {
+			for(const IndexedTriangle& tri : triangles) {
+				for(usize k = 0; k != 3; ++k) {
+					_edges << edge_key(tri[k], tri[(k + 1) % 3]);
+				}
+			}
+			std::sort(_edges.begin(), _edges.end());
+		}
+
+		usize count(u32 a, u32 b) const {
+			auto range = std::equal_range(_edges.begin(), _edges.end(), edge_key(a, b));
+			return usize(range.second - range.first);
+		}
+
+		bool is_border(u32 a, u32 b) const {
+			return (count(a, b) + count(b, a)) == 1;
+		}
+
+	private:
+		core::Vector<u64> _edges;
+};
+}
+
+static core::Vector<VertexKind> classify_vertices(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles, const EdgeSet& edges) {
+	core::Vector<VertexKind> kinds(vertices.size(), VertexKind::Manifold);
+
+	// vertices sharing a position with another one sit on an attribute seam
+	{
+		core::Vector<u32> order(vertices.size(), 0u);
+		for(usize i = 0; i != order.size(); ++i) {
+			order[i] = u32(i);
+		}
+		auto less = [&](u32 a, u32 b) {
+			return std::memcmp(&vertices[a].position, &vertices[b].position, sizeof(math::Vec3)) < 0;
+		};
+		std::sort(order.begin(), order.end(), less);
+		for(usize i = 1; i < order.size(); ++i) {
+			if(!less(order[i - 1], order[i])) {
+				kinds[order[i - 1]] = VertexKind::Locked;
+				kinds[order[i]] = VertexKind::Locked;
+			}
+		}
+	}
+
+	core::Vector<u32> border_edges(vertices.size(), 0u);
+	for(const IndexedTriangle& tri : triangles) {
+		for(usize k = 0; k != 3; ++k) {
+			u32 a = tri[k];
+			u32 b = tri[(k + 1) % 3];
+			if(edges.count(a, b) > 1) {
+				kinds[a] = kinds[b] = VertexKind::Locked;
+			} else if(!edges.count(b, a)) {
+				++border_edges[a];
+				++border_edges[b];
+			}
+		}
+	}
+
+	for(usize i = 0; i != kinds.size(); ++i) {
+		if(kinds[i] == VertexKind::Manifold && border_edges[i]) {
+			kinds[i] = border_edges[i] == 2 ? VertexKind::Border : VertexKind::Locked;
+		}
+	}
+
+	return kinds;
+}
+
+static core::Vector<Quadric> compute_quadrics(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles, const EdgeSet& edges) {
+	core::Vector<Quadric> quadrics(vertices.size(), Quadric());
+
+	for(const IndexedTriangle& tri : triangles) {
+		const math::Vec3& p0 = vertices[tri[0]].position;
+		const math::Vec3& p1 = vertices[tri[1]].position;
+		const math::Vec3& p2 = vertices[tri[2]].position;
+
+		math::Vec3 normal = (p1 - p0).cross(p2 - p0);
+		float area = normal.length();
+		if(area <= 0.0f) {
+			continue;
+		}
+		normal /= area;
+
+		Quadric q = Quadric::from_plane(normal, p0, area * 0.5);
+		for(usize k = 0; k != 3; ++k) {
+			quadrics[tri[k]] += q;
+		}
+
+		// borders get a perpendicular plane to keep them from shrinking
+		for(usize k = 0; k != 3; ++k) {
+			u32 a = tri[k];
+			u32 b = tri[(k + 1) % 3];
+			if(edges.count(b, a)) {
+				continue;
+			}
+			math::Vec3 edge = vertices[b].position - vertices[a].position;
+			float length = edge.length();
+			if(length <= 0.0f) {
+				continue;
+			}
+			math::Vec3 border_normal = edge.cross(normal).normalized();
+			Quadric border = Quadric::from_plane(border_normal, vertices[a].position, double(length) * double(length) * border_weight);
+			quadrics[a] += border;
+			quadrics[b] += border;
+		}
+	}
+
+	return quadrics;
+}
+
+// returns true if moving from onto to would flip one of from's triangles
+static bool flips(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles, core::ArrayView<u32> adjacency, u32 from, u32 to) {
+	for(u32 t : adjacency) {
+		const IndexedTriangle& tri = triangles[t];
+		if(tri[0] == to || tri[1] == to || tri[2] == to) {
+			continue;
+		}
+
+		std::array<math::Vec3, 3> pos = {vertices[tri[0]].position, vertices[tri[1]].position, vertices[tri[2]].position};
+		math::Vec3 before = (pos[1] - pos[0]).cross(pos[2] - pos[0]);
+		for(usize k = 0; k != 3; ++k) {
+			if(tri[k] == from) {
+				pos[k] = vertices[to].position;
+			}
+		}
+		math::Vec3 after = (pos[1] - pos[0]).cross(pos[2] - pos[0]);
+		if(before.dot(after) <= 0.0f) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static float point_triangle_distance(const math::Vec3& p, const math::Vec3& a, const math::Vec3& b, const math::Vec3& c) {
+	const math::Vec3 corners[] = {a, b, c};
+	math::Vec3 normal = (b - a).cross(c - a);
+	if(normal.length2() > 0.0f) {
+		normal.normalize();
+		bool inside = true;
+		for(usize k = 0; k != 3; ++k) {
+			inside &= (corners[(k + 1) % 3] - corners[k]).cross(p - corners[k]).dot(normal) >= 0.0f;
+		}
+		if(inside) {
+			return std::abs(normal.dot(p - a));
+		}
+	}
+
+	float dist = std::numeric_limits<float>::max();
+	for(usize k = 0; k != 3; ++k) {
+		math::Vec3 edge = corners[(k + 1) % 3] - corners[k];
+		float t = edge.length2() > 0.0f ? std::clamp(edge.dot(p - corners[k]) / edge.length2(), 0.0f, 1.0f) : 0.0f;
+		dist = std::min(dist, (corners[k] + edge * t - p).length());
+	}
+	return dist;
+}
+
+// distance from every removed vertex to the triangles around the vertex it ended up collapsed onto,
+// which bounds its distance to the simplified surface
+static float collapse_distance(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> result, core::Vector<u32>& remap) {
+	for(usize i = 0; i != remap.size(); ++i) {
+		u32 r = remap[i];
+		while(remap[r] != r) {
+			r = remap[r];
+		}
+		remap[i] = r;
+	}
+
+	core::Vector<u32> adjacency_offsets(vertices.size() + 1, 0u);
+	for(const IndexedTriangle& tri : result) {
+		for(u32 v : tri) {
+			++adjacency_offsets[v + 1];
+		}
+	}
+	for(usize i = 1; i != adjacency_offsets.size(); ++i) {
+		adjacency_offsets[i] += adjacency_offsets[i - 1];
+	}
+	core::Vector<u32> adjacency(result.size() * 3, 0u);
+	{
+		core::Vector<u32> fill = adjacency_offsets;
+		for(usize t = 0; t != result.size(); ++t) {
+			for(u32 v : result[t]) {
+				adjacency[fill[v]++] = u32(t);
+			}
+		}
+	}
+
+	float max_dist = 0.0f;
+	for(usize i = 0; i != remap.size(); ++i) {
+		u32 r = remap[i];
+		if(r == i || adjacency_offsets[r] == adjacency_offsets[r + 1]) {
+			continue;
+		}
+		float dist = std::numeric_limits<float>::max();
+		for(u32 k = adjacency_offsets[r]; k != adjacency_offsets[r + 1]; ++k) {
+			const IndexedTriangle& tri = result[adjacency[k]];
+			dist = std::min(dist, point_triangle_distance(vertices[i].position, vertices[tri[0]].position, vertices[tri[1]].position, vertices[tri[2]].position));
+		}
+		max_dist = std::max(max_dist, dist);
+	}
+	return max_dist;
+}
+
+core::Vector<IndexedTriangle> simplify_mesh(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles, usize target_triangle_count, float* error) {
+	y_profile();
+
+	core::Vector<IndexedTriangle> result(triangles);
+	core::Vector<u32> remap(vertices.size(), 0u);
+	for(usize i = 0; i != remap.size(); ++i) {
+		remap[i] = u32(i);
+	}
+
+	if(result.size() > target_triangle_count) {
+		const EdgeSet edges(triangles);
+		const core::Vector<VertexKind> kinds = classify_vertices(vertices, triangles, edges);
+		core::Vector<Quadric> quadrics = compute_quadrics(vertices, triangles, edges);
+
+		auto can_collapse = [&](u32 from, u32 to) {
+			switch(kinds[from]) {
+				case VertexKind::Manifold:
+					return true;
+				case VertexKind::Border:
+					return kinds[to] != VertexKind::Manifold && edges.is_border(from, to);
+				default:
+					return false;
+			}
+		};
+
+		core::Vector<Collapse> best(vertices.size(), Collapse{0, 0, std::numeric_limits<float>::max()});
+		core::Vector<u32> adjacency_offsets(vertices.size() + 1, 0u);
+		core::Vector<u32> adjacency(result.size() * 3, 0u);
+		core::Vector<u8> touched(vertices.size(), u8(0));
+		core::Vector<Collapse> collapses;
+
+		for(;;) {
+			// one pass collapses as many independent edges as possible
+			std::fill(best.begin(), best.end(), Collapse{0, 0, std::numeric_limits<float>::max()});
+			for(const IndexedTriangle& tri : result) {
+				for(usize k = 0; k != 3; ++k) {
+					u32 a = tri[k];
+					u32 b = tri[(k + 1) % 3];
+					for(usize d = 0; d != 2; ++d) {
+						if(can_collapse(a, b)) {
+							float e = float((quadrics[a] + quadrics[b]).error(vertices[b].position));
+							if(e < best[a].error) {
+								best[a] = Collapse{a, b, e};
+							}
+						}
+						std::swap(a, b);
+					}
+				}
+			}
+
+			collapses.make_empty();
+			for(const Collapse& c : best) {
+				if(c.error != std::numeric_limits<float>::max()) {
+					collapses << c;
+				}
+			}
+			if(collapses.is_empty()) {
+				break;
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0u);
+			for(const IndexedTriangle& tri : result) {
+				for(u32 v : tri) {
+					++adjacency_offsets[v + 1];
+				}
+			}
+			for(usize i = 1; i != adjacency_offsets.size(); ++i) {
+				adjacency_offsets[i] += adjacency_offsets[i - 1];
+			}
+			{
+				core::Vector<u32> fill = adjacency_offsets;
+				for(usize t = 0; t != result.size(); ++t) {
+					for(u32 v : result[t]) {
+						adjacency[fill[v]++] = u32(t);
+					}
+				}
+			}
+
+			std::fill(touched.begin(), touched.end(), u8(0));
+			usize removable = result.size() - target_triangle_count;
+			usize removed = 0;
+			usize applied = 0;
+			for(const Collapse& c : collapses) {
+				if(removed >= removable) {
+					break;
+				}
+				if(touched[c.from] || touched[c.to]) {
+					continue;
+				}
+
+				core::ArrayView<u32> adj(adjacency.data() + adjacency_offsets[c.from], adjacency_offsets[c.from + 1] - adjacency_offsets[c.from]);
+				if(flips(vertices, result, adj, c.from, c.to)) {
+					continue;
+				}
+
+				// lock the whole one ring so that flip tests stay valid for the rest of the pass
+				for(u32 t : adj) {
+					for(u32 v : result[t]) {
+						touched[v] = 1;
+					}
+				}
+				for(u32 t : adj) {
+					for(u32& v : result[t]) {
+						if(v == c.from) {
+							v = c.to;
+						}
+					}
+				}
+
+				quadrics[c.to] += quadrics[c.from];
+				remap[c.from] = c.to;
+				removed += kinds[c.from] == VertexKind::Border ? 1 : 2;
+				++applied;
+			}
+
+			if(!applied) {
+				break;
+			}
+
+			auto degenerate = [](const IndexedTriangle& tri) { return tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]; };
+			auto end = std::remove_if(result.begin(), result.end(), degenerate);
+			usize kept = usize(end - result.begin());
+			while(result.size() != kept) {
+				result.pop();
+			}
+
+			if(result.size() <= target_triangle_count) {
+				break;
+			}
+		}
+	}
+
+	if(error) {
+		*error = collapse_distance(vertices, result, remap);
+	}
+	return result;
+}
+
+MeshData generate_lods(const MeshData& mesh, core::ArrayView<float> ratios) {
+	y_profile();
+
+	core::Vector<MeshLod> lods;
+
+	const core::Vector<IndexedTriangle>* previous = &mesh.triangles();
+	float previous_error = 0.0f;
+	for(float ratio : ratios) {
+		usize target = usize(float(mesh.triangles().size()) * ratio);
+		if(!target) {
+			break;
+		}
+
+		float error = 0.0f;
+		core::Vector<IndexedTriangle> triangles = simplify_mesh(mesh.vertices(), *previous, target, &error);
+
+		// not worth a LOD
+		if(triangles.is_empty() || triangles.size() * 10 > previous->size() * 9) {
+			break;
+		}
+
+		optimize_vertex_cache(triangles, mesh.vertices().size());
+
+		// errors accumulate along the chain
+		float relative_error = mesh.radius() > 0.0f ? error / mesh.radius() : 0.0f;
+		previous_error += relative_error;
+		lods << MeshLod{std::move(triangles), previous_error};
+		previous = &lods.last().triangles;
+	}
+
+	core::Vector<Vertex> vertices = mesh.vertices();
+	core::Vector<IndexedTriangle> triangles = mesh.triangles();
+	core::Vector<SkinWeights> skin;
+	core::Vector<Bone> bones;
+	if(mesh.has_skeleton()) {
+		skin = mesh.skin();
+		bones = mesh.bones();
+	}
+
+	MeshData result = MeshData::from_parts(std::move(vertices), std::move(triangles), std::move(skin), std::move(bones));
+	result.set_vertex_format(mesh.vertex_format());
+	result.set_lods(std::move(lods));
+	result.set_meshlets(core::Vector<Meshlet>(mesh.meshlets()));
+	return result;
+}
+
+}
@@ -0,0 +1,42 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_MESHES_MESHSIMPLIFIER_H
+#define YAVE_MESHES_MESHSIMPLIFIER_H
+
+#include "MeshData.h"
+
+namespace yave {
+
+static constexpr std::array<float, 4> default_lod_ratios = {0.5f, 0.25f, 0.125f, 0.0625f};
+
+// Quadric error metric edge collapse (Garland & Heckbert), vertices are collapsed onto their neighbors
+// so the result indexes the input vertices. Attribute seams and non manifold vertices are never moved,
+// borders can only collapse along themselves.
+// Returns the simplified triangles, error bounds the distance from the input vertices to the result, in model space units.
+core::Vector<IndexedTriangle> simplify_mesh(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles, usize target_triangle_count, float* error = nullptr);
+
+// each LOD is simplified from the previous one, stops once simplification stalls
+MeshData generate_lods(const MeshData& mesh, core::ArrayView<float> ratios = default_lod_ratios);
+
+}
+
+#endif // YAVE_MESHES_MESHSIMPLIFIER_H
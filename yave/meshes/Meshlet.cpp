@@ -0,0 +1,166 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "Meshlet.h"
+
+namespace yave {
+
+static void compute_bounds(Meshlet& meshlet, core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles) {
+	math::Vec3 aabb_min(std::numeric_limits<float>::max());
+	math::Vec3 aabb_max(std::numeric_limits<float>::lowest());
+	math::Vec3 normal_sum;
+
+	for(usize i = 0; i != meshlet.triangle_count; ++i) {
+		const IndexedTriangle& tri = triangles[meshlet.first_triangle + i];
+		for(u32 v : tri) {
+			const math::Vec3& pos = vertices[v].position;
+			for(usize k = 0; k != 3; ++k) {
+				aabb_min[k] = std::min(aabb_min[k], pos[k]);
+				aabb_max[k] = std::max(aabb_max[k], pos[k]);
+			}
+		}
+		math::Vec3 normal = (vertices[tri[1]].position - vertices[tri[0]].position).cross(vertices[tri[2]].position - vertices[tri[0]].position);
+		float length = normal.length();
+		if(length > 0.0f) {
+			normal_sum += normal / length;
+		}
+	}
+
+	meshlet.center = (aabb_min + aabb_max) * 0.5f;
+	float radius = 0.0f;
+	for(usize i = 0; i != meshlet.triangle_count; ++i) {
+		for(u32 v : triangles[meshlet.first_triangle + i]) {
+			radius = std::max(radius, (vertices[v].position - meshlet.center).length2());
+		}
+	}
+	meshlet.radius = std::sqrt(radius);
+
+	// cone_cutoff = 1.0 disables cone culling
+	meshlet.cone_cutoff = 1.0f;
+	float sum_length = normal_sum.length();
+	if(sum_length <= 0.0f) {
+		return;
+	}
+	meshlet.cone_axis = normal_sum / sum_length;
+
+	float min_dot = 1.0f;
+	for(usize i = 0; i != meshlet.triangle_count; ++i) {
+		const IndexedTriangle& tri = triangles[meshlet.first_triangle + i];
+		math::Vec3 normal = (vertices[tri[1]].position - vertices[tri[0]].position).cross(vertices[tri[2]].position - vertices[tri[0]].position);
+		float length = normal.length();
+		if(length > 0.0f) {
+			min_dot = std::min(min_dot, meshlet.cone_axis.dot(normal) / length);
+		}
+	}
+
+	// cone wider than ~85 degrees, not worth testing
+	if(min_dot > 0.1f) {
+		meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+	}
+}
+
+core::Vector<Meshlet> build_meshlets(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles) {
+	y_profile();
+
+	core::Vector<Meshlet> meshlets;
+	core::Vector<u32> stamps(vertices.size(), u32(-1));
+
+	Meshlet current;
+	auto new_vertices = [&](const IndexedTriangle& tri) {
+		u32 stamp = u32(meshlets.size());
+		usize count = 0;
+		for(usize k = 0; k != 3; ++k) {
+			bool duplicate = (k > 0 && tri[k] == tri[0]) || (k > 1 && tri[k] == tri[1]);
+			count += (stamps[tri[k]] != stamp && !duplicate);
+		}
+		return count;
+	};
+
+	for(usize i = 0; i != triangles.size(); ++i) {
+		const IndexedTriangle& tri = triangles[i];
+		usize added = new_vertices(tri);
+		if(current.vertex_count + added > max_meshlet_vertices || current.triangle_count == max_meshlet_triangles) {
+			meshlets << current;
+			current = Meshlet();
+			current.first_triangle = u32(i);
+			added = new_vertices(tri);
+		}
+
+		u32 stamp = u32(meshlets.size());
+		for(u32 v : tri) {
+			stamps[v] = stamp;
+		}
+		current.vertex_count += u32(added);
+		++current.triangle_count;
+	}
+	if(current.triangle_count) {
+		meshlets << current;
+	}
+
+	for(Meshlet& meshlet : meshlets) {
+		compute_bounds(meshlet, vertices, triangles);
+	}
+
+	return meshlets;
+}
+
+MeshletCullData meshlet_cull_data(const math::Transform<>& transform, const Frustum& frustum, const math::Vec3& eye) {
+	MeshletCullData data;
+
+	// planes are transformed by the transpose of the model matrix
+	auto transposed = transform.transposed();
+	for(usize i = 0; i != data.planes.size(); ++i) {
+		data.planes[i] = transposed * frustum[i];
+	}
+
+	float scales[] = {transform.forward().length(), transform.left().length(), transform.up().length()};
+	float max_scale = std::max({scales[0], scales[1], scales[2]});
+	float min_scale = std::min({scales[0], scales[1], scales[2]});
+	data.radius_scale = max_scale;
+
+	// normal cones are only valid under uniform scaling, mirrored instances flip the winding so front faces would be culled
+	bool mirrored = transform.forward().dot(transform.left().cross(transform.up())) < 0.0f;
+	data.cone_culling = !mirrored && max_scale - min_scale <= max_scale * 0.01f;
+	data.eye = (transform.inverse() * math::Vec4(eye, 1.0f)).to<3>();
+
+	return data;
+}
+
+bool is_meshlet_backfacing(const Meshlet& meshlet, const MeshletCullData& data) {
+	if(!data.cone_culling) {
+		return false;
+	}
+	math::Vec3 dir = meshlet.center - data.eye;
+	return dir.dot(meshlet.cone_axis) >= meshlet.cone_cutoff * dir.length() + meshlet.radius;
+}
+
+bool is_meshlet_visible(const Meshlet& meshlet, const MeshletCullData& data) {
+	float radius = meshlet.radius * data.radius_scale;
+	for(const math::Vec4& plane : data.planes) {
+		if(plane.dot(math::Vec4(meshlet.center, 1.0f)) + radius < 0.0f) {
+			return false;
+		}
+	}
+	return !is_meshlet_backfacing(meshlet, data);
+}
+
+}
@@ -0,0 +1,81 @@
+/*******************************
+Copyright (c) 2016-2019 Grégoire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_MESHES_MESHLET_H
+#define YAVE_MESHES_MESHLET_H
+
+#include "Vertex.h"
+
+#include <yave/camera/Frustum.h>
+#include <yave/utils/serde.h>
+
+#include <y/math/Transform.h>
+
+namespace yave {
+
+static constexpr usize max_meshlet_vertices = 64;
+static constexpr usize max_meshlet_triangles = 124;
+
+// matches the layout used by meshlet_cull.comp
+struct Meshlet {
+	math::Vec3 center;
+	float radius = 0.0f;
+
+	// cluster is back facing when dot(center - eye, cone_axis) >= cone_cutoff * |center - eye| + radius
+	math::Vec3 cone_axis;
+	float cone_cutoff = 1.0f;
+
+	u32 first_triangle = 0;
+	u32 triangle_count = 0;
+	u32 vertex_count = 0;
+	u32 padding = 0;
+
+	y_serde(center, radius, cone_axis, cone_cutoff, first_triangle, triangle_count, vertex_count)
+};
+
+static_assert(sizeof(Meshlet) == 48);
+
+// per instance culling parameters, in model space, used as push constant by meshlet_cull.comp
+struct MeshletCullData {
+	std::array<math::Vec4, 6> planes;
+
+	math::Vec3 eye;
+	float radius_scale = 1.0f;
+
+	u32 meshlet_count = 0;
+	u32 output_offset = 0;
+	u32 command_index = 0;
+	u32 cone_culling = 0;
+};
+
+static_assert(sizeof(MeshletCullData) == 128);
+
+// splits consecutive triangles into meshlets, triangle order is preserved
+core::Vector<Meshlet> build_meshlets(core::ArrayView<Vertex> vertices, core::ArrayView<IndexedTriangle> triangles);
+
+MeshletCullData meshlet_cull_data(const math::Transform<>& transform, const Frustum& frustum, const math::Vec3& eye);
+
+bool is_meshlet_backfacing(const Meshlet& meshlet, const MeshletCullData& data);
+bool is_meshlet_visible(const Meshlet& meshlet, const MeshletCullData& data);
+
+}
+
+#endif // YAVE_MESHES_MESHLET_H
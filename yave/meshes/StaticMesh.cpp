@@ -28,32 +28,117 @@ SOFTWARE.
 
 namespace yave {
 
+template<typename Buff, typename T>
+static Buff create_staged_buffer(DevicePtr dptr, CmdBufferRecorder& recorder, const core::Vector<T>& data) {
+	Buff buffer(dptr, data.size() * sizeof(T));
+	Mapping::stage(buffer, recorder, data.data());
+	return buffer;
+}
+
+static core::Vector<ShortIndexedTriangle> to_short_triangles(const core::Vector<IndexedTriangle>& triangles) {
+	auto tris = core::vector_with_capacity<ShortIndexedTriangle>(triangles.size());
+	for(const IndexedTriangle& t : triangles) {
+		tris << ShortIndexedTriangle{u16(t[0]), u16(t[1]), u16(t[2])};
+	}
+	return tris;
+}
+
 StaticMesh::StaticMesh(DevicePtr dptr, const MeshData& mesh_data) :
-		_triangle_buffer(dptr, mesh_data.triangles().size()),
-		_vertex_buffer(dptr, mesh_data.vertices().size()),
-		_indirect_data(mesh_data.triangles().size() * 3, 1),
+		_vertex_format(mesh_data.vertex_format()),
 		_radius(mesh_data.radius()) {
 
+	using IndexBuffer = decltype(_triangle_buffer);
+	using AttribBuffer = decltype(_vertex_buffer);
+	using MeshletBuffer = decltype(_meshlet_buffer);
+
 	CmdBufferRecorder recorder(dptr->create_disposable_cmd_buffer());
-	Mapping::stage(_triangle_buffer, recorder, mesh_data.triangles().data());
-	Mapping::stage(_vertex_buffer, recorder, mesh_data.vertices().data());
+	if(_vertex_format == VertexFormat::Packed) {
+		_vertex_buffer = create_staged_buffer<AttribBuffer>(dptr, recorder, mesh_data.packed_vertices());
+		_dequantization = Dequantization{math::Vec4(mesh_data.aabb_min(), 0.0f), math::Vec4(mesh_data.aabb_max() - mesh_data.aabb_min(), 0.0f)};
+	} else {
+		_vertex_buffer = create_staged_buffer<AttribBuffer>(dptr, recorder, mesh_data.vertices());
+	}
+
+	// all LODs share a single index buffer
+	usize triangle_count = mesh_data.triangles().size();
+	for(const MeshLod& lod : mesh_data.lods()) {
+		triangle_count += lod.triangles.size();
+	}
+	auto triangles = core::vector_with_capacity<IndexedTriangle>(triangle_count);
+	auto add_lod = [&](const core::Vector<IndexedTriangle>& tris, float error) {
+		_lods << Lod{vk::DrawIndexedIndirectCommand(u32(tris.size() * 3), 1, u32(triangles.size() * 3)), error};
+		for(const IndexedTriangle& t : tris) {
+			triangles << t;
+		}
+	};
+	add_lod(mesh_data.triangles(), 0.0f);
+	for(const MeshLod& lod : mesh_data.lods()) {
+		add_lod(lod.triangles, lod.error);
+	}
+
+	// meshlet culling reads 32 bits indices
+	if(_vertex_format == VertexFormat::Packed && mesh_data.has_short_indices() && !mesh_data.has_meshlets()) {
+		_triangle_buffer = create_staged_buffer<IndexBuffer>(dptr, recorder, to_short_triangles(triangles));
+		_index_type = vk::IndexType::eUint16;
+	} else {
+		_triangle_buffer = create_staged_buffer<IndexBuffer>(dptr, recorder, triangles);
+	}
+
+	if(mesh_data.has_meshlets()) {
+		_meshlet_buffer = create_staged_buffer<MeshletBuffer>(dptr, recorder, mesh_data.meshlets());
+		_meshlet_count = mesh_data.meshlets().size();
+		_meshlet_descriptor_set = DescriptorSet(dptr, {Binding(_meshlet_buffer), Binding(_triangle_buffer)});
+	}
+
 	dptr->graphic_queue().submit<SyncSubmit>(RecordedCmdBuffer(std::move(recorder)));
 }
 
-const TriangleBuffer<>& StaticMesh::triangle_buffer() const {
+SubBuffer<BufferUsage::IndexBit> StaticMesh::triangle_buffer() const {
 	return _triangle_buffer;
 }
 
-const VertexBuffer<>& StaticMesh::vertex_buffer() const {
+SubBuffer<BufferUsage::AttributeBit> StaticMesh::vertex_buffer() const {
 	return _vertex_buffer;
 }
 
-const vk::DrawIndexedIndirectCommand& StaticMesh::indirect_data() const {
-	return _indirect_data;
+const vk::DrawIndexedIndirectCommand& StaticMesh::indirect_data(usize lod) const {
+	return _lods[lod].indirect_data;
+}
+
+usize StaticMesh::lod_count() const {
+	return _lods.size();
+}
+
+float StaticMesh::lod_error(usize lod) const {
+	return _lods[lod].error;
+}
+
+vk::IndexType StaticMesh::index_type() const {
+	return _index_type;
+}
+
+VertexFormat StaticMesh::vertex_format() const {
+	return _vertex_format;
+}
+
+const StaticMesh::Dequantization& StaticMesh::dequantization() const {
+	return _dequantization;
 }
 
 float StaticMesh::radius() const {
 	return _radius;
 }
 
+bool StaticMesh::has_meshlets() const {
+	return _meshlet_count;
+}
+
+usize StaticMesh::meshlet_count() const {
+	return _meshlet_count;
+}
+
+const DescriptorSet& StaticMesh::meshlet_descriptor_set() const {
+	return _meshlet_descriptor_set;
+}
+
 }
@@ -26,6 +26,7 @@ SOFTWARE.
 
 #include <yave/graphics/buffers/buffers.h>
 #include <yave/graphics/buffers/TypedWrapper.h>
+#include <yave/graphics/bindings/DescriptorSet.h>
 
 #include <yave/assets/AssetTraits.h>
 
@@ -34,20 +35,51 @@ namespace yave {
 class StaticMesh : NonCopyable {
 
 	public:
+		struct Lod {
+			vk::DrawIndexedIndirectCommand indirect_data;
+			float error = 0.0f;
+		};
+
+		// maps packed positions back into model space, used as push constant by packed shaders
+		struct Dequantization {
+			math::Vec4 offset;
+			math::Vec4 scale;
+		};
+
 		StaticMesh() = default;
 
 		StaticMesh(DevicePtr dptr, const MeshData& mesh_data);
 
-		const TriangleBuffer<>& triangle_buffer() const;
-		const VertexBuffer<>& vertex_buffer() const;
-		const vk::DrawIndexedIndirectCommand& indirect_data() const;
+		SubBuffer<BufferUsage::IndexBit> triangle_buffer() const;
+		SubBuffer<BufferUsage::AttributeBit> vertex_buffer() const;
+		const vk::DrawIndexedIndirectCommand& indirect_data(usize lod = 0) const;
+
+		usize lod_count() const;
+		float lod_error(usize lod) const;
+
+		vk::IndexType index_type() const;
+		VertexFormat vertex_format() const;
+		const Dequantization& dequantization() const;
 
 		float radius() const;
 
+		// meshlets and triangles as storage buffers, for meshlet_cull.comp
+		bool has_meshlets() const;
+		usize meshlet_count() const;
+		const DescriptorSet& meshlet_descriptor_set() const;
+
 	private:
-		TriangleBuffer<> _triangle_buffer;
-		VertexBuffer<> _vertex_buffer;
-		vk::DrawIndexedIndirectCommand _indirect_data;
+		Buffer<BufferUsage::IndexBit | BufferUsage::StorageBit | BufferUsage::TransferDstBit, MemoryType::DeviceLocal> _triangle_buffer;
+		Buffer<BufferUsage::AttributeBit | BufferUsage::TransferDstBit> _vertex_buffer;
+		core::Vector<Lod> _lods;
+
+		vk::IndexType _index_type = vk::IndexType::eUint32;
+		VertexFormat _vertex_format = VertexFormat::Full;
+		Dequantization _dequantization;
+
+		Buffer<BufferUsage::StorageBit | BufferUsage::TransferDstBit, MemoryType::DeviceLocal> _meshlet_buffer;
+		usize _meshlet_count = 0;
+		DescriptorSet _meshlet_descriptor_set;
 
 		float _radius;
 };
@@ -34,6 +34,22 @@ struct Vertex {
 };
 
 using IndexedTriangle = std::array<u32, 3>;
+using ShortIndexedTriangle = std::array<u16, 3>;
+
+enum class VertexFormat : u32 {
+	Full = 0,
+	Packed = 1
+};
+
+// position: unorm16 relative to mesh bounds (w unused)
+// normal, tangent: octahedral snorm16
+// uv: half float
+struct PackedVertex {
+	std::array<u16, 4> position;
+	std::array<i16, 2> normal;
+	std::array<i16, 2> tangent;
+	std::array<u16, 2> uv;
+};
 
 struct SkinWeights {
 	static constexpr usize size = 4;
@@ -47,8 +63,12 @@ struct SkinnedVertex {
 	SkinWeights weights;
 };
 
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex should be tightly packed");
+
+static_assert(std::is_trivially_copyable_v<PackedVertex>, "PackedVertex should be trivially copyable");
 static_assert(std::is_trivially_copyable_v<SkinnedVertex>, "SkinnedVertex should be trivially copyable");
 static_assert(std::is_trivially_copyable_v<IndexedTriangle>, "IndexedTriangle should be trivially copyable");
+static_assert(std::is_trivially_copyable_v<ShortIndexedTriangle>, "ShortIndexedTriangle should be trivially copyable");
 
 }
 
@@ -55,12 +55,21 @@ float Light::radius() const {
 	return _radius;
 }
 
+bool& Light::cast_shadows() {
+	return _cast_shadows;
+}
+
+bool Light::cast_shadows() const {
+	return _cast_shadows;
+}
+
 Light::operator uniform::Light() const {
 	return uniform::Light {
 			_type == Directional ? forward() : position(),
 			_radius,
 			_color * _intensity,
-			u32(_type)
+			u32(_type),
+			uniform::no_shadow
 		};
 }
 
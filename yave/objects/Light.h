@@ -47,6 +47,9 @@ class Light final : public Transformable {
 		float& radius();
 		float radius() const;
 
+		bool& cast_shadows();
+		bool cast_shadows() const;
+
 		operator uniform::Light() const;
 
 	private:
@@ -54,6 +57,7 @@ class Light final : public Transformable {
 		math::Vec3 _color = math::Vec3{1.0f};
 		float _intensity = 1.0f;
 		float _radius = 1.0f;
+		bool _cast_shadows = false;
 };
 
 }
@@ -30,6 +30,8 @@ SOFTWARE.
 
 namespace yave {
 
+class SkeletonInstance;
+
 class Renderable : public Transformable {
 
 	public:
@@ -38,6 +40,12 @@ class Renderable : public Transformable {
 			u32 instance_index;
 		};
 
+		struct SkinningData {
+			// skinning matrices of every animated renderable, starting at bone_offset for this one
+			const DescriptorSetBase& bone_palette;
+			u32 bone_offset;
+		};
+
 		virtual ~Renderable() {
 		}
 
@@ -46,6 +54,19 @@ class Renderable : public Transformable {
 		virtual void flush_reload() {
 		}
 
+		virtual SkeletonInstance* skeleton() const {
+			return nullptr;
+		}
+
+		// skins the vertices that render() will draw into skinned_vertices()
+		virtual void skin(CmdBufferRecorder&, const SkinningData&) const {
+		}
+
+		// only valid for renderables with a skeleton
+		virtual SubBufferBase skinned_vertices() const {
+			return SubBufferBase();
+		}
+
 };
 
 }
@@ -23,33 +23,65 @@ SOFTWARE.
 #include "SkinnedMeshInstance.h"
 
 #include <yave/graphics/commands/CmdBufferRecorder.h>
+#include <yave/graphics/shaders/ComputeProgram.h>
 #include <yave/material/Material.h>
+#include <yave/device/Device.h>
 
 namespace yave {
 
+// matches PushConstants in skinning.comp
+struct SkinningConstants {
+	u32 bone_offset;
+	u32 vertex_count;
+};
+
 SkinnedMeshInstance::SkinnedMeshInstance(const AssetPtr<SkinnedMesh>& mesh, const AssetPtr<Material>& material) :
 		_mesh(mesh),
-		_skeleton(_mesh->triangle_buffer().device(), &mesh->skeleton()),
+		_skeleton(&mesh->skeleton()),
 		_material(material) {
 
 	set_radius(_mesh->radius());
+	create_skinned_vertices();
+}
+
+void SkinnedMeshInstance::create_skinned_vertices() {
+	DevicePtr dptr = _mesh->vertex_buffer().device();
+	_skinned_vertices = decltype(_skinned_vertices)(dptr, _mesh->vertex_buffer().size());
+	_skinning_set = DescriptorSet(dptr, {Binding(_mesh->vertex_buffer()), Binding(_skinned_vertices)});
+	_skinned = false;
+	_skeleton.invalidate_pose();
 }
 
 void SkinnedMeshInstance::flush_reload() {
 	_skeleton.flush_reload();
-	_mesh.flush_reload();
+	if(_mesh.flush_reload()) {
+		create_skinned_vertices();
+	}
 	_material.flush_reload();
 }
 
 void SkinnedMeshInstance::render(RenderPassRecorder& recorder, const SceneData& scene_data) const {
-	_skeleton.update();
+	if(!_skinned) {
+		return;
+	}
 
-	recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set, _skeleton.descriptor_set(), _material->descriptor_set()});
-	recorder.bind_buffers(TriangleSubBuffer(_mesh->triangle_buffer()), {SkinnedVertexSubBuffer(_mesh->vertex_buffer())});
+	recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set, _material->descriptor_set()});
+	recorder.bind_buffers(TriangleSubBuffer(_mesh->triangle_buffer()), {VertexSubBuffer(_skinned_vertices)});
 
 	auto indirect = _mesh->indirect_data();
 	indirect.setFirstInstance(scene_data.instance_index);
 	recorder.draw(indirect);
 }
 
+void SkinnedMeshInstance::skin(CmdBufferRecorder& recorder, const SkinningData& skinning_data) const {
+	SkinningConstants constants{skinning_data.bone_offset, u32(_skinned_vertices.size())};
+	const auto& program = recorder.device()->device_resources()[DeviceResources::SkinningProgram];
+	recorder.dispatch_size(program, math::Vec3ui(constants.vertex_count, 1, 1), {skinning_data.bone_palette, _skinning_set}, constants);
+	_skinned = true;
+}
+
+SubBufferBase SkinnedMeshInstance::skinned_vertices() const {
+	return SubBufferBase(_skinned_vertices);
+}
+
 }
@@ -25,6 +25,7 @@ SOFTWARE.
 #include <yave/assets/AssetPtr.h>
 #include <yave/meshes/SkinnedMesh.h>
 #include <yave/animations/SkeletonInstance.h>
+#include <yave/graphics/bindings/DescriptorSet.h>
 
 #include "Transformable.h"
 #include "Renderable.h"
@@ -43,14 +44,27 @@ class SkinnedMeshInstance final : public Renderable {
 		void flush_reload() override;
 
 		void render(RenderPassRecorder& recorder, const SceneData& scene_data) const override;
+		void skin(CmdBufferRecorder& recorder, const SkinningData& skinning_data) const override;
+		SubBufferBase skinned_vertices() const override;
+
+		SkeletonInstance* skeleton() const override {
+			return &_skeleton;
+		}
 
 		void animate(const AssetPtr<Animation>& anim) {
 			_skeleton.animate(anim);
 		}
 
 	private:
+		void create_skinned_vertices();
+
 		AssetPtr<SkinnedMesh> _mesh;
 
+		// written by skinning.comp, kept as long as the pose doesn't change
+		TypedBuffer<Vertex, BufferUsage::AttributeBit | BufferUsage::StorageBit, MemoryType::DeviceLocal> _skinned_vertices;
+		DescriptorSet _skinning_set;
+		mutable bool _skinned = false;
+
 		mutable SkeletonInstance _skeleton;
 		mutable AssetPtr<Material> _material;
 };
@@ -23,6 +23,7 @@ SOFTWARE.
 #include "StaticMeshInstance.h"
 
 #include <yave/material/Material.h>
+#include <yave/camera/Camera.h>
 
 namespace yave {
 
@@ -39,24 +40,80 @@ StaticMeshInstance::StaticMeshInstance(StaticMeshInstance&& other) :
 		_material(std::move(other._material)) {
 }
 
+usize StaticMeshInstance::select_lod(const Camera& camera, usize current) const {
+	usize lod_count = _mesh->lod_count();
+	if(lod_count <= 1) {
+		return 0;
+	}
+
+	const auto& tr = transform();
+	float scale = std::max({tr.forward().length(), tr.left().length(), tr.up().length()});
+	float distance = (tr.position() - camera.position()).length();
+	float world_radius = radius() * scale;
+	if(distance <= world_radius) {
+		return 0;
+	}
+
+	// projected radius relative to the viewport half height
+	float screen_size = world_radius * camera.proj_matrix()[1][1] / distance;
+	auto threshold = [&](usize lod) {
+		return lod_screen_error / _mesh->lod_error(lod);
+	};
+
+	usize lod = std::min(current, lod_count - 1);
+	while(lod + 1 < lod_count && screen_size < threshold(lod + 1) * (1.0f - lod_hysteresis)) {
+		++lod;
+	}
+	while(lod && screen_size > threshold(lod) * (1.0f + lod_hysteresis)) {
+		--lod;
+	}
+	return lod;
+}
+
 void StaticMeshInstance::flush_reload() {
 	_mesh.flush_reload();
 	_material.flush_reload();
 }
 
-void StaticMeshInstance::render(RenderPassRecorder& recorder, const SceneData& scene_data) const {
+void StaticMeshInstance::bind_material(RenderPassRecorder& recorder, const SceneData& scene_data) const {
+	VertexFormat vertex_format = _mesh->vertex_format();
 	if(_material->descriptor_set().device()) {
-		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set, _material->descriptor_set()});
+		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set, _material->descriptor_set()}, vertex_format);
 	} else {
-		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set});
+		recorder.bind_material(_material->mat_template(), {scene_data.descriptor_set}, vertex_format);
+	}
+
+	if(vertex_format == VertexFormat::Packed) {
+		recorder.push_constants(_mesh->dequantization());
 	}
+}
+
+void StaticMeshInstance::render(RenderPassRecorder& recorder, const SceneData& scene_data) const {
+	render_lod(recorder, scene_data, 0);
+}
 
-	recorder.bind_buffers(TriangleSubBuffer(_mesh->triangle_buffer()), {VertexSubBuffer(_mesh->vertex_buffer())});
+void StaticMeshInstance::render_lod(RenderPassRecorder& recorder, const SceneData& scene_data, usize lod) const {
+	bind(recorder, scene_data);
 
-	auto indirect = _mesh->indirect_data();
+	auto indirect = _mesh->indirect_data(std::min(lod, _mesh->lod_count() - 1));
 	indirect.setFirstInstance(scene_data.instance_index);
 	recorder.draw(indirect);
 }
 
+void StaticMeshInstance::render_culled(RenderPassRecorder& recorder, const SceneData& scene_data, const SubBuffer<BufferUsage::IndexBit>& indices, const IndirectSubBuffer& commands, usize command_index) const {
+	bind_culled(recorder, scene_data, indices);
+	recorder.draw_indirect(commands, command_index);
+}
+
+void StaticMeshInstance::bind(RenderPassRecorder& recorder, const SceneData& scene_data) const {
+	bind_material(recorder, scene_data);
+	recorder.bind_buffers(_mesh->triangle_buffer(), {_mesh->vertex_buffer()}, _mesh->index_type());
+}
+
+void StaticMeshInstance::bind_culled(RenderPassRecorder& recorder, const SceneData& scene_data, const SubBuffer<BufferUsage::IndexBit>& indices) const {
+	bind_material(recorder, scene_data);
+	recorder.bind_buffers(indices, {_mesh->vertex_buffer()});
+}
+
 
 }
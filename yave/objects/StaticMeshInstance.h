@@ -29,9 +29,15 @@ SOFTWARE.
 
 namespace yave {
 
+class Camera;
+
 class StaticMeshInstance final : public Renderable {
 
 	public:
+		// maximum LOD error on screen, relative to the viewport half height
+		static constexpr float lod_screen_error = 1.0f / 1024.0f;
+		static constexpr float lod_hysteresis = 0.1f;
+
 		StaticMeshInstance(const AssetPtr<StaticMesh>& mesh, const AssetPtr<Material>& material);
 
 		StaticMeshInstance(StaticMeshInstance&& other);
@@ -39,8 +45,23 @@ class StaticMeshInstance final : public Renderable {
 
 		void flush_reload() override;
 
+		// draws the full detail mesh
 		void render(RenderPassRecorder& recorder, const SceneData& scene_data) const override;
 
+		void render_lod(RenderPassRecorder& recorder, const SceneData& scene_data, usize lod) const;
+
+		// draws indices compacted by meshlet_cull.comp
+		void render_culled(RenderPassRecorder& recorder, const SceneData& scene_data, const SubBuffer<BufferUsage::IndexBit>& indices, const IndirectSubBuffer& commands, usize command_index) const;
+
+		// binds the material and the mesh's own buffers, for commands written on the GPU
+		void bind(RenderPassRecorder& recorder, const SceneData& scene_data) const;
+
+		// binds the material and indices compacted by meshlet_cull.comp
+		void bind_culled(RenderPassRecorder& recorder, const SceneData& scene_data, const SubBuffer<BufferUsage::IndexBit>& indices) const;
+
+		// returns the LOD to use for camera, current is the LOD selected for the previous frame, for hysteresis
+		usize select_lod(const Camera& camera, usize current) const;
+
 		const auto& mesh() const {
 			return _mesh;
 		}
@@ -59,6 +80,8 @@ class StaticMeshInstance final : public Renderable {
 
 
 	private:
+		void bind_material(RenderPassRecorder& recorder, const SceneData& scene_data) const;
+
 		AssetPtr<StaticMesh> _mesh;
 		mutable AssetPtr<Material> _material;
 };
@@ -24,7 +24,7 @@ SOFTWARE.
 
 namespace yave {
 
-GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size) {
+GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size, const std::shared_ptr<OcclusionCuller>& culler) {
 	static constexpr vk::Format depth_format = vk::Format::eD32Sfloat;
 	static constexpr vk::Format color_format = vk::Format::eR8G8B8A8Unorm;
 	static constexpr vk::Format normal_format = vk::Format::eR16G16B16A16Unorm;
@@ -33,13 +33,22 @@ GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const
 	auto color = framegraph.declare_image(color_format, size);
 	auto normal = framegraph.declare_image(normal_format, size);
 
+	// every other pass of the view reads them
+	view->update_lods();
+
+	SkinningPass skinning = skin_meshes(framegraph, view);
+	MeshletCullPass meshlet_pass = cull_meshlets(framegraph, view);
+	OcclusionCullPass occlusion_pass = cull_occluded(framegraph, view, size, meshlet_pass, culler);
+
 	FrameGraphPassBuilder builder = framegraph.add_pass("G-buffer pass");
 
 	GBufferPass pass;
 	pass.depth = depth;
 	pass.color = color;
 	pass.normal = normal;
-	pass.scene_pass = create_scene_render(framegraph, builder, view);
+	pass.skinning = skinning;
+	pass.scene_pass = create_scene_render(framegraph, builder, view, meshlet_pass, occlusion_pass);
+	add_skinned_vertex_inputs(builder, skinning);
 
 	builder.add_depth_output(depth);
 	builder.add_color_output(color);
@@ -49,6 +58,22 @@ GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const
 			render_scene(render_pass, pass.scene_pass, self);
 		});
 
+	if(occlusion_pass.is_valid()) {
+		cull_disoccluded(framegraph, occlusion_pass, depth);
+
+		FrameGraphPassBuilder late_builder = framegraph.add_pass("G-buffer disocclusion pass");
+		SceneRenderSubPass late_scene_pass = create_scene_render(framegraph, late_builder, view, meshlet_pass, occlusion_pass, OcclusionCullPhase::Late);
+		add_skinned_vertex_inputs(late_builder, skinning);
+
+		late_builder.add_depth_output(depth, Framebuffer::LoadOp::Load);
+		late_builder.add_color_output(color, Framebuffer::LoadOp::Load);
+		late_builder.add_color_output(normal, Framebuffer::LoadOp::Load);
+		late_builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				auto render_pass = recorder.bind_framebuffer(self->framebuffer());
+				render_scene(render_pass, late_scene_pass, self);
+			});
+	}
+
 	return pass;
 }
 
@@ -23,18 +23,21 @@ SOFTWARE.
 #define YAVE_RENDERER_GBUFFERPASS_H
 
 #include "SceneRenderSubPass.h"
+#include "SkinningPass.h"
 
 namespace yave {
 
 struct GBufferPass {
 	SceneRenderSubPass scene_pass;
+	SkinningPass skinning;
 
 	FrameGraphImageId depth;
 	FrameGraphImageId color;
 	FrameGraphImageId normal;
 };
 
-GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size);
+// static meshes are occlusion culled if culler is not null, see OcclusionCuller
+GBufferPass render_gbuffer(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size, const std::shared_ptr<OcclusionCuller>& culler = nullptr);
 }
 
 
@@ -0,0 +1,106 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "HiZPyramid.h"
+
+#include <yave/device/Device.h>
+
+namespace yave {
+
+static vk::ImageView create_view(DevicePtr dptr, vk::Image image, ImageFormat format, usize level) {
+	return dptr->vk_device().createImageView(vk::ImageViewCreateInfo()
+			.setImage(image)
+			.setViewType(vk::ImageViewType::e2D)
+			.setFormat(format.vk_format())
+			.setSubresourceRange(vk::ImageSubresourceRange()
+					.setAspectMask(format.vk_aspect())
+					.setBaseArrayLayer(0)
+					.setLayerCount(1)
+					.setBaseMipLevel(u32(level))
+					.setLevelCount(1)
+				)
+		);
+}
+
+static u32 level_0_size(u32 depth_size) {
+	u32 size = 1;
+	while(size * 2 < depth_size) {
+		size *= 2;
+	}
+	return size;
+}
+
+static usize level_count(const math::Vec2ui& size) {
+	return 1 + log2ui(std::max(size.x(), size.y()));
+}
+
+struct PyramidBase : ImageBase {
+	PyramidBase(DevicePtr dptr, const math::Vec2ui& size) :
+		ImageBase(dptr, HiZPyramid::format, ImageUsage::TextureBit | ImageUsage::StorageBit, math::Vec3ui(size, 1), ImageType::TwoD, 1, level_count(size)) {
+	}
+};
+
+struct PyramidLevelView : HiZPyramid::LevelView {
+	// does not destroy the view, need to be done manually
+	PyramidLevelView(const ImageBase& base, usize level) :
+			LevelView(base.device(),
+					  math::Vec2ui(std::max(base.image_size().x() >> level, 1u), std::max(base.image_size().y() >> level, 1u)),
+					  base.usage(),
+					  base.format(),
+					  create_view(base.device(), base.vk_image(), base.format(), level),
+					  base.vk_image()) {
+	}
+};
+
+
+math::Vec2ui HiZPyramid::pyramid_size(const math::Vec2ui& depth_size) {
+	return math::Vec2ui(level_0_size(depth_size.x()), level_0_size(depth_size.y()));
+}
+
+HiZPyramid::HiZPyramid(DevicePtr dptr, const math::Vec2ui& depth_size) : _depth_size(depth_size) {
+	ImageBase::operator=(PyramidBase(dptr, pyramid_size(depth_size)));
+
+	_levels.set_min_capacity(mipmaps());
+	for(usize i = 0; i != mipmaps(); ++i) {
+		_levels << PyramidLevelView(*this, i);
+	}
+}
+
+HiZPyramid::~HiZPyramid() {
+	for(const auto& level : _levels) {
+		device()->destroy(level.vk_view());
+	}
+}
+
+const math::Vec2ui& HiZPyramid::depth_size() const {
+	return _depth_size;
+}
+
+usize HiZPyramid::levels() const {
+	return _levels.size();
+}
+
+const HiZPyramid::LevelView& HiZPyramid::level(usize index) const {
+	return _levels[index];
+}
+
+}
@@ -0,0 +1,58 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_HIZPYRAMID_H
+#define YAVE_RENDERER_HIZPYRAMID_H
+
+#include <yave/graphics/images/ImageView.h>
+
+namespace yave {
+
+// Each texel holds the farthest depth (the min with reversed Z) of the texels it covers in the level below.
+// Levels are power of two sized so that every level exactly halves the previous one, level 0 covers the whole depth buffer.
+class HiZPyramid : public StorageTexture {
+
+	public:
+		using LevelView = ImageView<ImageUsage::TextureBit | ImageUsage::StorageBit>;
+
+		static constexpr vk::Format format = vk::Format::eR32Sfloat;
+
+		static math::Vec2ui pyramid_size(const math::Vec2ui& depth_size);
+
+		HiZPyramid(DevicePtr dptr, const math::Vec2ui& depth_size);
+		~HiZPyramid();
+
+		HiZPyramid(HiZPyramid&&) = delete;
+		HiZPyramid& operator=(HiZPyramid&&) = delete;
+
+		const math::Vec2ui& depth_size() const;
+
+		usize levels() const;
+		const LevelView& level(usize index) const;
+
+	private:
+		math::Vec2ui _depth_size;
+		core::Vector<LevelView> _levels;
+};
+
+}
+
+#endif // YAVE_RENDERER_HIZPYRAMID_H
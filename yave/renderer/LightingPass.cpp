@@ -25,8 +25,12 @@ SOFTWARE.
 #include <yave/device/Device.h>
 
 #include <y/core/Chrono.h>
+#include <y/concurrent/concurrent.h>
+#include <y/mem/LinearAllocator.h>
 #include <y/io/File.h>
 
+#include <mutex>
+
 namespace yave {
 
 static Texture create_ibl_lut(DevicePtr dptr, usize size = 512) {
@@ -79,54 +83,228 @@ TextureView IBLData::brdf_lut() const  {
 }
 
 
-static constexpr usize max_light_count = 1024;
+static constexpr usize max_light_count = 64 * 1024;
+
+// must match yave.glsl
+static constexpr u32 cluster_tile_size = 64;
+static constexpr u32 cluster_slices = 24;
+static constexpr usize max_cluster_lights = 128;
+
+
+LightClusterCache::LightClusterCache(DevicePtr dptr) : DeviceLinked(dptr), _dropped(dptr, 1) {
+}
+
+std::shared_ptr<LightClusterCache::ReadbackFrame> LightClusterCache::next_frame() {
+	return _dropped.next_frame([this](const TypedMapping<u32>& mapping) {
+		const u32 dropped = mapping[0];
+		if(dropped != _dropped_lights) {
+			if(dropped) {
+				log_msg(fmt("% lights were dropped from full light clusters (max % per cluster).", dropped, max_cluster_lights), Log::Warning);
+			} else {
+				log_msg("Light clusters are no longer full.");
+			}
+		}
+		_dropped_lights = dropped;
+	});
+}
+
+u32 LightClusterCache::dropped_lights() const {
+	return _dropped_lights;
+}
 
 
-LightingPass render_lighting(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<IBLData>& ibl_data) {
+static uniform::Light shadowed_light(const Light* light, const ShadowMapCache::FrameData& shadows) {
+	uniform::Light l = *light;
+	if(auto it = shadows.shadow_indices.find(light); it != shadows.shadow_indices.end()) {
+		l.shadow_index = it->second;
+	}
+	return l;
+}
+
+// culls point lights against the frustum and writes them packed at the start of mapping,
+// directional lights are never culled and are packed at the end, see LightingStats::directional_offset.
+// Lights are written in scene order: full clusters keep the lights with the lowest indices, which must not change from one frame to the next
+static LightingStats pack_lights(const SceneView* scene, const ShadowMapCache::FrameData& shadows, TypedMapping<uniform::Light>& mapping, u32 max_count) {
+	y_profile();
+
+	const auto& lights = scene->scene().lights();
+	const Frustum frustum = scene->camera().frustum();
+
+	struct Block {
+		usize index = 0;
+		u32 point_count = 0;
+		core::Vector<const Light*> visible;
+		core::Vector<const Light*> directionals;
+
+		u32 point_offset = 0;
+		u32 directional_offset = 0;
+	};
+
+	core::Vector<Block> blocks;
+	std::mutex lock;
+	concurrent::parallel_indexed_block_for(lights.begin(), lights.end(), [&](usize index, const auto& range) {
+		Block block;
+		block.index = index;
+		for(const auto& l : range) {
+			if(l->type() == Light::Point) {
+				++block.point_count;
+				if(frustum.is_inside(l->position(), l->radius())) {
+					block.visible << l.get();
+				}
+			} else {
+				block.directionals << l.get();
+			}
+		}
+
+		std::unique_lock _(lock);
+		blocks << std::move(block);
+	});
+	std::sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) { return a.index < b.index; });
+
+	LightingStats stats;
+	for(Block& block : blocks) {
+		block.point_offset = stats.visible_point_count;
+		block.directional_offset = stats.directional_count;
+		stats.point_count += block.point_count;
+		stats.visible_point_count += u32(block.visible.size());
+		stats.directional_count += u32(block.directionals.size());
+	}
+	const u32 wanted = stats.visible_point_count + stats.directional_count;
+
+	// directionals are never dropped before points
+	stats.directional_count = std::min(stats.directional_count, max_count);
+	stats.visible_point_count = std::min(stats.visible_point_count, max_count - stats.directional_count);
+	stats.directional_offset = max_count - stats.directional_count;
+
+	if(wanted > max_count) {
+		log_msg(fmt("Too many lights (%), only % will be rendered.", wanted, max_count), Log::Warning);
+	}
+
+	concurrent::parallel_for_each(blocks.begin(), blocks.end(), [&](const Block& block) {
+		for(usize i = 0; i != block.directionals.size() && block.directional_offset + i < stats.directional_count; ++i) {
+			mapping[max_count - 1 - (block.directional_offset + i)] = shadowed_light(block.directionals[i], shadows);
+		}
+		for(usize i = 0; i != block.visible.size() && block.point_offset + i < stats.visible_point_count; ++i) {
+			mapping[block.point_offset + i] = shadowed_light(block.visible[i], shadows);
+		}
+	});
+
+	return stats;
+}
+
+
+LightingPass render_lighting(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<IBLData>& ibl_data, const ShadowMapPass& shadows, const std::shared_ptr<LightClusterCache>& clusters) {
 	y_profile();
 
 	static constexpr vk::Format lighting_format = vk::Format::eR16G16B16A16Sfloat;
 	math::Vec2ui size = framegraph.image_size(gbuffer.depth);
-
+	math::Vec2ui tile_count = (size + math::Vec2ui(cluster_tile_size - 1)) / cluster_tile_size;
+	usize cluster_count = tile_count.x() * tile_count.y() * cluster_slices;
 	const SceneView* scene = gbuffer.scene_pass.scene_view;
 
+	// enough for every cluster to be full, clusters can't hold more than the scene's lights
+	usize max_index_count = cluster_count * std::clamp(scene->scene().lights().size(), usize(1), max_cluster_lights);
+
 	auto lit = framegraph.declare_image(lighting_format, size);
 	auto light_buffer = framegraph.declare_typed_buffer<uniform::Light>(max_light_count);
+	auto clusters = framegraph.declare_typed_buffer<math::Vec2ui>(cluster_count);
+	auto light_indices = framegraph.declare_typed_buffer<u32>(max_index_count);
+	auto index_count = framegraph.declare_typed_buffer<u32>();
+	auto shadow_maps = framegraph.declare_typed_buffer<uniform::ShadowMap>(std::max(shadows.frame->views.size(), usize(1)));
+	auto shadow_frame = shadows.frame;
 
 	LightingPass pass;
 	pass.lit = lit;
+	pass.stats = std::make_shared<LightingStats>();
 
-	FrameGraphPassBuilder builder = framegraph.add_pass("Lighting pass");
-	builder.add_uniform_input(gbuffer.depth, 0, PipelineStage::ComputeBit);
-	builder.add_uniform_input(gbuffer.color, 0, PipelineStage::ComputeBit);
-	builder.add_uniform_input(gbuffer.normal, 0, PipelineStage::ComputeBit);
-	builder.add_uniform_input(ibl_data->envmap(), 0, PipelineStage::ComputeBit);
-	builder.add_uniform_input(ibl_data->brdf_lut(), 0, PipelineStage::ComputeBit);
-	builder.add_storage_input(light_buffer, 0, PipelineStage::ComputeBit);
-	builder.add_storage_output(lit, 0, PipelineStage::ComputeBit);
-
-	builder.map_update(light_buffer);
-
-	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
-			struct PushData {
-				uniform::Camera camera;
-				u32 point_count = 0;
-				u32 directional_count = 0;
-			} push_data;
-			push_data.camera = scene->camera();
-
-			TypedMapping<uniform::Light> mapping = self->resources()->mapped_buffer(light_buffer);
-			usize light_count = scene->scene().lights().size();
-			for(const auto& l : scene->scene().lights()) {
-				if(l->type() == Light::Point) {
-					mapping[push_data.point_count++] = *l;
-				} else {
-					mapping[light_count - ++push_data.directional_count] = *l;
+	{
+		FrameGraphPassBuilder builder = framegraph.add_pass("Light clustering pass");
+		builder.add_storage_input(light_buffer, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(clusters, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(light_indices, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(index_count, 0, PipelineStage::ComputeBit);
+
+		auto dropped_lights = clusters->next_frame();
+		builder.add_descriptor_binding(Binding(dropped_lights->buffer()));
+
+		builder.map_update(light_buffer);
+		builder.map_update(index_count);
+
+		std::shared_ptr<LightingStats> stats = pass.stats;
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				{
+					TypedMapping<uniform::Light> mapping = self->resources()->mapped_buffer(light_buffer);
+					*stats = pack_lights(scene, *shadow_frame, mapping, u32(max_light_count));
 				}
-			}
-			const auto& program = recorder.device()->device_resources()[DeviceResources::DeferredLightingProgram];
-			recorder.dispatch_size(program, size, {self->descriptor_sets()[0]}, push_data);
-		});
+
+				self->resources()->mapped_buffer(index_count)[0] = 0;
+
+				struct PushData {
+					uniform::Camera camera;
+					math::Vec2 tile_uv_size;
+					u32 point_count = 0;
+					u32 max_index_count = 0;
+				} push_data;
+				push_data.camera = scene->camera();
+				push_data.tile_uv_size = math::Vec2(float(cluster_tile_size)) / math::Vec2(size);
+				push_data.point_count = stats->visible_point_count;
+				push_data.max_index_count = u32(max_index_count);
+
+				const auto& program = recorder.device()->device_resources()[DeviceResources::LightClusterProgram];
+				recorder.dispatch(program, math::Vec3ui(tile_count, 1), {self->descriptor_sets()[0]}, push_data);
+
+				recorder.barriers(BufferBarrier(dropped_lights->buffer(), PipelineStage::ComputeBit, PipelineStage::HostBit));
+				recorder.keep_alive(dropped_lights);
+			});
+	}
+
+	{
+		FrameGraphPassBuilder builder = framegraph.add_pass("Lighting pass");
+		builder.add_uniform_input(gbuffer.depth, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(gbuffer.color, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(gbuffer.normal, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(ibl_data->envmap(), 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(ibl_data->brdf_lut(), 0, PipelineStage::ComputeBit);
+		builder.add_storage_input(light_buffer, 0, PipelineStage::ComputeBit);
+		builder.add_storage_output(lit, 0, PipelineStage::ComputeBit);
+		builder.add_storage_input(clusters, 0, PipelineStage::ComputeBit);
+		builder.add_storage_input(light_indices, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(TextureView(shadows.cache->static_atlas()), 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(shadows.dynamic_atlas, 0, PipelineStage::ComputeBit);
+		builder.add_storage_input(shadow_maps, 0, PipelineStage::ComputeBit);
+
+		builder.map_update(shadow_maps);
+
+		float atlas_size = float(shadows.cache->atlas_size());
+
+		// filled by the light clustering pass, which is rendered first
+		std::shared_ptr<const LightingStats> stats = pass.stats;
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				struct PushData {
+					uniform::Camera camera;
+					u32 directional_offset = 0;
+					u32 directional_count = 0;
+				} push_data;
+				push_data.camera = scene->camera();
+				push_data.directional_offset = stats->directional_offset;
+				push_data.directional_count = stats->directional_count;
+
+				{
+					TypedMapping<uniform::ShadowMap> mapping = self->resources()->mapped_buffer(shadow_maps);
+					for(usize i = 0; i != shadow_frame->views.size(); ++i) {
+						const auto& view = shadow_frame->views[i];
+						mapping[i] = uniform::ShadowMap{
+								view.camera.viewproj_matrix(),
+								math::Vec2(view.tile.offset) / atlas_size,
+								math::Vec2(float(view.tile.size) / atlas_size)
+							};
+					}
+				}
+
+				const auto& program = recorder.device()->device_resources()[DeviceResources::DeferredLightingProgram];
+				recorder.dispatch_size(program, size, {self->descriptor_sets()[0]}, push_data);
+			});
+	}
 
 	return pass;
 }
@@ -23,8 +23,10 @@ SOFTWARE.
 #define YAVE_RENDERER_LIGHTINGPASS_H
 
 #include <yave/graphics/images/IBLProbe.h>
+#include <yave/graphics/buffers/ReadbackRing.h>
 
 #include "GBufferPass.h"
+#include "ShadowMapPass.h"
 
 namespace yave {
 
@@ -44,11 +46,41 @@ class IBLData : NonCopyable, public DeviceLinked {
 };
 
 
+// Per view state of the light clustering.
+// Lights dropped by full clusters are read back once the GPU is done with the frame, a warning is logged when their count changes.
+class LightClusterCache : NonCopyable, public DeviceLinked {
+	public:
+		using ReadbackFrame = ReadbackRing<u32>::Frame;
+
+		LightClusterCache(DevicePtr dptr);
+
+		// reads back the completed frames and returns the buffer the next one writes its dropped light count in
+		std::shared_ptr<ReadbackFrame> next_frame();
+
+		// in the last frame read back
+		u32 dropped_lights() const;
+
+	private:
+		ReadbackRing<u32> _dropped;
+		u32 _dropped_lights = 0;
+};
+
+
+// filled when the frame graph is rendered
+struct LightingStats {
+	u32 point_count = 0;
+	u32 visible_point_count = 0;
+	u32 directional_count = 0;
+	// directionals are at the end of the light buffer
+	u32 directional_offset = 0;
+};
+
 struct LightingPass {
 	FrameGraphImageId lit;
+	std::shared_ptr<LightingStats> stats;
 };
 
-LightingPass render_lighting(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<IBLData>& ibl_data);
+LightingPass render_lighting(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<IBLData>& ibl_data, const ShadowMapPass& shadows, const std::shared_ptr<LightClusterCache>& clusters);
 
 }
 
@@ -0,0 +1,97 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "MeshletCullPass.h"
+
+#include <yave/device/Device.h>
+#include <yave/graphics/shaders/ComputeProgram.h>
+#include <yave/objects/StaticMeshInstance.h>
+
+namespace yave {
+
+MeshletCullPass cull_meshlets(FrameGraph& framegraph, const SceneView* view) {
+	y_profile();
+
+	MeshletCullPass pass;
+
+	usize index_count = 0;
+	usize command_count = 0;
+	for(const auto& r : view->scene().static_meshes()) {
+		if(r->mesh()->has_meshlets()) {
+			index_count += r->mesh()->indirect_data().indexCount;
+			++command_count;
+		}
+	}
+
+	if(!command_count) {
+		return pass;
+	}
+
+	auto indices = framegraph.declare_typed_buffer<u32>(index_count);
+	auto commands = framegraph.declare_typed_buffer<vk::DrawIndexedIndirectCommand>(command_count);
+	pass.indices = indices;
+	pass.commands = commands;
+
+	FrameGraphPassBuilder builder = framegraph.add_pass("Meshlet culling pass");
+	builder.add_storage_output(indices, 0, PipelineStage::ComputeBit);
+	builder.add_storage_output(commands, 0, PipelineStage::ComputeBit);
+	builder.map_update(commands);
+
+	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+			const Camera& camera = view->camera();
+			Frustum frustum = camera.frustum();
+			math::Vec3 eye = camera.position();
+
+			const auto& program = recorder.device()->device_resources()[DeviceResources::MeshletCullProgram];
+			TypedMapping<vk::DrawIndexedIndirectCommand> mapping = self->resources()->mapped_buffer(commands);
+
+			// instance indices follow render_scene: renderables first, then static meshes
+			u32 instance_index = u32(view->scene().renderables().size());
+			u32 command_index = 0;
+			u32 offset = 0;
+			for(const auto& r : view->scene().static_meshes()) {
+				u32 instance = instance_index++;
+				const auto& mesh = r->mesh();
+				if(!mesh->has_meshlets()) {
+					continue;
+				}
+
+				u32 mesh_index_count = mesh->indirect_data().indexCount;
+				mapping[command_index] = vk::DrawIndexedIndirectCommand(0, 1, offset, 0, instance);
+
+				if(!view->lod(*r)) {
+					MeshletCullData data = meshlet_cull_data(r->transform(), frustum, eye);
+					data.meshlet_count = u32(mesh->meshlet_count());
+					data.output_offset = offset;
+					data.command_index = command_index;
+					recorder.dispatch(program, math::Vec3ui(data.meshlet_count, 1, 1), {self->descriptor_sets()[0], mesh->meshlet_descriptor_set()}, data);
+				}
+
+				offset += mesh_index_count;
+				++command_index;
+			}
+		});
+
+	return pass;
+}
+
+}
@@ -0,0 +1,41 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_MESHLETCULLPASS_H
+#define YAVE_RENDERER_MESHLETCULLPASS_H
+
+#include <yave/scene/SceneView.h>
+#include <yave/framegraph/FrameGraph.h>
+
+namespace yave {
+
+// compacts the visible meshlets of every LOD 0 static mesh into one draw command per instance
+struct MeshletCullPass {
+	FrameGraphMutableTypedBufferId<u32> indices;
+	FrameGraphMutableTypedBufferId<vk::DrawIndexedIndirectCommand> commands;
+};
+
+// commands is invalid if nothing in the scene has meshlets
+MeshletCullPass cull_meshlets(FrameGraph& framegraph, const SceneView* view);
+
+}
+
+#endif // YAVE_RENDERER_MESHLETCULLPASS_H
@@ -0,0 +1,283 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "OcclusionCullPass.h"
+
+#include <yave/device/Device.h>
+#include <yave/graphics/shaders/ComputeProgram.h>
+#include <yave/objects/StaticMeshInstance.h>
+
+#include <y/mem/LinearAllocator.h>
+
+#include <tuple>
+
+namespace yave {
+
+static math::Vec4 bounding_sphere(const Renderable& r) {
+	const auto& tr = r.transform();
+	float scale = std::max({tr.forward().length(), tr.left().length(), tr.up().length()});
+	return math::Vec4(tr.position(), r.radius() * scale);
+}
+
+static void add_cull_resources(FrameGraphPassBuilder& builder, const OcclusionCullPass& pass, OcclusionCullPhase phase) {
+	builder.add_uniform_input(pass.cull_data, 0, PipelineStage::ComputeBit);
+	builder.add_uniform_input(TextureView(*pass.frame->pyramid), 0, PipelineStage::ComputeBit);
+	builder.add_storage_input(pass.instances, 0, PipelineStage::ComputeBit);
+	builder.add_storage_input(pass.meshlet_commands, 0, PipelineStage::ComputeBit);
+	if(phase == OcclusionCullPhase::Early) {
+		builder.add_storage_output(pass.early_commands, 0, PipelineStage::ComputeBit);
+	} else {
+		builder.add_storage_input(pass.early_commands, 0, PipelineStage::ComputeBit);
+	}
+	builder.add_storage_output(pass.late_commands, 0, PipelineStage::ComputeBit);
+	builder.add_storage_output(pass.counts, 0, PipelineStage::ComputeBit);
+	if(phase == OcclusionCullPhase::Early) {
+		builder.add_storage_output(pass.late_candidates, 0, PipelineStage::ComputeBit);
+	} else {
+		builder.add_storage_input(pass.late_candidates, 0, PipelineStage::ComputeBit);
+	}
+	builder.add_descriptor_binding(Binding(pass.frame->stats->buffer()));
+}
+
+static void dispatch_cull(CmdBufferRecorder& recorder, const FrameGraphPass* self, const OcclusionCullPass& pass, OcclusionCullPhase phase) {
+	usize instance_count = pass.frame->static_meshes.size();
+	if(!instance_count) {
+		return;
+	}
+
+	const auto& program = recorder.device()->device_resources()[DeviceResources::OcclusionCullProgram];
+	const u32 phase_index = u32(phase);
+	recorder.dispatch_size(program, math::Vec3ui(u32(instance_count), 1, 1), {self->descriptor_sets()[0]}, phase_index);
+}
+
+
+
+OcclusionCuller::OcclusionCuller(DevicePtr dptr) :
+		DeviceLinked(dptr),
+		_stats_ring(dptr, 2) {
+}
+
+OcclusionCuller::FrameData OcclusionCuller::update(const SceneView* view, const math::Vec2ui& depth_size) {
+	y_profile();
+
+	auto stats = _stats_ring.next_frame([this](const TypedMapping<u32>& mapping) {
+			_stats = _pending_stats.front();
+			_pending_stats.pop_front();
+			_stats.early_visible = mapping[0];
+			_stats.late_visible = mapping[1];
+			_stats.occluded = _stats.frustum_visible - std::min(_stats.frustum_visible, _stats.early_visible + _stats.late_visible);
+		});
+
+	if(!_pyramid || _pyramid->depth_size() != depth_size) {
+		_pyramid = std::make_unique<HiZPyramid>(device(), depth_size);
+		_has_history = false;
+	}
+
+	const Camera& camera = view->camera();
+	const auto& static_meshes = view->scene().static_meshes();
+
+	math::SphereArray spheres(static_meshes.size());
+	for(usize i = 0; i != static_meshes.size(); ++i) {
+		spheres.set(i, bounding_sphere(*static_meshes[i]));
+	}
+
+	core::Vector<u8> visible(static_meshes.size(), u8(0));
+	camera.frustum().is_inside(spheres, visible.data());
+
+	FrameData frame;
+	for(usize i = 0; i != visible.size(); ++i) {
+		if(visible[i]) {
+			frame.static_meshes << u32(i);
+		}
+	}
+
+	// meshlet culled instances are drawn from another index buffer
+	auto batch_key = [&](u32 i) {
+		const auto& r = static_meshes[i];
+		return std::make_tuple(r->material().get(), r->mesh().get(), view->lod(*r) == 0);
+	};
+	std::sort(frame.static_meshes.begin(), frame.static_meshes.end(), [&](u32 a, u32 b) { return batch_key(a) < batch_key(b); });
+	for(usize i = 0; i != frame.static_meshes.size(); ++i) {
+		if(!i || batch_key(frame.static_meshes[i]) != batch_key(frame.static_meshes[i - 1])) {
+			frame.batches << Batch{u32(i), 0};
+		}
+		++frame.batches.last().size;
+	}
+
+	frame.cull_data.view_proj = camera.viewproj_matrix();
+	frame.cull_data.prev_view_proj = _prev_view_proj;
+	frame.cull_data.pyramid_size = math::Vec2(_pyramid->size());
+	frame.cull_data.pyramid_levels = u32(_pyramid->levels());
+	frame.cull_data.instance_count = u32(frame.static_meshes.size());
+	frame.cull_data.has_history = _has_history;
+	frame.cull_data.batch_count = u32(frame.batches.size());
+	frame.cull_data.compact = device()->draw_indirect_count() != nullptr;
+
+	frame.pyramid = _pyramid.get();
+	frame.stats = std::move(stats);
+
+	OcclusionCullStats& pending = _pending_stats.emplace_back();
+	pending.instances = u32(static_meshes.size());
+	pending.frustum_visible = u32(frame.static_meshes.size());
+
+	_prev_view_proj = frame.cull_data.view_proj;
+	_has_history = true;
+
+	return frame;
+}
+
+const OcclusionCullStats& OcclusionCuller::stats() const {
+	return _stats;
+}
+
+bool& OcclusionCuller::enabled() {
+	return _enabled;
+}
+
+bool OcclusionCuller::enabled() const {
+	return _enabled;
+}
+
+
+
+OcclusionCullPass cull_occluded(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size, const MeshletCullPass& meshlet_pass, const std::shared_ptr<OcclusionCuller>& culler) {
+	y_profile();
+
+	OcclusionCullPass pass;
+	if(!culler || !culler->enabled()) {
+		return pass;
+	}
+
+	auto frame = std::make_shared<OcclusionCuller::FrameData>(culler->update(view, size));
+	usize instance_count = std::max(frame->static_meshes.size(), usize(1));
+
+	bool has_meshlets = meshlet_pass.commands.is_valid();
+
+	pass.cull_data = framegraph.declare_typed_buffer<OcclusionCullData>();
+	pass.instances = framegraph.declare_typed_buffer<OcclusionCullInstance>(instance_count);
+	// placeholder so that the descriptor layout doesn't depend on the scene, never read
+	pass.meshlet_commands = has_meshlets ? meshlet_pass.commands : framegraph.declare_typed_buffer<vk::DrawIndexedIndirectCommand>();
+	pass.early_commands = framegraph.declare_typed_buffer<vk::DrawIndexedIndirectCommand>(instance_count);
+	pass.late_commands = framegraph.declare_typed_buffer<vk::DrawIndexedIndirectCommand>(instance_count);
+	pass.counts = framegraph.declare_typed_buffer<u32>(frame->batches.size() * 2 + 1);
+	pass.late_candidates = framegraph.declare_typed_buffer<u32>(instance_count);
+	pass.culler = culler;
+	pass.frame = frame;
+
+	FrameGraphPassBuilder builder = framegraph.add_pass("Occlusion culling pass");
+	add_cull_resources(builder, pass, OcclusionCullPhase::Early);
+	builder.map_update(pass.cull_data);
+	builder.map_update(pass.instances);
+	builder.map_update(pass.counts);
+
+	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+			const auto& static_meshes = view->scene().static_meshes();
+			const auto& visible = frame->static_meshes;
+
+			self->resources()->mapped_buffer(pass.cull_data)[0] = frame->cull_data;
+
+			{
+				auto counts = self->resources()->mapped_buffer(pass.counts);
+				std::fill(counts.begin(), counts.end(), 0u);
+			}
+
+			{
+				TypedMapping<OcclusionCullInstance> mapping = self->resources()->mapped_buffer(pass.instances);
+
+				// meshlet commands are indexed like in cull_meshlets
+				auto meshlet_commands = core::frame_vector_with_capacity<u32>(static_meshes.size());
+				u32 meshlet_command = 0;
+				for(const auto& r : static_meshes) {
+					meshlet_commands << (has_meshlets && r->mesh()->has_meshlets() ? meshlet_command++ : OcclusionCullInstance::no_meshlet_command);
+				}
+
+				// instance indices follow render_scene: renderables first, then static meshes
+				u32 renderable_count = u32(view->scene().renderables().size());
+				for(usize b = 0; b != frame->batches.size(); ++b) {
+					const auto& batch = frame->batches[b];
+					for(u32 k = batch.first; k != batch.first + batch.size; ++k) {
+						u32 i = visible[k];
+						const auto& r = static_meshes[i];
+						const auto& mesh = r->mesh();
+
+						OcclusionCullInstance instance;
+						instance.sphere = bounding_sphere(*r);
+						usize lod = view->lod(*r);
+						instance.command = mesh->indirect_data(std::min(lod, mesh->lod_count() - 1));
+						instance.command.setFirstInstance(renderable_count + i);
+						instance.meshlet_command = lod ? OcclusionCullInstance::no_meshlet_command : meshlet_commands[i];
+						instance.batch = u32(b);
+						instance.first_command = batch.first;
+						mapping[k] = instance;
+					}
+				}
+			}
+
+			// the previous frame built the pyramid
+			recorder.barriers(ImageBarrier(*frame->pyramid, PipelineStage::ComputeBit, PipelineStage::ComputeBit));
+			dispatch_cull(recorder, self, pass, OcclusionCullPhase::Early);
+		});
+
+	return pass;
+}
+
+void cull_disoccluded(FrameGraph& framegraph, const OcclusionCullPass& occlusion_pass, FrameGraphImageId depth) {
+	y_profile();
+
+	const HiZPyramid* pyramid = occlusion_pass.frame->pyramid;
+
+	{
+		FrameGraphPassBuilder builder = framegraph.add_pass("Hi-Z pass");
+
+		// every level is built from the previous one in its own descriptor set
+		builder.add_uniform_input(depth, 0, PipelineStage::ComputeBit);
+		builder.add_uniform_input(StorageView(pyramid->level(0)), 0, PipelineStage::ComputeBit);
+		for(usize i = 1; i != pyramid->levels(); ++i) {
+			builder.add_uniform_input(TextureView(pyramid->level(i - 1)), i, PipelineStage::ComputeBit);
+			builder.add_uniform_input(StorageView(pyramid->level(i)), i, PipelineStage::ComputeBit);
+		}
+
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				const auto& program = recorder.device()->device_resources()[DeviceResources::HiZProgram];
+
+				// the first culling phase is still reading the previous pyramid
+				recorder.barriers(ImageBarrier(*pyramid, PipelineStage::ComputeBit, PipelineStage::ComputeBit));
+				for(usize i = 0; i != pyramid->levels(); ++i) {
+					recorder.dispatch_size(program, pyramid->level(i).size(), {self->descriptor_sets()[i]});
+					recorder.barriers(ImageBarrier(*pyramid, PipelineStage::ComputeBit, PipelineStage::ComputeBit));
+				}
+			});
+	}
+
+	{
+		FrameGraphPassBuilder builder = framegraph.add_pass("Disocclusion culling pass");
+		add_cull_resources(builder, occlusion_pass, OcclusionCullPhase::Late);
+
+		builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+				dispatch_cull(recorder, self, occlusion_pass, OcclusionCullPhase::Late);
+				recorder.barriers(BufferBarrier(occlusion_pass.frame->stats->buffer(), PipelineStage::ComputeBit, PipelineStage::HostBit));
+				recorder.keep_alive(occlusion_pass.frame->stats);
+			});
+	}
+}
+
+}
@@ -0,0 +1,161 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_OCCLUSIONCULLPASS_H
+#define YAVE_RENDERER_OCCLUSIONCULLPASS_H
+
+#include "MeshletCullPass.h"
+#include "HiZPyramid.h"
+
+#include <yave/graphics/buffers/buffers.h>
+#include <yave/graphics/buffers/ReadbackRing.h>
+
+#include <deque>
+
+namespace yave {
+
+struct OcclusionCullStats {
+	u32 instances = 0;
+	u32 frustum_visible = 0;
+	// drawn in the first phase because they were visible in the previous frame's pyramid
+	u32 early_visible = 0;
+	// disoccluded, drawn in the second phase
+	u32 late_visible = 0;
+	u32 occluded = 0;
+};
+
+// matches Instance in occlusion_cull.comp
+struct OcclusionCullInstance {
+	static constexpr u32 no_meshlet_command = u32(-1);
+
+	math::Vec4 sphere;
+	vk::DrawIndexedIndirectCommand command;
+	// index of the command written by meshlet_cull.comp, replaces command if set
+	u32 meshlet_command = no_meshlet_command;
+	u32 batch = 0;
+	// index of the batch's first command
+	u32 first_command = 0;
+};
+
+static_assert(sizeof(OcclusionCullInstance) == 48);
+
+// matches CullData in occlusion_cull.comp
+struct OcclusionCullData {
+	math::Matrix4<> view_proj;
+	math::Matrix4<> prev_view_proj;
+	math::Vec2 pyramid_size;
+	u32 pyramid_levels = 0;
+	u32 instance_count = 0;
+	u32 has_history = 0;
+	u32 batch_count = 0;
+	// surviving commands are packed at the start of their batch, requires VK_KHR_draw_indirect_count
+	u32 compact = 0;
+	u32 padding = 0;
+};
+
+static_assert(sizeof(OcclusionCullData) == 160);
+
+enum class OcclusionCullPhase {
+	Early,
+	Late
+};
+
+// Static meshes are culled in two phases against a Hi-Z pyramid.
+// Frustum visible instances are sorted in batches sharing material and mesh, each drawn with one indirect call per phase.
+// Instances visible in the previous frame's pyramid are drawn first, the pyramid is then rebuilt from their depth
+// and the rejected instances are tested against it and drawn in a second phase if they turned out to be visible.
+// The pyramid built from the first phase is kept for the next frame: it misses the disoccluded instances, which only makes it conservative.
+class OcclusionCuller : NonCopyable, public DeviceLinked {
+
+	public:
+		using StatsFrame = ReadbackRing<u32>::Frame;
+
+		// consecutive commands of instances sharing material and mesh
+		struct Batch {
+			u32 first = 0;
+			u32 size = 0;
+		};
+
+		struct FrameData {
+			OcclusionCullData cull_data;
+
+			// indices of the frustum visible static meshes, sorted by batch, one instance and command each
+			core::Vector<u32> static_meshes;
+			core::Vector<Batch> batches;
+
+			const HiZPyramid* pyramid = nullptr;
+			// early and late visible counts, read back once the GPU is done with the frame
+			std::shared_ptr<StatsFrame> stats;
+		};
+
+		OcclusionCuller(DevicePtr dptr);
+
+		FrameData update(const SceneView* view, const math::Vec2ui& depth_size);
+
+		const OcclusionCullStats& stats() const;
+
+		bool& enabled();
+		bool enabled() const;
+
+	private:
+		std::unique_ptr<HiZPyramid> _pyramid;
+		math::Matrix4<> _prev_view_proj;
+		bool _has_history = false;
+
+		ReadbackRing<u32> _stats_ring;
+		// CPU side stats of the frames not read back yet, oldest first
+		std::deque<OcclusionCullStats> _pending_stats;
+
+		OcclusionCullStats _stats;
+		bool _enabled = true;
+};
+
+
+// invalid if the culler is null or disabled
+struct OcclusionCullPass {
+	FrameGraphMutableTypedBufferId<OcclusionCullData> cull_data;
+	FrameGraphMutableTypedBufferId<OcclusionCullInstance> instances;
+	FrameGraphMutableTypedBufferId<vk::DrawIndexedIndirectCommand> meshlet_commands;
+	FrameGraphMutableTypedBufferId<vk::DrawIndexedIndirectCommand> early_commands;
+	FrameGraphMutableTypedBufferId<vk::DrawIndexedIndirectCommand> late_commands;
+
+	// command count of each batch in the first phase, then in the second one, then the number of late candidates
+	FrameGraphMutableTypedBufferId<u32> counts;
+	// instances rejected by the first phase
+	FrameGraphMutableTypedBufferId<u32> late_candidates;
+
+	std::shared_ptr<OcclusionCuller> culler;
+	std::shared_ptr<const OcclusionCuller::FrameData> frame;
+
+	bool is_valid() const {
+		return early_commands.is_valid();
+	}
+};
+
+// first phase, fills early_commands with the instances visible in the previous frame
+OcclusionCullPass cull_occluded(FrameGraph& framegraph, const SceneView* view, const math::Vec2ui& size, const MeshletCullPass& meshlet_pass, const std::shared_ptr<OcclusionCuller>& culler);
+
+// builds the pyramid from the depth of the first phase and fills late_commands with the disoccluded instances
+void cull_disoccluded(FrameGraph& framegraph, const OcclusionCullPass& occlusion_pass, FrameGraphImageId depth);
+
+}
+
+#endif // YAVE_RENDERER_OCCLUSIONCULLPASS_H
@@ -25,7 +25,9 @@ SOFTWARE.
 namespace yave {
 static constexpr usize max_batch_size = 128 * 1024;
 
-SceneRenderSubPass create_scene_render(FrameGraph& framegraph, FrameGraphPassBuilder& builder, const SceneView* view) {
+SceneRenderSubPass create_scene_render(FrameGraph& framegraph, FrameGraphPassBuilder& builder, const SceneView* view,
+									   const MeshletCullPass& meshlet_pass,
+									   const OcclusionCullPass& occlusion_pass, OcclusionCullPhase occlusion_phase) {
 	auto camera_buffer = framegraph.declare_typed_buffer<math::Matrix4<>>();
 	auto transform_buffer = framegraph.declare_typed_buffer<math::Transform<>>(max_batch_size);
 
@@ -39,9 +41,67 @@ SceneRenderSubPass create_scene_render(FrameGraph& framegraph, FrameGraphPassBui
 	builder.map_update(camera_buffer);
 	builder.map_update(transform_buffer);
 
+	if(meshlet_pass.commands.is_valid()) {
+		pass.meshlet_pass = meshlet_pass;
+		builder.add_index_input(meshlet_pass.indices);
+		builder.add_indirect_input(meshlet_pass.commands);
+	}
+
+	if(occlusion_pass.is_valid()) {
+		pass.occlusion_pass = occlusion_pass;
+		pass.occlusion_phase = occlusion_phase;
+		builder.add_indirect_input(occlusion_phase == OcclusionCullPhase::Early ? occlusion_pass.early_commands : occlusion_pass.late_commands);
+		builder.add_indirect_input(occlusion_pass.counts);
+	}
+
 	return pass;
 }
 
+static void render_occlusion_culled(RenderPassRecorder& recorder, const SceneRenderSubPass& subpass, const FrameGraphPass* pass) {
+	auto& descriptor_set = pass->descriptor_sets()[0];
+	const Scene& scene = subpass.scene_view->scene();
+	const OcclusionCullPass& occlusion_pass = subpass.occlusion_pass;
+
+	bool early = subpass.occlusion_phase == OcclusionCullPhase::Early;
+	u32 renderable_count = u32(scene.renderables().size());
+
+	if(early) {
+		u32 attrib_index = 0;
+		for(const auto& r : scene.renderables()) {
+			r->render(recorder, Renderable::SceneData{descriptor_set, attrib_index++});
+		}
+	}
+
+	bool has_meshlets = subpass.meshlet_pass.commands.is_valid();
+	SubBuffer<BufferUsage::IndexBit> indices;
+	if(has_meshlets) {
+		indices = pass->resources()->buffer<BufferUsage::IndexBit>(subpass.meshlet_pass.indices);
+	}
+	auto commands = pass->resources()->buffer<BufferUsage::IndirectBit>(early ? occlusion_pass.early_commands : occlusion_pass.late_commands);
+	auto counts = pass->resources()->buffer<BufferUsage::IndirectBit>(occlusion_pass.counts);
+
+	// batches share material and mesh, commands are laid out as in cull_occluded
+	const auto& frame = *occlusion_pass.frame;
+	for(usize b = 0; b != frame.batches.size(); ++b) {
+		const auto& batch = frame.batches[b];
+		u32 index = frame.static_meshes[batch.first];
+		const auto& r = scene.static_meshes()[index];
+		Renderable::SceneData scene_data{descriptor_set, renderable_count + index};
+		if(has_meshlets && r->mesh()->has_meshlets() && !subpass.scene_view->lod(*r)) {
+			r->bind_culled(recorder, scene_data, indices);
+		} else {
+			r->bind(recorder, scene_data);
+		}
+
+		if(frame.cull_data.compact) {
+			usize count_index = early ? b : frame.batches.size() + b;
+			recorder.draw_indirect_count(commands, batch.first, counts, count_index, batch.size);
+		} else {
+			recorder.draw_indirect(commands, batch.first, batch.size);
+		}
+	}
+}
+
 
 void render_scene(RenderPassRecorder& recorder, const SceneRenderSubPass& subpass, const FrameGraphPass* pass) {
 	y_profile();
@@ -81,6 +141,11 @@ void render_scene(RenderPassRecorder& recorder, const SceneRenderSubPass& subpas
 		auto transform_buffer = pass->resources()->buffer<BufferUsage::AttributeBit>(subpass.transform_buffer);
 		recorder.bind_attrib_buffers({transform_buffer, transform_buffer});
 
+		if(subpass.occlusion_pass.is_valid()) {
+			render_occlusion_culled(recorder, subpass, pass);
+			return;
+		}
+
 		// renderables
 		{
 			for(const auto& r : subpass.scene_view->scene().renderables()) {
@@ -90,8 +155,26 @@ void render_scene(RenderPassRecorder& recorder, const SceneRenderSubPass& subpas
 
 		// static meshes
 		{
-			for(const auto& r : subpass.scene_view->scene().static_meshes()) {
-				r->render(recorder, Renderable::SceneData{descriptor_set, attrib_index++});
+			if(subpass.meshlet_pass.commands.is_valid()) {
+				auto indices = pass->resources()->buffer<BufferUsage::IndexBit>(subpass.meshlet_pass.indices);
+				auto commands = pass->resources()->buffer<BufferUsage::IndirectBit>(subpass.meshlet_pass.commands);
+
+				usize command_index = 0;
+				for(const auto& r : subpass.scene_view->scene().static_meshes()) {
+					Renderable::SceneData scene_data{descriptor_set, attrib_index++};
+					if(r->mesh()->has_meshlets()) {
+						usize index = command_index++;
+						if(!subpass.scene_view->lod(*r)) {
+							r->render_culled(recorder, scene_data, indices, commands, index);
+							continue;
+						}
+					}
+					r->render_lod(recorder, scene_data, subpass.scene_view->lod(*r));
+				}
+			} else {
+				for(const auto& r : subpass.scene_view->scene().static_meshes()) {
+					r->render_lod(recorder, Renderable::SceneData{descriptor_set, attrib_index++}, subpass.scene_view->lod(*r));
+				}
 			}
 		}
 	}
@@ -22,8 +22,7 @@ SOFTWARE.
 #ifndef YAVE_RENDERER_SCENERENDERSUBPASS_H
 #define YAVE_RENDERER_SCENERENDERSUBPASS_H
 
-#include <yave/scene/SceneView.h>
-#include <yave/framegraph/FrameGraph.h>
+#include "OcclusionCullPass.h"
 
 namespace yave {
 
@@ -33,9 +32,16 @@ struct SceneRenderSubPass {
 	FrameGraphMutableTypedBufferId<math::Matrix4<>> camera_buffer;
 	FrameGraphMutableTypedBufferId<math::Transform<>> transform_buffer;
 
+	MeshletCullPass meshlet_pass;
+
+	// if valid, frustum visible static meshes are drawn with the commands of the phase and renderables only in the early phase
+	OcclusionCullPass occlusion_pass;
+	OcclusionCullPhase occlusion_phase = OcclusionCullPhase::Early;
 };
 
-SceneRenderSubPass create_scene_render(FrameGraph& framegraph, FrameGraphPassBuilder& builder, const SceneView* view);
+SceneRenderSubPass create_scene_render(FrameGraph& framegraph, FrameGraphPassBuilder& builder, const SceneView* view,
+									   const MeshletCullPass& meshlet_pass = MeshletCullPass(),
+									   const OcclusionCullPass& occlusion_pass = OcclusionCullPass(), OcclusionCullPhase occlusion_phase = OcclusionCullPhase::Early);
 void render_scene(RenderPassRecorder& recorder, const SceneRenderSubPass& subpass, const FrameGraphPass* pass);
 
 }
@@ -0,0 +1,139 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "ShadowAtlas.h"
+
+namespace yave {
+
+static u32 next_pow_of_2(u32 x) {
+	u32 p = 1;
+	while(p < x) {
+		p <<= 1;
+	}
+	return p;
+}
+
+static bool is_pow_of_2(u32 x) {
+	return x && !(x & (x - 1));
+}
+
+ShadowAtlas::ShadowAtlas(u32 size, u32 min_tile_size) : _size(size), _min_tile_size(min_tile_size) {
+	if(!is_pow_of_2(size) || !is_pow_of_2(min_tile_size) || min_tile_size > size) {
+		y_fatal("Invalid shadow atlas size.");
+	}
+
+	for(u32 s = size; s >= min_tile_size; s >>= 1) {
+		_free.emplace_back();
+	}
+	_free[0] << math::Vec2ui(0);
+}
+
+u32 ShadowAtlas::size() const {
+	return _size;
+}
+
+u32 ShadowAtlas::min_tile_size() const {
+	return _min_tile_size;
+}
+
+u32 ShadowAtlas::tile_size(u32 size) const {
+	return std::min(_size, std::max(_min_tile_size, next_pow_of_2(size)));
+}
+
+usize ShadowAtlas::allocated_area() const {
+	return _allocated_area;
+}
+
+usize ShadowAtlas::level(u32 size) const {
+	usize l = 0;
+	for(u32 s = _size; s > size; s >>= 1) {
+		++l;
+	}
+	return l;
+}
+
+std::optional<ShadowAtlas::Tile> ShadowAtlas::alloc(u32 size) {
+	size = tile_size(size);
+	if(auto offset = alloc_level(level(size))) {
+		_allocated_area += usize(size) * size;
+		return Tile{*offset, size};
+	}
+	return std::nullopt;
+}
+
+void ShadowAtlas::free(const Tile& tile) {
+	y_debug_assert(tile.size && is_pow_of_2(tile.size));
+	_allocated_area -= usize(tile.size) * tile.size;
+	free_level(tile.offset, level(tile.size));
+}
+
+std::optional<math::Vec2ui> ShadowAtlas::alloc_level(usize level) {
+	auto& free = _free[level];
+	if(!free.is_empty()) {
+		math::Vec2ui offset = free.pop();
+		return offset;
+	}
+
+	if(!level) {
+		return std::nullopt;
+	}
+
+	// split a parent tile, keep the 3 other quadrants for later
+	if(auto parent = alloc_level(level - 1)) {
+		u32 half = _size >> level;
+		free << (*parent + math::Vec2ui(half, 0))
+			 << (*parent + math::Vec2ui(0, half))
+			 << (*parent + math::Vec2ui(half, half));
+		return parent;
+	}
+	return std::nullopt;
+}
+
+void ShadowAtlas::free_level(math::Vec2ui offset, usize level) {
+	auto& free = _free[level];
+	if(!level) {
+		free << offset;
+		return;
+	}
+
+	// merges back with the 3 other quadrants if they are all free
+	u32 parent_mask = ~((_size >> (level - 1)) - 1);
+	math::Vec2ui parent(offset.x() & parent_mask, offset.y() & parent_mask);
+	auto is_sibling = [&](const math::Vec2ui& o) {
+		return (o.x() & parent_mask) == parent.x() && (o.y() & parent_mask) == parent.y();
+	};
+
+	if(std::count_if(free.begin(), free.end(), is_sibling) == 3) {
+		for(usize i = 0; i != free.size();) {
+			if(is_sibling(free[i])) {
+				free.erase_unordered(free.begin() + i);
+			} else {
+				++i;
+			}
+		}
+		free_level(parent, level - 1);
+	} else {
+		free << offset;
+	}
+}
+
+}
@@ -0,0 +1,71 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_SHADOWATLAS_H
+#define YAVE_RENDERER_SHADOWATLAS_H
+
+#include <yave/yave.h>
+
+#include <y/core/Vector.h>
+#include <y/math/Vec.h>
+
+#include <optional>
+
+namespace yave {
+
+// Quadtree buddy allocator handing out square power of two tiles of a square atlas
+class ShadowAtlas {
+	public:
+		struct Tile {
+			math::Vec2ui offset;
+			u32 size = 0;
+		};
+
+		ShadowAtlas(u32 size = 4096, u32 min_tile_size = 64);
+
+		// size is rounded up to the next power of two
+		std::optional<Tile> alloc(u32 size);
+		void free(const Tile& tile);
+
+		u32 size() const;
+		u32 min_tile_size() const;
+
+		// clamps size to the sizes that the atlas can allocate
+		u32 tile_size(u32 size) const;
+
+		usize allocated_area() const;
+
+	private:
+		usize level(u32 size) const;
+		std::optional<math::Vec2ui> alloc_level(usize level);
+		void free_level(math::Vec2ui offset, usize level);
+
+		u32 _size = 0;
+		u32 _min_tile_size = 0;
+		usize _allocated_area = 0;
+
+		// free tiles of each level, level 0 is the whole atlas
+		core::Vector<core::Vector<math::Vec2ui>> _free;
+};
+
+}
+
+#endif // YAVE_RENDERER_SHADOWATLAS_H
@@ -0,0 +1,469 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "ShadowMapPass.h"
+
+#include <yave/device/Device.h>
+
+namespace yave {
+
+// entries of lights that have not been visible for this many frames are evicted
+static constexpr u64 eviction_delay = 120;
+
+// faces follow the major axis of the light to fragment direction in deferred.comp
+static const std::array<math::Vec3, 6> cube_directions = {{
+		{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+		{0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+		{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}
+	}};
+
+static math::Vec4 bounding_sphere(const Renderable& r) {
+	const auto& tr = r.transform();
+	float scale = std::max({tr.forward().length(), tr.left().length(), tr.up().length()});
+	return math::Vec4(tr.position(), r.radius() * scale);
+}
+
+static Viewport tile_viewport(const ShadowAtlas::Tile& tile) {
+	return Viewport(math::Vec2(float(tile.size)), math::Vec2(tile.offset));
+}
+
+static u32 face_mask(usize faces) {
+	return (1u << faces) - 1;
+}
+
+// orthographic view with reversed Z, covers depth on both sides of center along dir
+static Camera directional_camera(const math::Vec3& center, const math::Vec3& dir, float half_size, float depth) {
+	math::Vec3 up = std::abs(dir.z()) > 0.99f ? math::Vec3(1.0f, 0.0f, 0.0f) : math::Vec3(0.0f, 0.0f, 1.0f);
+
+	Camera camera;
+	camera.set_proj(math::Matrix4<>(1.0f / half_size, 0.0f, 0.0f, 0.0f,
+									0.0f, 1.0f / half_size, 0.0f, 0.0f,
+									0.0f, 0.0f, 0.5f / depth, 1.0f,
+									0.0f, 0.0f, 0.0f, 1.0f));
+	camera.set_view(math::look_at(center + dir * depth, center, up));
+	return camera;
+}
+
+static math::Vec3 snap(const math::Vec3& v, float grid) {
+	return math::Vec3(std::floor(v.x() / grid), std::floor(v.y() / grid), std::floor(v.z() / grid)) * grid;
+}
+
+
+ShadowMapCache::ShadowMapCache(DevicePtr dptr, u32 atlas_size, usize update_budget) :
+		DeviceLinked(dptr),
+		_atlas(atlas_size),
+		_static_atlas(dptr, atlas_format, math::Vec2ui(atlas_size)),
+		_static_framebuffer(dptr, _static_atlas, {}, Framebuffer::LoadOp::Load),
+		_update_budget(update_budget) {
+}
+
+u32 ShadowMapCache::atlas_size() const {
+	return _atlas.size();
+}
+
+const DepthTextureAttachment& ShadowMapCache::static_atlas() const {
+	return _static_atlas;
+}
+
+const Framebuffer& ShadowMapCache::static_framebuffer() const {
+	return _static_framebuffer;
+}
+
+ShadowMapCache::StaticChanges ShadowMapCache::update_static_spheres(const Scene& scene) {
+	StaticChanges changes;
+	_moved_spheres.make_empty();
+
+	const auto& statics = scene.static_meshes();
+	if(statics.size() != _static_spheres.size()) {
+		changes.reset = true;
+		_static_spheres.make_empty();
+		std::transform(statics.begin(), statics.end(), std::back_inserter(_static_spheres), [](const auto& r) { return bounding_sphere(*r); });
+	} else {
+		for(usize i = 0; i != statics.size(); ++i) {
+			math::Vec4 sphere = bounding_sphere(*statics[i]);
+			if(sphere != _static_spheres[i]) {
+				_moved_spheres << _static_spheres[i] << sphere;
+				_static_spheres[i] = sphere;
+			}
+		}
+	}
+
+	math::Vec4 bounds;
+	if(!_static_spheres.is_empty()) {
+		math::Vec3 min(std::numeric_limits<float>::max());
+		math::Vec3 max(-std::numeric_limits<float>::max());
+		for(const math::Vec4& s : _static_spheres) {
+			for(usize i = 0; i != 3; ++i) {
+				min[i] = std::min(min[i], s[i] - s.w());
+				max[i] = std::max(max[i], s[i] + s.w());
+			}
+		}
+		bounds = math::Vec4((min + max) * 0.5f, (max - min).length() * 0.5f);
+	}
+
+	changes.bounds_changed = bounds != _static_bounds;
+	_static_bounds = bounds;
+
+	return changes;
+}
+
+void ShadowMapCache::free_tiles(Entry& entry) {
+	for(const auto& tile : entry.tiles) {
+		_atlas.free(tile);
+	}
+	entry.tiles.make_empty();
+	entry.valid_faces = 0;
+}
+
+void ShadowMapCache::allocate_tiles(Entry& entry, u32 tile_size) {
+	free_tiles(entry);
+
+	usize faces = entry.type == Light::Point ? cube_directions.size() : directional_cascades;
+	entry.dirty_faces = face_mask(faces);
+
+	// falls back to smaller tiles when the atlas is full
+	for(; tile_size >= _atlas.min_tile_size(); tile_size /= 2) {
+		for(usize i = 0; i != faces; ++i) {
+			if(auto tile = _atlas.alloc(tile_size)) {
+				entry.tiles << *tile;
+			} else {
+				break;
+			}
+		}
+		if(entry.tiles.size() == faces) {
+			return;
+		}
+		free_tiles(entry);
+	}
+}
+
+void ShadowMapCache::update_views(Entry& entry) const {
+	entry.views.make_empty();
+
+	if(entry.type == Light::Point) {
+		float z_near = std::max(entry.radius * 0.001f, 0.01f);
+		math::Matrix4<> proj = math::perspective(math::to_rad(90.0f), 1.0f, z_near, entry.radius);
+		for(usize i = 0; i != cube_directions.size(); ++i) {
+			const math::Vec3& dir = cube_directions[i];
+			math::Vec3 up = std::abs(dir.z()) > 0.5f ? math::Vec3(1.0f, 0.0f, 0.0f) : math::Vec3(0.0f, 0.0f, 1.0f);
+
+			View view;
+			view.camera.set_proj(proj);
+			view.camera.set_view(math::look_at(entry.position, entry.position + dir, up));
+			view.tile = entry.tiles[i];
+			entry.views << view;
+		}
+	} else {
+		// camera cascade first, as expected by deferred.comp, then the whole static geometry
+		math::Vec3 center = _static_bounds.to<3>();
+		float radius = std::max(_static_bounds.w(), 0.01f) * 1.01f;
+		float cascade_radius = radius * directional_cascade_ratio;
+		const math::Vec3& dir = entry.position;
+
+		// every static caster between the light and the cascade has to be in its depth range
+		float cascade_depth = (entry.cascade_center - center).length() + radius;
+
+		View cascade;
+		cascade.camera = directional_camera(entry.cascade_center, dir, cascade_radius, cascade_depth);
+		cascade.tile = entry.tiles[0];
+		entry.views << cascade;
+
+		View view;
+		view.camera = directional_camera(center, dir, radius, radius);
+		view.tile = entry.tiles[1];
+		entry.views << view;
+	}
+}
+
+ShadowMapCache::FrameData ShadowMapCache::update(const SceneView* scene_view, const math::Vec2ui& screen_size) {
+	y_profile();
+
+	++_frame;
+
+	const Scene& scene = scene_view->scene();
+	const Camera& camera = scene_view->camera();
+	const Frustum frustum = camera.frustum();
+
+	StaticChanges changes = update_static_spheres(scene);
+
+	for(const auto& light : scene.lights()) {
+		if(!light->cast_shadows()) {
+			continue;
+		}
+
+		bool is_point = light->type() == Light::Point;
+		math::Vec3 position = is_point ? light->position() : light->forward();
+		float radius = is_point ? light->radius() : 0.0f;
+
+		u32 tile_size = _atlas.tile_size(max_directional_tile_size);
+		float priority = 2.0f;
+		math::Vec3 cascade_center;
+		if(is_point) {
+			if(!frustum.is_inside(position, radius)) {
+				continue;
+			}
+			// resolution follows the projected size of the light's sphere of influence
+			float distance = (position - camera.position()).length();
+			float coverage = distance <= radius ? 1.0f : std::min(1.0f, radius * camera.proj_matrix()[1][1] / distance);
+			tile_size = _atlas.tile_size(std::min(max_point_tile_size, u32(coverage * screen_size.y())));
+			priority = coverage;
+		} else if(_static_bounds.w() <= 0.0f) {
+			continue;
+		} else {
+			// snapped to a quarter of the cascade, which always contains the three quarters in front of the camera
+			float cascade_radius = _static_bounds.w() * directional_cascade_ratio;
+			cascade_center = snap(camera.position() + camera.forward() * (cascade_radius * 0.5f), cascade_radius * 0.25f);
+		}
+
+		auto [it, inserted] = _entries.emplace(light.get());
+		Entry& entry = it->second;
+		bool moved = inserted || entry.type != light->type() || entry.position != position || entry.radius != radius;
+		bool cascade_moved = !is_point && entry.cascade_center != cascade_center;
+		if(entry.type != light->type()) {
+			free_tiles(entry);
+		}
+
+		entry.type = light->type();
+		entry.position = position;
+		entry.radius = radius;
+		entry.cascade_center = cascade_center;
+		entry.priority = priority;
+		entry.frame = _frame;
+
+		// hysteresis avoids re-rendering lights that hover around a resolution threshold
+		u32 current_size = entry.tiles.is_empty() ? 0 : entry.tiles[0].size;
+		if(tile_size > current_size || tile_size * 4 <= current_size) {
+			allocate_tiles(entry, tile_size);
+		}
+		if(entry.tiles.is_empty()) {
+			continue;
+		}
+
+		update_views(entry);
+
+		if(moved || changes.reset || (!is_point && changes.bounds_changed)) {
+			entry.dirty_faces = face_mask(entry.views.size());
+		} else {
+			if(cascade_moved) {
+				entry.dirty_faces |= 1u;
+			}
+			for(usize i = 0; i != entry.views.size(); ++i) {
+				Frustum view_frustum = entry.views[i].camera.frustum();
+				for(const math::Vec4& s : _moved_spheres) {
+					if(view_frustum.is_inside(s.to<3>(), s.w())) {
+						entry.dirty_faces |= 1u << i;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	// erasing only marks the slot as deleted, iterators stay valid
+	for(auto it = _entries.begin(); it != _entries.end();) {
+		auto next = std::next(it);
+		if(_frame - it->second.frame > eviction_delay) {
+			free_tiles(it->second);
+			_entries.erase(it);
+		}
+		it = next;
+	}
+
+	// schedule static updates: lights without a complete shadow first, then by screen coverage
+	struct Update {
+		Entry* entry;
+		usize face;
+		bool complete;
+	};
+
+	core::Vector<Update> updates;
+	for(auto& [light, entry] : _entries) {
+		if(entry.frame != _frame || entry.tiles.is_empty()) {
+			continue;
+		}
+		bool complete = entry.valid_faces == face_mask(entry.views.size());
+		for(usize i = 0; i != entry.views.size(); ++i) {
+			if(entry.dirty_faces & (1u << i)) {
+				updates << Update{&entry, i, complete};
+			}
+		}
+	}
+
+	std::sort(updates.begin(), updates.end(), [](const Update& a, const Update& b) {
+			if(a.complete != b.complete) {
+				return !a.complete;
+			}
+			return a.entry->priority > b.entry->priority;
+		});
+
+	usize update_count = std::min(updates.size(), _update_budget);
+	for(usize i = 0; i != update_count; ++i) {
+		Entry& entry = *updates[i].entry;
+		u32 bit = 1u << updates[i].face;
+		entry.dirty_faces &= ~bit;
+		entry.valid_faces |= bit;
+		entry.views[updates[i].face].update_static = true;
+	}
+
+	FrameData frame;
+	frame.stats.static_updates = u32(update_count);
+	frame.stats.pending_updates = u32(updates.size() - update_count);
+	frame.stats.atlas_usage = float(_atlas.allocated_area()) / float(usize(_atlas.size()) * _atlas.size());
+
+	for(auto& [light, entry] : _entries) {
+		if(entry.frame != _frame || entry.tiles.is_empty()) {
+			continue;
+		}
+
+		// lights are only shadowed once all their faces have been rendered
+		bool shadowed = entry.valid_faces == face_mask(entry.views.size());
+		if(shadowed) {
+			frame.shadow_indices[light] = u32(frame.views.size());
+			++frame.stats.shadowed_lights;
+		}
+
+		for(View& view : entry.views) {
+			if(shadowed || view.update_static) {
+				view.render_dynamic = shadowed;
+				frame.stats.dynamic_views += shadowed;
+				frame.views << view;
+			}
+		}
+	}
+
+	return frame;
+}
+
+
+
+ShadowMapPass render_shadows(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<ShadowMapCache>& cache) {
+	y_profile();
+
+	const SceneView* scene = gbuffer.scene_pass.scene_view;
+	auto frame = std::make_shared<ShadowMapCache::FrameData>(cache->update(scene, framegraph.image_size(gbuffer.depth)));
+
+	usize renderable_count = scene->scene().renderables().size();
+	usize instance_count = renderable_count + scene->scene().static_meshes().size();
+
+	// the dynamic atlas is only cleared when nothing needs it, lighting samples it regardless
+	bool has_dynamic = frame->stats.dynamic_views && renderable_count;
+	auto dynamic_atlas = framegraph.declare_image(ShadowMapCache::atlas_format, math::Vec2ui(has_dynamic ? cache->atlas_size() : 1));
+	auto transform_buffer = framegraph.declare_typed_buffer<math::Transform<>>(std::max(instance_count, usize(1)));
+
+	ShadowMapPass pass;
+	pass.dynamic_atlas = dynamic_atlas;
+	pass.cache = cache;
+	pass.frame = frame;
+
+	FrameGraphPassBuilder builder = framegraph.add_pass("Shadow pass");
+	builder.add_depth_output(dynamic_atlas);
+	builder.add_attrib_input(transform_buffer);
+	builder.map_update(transform_buffer);
+	add_skinned_vertex_inputs(builder, gbuffer.skinning);
+
+	// every view gets its own descriptor set with its camera
+	auto camera_buffers = core::vector_with_capacity<FrameGraphMutableTypedBufferId<math::Matrix4<>>>(frame->views.size());
+	for(usize i = 0; i != frame->views.size(); ++i) {
+		auto camera_buffer = framegraph.declare_typed_buffer<math::Matrix4<>>();
+		builder.add_uniform_input(camera_buffer, i);
+		builder.map_update(camera_buffer);
+		camera_buffers << camera_buffer;
+	}
+
+	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+			const Scene& sc = scene->scene();
+			const auto& views = frame->views;
+
+			{
+				auto transform_mapping = self->resources()->mapped_buffer(transform_buffer);
+				usize attrib_index = 0;
+				for(const auto& r : sc.renderables()) {
+					transform_mapping[attrib_index++] = r->transform();
+				}
+				for(const auto& r : sc.static_meshes()) {
+					transform_mapping[attrib_index++] = r->transform();
+				}
+			}
+
+			for(usize i = 0; i != views.size(); ++i) {
+				self->resources()->mapped_buffer(camera_buffers[i])[0] = views[i].camera.viewproj_matrix();
+			}
+
+			auto transforms = self->resources()->buffer<BufferUsage::AttributeBit>(transform_buffer);
+
+			if(frame->stats.static_updates) {
+				const DepthTextureAttachment& static_atlas = cache->static_atlas();
+
+				// the previous frame might still be sampling the atlas
+				recorder.barriers(ImageBarrier(static_atlas, PipelineStage::ComputeBit, PipelineStage::FragmentBit));
+				{
+					auto render_pass = recorder.bind_framebuffer(cache->static_framebuffer());
+					render_pass.bind_attrib_buffers({transforms, transforms});
+					for(usize i = 0; i != views.size(); ++i) {
+						if(!views[i].update_static) {
+							continue;
+						}
+
+						render_pass.set_viewport(tile_viewport(views[i].tile));
+						render_pass.clear_depth();
+
+						Frustum frustum = views[i].camera.frustum();
+						u32 attrib_index = u32(renderable_count);
+						for(const auto& r : sc.static_meshes()) {
+							Renderable::SceneData scene_data{self->descriptor_sets()[i], attrib_index++};
+							math::Vec4 sphere = bounding_sphere(*r);
+							if(frustum.is_inside(sphere.to<3>(), sphere.w())) {
+								r->render_lod(render_pass, scene_data, 0);
+							}
+						}
+					}
+				}
+				recorder.barriers(ImageBarrier(static_atlas, PipelineStage::FragmentBit, PipelineStage::ComputeBit));
+			}
+
+			auto render_pass = recorder.bind_framebuffer(self->framebuffer());
+			if(has_dynamic) {
+				render_pass.bind_attrib_buffers({transforms, transforms});
+				for(usize i = 0; i != views.size(); ++i) {
+					if(!views[i].render_dynamic) {
+						continue;
+					}
+
+					render_pass.set_viewport(tile_viewport(views[i].tile));
+
+					Frustum frustum = views[i].camera.frustum();
+					u32 attrib_index = 0;
+					for(const auto& r : sc.renderables()) {
+						Renderable::SceneData scene_data{self->descriptor_sets()[i], attrib_index++};
+						math::Vec4 sphere = bounding_sphere(*r);
+						if(frustum.is_inside(sphere.to<3>(), sphere.w())) {
+							r->render(render_pass, scene_data);
+						}
+					}
+				}
+			}
+		});
+
+	return pass;
+}
+
+}
@@ -0,0 +1,141 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_SHADOWMAPPASS_H
+#define YAVE_RENDERER_SHADOWMAPPASS_H
+
+#include <yave/graphics/framebuffer/Framebuffer.h>
+
+#include "GBufferPass.h"
+#include "ShadowAtlas.h"
+
+#include <y/core/FlatHashMap.h>
+
+namespace yave {
+
+struct ShadowMapStats {
+	u32 shadowed_lights = 0;
+	u32 static_updates = 0;
+	u32 pending_updates = 0;
+	u32 dynamic_views = 0;
+	float atlas_usage = 0.0f;
+};
+
+// Shadows of static meshes are cached in a persistent atlas and only re-rendered when the light moves,
+// when a static mesh moves inside the light view or when the light gets a new tile.
+// Renderables are considered dynamic and are rendered every frame in a transient atlas with the same layout.
+// Static shadows are rendered at full detail so that they don't depend on the LODs selected for the main view.
+// Directional lights have two cascades: one around the camera, snapped to a grid so that it is rarely re-rendered,
+// and one that covers the whole static geometry.
+class ShadowMapCache : NonCopyable, public DeviceLinked {
+
+	public:
+		static constexpr vk::Format atlas_format = vk::Format::eD32Sfloat;
+
+		static constexpr u32 default_atlas_size = 4096;
+		static constexpr u32 max_point_tile_size = 1024;
+		static constexpr u32 max_directional_tile_size = 1024;
+
+		// radius of the camera cascade, relative to the radius of the static geometry
+		static constexpr float directional_cascade_ratio = 1.0f / 8.0f;
+		static constexpr usize directional_cascades = 2;
+
+		// maximum number of static shadow maps (cube faces count as one each) rendered every frame
+		static constexpr usize default_update_budget = 12;
+
+		struct View {
+			Camera camera;
+			ShadowAtlas::Tile tile;
+			bool update_static = false;
+			bool render_dynamic = false;
+		};
+
+		struct FrameData {
+			core::Vector<View> views;
+			// index of the first view of each shadowed light
+			core::FlatHashMap<const Light*, u32> shadow_indices;
+			ShadowMapStats stats;
+		};
+
+		ShadowMapCache(DevicePtr dptr, u32 atlas_size = default_atlas_size, usize update_budget = default_update_budget);
+
+		FrameData update(const SceneView* view, const math::Vec2ui& screen_size);
+
+		u32 atlas_size() const;
+
+		const DepthTextureAttachment& static_atlas() const;
+		const Framebuffer& static_framebuffer() const;
+
+	private:
+		struct StaticChanges {
+			bool reset = false;
+			bool bounds_changed = false;
+		};
+
+		struct Entry {
+			Light::Type type;
+			math::Vec3 position;
+			float radius = 0.0f;
+			math::Vec3 cascade_center;
+
+			core::Vector<ShadowAtlas::Tile> tiles;
+			core::Vector<View> views;
+
+			u32 dirty_faces = 0;
+			u32 valid_faces = 0;
+
+			float priority = 0.0f;
+			u64 frame = 0;
+		};
+
+		StaticChanges update_static_spheres(const Scene& scene);
+		void allocate_tiles(Entry& entry, u32 tile_size);
+		void free_tiles(Entry& entry);
+		void update_views(Entry& entry) const;
+
+		ShadowAtlas _atlas;
+		DepthTextureAttachment _static_atlas;
+		Framebuffer _static_framebuffer;
+
+		usize _update_budget = 0;
+		u64 _frame = 0;
+
+		core::FlatHashMap<const Light*, Entry> _entries;
+
+		// (center, radius) of every static mesh when the cache was last updated
+		core::Vector<math::Vec4> _static_spheres;
+		core::Vector<math::Vec4> _moved_spheres;
+		math::Vec4 _static_bounds;
+};
+
+
+struct ShadowMapPass {
+	FrameGraphImageId dynamic_atlas;
+
+	std::shared_ptr<ShadowMapCache> cache;
+	std::shared_ptr<const ShadowMapCache::FrameData> frame;
+};
+
+ShadowMapPass render_shadows(FrameGraph& framegraph, const GBufferPass& gbuffer, const std::shared_ptr<ShadowMapCache>& cache);
+
+}
+
+#endif // YAVE_RENDERER_SHADOWMAPPASS_H
@@ -0,0 +1,120 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+
+#include "SkinningPass.h"
+
+#include <yave/animations/SkeletonInstance.h>
+
+#include <y/mem/LinearAllocator.h>
+
+namespace yave {
+
+static constexpr usize max_bone_palette_size = 64 * 1024;
+
+static bool is_visible(const Renderable& r, const Frustum& frustum) {
+	const auto& tr = r.transform();
+	float scale = std::max({tr.forward().length(), tr.left().length(), tr.up().length()});
+	return frustum.is_inside(tr.position(), r.radius() * scale);
+}
+
+SkinningPass skin_meshes(FrameGraph& framegraph, const SceneView* view) {
+	y_profile();
+
+	SkinningPass pass;
+
+	usize skinned_count = std::count_if(view->scene().renderables().begin(), view->scene().renderables().end(), [](const auto& r) { return r->skeleton(); });
+	if(!skinned_count) {
+		return pass;
+	}
+
+	auto bone_palette = framegraph.declare_typed_buffer<math::Transform<>>(max_bone_palette_size);
+	pass.bone_palette = bone_palette;
+
+	FrameGraphPassBuilder builder = framegraph.add_pass("Skinning pass");
+	builder.add_storage_input(bone_palette, 0, PipelineStage::ComputeBit);
+	builder.map_update(bone_palette);
+
+	for(const auto& r : view->scene().renderables()) {
+		if(r->skeleton()) {
+			auto skinned = framegraph.import_buffer(r->skinned_vertices());
+			builder.add_unbound_storage_output(skinned, PipelineStage::ComputeBit);
+			pass.skinned_vertices << skinned;
+		}
+	}
+
+	builder.set_render_func([=](CmdBufferRecorder& recorder, const FrameGraphPass* self) {
+			const Frustum frustum = view->camera().frustum();
+
+			// visible skeletons are animated in parallel, their bones packed in the palette
+			auto renderables = core::frame_vector_with_capacity<const Renderable*>(skinned_count);
+			auto skeletons = core::frame_vector_with_capacity<SkeletonInstance*>(skinned_count);
+			auto offsets = core::frame_vector_with_capacity<u32>(skinned_count);
+			u32 bone_count = 0;
+			for(const auto& r : view->scene().renderables()) {
+				if(SkeletonInstance* skeleton = r->skeleton()) {
+					if(!is_visible(*r, frustum)) {
+						// skin again once back in view
+						skeleton->invalidate_pose();
+						continue;
+					}
+					renderables << r.get();
+					skeletons << skeleton;
+					offsets << bone_count;
+					bone_count += u32(skeleton->bone_count());
+				}
+			}
+
+			{
+				auto mapping = self->resources()->mapped_buffer(bone_palette);
+				if(mapping.size() < bone_count) {
+					y_fatal("Bone palette overflow.");
+				}
+				update_skeletons(skeletons, offsets, mapping.begin());
+			}
+
+			// unchanged poses keep the vertices skinned by a previous frame, which may still be drawing them
+			auto barriers = core::frame_vector_with_capacity<BufferBarrier>(renderables.size());
+			for(usize i = 0; i != renderables.size(); ++i) {
+				if(skeletons[i]->pose_changed()) {
+					barriers.emplace_back(renderables[i]->skinned_vertices(), PipelineStage::VertexInputBit, PipelineStage::ComputeBit);
+				}
+			}
+			recorder.barriers(barriers);
+
+			const auto& palette_set = self->descriptor_sets()[0];
+			for(usize i = 0; i != renderables.size(); ++i) {
+				if(skeletons[i]->pose_changed()) {
+					renderables[i]->skin(recorder, Renderable::SkinningData{palette_set, offsets[i]});
+				}
+			}
+		});
+
+	return pass;
+}
+
+void add_skinned_vertex_inputs(FrameGraphPassBuilder& builder, const SkinningPass& skinning) {
+	for(FrameGraphBufferId skinned : skinning.skinned_vertices) {
+		builder.add_attrib_input(skinned);
+	}
+}
+
+}
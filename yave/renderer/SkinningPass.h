@@ -0,0 +1,46 @@
+/*******************************
+Copyright (c) 2016-2019 Gr�goire Angerand
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+**********************************/
+#ifndef YAVE_RENDERER_SKINNINGPASS_H
+#define YAVE_RENDERER_SKINNINGPASS_H
+
+#include <yave/scene/SceneView.h>
+#include <yave/framegraph/FrameGraph.h>
+
+namespace yave {
+
+// animates every visible skinned renderable and skins its vertices once, scene passes then draw them like static meshes
+struct SkinningPass {
+	FrameGraphMutableTypedBufferId<math::Transform<>> bone_palette;
+
+	// persistent vertex buffers of every skinned renderable, imported in the frame graph
+	core::Vector<FrameGraphBufferId> skinned_vertices;
+};
+
+// bone_palette is invalid if nothing in the scene is skinned
+SkinningPass skin_meshes(FrameGraph& framegraph, const SceneView* view);
+
+// for passes drawing skinned renderables
+void add_skinned_vertex_inputs(FrameGraphPassBuilder& builder, const SkinningPass& skinning);
+
+}
+
+#endif // YAVE_RENDERER_SKINNINGPASS_H
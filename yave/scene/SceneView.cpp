@@ -44,4 +44,20 @@ Camera& SceneView::camera() {
 	return _camera;
 }
 
+void SceneView::update_lods() const {
+	y_profile();
+
+	// rebuilt every frame so that removed instances are dropped
+	core::FlatHashMap<const StaticMeshInstance*, usize> lods;
+	for(const auto& r : scene().static_meshes()) {
+		lods.emplace(r.get(), r->select_lod(_camera, lod(*r)));
+	}
+	_lods = std::move(lods);
+}
+
+usize SceneView::lod(const StaticMeshInstance& instance) const {
+	auto it = _lods.find(&instance);
+	return it == _lods.end() ? 0 : it->second;
+}
+
 }
@@ -26,6 +26,8 @@ SOFTWARE.
 
 #include "Scene.h"
 
+#include <y/core/FlatHashMap.h>
+
 namespace yave {
 
 class SceneView {
@@ -38,11 +40,18 @@ class SceneView {
 		const Camera& camera() const;
 		Camera& camera();
 
+		// selects the static mesh LODs of this view, called once per frame by render_gbuffer
+		void update_lods() const;
+		usize lod(const StaticMeshInstance& instance) const;
+
 	private:
 		void swap();
 
 		Scene* _scene = nullptr;
 		Camera _camera;
+
+		// hysteresis state, every view has its own
+		mutable core::FlatHashMap<const StaticMeshInstance*, usize> _lods;
 };
 
 }
@@ -30,7 +30,28 @@ SOFTWARE.
 
 namespace yave {
 
-static constexpr u32 scene_file_version = 3;
+static constexpr u32 scene_file_version = 4;
+
+// lights are written raw, they gained cast_shadows in version 4
+static constexpr u32 no_shadows_scene_file_version = 3;
+
+static std::unique_ptr<Light> read_no_shadows_light(io::ReaderRef reader) {
+	struct NoShadowsLight {
+		math::Transform<> transform;
+		Light::Type type;
+		math::Vec3 color;
+		float intensity;
+		float radius;
+	};
+
+	auto data = reader->read_one<NoShadowsLight>();
+	auto light = std::make_unique<Light>(data.type);
+	light->transform() = data.transform;
+	light->color() = data.color;
+	light->intensity() = data.intensity;
+	light->radius() = data.radius;
+	return light;
+}
 
 void Scene::serialize(io::WriterRef writer) const {
 	writer->write_one(fs::magic_number);
@@ -71,7 +92,7 @@ core::Result<Scene> Scene::load(io::ReaderRef reader, AssetLoader& loader) {
 			bool is_valid() const {
 				return magic == fs::magic_number &&
 					   type == AssetType::Scene &&
-					   version == scene_file_version;
+					   (version == scene_file_version || version == no_shadows_scene_file_version);
 			}
 		};
 
@@ -116,6 +137,11 @@ core::Result<Scene> Scene::load(io::ReaderRef reader, AssetLoader& loader) {
 		}
 
 		for(u32 i = 0; i != header.lights; ++i) {
+			if(header.version == no_shadows_scene_file_version) {
+				scene.lights().emplace_back(read_no_shadows_light(reader));
+				continue;
+			}
+
 			// load as point, then read on top. Maybe change this ?
 			auto light = std::make_unique<Light>(Light::Point);
 			reader->read_one(*light);